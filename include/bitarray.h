@@ -8,4 +8,13 @@
 void bitarray_set(uint8_t* arr, size_t bit);
 bool bitarray_get(const uint8_t* arr, size_t bit);
 
+// Bits a 1 en los primeros nbytes bytes
+size_t bitarray_popcount(const uint8_t* arr, size_t nbytes);
+
+// dst[i] |= src[i] para i en [0, nbytes)
+void bitarray_or(uint8_t* dst, const uint8_t* src, size_t nbytes);
+
+// arr[i] &= mask para i en [0, nbytes)
+void bitarray_and_mask(uint8_t* arr, uint8_t mask, size_t nbytes);
+
 #endif
@@ -0,0 +1,53 @@
+#ifndef BLOOM_BLOCKED_H
+#define BLOOM_BLOCKED_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "bloomdb.h"
+
+// ============================================================================
+// Blocked Bloom filter
+//
+// El arreglo se divide en bloques de 64 bytes (una línea de caché, 512 bits).
+// Cada clave elige un bloque y pone sus k bits dentro de él, así que una
+// consulta cuesta un solo fallo de caché en vez de hasta k.
+//
+// Costo: a igual memoria el FPR es algo mayor que el de BloomDB, porque los
+// bloques se llenan de forma desigual. Ver docs/API_REFERENCE.md para la
+// tabla bits-por-clave vs FPR.
+// ============================================================================
+
+#define BLOOMDB_BLOCK_BITS  512
+#define BLOOMDB_BLOCK_WORDS 8
+#define BLOOMDB_BLOCKED_MAX_HASHES 16
+
+typedef struct {
+    uint64_t* blocks;      //block_count * 8 palabras, alineado a 64 bytes
+    size_t block_count;    //número de bloques de 512 bits
+    size_t bit_count;      //block_count * 512
+    int num_hashes;        //bits por clave dentro del bloque (1..16)
+    uint64_t seed;         //semilla del hash
+    void* alloc;           //puntero original de la reserva (interno)
+} BloomDBBlocked;
+
+// ============================================================================
+// Simple API (returns NULL/false on error)
+// ============================================================================
+
+// bits se redondea hacia arriba a un múltiplo de 512
+BloomDBBlocked* bloomdb_blocked_create(size_t bits, int num_hashes, uint64_t seed);
+void bloomdb_blocked_free(BloomDBBlocked* bf);
+bool bloomdb_blocked_insert(BloomDBBlocked* bf, const void* key, size_t len);
+bool bloomdb_blocked_might_contain(const BloomDBBlocked* bf, const void* key, size_t len);
+
+// ============================================================================
+// Extended API (explicit error handling)
+// ============================================================================
+
+BloomDBError bloomdb_blocked_create_ex(size_t bits, int num_hashes, uint64_t seed, BloomDBBlocked** out_bf);
+BloomDBError bloomdb_blocked_insert_ex(BloomDBBlocked* bf, const void* key, size_t len);
+BloomDBError bloomdb_blocked_might_contain_ex(const BloomDBBlocked* bf, const void* key, size_t len, bool* out_result);
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef BLOOM_COUNTING_H
+#define BLOOM_COUNTING_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "bloomdb.h"
+
+// ============================================================================
+// Counting Bloom filter
+//
+// Cada posición es un contador de 4 bits en vez de un bit (16 por palabra de
+// 64 bits), así que las claves se pueden borrar. Los índices se derivan
+// igual que en BloomDB (MurmurHash3, h1 + i*h2, MASK o FASTRANGE según el
+// tamaño), por eso bloomdb_counting_to_bloomdb da un filtro de bits que
+// responde exactamente igual.
+//
+// Los contadores saturan en 15 y a partir de ahí no se decrementan nunca
+// (borrar podría dar falsos negativos). Con k óptimo la probabilidad de
+// llegar a 15 es despreciable (< 1e-14 por contador).
+//
+// Costo: 4 veces la memoria de un BloomDB con el mismo FPR.
+// ============================================================================
+
+#define BLOOMDB_COUNTER_MAX 15
+
+typedef struct {
+    uint64_t* words;       //contadores empaquetados, 16 por palabra (el i en los bits 4*(i%16))
+    size_t word_count;     //(counter_count + 15) / 16
+    size_t counter_count;  //número de contadores (m)
+    int num_hashes;        //cantidad de hashes k
+    uint64_t seed;         //semilla del hash
+    int index_mode;        //BloomDBIndexMode, mismo criterio que bloomdb_create_ex
+} BloomDBCounting;
+
+// ============================================================================
+// Simple API (returns NULL/false on error)
+// ============================================================================
+
+BloomDBCounting* bloomdb_counting_create(size_t counters, int num_hashes, uint64_t seed);
+void bloomdb_counting_free(BloomDBCounting* cf);
+bool bloomdb_counting_insert(BloomDBCounting* cf, const void* key, size_t len);
+bool bloomdb_counting_remove(BloomDBCounting* cf, const void* key, size_t len);
+bool bloomdb_counting_might_contain(const BloomDBCounting* cf, const void* key, size_t len);
+
+// Filtro de bits equivalente (bit i = contador i > 0), para servir en solo
+// lectura con la API de BloomDB. Mismo tamaño, k, seed y modo de índice.
+BloomDB* bloomdb_counting_to_bloomdb(const BloomDBCounting* cf);
+
+// ============================================================================
+// Extended API (explicit error handling)
+// ============================================================================
+
+BloomDBError bloomdb_counting_create_ex(size_t counters, int num_hashes, uint64_t seed, BloomDBCounting** out_cf);
+BloomDBError bloomdb_counting_insert_ex(BloomDBCounting* cf, const void* key, size_t len);
+
+// Si la clave no está (algún contador a 0) devuelve INVALID_ARGUMENT sin
+// tocar nada: borrar una clave nunca insertada rompería las demás.
+BloomDBError bloomdb_counting_remove_ex(BloomDBCounting* cf, const void* key, size_t len);
+BloomDBError bloomdb_counting_might_contain_ex(const BloomDBCounting* cf, const void* key, size_t len, bool* out_result);
+BloomDBError bloomdb_counting_to_bloomdb_ex(const BloomDBCounting* cf, BloomDB** out_db);
+
+#endif
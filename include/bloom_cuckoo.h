@@ -0,0 +1,74 @@
+#ifndef BLOOM_CUCKOO_H
+#define BLOOM_CUCKOO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "bloomdb.h"
+
+// ============================================================================
+// Cuckoo filter (Fan et al.)
+//
+// Tabla de cubetas de 4 huellas de 16 bits: cada cubeta es exactamente un
+// uint64_t, así que una consulta lee dos palabras (dos líneas de caché como
+// mucho) y compara las 4 huellas de cada una con SWAR, sin bucles.
+//
+// Cada clave tiene dos cubetas posibles, i1 = h1 & mask e
+// i2 = i1 ^ mix(huella), y la segunda se calcula desde cualquiera de las dos
+// con solo la huella: así se puede reubicar una huella (cuckoo kick) y
+// borrar sin conocer la clave original.
+//
+// FPR ~ 8 / 2^16 (~0.012%) a ocupación máxima, con 16 / ocupación bits por
+// clave (~17 al 95%). Un BloomDB necesita ~19 bits por clave para ese FPR.
+// ============================================================================
+
+#define BLOOMDB_CUCKOO_SLOTS      4      // huellas por cubeta
+#define BLOOMDB_CUCKOO_MAX_KICKS  500    // reubicaciones antes de declararse lleno
+#define BLOOMDB_CUCKOO_LOAD       0.95   // ocupación objetivo al dimensionar
+
+typedef struct {
+    uint64_t* buckets;       //bucket_count cubetas de 4 huellas de 16 bits (0 = vacío)
+    size_t bucket_count;     //potencia de 2
+    size_t count;            //huellas guardadas (incluida la víctima)
+    uint64_t seed;           //semilla del hash
+    uint64_t rng;            //estado xorshift para elegir qué huella expulsar
+    size_t victim_index;     //cubeta de la víctima (si has_victim)
+    uint16_t victim_fp;      //huella que no cupo tras MAX_KICKS reubicaciones
+    bool has_victim;
+} BloomDBCuckoo;
+
+// ============================================================================
+// Simple API (returns NULL/false on error)
+// ============================================================================
+
+// Cubetas para capacity claves al 95% de ocupación, redondeadas a potencia de 2
+BloomDBCuckoo* bloomdb_cuckoo_create(size_t capacity, uint64_t seed);
+void bloomdb_cuckoo_free(BloomDBCuckoo* cf);
+bool bloomdb_cuckoo_insert(BloomDBCuckoo* cf, const void* key, size_t len);
+bool bloomdb_cuckoo_remove(BloomDBCuckoo* cf, const void* key, size_t len);
+bool bloomdb_cuckoo_might_contain(const BloomDBCuckoo* cf, const void* key, size_t len);
+
+// Resultado: bit i de out_bitmap (LSB primero) = clave i
+bool bloomdb_cuckoo_might_contain_batch(const BloomDBCuckoo* cf, const void* const* keys, const size_t* lens,
+                                        size_t n, uint8_t* out_bitmap);
+
+// count / (4 * bucket_count)
+double bloomdb_cuckoo_load_factor(const BloomDBCuckoo* cf);
+
+// ============================================================================
+// Extended API (explicit error handling)
+// ============================================================================
+
+BloomDBError bloomdb_cuckoo_create_ex(size_t capacity, uint64_t seed, BloomDBCuckoo** out_cf);
+
+// BLOOMDB_ERR_FULL si la tabla está llena: la clave no se inserta
+BloomDBError bloomdb_cuckoo_insert_ex(BloomDBCuckoo* cf, const void* key, size_t len);
+
+// BLOOMDB_ERR_INVALID_ARGUMENT si la huella no está en ninguna de sus cubetas
+BloomDBError bloomdb_cuckoo_remove_ex(BloomDBCuckoo* cf, const void* key, size_t len);
+BloomDBError bloomdb_cuckoo_might_contain_ex(const BloomDBCuckoo* cf, const void* key, size_t len, bool* out_result);
+BloomDBError bloomdb_cuckoo_might_contain_batch_ex(const BloomDBCuckoo* cf, const void* const* keys,
+                                                   const size_t* lens, size_t n, uint8_t* out_bitmap);
+
+#endif
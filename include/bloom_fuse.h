@@ -0,0 +1,63 @@
+#ifndef BLOOM_FUSE_H
+#define BLOOM_FUSE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "bloomdb.h"
+
+// ============================================================================
+// Binary fuse filter (Graf & Lemire, 8 bits por huella)
+//
+// Filtro inmutable: se construye de una vez a partir de todas las claves y
+// después solo se consulta. Cada clave tiene tres posiciones en tres
+// segmentos consecutivos del arreglo, y la construcción (peeling de un
+// hipergrafo de 3 vértices) elige los bytes de forma que el XOR de las tres
+// sea la huella de la clave.
+//
+// Una consulta = un hash64 + exactamente 3 lecturas de un byte, sin ramas.
+// FPR = 1/256 (~0.39%) con ~9 bits por clave (factor 1.125 en conjuntos
+// grandes); un BloomDB necesita ~11.5 bits por clave para el mismo FPR.
+//
+// No admite inserciones: para añadir claves hay que reconstruirlo.
+// ============================================================================
+
+#define BLOOMDB_FUSE_MAX_KEYS ((size_t)1 << 31)
+
+typedef struct {
+    uint8_t* fingerprints;          //array_length huellas de 8 bits
+    uint32_t array_length;          //(segment_count + 2) * segment_length
+    uint32_t segment_length;        //potencia de 2
+    uint32_t segment_length_mask;   //segment_length - 1
+    uint32_t segment_count;         //segmentos donde puede empezar una clave
+    uint32_t segment_count_length;  //segment_count * segment_length
+    uint64_t seed;                  //semilla de hash64 (clave -> 64 bits)
+    uint64_t fuse_seed;             //semilla con la que la construcción tuvo éxito
+    size_t key_count;               //claves distintas del conjunto
+} BloomDBFuse;
+
+// ============================================================================
+// Simple API (returns NULL/false on error)
+// ============================================================================
+
+// keys[i] con lens[i] > 0 bytes; las claves repetidas se admiten
+BloomDBFuse* bloomdb_fuse_build(const void* const* keys, const size_t* lens, size_t n, uint64_t seed);
+void bloomdb_fuse_free(BloomDBFuse* ff);
+bool bloomdb_fuse_might_contain(const BloomDBFuse* ff, const void* key, size_t len);
+
+// Bytes de huellas (sin contar la cabecera)
+size_t bloomdb_fuse_size_bytes(const BloomDBFuse* ff);
+
+// ============================================================================
+// Extended API (explicit error handling)
+// ============================================================================
+
+// BLOOMDB_ERR_INVALID_ARGUMENT si n > BLOOMDB_FUSE_MAX_KEYS;
+// BLOOMDB_ERR_INTERNAL si ninguna semilla construye el filtro (probabilidad
+// despreciable)
+BloomDBError bloomdb_fuse_build_ex(const void* const* keys, const size_t* lens, size_t n, uint64_t seed,
+                                   BloomDBFuse** out_ff);
+BloomDBError bloomdb_fuse_might_contain_ex(const BloomDBFuse* ff, const void* key, size_t len, bool* out_result);
+
+#endif
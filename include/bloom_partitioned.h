@@ -0,0 +1,53 @@
+#ifndef BLOOM_PARTITIONED_H
+#define BLOOM_PARTITIONED_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "bloomdb.h"
+
+// ============================================================================
+// Partitioned Bloom filter
+//
+// El arreglo se divide en k particiones iguales y la sonda i pone un bit en
+// la partición i. Cada partición mide una potencia de 2, así que el índice
+// es un AND (sin división ni multiplicación), y las k sondas son
+// independientes: sus cargas salen a la vez.
+//
+// Ninguna clave pone dos veces el mismo bit, así que el FPR es más
+// predecible que en BloomDB: (1 - e^(-n/s))^k con s bits por partición.
+//
+// Costo: el tamaño pedido se redondea hacia arriba a k * 2^j bits (hasta el
+// doble si bits/k no es potencia de 2). Para no desperdiciar memoria, elegir
+// bits = k * 2^j.
+// ============================================================================
+
+#define BLOOMDB_PARTITIONED_MAX_HASHES 32
+
+typedef struct {
+    uint64_t* words;       //num_hashes particiones contiguas de slice_bits bits
+    size_t slice_bits;     //bits por partición (potencia de 2, >= 64)
+    size_t bit_count;      //num_hashes * slice_bits
+    int num_hashes;        //k = número de particiones (1..32)
+    uint64_t seed;         //semilla del hash
+} BloomDBPartitioned;
+
+// ============================================================================
+// Simple API (returns NULL/false on error)
+// ============================================================================
+
+BloomDBPartitioned* bloomdb_partitioned_create(size_t bits, int num_hashes, uint64_t seed);
+void bloomdb_partitioned_free(BloomDBPartitioned* pf);
+bool bloomdb_partitioned_insert(BloomDBPartitioned* pf, const void* key, size_t len);
+bool bloomdb_partitioned_might_contain(const BloomDBPartitioned* pf, const void* key, size_t len);
+
+// ============================================================================
+// Extended API (explicit error handling)
+// ============================================================================
+
+BloomDBError bloomdb_partitioned_create_ex(size_t bits, int num_hashes, uint64_t seed, BloomDBPartitioned** out_pf);
+BloomDBError bloomdb_partitioned_insert_ex(BloomDBPartitioned* pf, const void* key, size_t len);
+BloomDBError bloomdb_partitioned_might_contain_ex(const BloomDBPartitioned* pf, const void* key, size_t len, bool* out_result);
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef BLOOM_RANGE_H
+#define BLOOM_RANGE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "bloomdb.h"
+
+// ============================================================================
+// Range Bloom filter (prefijos diádicos sobre claves uint64_t)
+//
+// Cada clave x se inserta en L niveles: en el nivel l va el prefijo x >> l,
+// que representa el intervalo diádico [p * 2^l, (p + 1) * 2^l). Todos los
+// niveles comparten un BloomDB (la entrada es el par (prefijo, nivel)).
+//
+// might_contain_range(lo, hi) descompone [lo, hi] en O(log(hi - lo))
+// intervalos diádicos y consulta su prefijo. Si uno da positivo se baja por
+// sus hijos hasta el nivel 0 antes de creerlo (una clave real tiene
+// presentes todos sus prefijos), así que un falso positivo necesita fallar
+// en todos los niveles del camino y el FPR de un rango queda cerca del de
+// una consulta puntual.
+//
+// Sin falsos negativos. Los intervalos por encima del nivel L - 1 se parten
+// en intervalos del nivel L - 1; si eso (o el descenso) supera
+// BLOOMDB_RANGE_MAX_PROBES sondas, la respuesta es true sin más comprobación.
+// ============================================================================
+
+#define BLOOMDB_RANGE_MAX_LEVELS 64
+#define BLOOMDB_RANGE_MAX_PROBES 512   // sondas por consulta antes de responder true
+
+typedef struct {
+    BloomDB* db;          //todos los prefijos (prefijo, nivel)
+    int levels;           //L: niveles 0..L-1; rangos de hasta ~2^L se resuelven con pocas sondas
+    uint64_t count;       //claves insertadas
+} BloomDBRange;
+
+// ============================================================================
+// Simple API (returns NULL/false on error)
+// ============================================================================
+
+// bits y num_hashes del BloomDB compartido; cada clave ocupa levels entradas
+BloomDBRange* bloomdb_range_create(size_t bits, int num_hashes, int levels, uint64_t seed);
+void bloomdb_range_free(BloomDBRange* rf);
+bool bloomdb_range_insert(BloomDBRange* rf, uint64_t key);
+bool bloomdb_range_might_contain(const BloomDBRange* rf, uint64_t key);
+
+// ¿Puede haber alguna clave en [lo, hi] (ambos incluidos)?
+bool bloomdb_range_might_contain_range(const BloomDBRange* rf, uint64_t lo, uint64_t hi);
+
+// ============================================================================
+// Extended API (explicit error handling)
+// ============================================================================
+
+BloomDBError bloomdb_range_create_ex(size_t bits, int num_hashes, int levels, uint64_t seed, BloomDBRange** out_rf);
+BloomDBError bloomdb_range_insert_ex(BloomDBRange* rf, uint64_t key);
+BloomDBError bloomdb_range_might_contain_ex(const BloomDBRange* rf, uint64_t key, bool* out_result);
+
+// BLOOMDB_ERR_INVALID_ARGUMENT si lo > hi
+BloomDBError bloomdb_range_might_contain_range_ex(const BloomDBRange* rf, uint64_t lo, uint64_t hi, bool* out_result);
+
+#endif
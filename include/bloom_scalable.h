@@ -0,0 +1,62 @@
+#ifndef BLOOM_SCALABLE_H
+#define BLOOM_SCALABLE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "bloomdb.h"
+
+// ============================================================================
+// Scalable Bloom filter (Almeida et al.)
+//
+// Cadena de BloomDB ("slices") que crece sin reconstruir: la slice i tiene
+// capacidad initial_capacity * 2^i y error fpr * (1 - r) * r^i, así que el
+// FPR compuesto (la suma) queda por debajo de fpr para cualquier número de
+// slices. Solo se inserta en la última; cuando su ocupación real (bits a 1,
+// medida con popcount) llega al 50% se añade la siguiente.
+//
+// Todas las slices comparten seed: cada operación hashea la clave una vez y
+// consulta las slices con el digest, de la más nueva a la más antigua.
+// ============================================================================
+
+#define BLOOMDB_SCALABLE_MAX_SLICES 48
+#define BLOOMDB_SCALABLE_GROWTH     2      // capacidad de cada slice respecto a la anterior
+#define BLOOMDB_SCALABLE_TIGHTENING 0.85   // r: error de cada slice respecto a la anterior
+#define BLOOMDB_SCALABLE_FILL       0.5    // ocupación a la que se añade una slice
+
+typedef struct {
+    BloomDB* slices[BLOOMDB_SCALABLE_MAX_SLICES];  //slices[0] es la más antigua
+    size_t slice_count;       //slices en uso (>= 1)
+    size_t initial_capacity;  //claves previstas para la slice 0
+    double fpr;               //cota del FPR compuesto
+    uint64_t seed;            //semilla común de todas las slices
+    uint64_t inserted;        //inserciones en la slice activa
+    uint64_t next_check;      //al llegar a este número se mide la ocupación
+} BloomDBScalable;
+
+// ============================================================================
+// Simple API (returns NULL/false on error)
+// ============================================================================
+
+// fpr en (0, 1): cota del FPR de toda la cadena
+BloomDBScalable* bloomdb_scalable_create(size_t initial_capacity, double fpr, uint64_t seed);
+void bloomdb_scalable_free(BloomDBScalable* sf);
+bool bloomdb_scalable_insert(BloomDBScalable* sf, const void* key, size_t len);
+bool bloomdb_scalable_might_contain(const BloomDBScalable* sf, const void* key, size_t len);
+
+// Suma de los errores de las slices actuales (siempre < fpr)
+double bloomdb_scalable_fpr_bound(const BloomDBScalable* sf);
+
+// ============================================================================
+// Extended API (explicit error handling)
+// ============================================================================
+
+BloomDBError bloomdb_scalable_create_ex(size_t initial_capacity, double fpr, uint64_t seed, BloomDBScalable** out_sf);
+
+// BLOOMDB_ERR_ALLOC si hace falta una slice nueva y no se puede reservar
+// (o ya hay BLOOMDB_SCALABLE_MAX_SLICES); la clave no se inserta.
+BloomDBError bloomdb_scalable_insert_ex(BloomDBScalable* sf, const void* key, size_t len);
+BloomDBError bloomdb_scalable_might_contain_ex(const BloomDBScalable* sf, const void* key, size_t len, bool* out_result);
+
+#endif
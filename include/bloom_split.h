@@ -0,0 +1,53 @@
+#ifndef BLOOM_SPLIT_H
+#define BLOOM_SPLIT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "bloomdb.h"
+
+// ============================================================================
+// Split-block Bloom filter
+//
+// Bloques de 256 bits vistos como ocho palabras de 32 bits. Cada clave elige
+// un bloque y pone exactamente un bit en cada palabra; la posición de cada
+// bit sale de multiplicar 32 bits del hash por una "sal" distinta por
+// palabra. Con AVX2 insertar y consultar son un puñado de instrucciones sin
+// ramas (vpmulld + vpsrld + vpsllvd + vpor/vptest); el camino escalar da
+// exactamente los mismos bits.
+//
+// k es fijo (8). A igual memoria el FPR es mayor que el del filtro bloqueado
+// de 512 bits; a cambio la consulta es la más barata de todas las variantes.
+// ============================================================================
+
+#define BLOOMDB_SPLIT_BLOCK_BITS  256
+#define BLOOMDB_SPLIT_BLOCK_WORDS 8
+
+typedef struct {
+    uint32_t* blocks;      //block_count * 8 palabras, alineado a 32 bytes
+    size_t block_count;    //número de bloques de 256 bits
+    size_t bit_count;      //block_count * 256
+    uint64_t seed;         //semilla del hash
+    void* alloc;           //puntero original de la reserva (interno)
+} BloomDBSplit;
+
+// ============================================================================
+// Simple API (returns NULL/false on error)
+// ============================================================================
+
+// bits se redondea hacia arriba a un múltiplo de 256
+BloomDBSplit* bloomdb_split_create(size_t bits, uint64_t seed);
+void bloomdb_split_free(BloomDBSplit* sf);
+bool bloomdb_split_insert(BloomDBSplit* sf, const void* key, size_t len);
+bool bloomdb_split_might_contain(const BloomDBSplit* sf, const void* key, size_t len);
+
+// ============================================================================
+// Extended API (explicit error handling)
+// ============================================================================
+
+BloomDBError bloomdb_split_create_ex(size_t bits, uint64_t seed, BloomDBSplit** out_sf);
+BloomDBError bloomdb_split_insert_ex(BloomDBSplit* sf, const void* key, size_t len);
+BloomDBError bloomdb_split_might_contain_ex(const BloomDBSplit* sf, const void* key, size_t len, bool* out_result);
+
+#endif
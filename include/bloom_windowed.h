@@ -0,0 +1,72 @@
+#ifndef BLOOM_WINDOWED_H
+#define BLOOM_WINDOWED_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "bloomdb.h"
+
+// ============================================================================
+// Windowed Bloom filter (ventana deslizante por generaciones)
+//
+// G generaciones (1..8) del mismo tamaño, k y seed. Las inserciones van a la
+// generación actual; rotate() avanza a la siguiente y la vacía, así que el
+// filtro recuerda las claves de las últimas G rotaciones con memoria y FPR
+// constantes sobre un flujo sin fin.
+//
+// Las generaciones están entrelazadas: cada posición guarda un carril de W
+// bits (W = G redondeado a 1, 2, 4 u 8) con un bit por generación. Una
+// consulta hashea una vez y lee k carriles; la clave está si el AND de los
+// k carriles tiene algún bit a 1 (todas sus sondas en una misma
+// generación). Cuesta lo mismo que una consulta a un BloomDB, no G veces.
+//
+// rotate() borra el bit de la generación más antigua en todos los carriles
+// con un AND por máscara vectorizado (kernel bitarray_and_mask): un pase
+// secuencial sobre byte_count bytes, sin tocar las demás generaciones.
+// ============================================================================
+
+#define BLOOMDB_WINDOWED_MAX_GENERATIONS 8
+
+typedef struct {
+    uint8_t* lanes;          //positions carriles de lane_bits bits (el de p en los bits p*W..p*W+W-1)
+    size_t positions;        //bits de cada generación (m)
+    size_t byte_count;       //(positions * lane_bits + 7) / 8
+    int lane_bits;           //W: 1, 2, 4 u 8 (>= generations)
+    int generations;         //G: generaciones de la ventana (1..8)
+    int current;             //generación que recibe las inserciones (0..G-1)
+    int num_hashes;          //cantidad de hashes k
+    uint64_t seed;           //semilla del hash
+    int index_mode;          //BloomDBIndexMode, mismo criterio que bloomdb_create_ex
+    uint64_t rotations;      //rotaciones desde la creación
+} BloomDBWindowed;
+
+// ============================================================================
+// Simple API (returns NULL/false on error)
+// ============================================================================
+
+// bits y num_hashes de cada generación (como bloomdb_create)
+BloomDBWindowed* bloomdb_windowed_create(size_t bits, int num_hashes, int generations, uint64_t seed);
+void bloomdb_windowed_free(BloomDBWindowed* wf);
+bool bloomdb_windowed_insert(BloomDBWindowed* wf, const void* key, size_t len);
+bool bloomdb_windowed_might_contain(const BloomDBWindowed* wf, const void* key, size_t len);
+
+// Deduplicación con un solo hash: devuelve si la clave ya estaba en la
+// ventana y la inserta en la generación actual (false también si hay error)
+bool bloomdb_windowed_test_and_insert(BloomDBWindowed* wf, const void* key, size_t len);
+
+// Vacía la generación más antigua y la convierte en la actual
+bool bloomdb_windowed_rotate(BloomDBWindowed* wf);
+
+// ============================================================================
+// Extended API (explicit error handling)
+// ============================================================================
+
+BloomDBError bloomdb_windowed_create_ex(size_t bits, int num_hashes, int generations, uint64_t seed,
+                                        BloomDBWindowed** out_wf);
+BloomDBError bloomdb_windowed_insert_ex(BloomDBWindowed* wf, const void* key, size_t len);
+BloomDBError bloomdb_windowed_might_contain_ex(const BloomDBWindowed* wf, const void* key, size_t len, bool* out_result);
+BloomDBError bloomdb_windowed_test_and_insert_ex(BloomDBWindowed* wf, const void* key, size_t len, bool* out_seen);
+BloomDBError bloomdb_windowed_rotate_ex(BloomDBWindowed* wf);
+
+#endif
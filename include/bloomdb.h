@@ -16,21 +16,79 @@ typedef enum {
     BLOOMDB_ERR_ALLOC,
     BLOOMDB_ERR_FILE_IO,
     BLOOMDB_ERR_FORMAT,
-    BLOOMDB_ERR_INTERNAL
+    BLOOMDB_ERR_INTERNAL,
+    BLOOMDB_ERR_FULL,
+    BLOOMDB_ERR_READ_ONLY,
+    BLOOMDB_ERR_CHECKSUM
 } BloomDBError;
 
 const char* bloomdb_strerror(BloomDBError err);
 
+// ============================================================================
+// CPU dispatch
+// ============================================================================
+
+// Conjunto de instrucciones de los kernels calientes (hash multi-clave,
+// sondas split-block, popcount, merge, AND con máscara). Al cargar la
+// librería se elige el mejor que soporta la CPU; todas las ISAs dan
+// resultados idénticos.
+typedef enum {
+    BLOOMDB_ISA_SCALAR = 0,   // C portable
+    BLOOMDB_ISA_SSE42 = 1,    // SSE4.2 + POPCNT
+    BLOOMDB_ISA_AVX2 = 2,
+    BLOOMDB_ISA_AVX512 = 3    // AVX-512 F/DQ/BW/VL (VPOPCNTDQ si existe)
+} BloomDBIsa;
+
+BloomDBIsa bloomdb_cpu_isa(void);            // la mejor soportada por esta CPU
+BloomDBIsa bloomdb_get_isa(void);            // la que está en uso
+BloomDBError bloomdb_set_isa(BloomDBIsa isa); // INVALID_ARGUMENT si la CPU no la soporta
+const char* bloomdb_isa_name(BloomDBIsa isa);
+
+// ============================================================================
+// Hash Algorithms
+// ============================================================================
+
+// Algoritmo con el que se derivan los índices. Se guarda en el archivo para
+// que un filtro cargado responda igual que cuando se construyó.
+typedef enum {
+    BLOOMDB_HASH_LEGACY = 0,   // hash byte a byte original (archivos antiguos)
+    BLOOMDB_HASH_MURMUR3 = 1   // MurmurHash3 x64_128, un digest por operación
+} BloomDBHashAlgo;
+
+// Cómo se reduce un hash de 64 bits a un índice en [0, bit_count).
+// bloomdb_create_ex elige automáticamente; se guarda en el archivo.
+typedef enum {
+    BLOOMDB_INDEX_MODULO = 0,     // h % bit_count (archivos antiguos)
+    BLOOMDB_INDEX_FASTRANGE = 1,  // (h * bit_count) >> 64 (Lemire), sin división
+    BLOOMDB_INDEX_MASK = 2        // h & (bit_count - 1), bit_count potencia de 2
+} BloomDBIndexMode;
+
 // ============================================================================
 // Core Data Structure
 // ============================================================================
 
-typedef struct {
+typedef struct BloomDB {
     uint8_t* bitarray;   //arreglo de bits comprimido
     size_t bit_count;    //número de bits totales
     size_t byte_count;   //número de bytes usados
     int num_hashes;      //cantidad de hashes k
     uint64_t seed;       //semilla del hash
+    int hash_algo;       //BloomDBHashAlgo usado para derivar los índices
+    int index_mode;      //BloomDBIndexMode: reducción de hash a índice
+    int concurrent;      //1 = inserciones/consultas con atómicos (bloomdb_set_concurrent)
+    int read_only;       //1 = abierto con bloomdb_open_mmap sin BLOOMDB_MMAP_WRITABLE
+    void* mapping;       //archivo mapeado (bloomdb_open_mmap) o NULL si bitarray es del heap
+    size_t mapping_size; //bytes mapeados
+    uint8_t* chunk_crcs; //formato v2 mapeado: CRC32C por chunk (uint32 little-endian) o NULL
+    int chunk_shift;     //log2 de los bytes de bitarray que cubre cada CRC de chunk_crcs
+    uint64_t* dirty;     //bitmap de páginas modificadas (bloomdb_track_dirty) o NULL
+    uint64_t* base_lag;  //páginas que aún no llegaron al archivo base (llamadas solo con delta) o NULL
+    uint64_t* delta_lag; //páginas que aún no llegaron a un delta (llamadas solo con base) o NULL
+
+    // Kernels de sondas especializados para num_hashes (internos; los elige
+    // bloomdb_create_ex una sola vez)
+    void (*probe_insert)(struct BloomDB* db, uint64_t h1, uint64_t h2);
+    bool (*probe_query)(const struct BloomDB* db, uint64_t h1, uint64_t h2);
 } BloomDB;
 
 // ============================================================================
@@ -50,6 +108,111 @@ BloomDBError bloomdb_create_ex(size_t bits, int num_hashes, uint64_t seed, Bloom
 BloomDBError bloomdb_insert_ex(BloomDB* db, const void* key, size_t len);
 BloomDBError bloomdb_might_contain_ex(const BloomDB* db, const void* key, size_t len, bool* out_result);
 
+// ============================================================================
+// Concurrency (lock-free inserts and queries)
+// ============================================================================
+
+// En modo concurrente varios hilos pueden llamar a insert/might_contain (y a
+// sus variantes digest, batch y u64/u128) sobre el mismo filtro sin locks:
+// los bits se ponen con fetch-or atómico sobre palabras de 64 bits y se leen
+// con cargas atómicas relaxed.
+//
+// Garantías:
+// - Ningún bit se pierde: una inserción terminada nunca se deshace.
+// - Si la inserción de una clave "happens-before" una consulta (join, mutex,
+//   o una bandera publicada con release/acquire), la consulta da true.
+// - Una consulta simultánea a la inserción de la misma clave puede dar
+//   cualquiera de los dos resultados.
+// El modo se cambia antes de compartir el filtro. merge, save y free
+// requieren que ningún otro hilo esté usando el filtro.
+bool bloomdb_set_concurrent(BloomDB* db, bool enabled);
+BloomDBError bloomdb_set_concurrent_ex(BloomDB* db, bool enabled);
+
+// ============================================================================
+// Whole-filter operations
+// ============================================================================
+
+// Bits a 1 del filtro (ocupación = count / bit_count)
+size_t bloomdb_count_set_bits(const BloomDB* db);
+
+// Unión: dst |= src. Ambos filtros deben tener el mismo tamaño, k, seed,
+// algoritmo de hash y modo de índice; si no, INVALID_ARGUMENT y dst intacto.
+bool bloomdb_merge(BloomDB* dst, const BloomDB* src);
+BloomDBError bloomdb_merge_ex(BloomDB* dst, const BloomDB* src);
+
+// ============================================================================
+// Dirty tracking (incremental save)
+// ============================================================================
+
+// Con el seguimiento activo, cada inserción marca en un bitmap aparte la
+// página (BLOOMDB_DIRTY_PAGE_SIZE bytes del bitarray) de cada bit que pone;
+// merge marca las páginas donde src tiene algún bit. Las consultas no
+// cambian y sin seguimiento las inserciones tampoco: solo se eligen otros
+// kernels de inserción. bloomdb_save_incremental (storage.h) escribe las
+// páginas marcadas y limpia el bitmap.
+//
+// Al activarlo el bitmap empieza limpio: se activa justo después de cargar
+// o guardar el archivo base. Igual que set_concurrent, antes de compartir
+// el filtro entre hilos.
+#define BLOOMDB_DIRTY_PAGE_SHIFT 12
+#define BLOOMDB_DIRTY_PAGE_SIZE  ((size_t)1 << BLOOMDB_DIRTY_PAGE_SHIFT)
+
+bool bloomdb_track_dirty(BloomDB* db, bool enabled);
+BloomDBError bloomdb_track_dirty_ex(BloomDB* db, bool enabled);
+
+// Páginas del bitarray (la última puede ser más corta) y cuántas están
+// marcadas (0 sin seguimiento)
+size_t bloomdb_page_count(const BloomDB* db);
+size_t bloomdb_dirty_pages(const BloomDB* db);
+
+// ============================================================================
+// Pre-hashed keys (hash once, probe many filters)
+// ============================================================================
+
+// Digest de una clave: basta para derivar los k índices en cualquier filtro
+// BLOOMDB_HASH_MURMUR3 creado con la misma seed.
+typedef struct {
+    uint64_t h1;
+    uint64_t h2;
+    uint64_t seed;   //seed con la que se calculó (se valida al usarlo)
+} BloomDBDigest;
+
+BloomDBDigest bloomdb_hash(uint64_t seed, const void* key, size_t len);
+
+bool bloomdb_insert_digest(BloomDB* db, const BloomDBDigest* digest);
+bool bloomdb_might_contain_digest(const BloomDB* db, const BloomDBDigest* digest);
+
+BloomDBError bloomdb_insert_digest_ex(BloomDB* db, const BloomDBDigest* digest);
+BloomDBError bloomdb_might_contain_digest_ex(const BloomDB* db, const BloomDBDigest* digest, bool* out_result);
+
+// ============================================================================
+// Batch API (group prefetching: overlaps the cache misses of many keys)
+// ============================================================================
+
+// Resultado de might_contain_batch: bit i de out_bitmap (LSB primero) = clave i.
+// out_bitmap debe tener al menos (n + 7) / 8 bytes. El lote se valida entero
+// antes de insertar nada.
+bool bloomdb_insert_batch(BloomDB* db, const void* const* keys, const size_t* lens, size_t n);
+bool bloomdb_might_contain_batch(const BloomDB* db, const void* const* keys, const size_t* lens,
+                                 size_t n, uint8_t* out_bitmap);
+
+BloomDBError bloomdb_insert_batch_ex(BloomDB* db, const void* const* keys, const size_t* lens, size_t n);
+BloomDBError bloomdb_might_contain_batch_ex(const BloomDB* db, const void* const* keys, const size_t* lens,
+                                            size_t n, uint8_t* out_bitmap);
+
+// ============================================================================
+// Parallel build
+// ============================================================================
+
+// Inserta las n claves repartidas entre threads hilos (threads <= 0: uno por
+// CPU en línea). El bitarray resultante es idéntico bit a bit al de
+// insertarlas en serie. Valida el lote entero antes de insertar nada.
+// Ningún otro hilo debe usar db durante la llamada.
+bool bloomdb_build_parallel(BloomDB* db, const void* const* keys, const size_t* lens,
+                            size_t n, int threads);
+BloomDBError bloomdb_build_parallel_ex(BloomDB* db, const void* const* keys, const size_t* lens,
+                                       size_t n, int threads);
+
 // ============================================================================
 // Helper Functions (C strings)
 // ============================================================================
@@ -75,24 +238,30 @@ static inline BloomDBError bloomdb_might_contain_cstr_ex(const BloomDB* db, cons
 }
 
 // ============================================================================
-// Helper Functions (uint64_t)
+// Integer keys (uint64_t / 128-bit)
 // ============================================================================
 
-static inline bool bloomdb_insert_u64(BloomDB* db, uint64_t value) {
-    return bloomdb_insert(db, &value, sizeof(value));
-}
+// Kernels dedicados: el entero se mezcla en registros, sin bucle de bytes.
+// Ponen exactamente los mismos bits que bloomdb_insert(db, &value, 8) (y
+// {lo, hi} como 16 bytes), así que mezclar ambas APIs en un filtro es seguro.
 
-static inline bool bloomdb_might_contain_u64(const BloomDB* db, uint64_t value) {
-    return bloomdb_might_contain(db, &value, sizeof(value));
-}
+bool bloomdb_insert_u64(BloomDB* db, uint64_t value);
+bool bloomdb_might_contain_u64(const BloomDB* db, uint64_t value);
+bool bloomdb_insert_u128(BloomDB* db, uint64_t lo, uint64_t hi);
+bool bloomdb_might_contain_u128(const BloomDB* db, uint64_t lo, uint64_t hi);
 
-static inline BloomDBError bloomdb_insert_u64_ex(BloomDB* db, uint64_t value) {
-    return bloomdb_insert_ex(db, &value, sizeof(value));
-}
+BloomDBError bloomdb_insert_u64_ex(BloomDB* db, uint64_t value);
+BloomDBError bloomdb_might_contain_u64_ex(const BloomDB* db, uint64_t value, bool* out_result);
+BloomDBError bloomdb_insert_u128_ex(BloomDB* db, uint64_t lo, uint64_t hi);
+BloomDBError bloomdb_might_contain_u128_ex(const BloomDB* db, uint64_t lo, uint64_t hi, bool* out_result);
 
-static inline BloomDBError bloomdb_might_contain_u64_ex(const BloomDB* db, uint64_t value, bool* out_result) {
-    return bloomdb_might_contain_ex(db, &value, sizeof(value), out_result);
-}
+// Lotes de enteros con group prefetching (out_bitmap como en la Batch API)
+bool bloomdb_insert_u64_batch(BloomDB* db, const uint64_t* values, size_t n);
+bool bloomdb_might_contain_u64_batch(const BloomDB* db, const uint64_t* values, size_t n, uint8_t* out_bitmap);
+
+BloomDBError bloomdb_insert_u64_batch_ex(BloomDB* db, const uint64_t* values, size_t n);
+BloomDBError bloomdb_might_contain_u64_batch_ex(const BloomDB* db, const uint64_t* values, size_t n,
+                                                uint8_t* out_bitmap);
 
 #endif
 
@@ -0,0 +1,16 @@
+#ifndef CRC32C_H
+#define CRC32C_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// CRC32C (Castagnoli, polinomio 0x1EDC6F41): el de iSCSI, ext4 y la
+// instrucción crc32 de SSE4.2, que se usa si la CPU la tiene.
+//
+// crc es el resultado de una llamada anterior (0 al empezar), así que los
+// datos se pueden procesar por trozos:
+//   crc32c(crc32c(0, a, n), b, m) == crc32c(0, a || b, n + m)
+//   crc32c(0, "123456789", 9) == 0xE3069283
+uint32_t crc32c(uint32_t crc, const void* data, size_t len);
+
+#endif
@@ -4,6 +4,42 @@
 #include <stddef.h>
 #include <stdint.h>
 
+// Digest de 128 bits: dos mitades independientes de 64 bits.
+typedef struct {
+    uint64_t h1;
+    uint64_t h2;
+} hash128_t;
+
+// MurmurHash3 x64_128 (consume 16 bytes por paso, lecturas little-endian).
+hash128_t hash128(const void* key, size_t len, uint64_t seed);
+
+// Mitad baja de hash128(): hash64(k, n, s) == hash128(k, n, s).h1
 uint64_t hash64(const void* key, size_t len, uint64_t seed);
 
+// Claves enteras sin pasar por el bucle de bytes. Idénticas a hashear la
+// representación en memoria: hash128_u64(v, s) == hash128(&v, 8, s) y
+// hash128_u128(lo, hi, s) == hash128({lo, hi}, 16, s).
+hash128_t hash128_u64(uint64_t value, uint64_t seed);
+hash128_t hash128_u128(uint64_t lo, uint64_t hi, uint64_t seed);
+
+// ----------------------------------------------------------------------------
+// Multi-key: hashea varias claves por llamada (AVX2 si la CPU lo soporta).
+// Para cada i: out[i] == hash128(keys[i], lens[i], seed), bit a bit.
+// ----------------------------------------------------------------------------
+
+void hash128_x4(const void* const keys[4], const size_t lens[4], uint64_t seed, hash128_t out[4]);
+void hash128_x8(const void* const keys[8], const size_t lens[8], uint64_t seed, hash128_t out[8]);
+
+// n claves de longitud variable
+void hash128_many(const void* const* keys, const size_t* lens, size_t n,
+                  uint64_t seed, hash128_t* out);
+
+// n claves contiguas de key_len bytes cada una (p. ej. uint64_t[], UUIDs de 16 bytes)
+void hash128_fixed(const void* keys, size_t key_len, size_t n,
+                   uint64_t seed, hash128_t* out);
+
+// Igual que hash128_many pero devuelve solo hash64() de cada clave
+void hash64_many(const void* const* keys, const size_t* lens, size_t n,
+                 uint64_t seed, uint64_t* out);
+
 #endif
@@ -0,0 +1,109 @@
+#ifndef INSERT_LOG_H
+#define INSERT_LOG_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <pthread.h>
+
+#include "bloomdb.h"
+
+// ============================================================================
+// Append-only insert log (durabilidad entre snapshots)
+//
+// Cada inserción hecha a través del log se aplica al filtro y se añade al
+// archivo como su digest (h1, h2: 16 bytes, la clave no se guarda). Los
+// registros se agrupan en frames con su CRC32C y se escriben con un solo
+// fdatasync por grupo (group commit): cuando el grupo llega a group_bytes o
+// cuando el registro más antiguo pendiente cumple group_interval_ms.
+//
+// Al abrir, el log se reaplica sobre el filtro (el último snapshot cargado
+// con bloomdb_load o bloomdb_open_mmap). Un frame incompleto o con CRC
+// erróneo al final es una escritura cortada por el crash: se descarta y el
+// archivo se trunca ahí. checkpoint guarda el snapshot y vacía el log.
+//
+// Insertar un bit dos veces no cambia nada, así que reaplicar un registro
+// que ya estaba en el snapshot es inocuo: un crash entre el rename del
+// snapshot y el truncado del log no pierde ni duplica nada.
+//
+// Solo filtros BLOOMDB_HASH_MURMUR3 (el digest es la clave). Varios hilos
+// pueden insertar a la vez si el filtro está en modo concurrente.
+// ============================================================================
+
+#define BLOOMDB_LOG_DEFAULT_GROUP_BYTES    (64 * 1024)
+#define BLOOMDB_LOG_DEFAULT_GROUP_INTERVAL 10            // ms
+#define BLOOMDB_LOG_MAX_GROUP_BYTES        (64 * 1024 * 1024)
+
+typedef struct {
+    size_t group_bytes;            //fdatasync al acumular estos bytes de registros (0: en cada inserción)
+    uint32_t group_interval_ms;    //o cuando el registro pendiente más antiguo tiene esta edad (0: sin límite)
+} BloomDBLogOptions;
+
+typedef struct {
+    BloomDB* db;                   //filtro al que se aplican (del llamador: close no lo libera)
+    int fd;
+    uint64_t file_size;            //bytes válidos del archivo (cabecera + frames completos)
+    size_t group_bytes;
+    uint32_t group_interval_ms;
+    uint64_t replayed;             //registros reaplicados al abrir
+    uint64_t appended;             //registros añadidos desde que se abrió
+    uint64_t syncs;                //grupos escritos (un fdatasync cada uno)
+
+    // Internos: doble buffer de frames. lock protege el activo; io_lock
+    // serializa las escrituras, así las inserciones no esperan al fsync de
+    // otro grupo.
+    uint8_t* active;
+    uint8_t* spare;
+    size_t pending;                //registros en active
+    uint64_t oldest_ns;            //CLOCK_MONOTONIC del primer registro de active
+    BloomDBError error;            //primer error de escritura (se devuelve en la siguiente llamada)
+    pthread_mutex_t lock;
+    pthread_mutex_t io_lock;
+    pthread_cond_t wake;
+    pthread_t flusher;             //solo con group_interval_ms > 0
+    int flusher_running;
+    int stopping;
+} BloomDBLog;
+
+// ============================================================================
+// Simple API (returns NULL/false on error)
+// ============================================================================
+
+// opts NULL: BLOOMDB_LOG_DEFAULT_GROUP_BYTES / _INTERVAL
+BloomDBLog* bloomdb_log_open(BloomDB* db, const char* path, const BloomDBLogOptions* opts);
+void bloomdb_log_close(BloomDBLog* log);
+
+bool bloomdb_log_insert(BloomDBLog* log, const void* key, size_t len);
+bool bloomdb_log_insert_u64(BloomDBLog* log, uint64_t value);
+
+// Escribe el grupo pendiente y espera a que sea durable
+bool bloomdb_log_sync(BloomDBLog* log);
+
+// Snapshot + vaciado del log (ver bloomdb_log_checkpoint_ex)
+bool bloomdb_log_checkpoint(BloomDBLog* log, const char* snapshot_path);
+
+// ============================================================================
+// Extended API (explicit error handling)
+// ============================================================================
+
+// Crea el log si no existe; si existe, lo reaplica sobre db. FORMAT si el
+// archivo no es un log o es de otra seed; CHECKSUM si la cabecera está
+// dañada; INVALID_ARGUMENT con filtros legacy; READ_ONLY con un mapeo de
+// solo lectura.
+BloomDBError bloomdb_log_open_ex(BloomDB* db, const char* path, const BloomDBLogOptions* opts,
+                                 BloomDBLog** out_log);
+
+// Escribe lo pendiente, cierra y libera el log (no el filtro)
+BloomDBError bloomdb_log_close_ex(BloomDBLog* log);
+
+BloomDBError bloomdb_log_insert_ex(BloomDBLog* log, const void* key, size_t len);
+BloomDBError bloomdb_log_insert_u64_ex(BloomDBLog* log, uint64_t value);
+BloomDBError bloomdb_log_sync_ex(BloomDBLog* log);
+
+// Escribe el filtro en snapshot_path (archivo temporal + fsync + rename, así
+// el snapshot anterior sigue entero hasta el último momento) y trunca el log.
+// Con un filtro mapeado escribible, snapshot_path NULL hace msync del propio
+// archivo. Sin inserciones simultáneas (como bloomdb_save).
+BloomDBError bloomdb_log_checkpoint_ex(BloomDBLog* log, const char* snapshot_path);
+
+#endif
@@ -2,8 +2,19 @@
 #define STORAGE_H
 
 #include <stdbool.h>
+#include <stdint.h>
+#include <pthread.h>
 
 #include "bloomdb.h"
+#include "bloom_blocked.h"
+#include "bloom_split.h"
+#include "bloom_counting.h"
+#include "bloom_scalable.h"
+#include "bloom_partitioned.h"
+#include "bloom_fuse.h"
+#include "bloom_cuckoo.h"
+#include "bloom_windowed.h"
+#include "bloom_range.h"
 
 // ============================================================================
 // Simple API (returns false/NULL on error)
@@ -19,4 +30,271 @@ BloomDB* bloomdb_load(const char* path);
 BloomDBError bloomdb_save_ex(const BloomDB* db, const char* path);
 BloomDBError bloomdb_load_ex(const char* path, BloomDB** out_db);
 
+// ============================================================================
+// Compressed encoding (filtros poco ocupados)
+// ============================================================================
+
+// Un filtro recién creado o con pocas claves es casi todo ceros. SPARSE
+// guarda cada chunk de 1 MiB según su ocupación medida: los poco ocupados
+// como run-length de los ceros (un varint por bit a 1), los demás tal cual,
+// cada uno con su CRC32C. AUTO elige SPARSE si menos de 1 de cada 16 bits
+// del filtro está a 1 y RAW (lo mismo que bloomdb_save) si no.
+//
+// bloomdb_load y bloomdb_deserialize leen cualquiera de los dos y
+// decodifican chunk a chunk directamente sobre el bitarray. Un archivo
+// SPARSE no se puede abrir con bloomdb_open_mmap (FORMAT) ni servir de base
+// a bloomdb_save_incremental (se reescribe en RAW).
+typedef enum {
+    BLOOMDB_ENCODING_RAW = 0,      // v2 sin codificar (mapeable)
+    BLOOMDB_ENCODING_SPARSE = 1,   // chunks codificados según su ocupación
+    BLOOMDB_ENCODING_AUTO = 2      // SPARSE o RAW según la ocupación del filtro
+} BloomDBEncoding;
+
+bool bloomdb_save_encoded(const BloomDB* db, const char* path, BloomDBEncoding encoding);
+BloomDBError bloomdb_save_encoded_ex(const BloomDB* db, const char* path, BloomDBEncoding encoding);
+
+// Los mismos bytes que el archivo, en memoria (para enviarlos): el buffer
+// devuelto se libera con free()
+uint8_t* bloomdb_serialize(const BloomDB* db, BloomDBEncoding encoding, size_t* out_len);
+BloomDBError bloomdb_serialize_ex(const BloomDB* db, BloomDBEncoding encoding, uint8_t** out_buf, size_t* out_len);
+
+BloomDB* bloomdb_deserialize(const void* buf, size_t len);
+BloomDBError bloomdb_deserialize_ex(const void* buf, size_t len, BloomDB** out_db);
+
+// ============================================================================
+// Memory-mapped open (zero-copy)
+// ============================================================================
+
+// bloomdb_open_mmap mapea un archivo de bloomdb_save con MAP_SHARED y apunta
+// bitarray dentro del mapeo: no reserva ni lee el filtro, las páginas se
+// cargan al consultarlas y el page cache se comparte entre procesos.
+typedef enum {
+    BLOOMDB_MMAP_READ_ONLY = 0,        // PROT_READ; las inserciones dan BLOOMDB_ERR_READ_ONLY
+    BLOOMDB_MMAP_WRITABLE  = 1 << 0,   // PROT_READ | PROT_WRITE: las inserciones van al archivo
+    BLOOMDB_MMAP_POPULATE  = 1 << 1,   // MAP_POPULATE: carga todas las páginas al abrir
+    BLOOMDB_MMAP_RANDOM    = 1 << 2,   // madvise(MADV_RANDOM): sin lectura anticipada
+    BLOOMDB_MMAP_WILLNEED  = 1 << 3,   // madvise(MADV_WILLNEED): lectura anticipada en segundo plano
+    BLOOMDB_MMAP_VERIFY    = 1 << 4    // comprueba todos los CRC al abrir (solo formato v2)
+} BloomDBMmapFlags;
+
+// flags: OR de BloomDBMmapFlags. bloomdb_free deshace el mapeo. El archivo
+// no debe truncarse ni reescribirse (bloomdb_save sobre él) mientras esté
+// abierto. En v2 el bitarray empieza en página propia; en archivos v1 no
+// queda alineado a 8 bytes, así que el modo concurrente no está disponible
+// y build_parallel inserta en un solo hilo.
+//
+// Un mapeo v2 escribible marca la cabecera con "CRC atrasados" al abrir:
+// las inserciones no tocan la tabla de CRC. bloomdb_sync la rehace y
+// bloomdb_free la rehace y quita la marca. Si el proceso muere con el mapeo
+// abierto, la marca se queda: bloomdb_load acepta el bitarray sin comparar
+// CRC (con las inserciones que llegaron a disco), un mapeo de solo lectura
+// no tiene CRC que verificar y el siguiente mapeo escribible rehace la tabla.
+BloomDB* bloomdb_open_mmap(const char* path, int flags);
+BloomDBError bloomdb_open_mmap_ex(const char* path, int flags, BloomDB** out_db);
+
+// msync de un mapeo escribible (no-op si es de solo lectura); en v2
+// recalcula antes la tabla de CRC (la marca sigue: el mapeo sigue abierto).
+// INVALID_ARGUMENT si db no viene de bloomdb_open_mmap
+bool bloomdb_sync(const BloomDB* db);
+BloomDBError bloomdb_sync_ex(const BloomDB* db);
+
+// ============================================================================
+// Chunk verification (formato v2 mapeado)
+// ============================================================================
+
+// Cada 2^chunk_shift bytes del bitarray llevan su CRC32C. La comprobación es
+// perezosa: open_mmap no lee el bitarray salvo con BLOOMDB_MMAP_VERIFY, y se
+// puede verificar un rango de chunks (el que se va a usar) o todos en
+// paralelo. 0 chunks (y INVALID_ARGUMENT al verificar) si db no es un
+// mapeo v2.
+size_t bloomdb_chunk_count(const BloomDB* db);
+BloomDBError bloomdb_verify_chunks_ex(const BloomDB* db, size_t first, size_t count);
+
+// threads <= 0: uno por CPU. BLOOMDB_ERR_CHECKSUM si algún chunk no cuadra
+bool bloomdb_verify(const BloomDB* db, int threads);
+BloomDBError bloomdb_verify_ex(const BloomDB* db, int threads);
+
+// ============================================================================
+// Incremental save (páginas sucias)
+// ============================================================================
+
+// Escribe solo las páginas marcadas (ver bloomdb_track_dirty_ex) y limpia el
+// bitmap; si falla, el bitmap se conserva. Requiere el seguimiento activo
+// (INVALID_ARGUMENT si no). Cada destino recibe las páginas marcadas desde
+// la última llamada que lo escribió: lo que una llamada solo con delta no
+// lleva al archivo base va en la siguiente que lo actualice, y al revés.
+//
+// path: archivo base, actualizado en sitio con pwrite (páginas y CRC de sus
+// chunks) y fdatasync. Debe ser el archivo desde el que se empezó a seguir
+// (o el de la última llamada con base); si no existe o no es un v2 con los
+// mismos parámetros, se escribe entero. La actualización no es atómica: un
+// crash a mitad puede dejar chunks cuyo CRC no cuadra, que load detecta
+// (CHECKSUM).
+// delta_path: archivo con solo esas páginas, para aplicarlo en otras copias
+// con bloomdb_apply_delta. Cualquiera de los dos puede ser NULL, no ambos.
+//
+// Sin inserciones simultáneas (como bloomdb_save).
+bool bloomdb_save_incremental(BloomDB* db, const char* path, const char* delta_path);
+BloomDBError bloomdb_save_incremental_ex(BloomDB* db, const char* path, const char* delta_path);
+
+// OR de las páginas del delta sobre db (marcándolas si hay seguimiento).
+// Se comprueba entero antes de aplicar nada: FORMAT si está cortado,
+// CHECKSUM si alguna entrada está dañada, INVALID_ARGUMENT si es de otro
+// filtro. Aplicarlo dos veces no cambia nada.
+bool bloomdb_apply_delta(BloomDB* db, const char* delta_path);
+BloomDBError bloomdb_apply_delta_ex(BloomDB* db, const char* delta_path);
+
+// ============================================================================
+// Background snapshots
+// ============================================================================
+
+// bloomdb_snapshot_async escribe el filtro en path desde otro hilo mientras
+// el llamador sigue insertando. El bitarray se copia por chunks de 1 MiB con
+// cargas atómicas y cada CRC sale de la copia. Como los bits solo pasan de 0
+// a 1, el snapshot contiene toda inserción terminada antes de la llamada;
+// las que lleguen durante la escritura pueden faltar o estar a medias. Se
+// escribe path.tmp, fsync y rename: path siempre tiene un snapshot completo.
+//
+// El filtro debe estar en modo concurrente (bloomdb_set_concurrent), aunque
+// solo inserte un hilo: las inserciones normales no son atómicas y el hilo
+// del snapshot las leería a la vez. INVALID_ARGUMENT si no lo está. db no se
+// puede liberar, ni cambiar de modo, hasta bloomdb_snapshot_wait. Un solo
+// snapshot por path a la vez.
+typedef void (*BloomDBSnapshotCallback)(BloomDBError status, const char* path, void* user);
+
+typedef struct {
+    const BloomDB* db;
+    char* path;
+    BloomDBSnapshotCallback callback;   //desde el hilo del snapshot al terminar (puede ser NULL)
+    void* user;
+    BloomDBError status;
+    pthread_t thread;
+} BloomDBSnapshot;
+
+BloomDBSnapshot* bloomdb_snapshot_async(const BloomDB* db, const char* path, BloomDBSnapshotCallback callback,
+                                        void* user);
+BloomDBError bloomdb_snapshot_async_ex(const BloomDB* db, const char* path, BloomDBSnapshotCallback callback,
+                                       void* user, BloomDBSnapshot** out_snap);
+
+// Espera al hilo, libera snap y devuelve el estado del snapshot
+bool bloomdb_snapshot_wait(BloomDBSnapshot* snap);
+BloomDBError bloomdb_snapshot_wait_ex(BloomDBSnapshot* snap);
+
+// Snapshots periódicos: uno cada interval_ms (contados desde el final del
+// anterior) en un hilo propio, con las mismas garantías; callback tras cada
+// uno. stop espera al snapshot en curso, si lo hay, y devuelve el estado del
+// último.
+typedef struct {
+    const BloomDB* db;
+    char* path;
+    uint32_t interval_ms;
+    BloomDBSnapshotCallback callback;
+    void* user;
+    uint64_t snapshots;                 //terminados (con éxito o no)
+    BloomDBError last_status;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    pthread_t thread;
+    int stopping;
+} BloomDBSnapshotScheduler;
+
+BloomDBSnapshotScheduler* bloomdb_snapshot_scheduler_start(const BloomDB* db, const char* path, uint32_t interval_ms,
+                                                           BloomDBSnapshotCallback callback, void* user);
+void bloomdb_snapshot_scheduler_stop(BloomDBSnapshotScheduler* sched);
+
+BloomDBError bloomdb_snapshot_scheduler_start_ex(const BloomDB* db, const char* path, uint32_t interval_ms,
+                                                 BloomDBSnapshotCallback callback, void* user,
+                                                 BloomDBSnapshotScheduler** out_sched);
+BloomDBError bloomdb_snapshot_scheduler_stop_ex(BloomDBSnapshotScheduler* sched);
+
+// ============================================================================
+// Blocked Bloom filter
+// ============================================================================
+
+bool            bloomdb_blocked_save(const BloomDBBlocked* bf, const char* path);
+BloomDBBlocked* bloomdb_blocked_load(const char* path);
+
+BloomDBError bloomdb_blocked_save_ex(const BloomDBBlocked* bf, const char* path);
+BloomDBError bloomdb_blocked_load_ex(const char* path, BloomDBBlocked** out_bf);
+
+// ============================================================================
+// Split-block Bloom filter
+// ============================================================================
+
+bool          bloomdb_split_save(const BloomDBSplit* sf, const char* path);
+BloomDBSplit* bloomdb_split_load(const char* path);
+
+BloomDBError bloomdb_split_save_ex(const BloomDBSplit* sf, const char* path);
+BloomDBError bloomdb_split_load_ex(const char* path, BloomDBSplit** out_sf);
+
+// ============================================================================
+// Partitioned Bloom filter
+// ============================================================================
+
+bool                bloomdb_partitioned_save(const BloomDBPartitioned* pf, const char* path);
+BloomDBPartitioned* bloomdb_partitioned_load(const char* path);
+
+BloomDBError bloomdb_partitioned_save_ex(const BloomDBPartitioned* pf, const char* path);
+BloomDBError bloomdb_partitioned_load_ex(const char* path, BloomDBPartitioned** out_pf);
+
+// ============================================================================
+// Binary fuse filter
+// ============================================================================
+
+bool         bloomdb_fuse_save(const BloomDBFuse* ff, const char* path);
+BloomDBFuse* bloomdb_fuse_load(const char* path);
+
+BloomDBError bloomdb_fuse_save_ex(const BloomDBFuse* ff, const char* path);
+BloomDBError bloomdb_fuse_load_ex(const char* path, BloomDBFuse** out_ff);
+
+// ============================================================================
+// Cuckoo filter
+// ============================================================================
+
+bool           bloomdb_cuckoo_save(const BloomDBCuckoo* cf, const char* path);
+BloomDBCuckoo* bloomdb_cuckoo_load(const char* path);
+
+BloomDBError bloomdb_cuckoo_save_ex(const BloomDBCuckoo* cf, const char* path);
+BloomDBError bloomdb_cuckoo_load_ex(const char* path, BloomDBCuckoo** out_cf);
+
+// ============================================================================
+// Windowed Bloom filter
+// ============================================================================
+
+bool             bloomdb_windowed_save(const BloomDBWindowed* wf, const char* path);
+BloomDBWindowed* bloomdb_windowed_load(const char* path);
+
+BloomDBError bloomdb_windowed_save_ex(const BloomDBWindowed* wf, const char* path);
+BloomDBError bloomdb_windowed_load_ex(const char* path, BloomDBWindowed** out_wf);
+
+// ============================================================================
+// Range Bloom filter
+// ============================================================================
+
+bool          bloomdb_range_save(const BloomDBRange* rf, const char* path);
+BloomDBRange* bloomdb_range_load(const char* path);
+
+BloomDBError bloomdb_range_save_ex(const BloomDBRange* rf, const char* path);
+BloomDBError bloomdb_range_load_ex(const char* path, BloomDBRange** out_rf);
+
+// ============================================================================
+// Counting Bloom filter
+// ============================================================================
+
+bool             bloomdb_counting_save(const BloomDBCounting* cf, const char* path);
+BloomDBCounting* bloomdb_counting_load(const char* path);
+
+BloomDBError bloomdb_counting_save_ex(const BloomDBCounting* cf, const char* path);
+BloomDBError bloomdb_counting_load_ex(const char* path, BloomDBCounting** out_cf);
+
+// ============================================================================
+// Scalable Bloom filter (toda la cadena en un archivo)
+// ============================================================================
+
+bool             bloomdb_scalable_save(const BloomDBScalable* sf, const char* path);
+BloomDBScalable* bloomdb_scalable_load(const char* path);
+
+BloomDBError bloomdb_scalable_save_ex(const BloomDBScalable* sf, const char* path);
+BloomDBError bloomdb_scalable_load_ex(const char* path, BloomDBScalable** out_sf);
+
 #endif
@@ -1,4 +1,10 @@
 #include "bitarray.h"
+#include "bloomdb_internal.h"
+#include <string.h>
+
+#ifdef BLOOMDB_HAVE_X86
+#include <immintrin.h>
+#endif
 
 void bitarray_set(uint8_t* arr, size_t bit) {
     arr[bit >> 3] |= (1u << (bit & 7));
@@ -7,3 +13,164 @@ void bitarray_set(uint8_t* arr, size_t bit) {
 bool bitarray_get(const uint8_t* arr, size_t bit) {
     return (arr[bit >> 3] & (1u << (bit & 7))) != 0;
 }
+
+// ============================================================================
+// Popcount, OR y AND con máscara de arreglos completos: variantes por ISA (ver dispatch.c)
+// ============================================================================
+
+static inline uint64_t load64(const uint8_t* p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline void store64(uint8_t* p, uint64_t v) {
+    memcpy(p, &v, sizeof(v));
+}
+
+// Popcount SWAR: no depende de la instrucción POPCNT
+static inline size_t popcount64_swar(uint64_t x) {
+    x = x - ((x >> 1) & 0x5555555555555555ULL);
+    x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+    x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+    return (size_t)((x * 0x0101010101010101ULL) >> 56);
+}
+
+static size_t popcount_tail(const uint8_t* data, size_t nbytes) {
+    size_t count = 0;
+    for (size_t i = 0; i < nbytes; i++) count += popcount64_swar(data[i]);
+    return count;
+}
+
+size_t bitarray_popcount_scalar(const uint8_t* data, size_t nbytes) {
+    size_t count = 0;
+    size_t i = 0;
+    for (; i + 8 <= nbytes; i += 8) count += popcount64_swar(load64(data + i));
+    return count + popcount_tail(data + i, nbytes - i);
+}
+
+void bitarray_or_scalar(uint8_t* dst, const uint8_t* src, size_t nbytes) {
+    size_t i = 0;
+    for (; i + 8 <= nbytes; i += 8) store64(dst + i, load64(dst + i) | load64(src + i));
+    for (; i < nbytes; i++) dst[i] |= src[i];
+}
+
+void bitarray_and_mask_scalar(uint8_t* arr, uint8_t mask, size_t nbytes) {
+    const uint64_t m = mask * 0x0101010101010101ULL;
+    size_t i = 0;
+    for (; i + 8 <= nbytes; i += 8) store64(arr + i, load64(arr + i) & m);
+    for (; i < nbytes; i++) arr[i] &= mask;
+}
+
+#ifdef BLOOMDB_HAVE_X86
+
+// SSE4.2: instrucción POPCNT, cuatro acumuladores para no encadenar sumas
+__attribute__((target("popcnt")))
+size_t bitarray_popcount_popcnt(const uint8_t* data, size_t nbytes) {
+    size_t c0 = 0, c1 = 0, c2 = 0, c3 = 0;
+    size_t i = 0;
+    for (; i + 32 <= nbytes; i += 32) {
+        c0 += (size_t)__builtin_popcountll(load64(data + i));
+        c1 += (size_t)__builtin_popcountll(load64(data + i + 8));
+        c2 += (size_t)__builtin_popcountll(load64(data + i + 16));
+        c3 += (size_t)__builtin_popcountll(load64(data + i + 24));
+    }
+    for (; i + 8 <= nbytes; i += 8) c0 += (size_t)__builtin_popcountll(load64(data + i));
+    return c0 + c1 + c2 + c3 + popcount_tail(data + i, nbytes - i);
+}
+
+/**
+ * AVX2 (Muła): popcount de cada nibble con vpshufb sobre una tabla de 16
+ * entradas y suma horizontal por bytes con vpsadbw cada 32 bytes.
+ */
+__attribute__((target("avx2")))
+size_t bitarray_popcount_avx2(const uint8_t* data, size_t nbytes) {
+    const __m256i lut = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                         0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low4 = _mm256_set1_epi8(0x0f);
+    __m256i acc = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 32 <= nbytes; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(data + i));
+        __m256i lo = _mm256_shuffle_epi8(lut, _mm256_and_si256(v, low4));
+        __m256i hi = _mm256_shuffle_epi8(lut, _mm256_and_si256(_mm256_srli_epi16(v, 4), low4));
+        acc = _mm256_add_epi64(acc, _mm256_sad_epu8(_mm256_add_epi8(lo, hi), _mm256_setzero_si256()));
+    }
+    uint64_t lanes[4];
+    _mm256_storeu_si256((__m256i*)lanes, acc);
+    size_t count = (size_t)(lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+    return count + bitarray_popcount_scalar(data + i, nbytes - i);
+}
+
+// AVX-512 VPOPCNTDQ: popcount de 8 palabras por instrucción
+__attribute__((target("avx512f,avx512vpopcntdq")))
+size_t bitarray_popcount_avx512(const uint8_t* data, size_t nbytes) {
+    __m512i acc = _mm512_setzero_si512();
+    size_t i = 0;
+    for (; i + 64 <= nbytes; i += 64) {
+        acc = _mm512_add_epi64(acc, _mm512_popcnt_epi64(_mm512_loadu_si512(data + i)));
+    }
+    size_t count = (size_t)_mm512_reduce_add_epi64(acc);
+    return count + bitarray_popcount_scalar(data + i, nbytes - i);
+}
+
+__attribute__((target("avx2")))
+void bitarray_or_avx2(uint8_t* dst, const uint8_t* src, size_t nbytes) {
+    size_t i = 0;
+    for (; i + 32 <= nbytes; i += 32) {
+        __m256i a = _mm256_loadu_si256((const __m256i*)(dst + i));
+        __m256i b = _mm256_loadu_si256((const __m256i*)(src + i));
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_or_si256(a, b));
+    }
+    bitarray_or_scalar(dst + i, src + i, nbytes - i);
+}
+
+__attribute__((target("avx512f")))
+void bitarray_or_avx512(uint8_t* dst, const uint8_t* src, size_t nbytes) {
+    size_t i = 0;
+    for (; i + 64 <= nbytes; i += 64) {
+        __m512i a = _mm512_loadu_si512(dst + i);
+        __m512i b = _mm512_loadu_si512(src + i);
+        _mm512_storeu_si512(dst + i, _mm512_or_si512(a, b));
+    }
+    bitarray_or_scalar(dst + i, src + i, nbytes - i);
+}
+
+__attribute__((target("avx2")))
+void bitarray_and_mask_avx2(uint8_t* arr, uint8_t mask, size_t nbytes) {
+    const __m256i m = _mm256_set1_epi8((char)mask);
+    size_t i = 0;
+    for (; i + 32 <= nbytes; i += 32) {
+        __m256i a = _mm256_loadu_si256((const __m256i*)(arr + i));
+        _mm256_storeu_si256((__m256i*)(arr + i), _mm256_and_si256(a, m));
+    }
+    bitarray_and_mask_scalar(arr + i, mask, nbytes - i);
+}
+
+__attribute__((target("avx512f")))
+void bitarray_and_mask_avx512(uint8_t* arr, uint8_t mask, size_t nbytes) {
+    const __m512i m = _mm512_set1_epi32((int)(mask * 0x01010101u));
+    size_t i = 0;
+    for (; i + 64 <= nbytes; i += 64) {
+        _mm512_storeu_si512(arr + i, _mm512_and_si512(_mm512_loadu_si512(arr + i), m));
+    }
+    bitarray_and_mask_scalar(arr + i, mask, nbytes - i);
+}
+
+#endif
+
+// ============================================================================
+// API pública (kernel elegido por dispatch.c)
+// ============================================================================
+
+size_t bitarray_popcount(const uint8_t* arr, size_t nbytes) {
+    return bloomdb_kernels.popcount(arr, nbytes);
+}
+
+void bitarray_or(uint8_t* dst, const uint8_t* src, size_t nbytes) {
+    bloomdb_kernels.merge_or(dst, src, nbytes);
+}
+
+void bitarray_and_mask(uint8_t* arr, uint8_t mask, size_t nbytes) {
+    bloomdb_kernels.and_mask(arr, mask, nbytes);
+}
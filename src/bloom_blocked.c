@@ -0,0 +1,128 @@
+#include "bloom_blocked.h"
+#include "hash64.h"
+#include "bloomdb_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+// ============================================================================
+// INTERNAS
+// ============================================================================
+
+// Remezcla para obtener más posiciones cuando k > 7 (splitmix64)
+static inline uint64_t remix(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+/**
+ * Máscara de la clave dentro de su bloque.
+ * h1 elige el bloque (fastrange) y h2 aporta las posiciones: 9 bits por
+ * sonda, 7 sondas por palabra de 64 bits.
+ */
+static inline void block_mask(const BloomDBBlocked* bf, hash128_t h,
+                              size_t* out_block, uint64_t mask[BLOOMDB_BLOCK_WORDS]) {
+    *out_block = fastrange64(h.h1, bf->block_count);
+
+    for (int w = 0; w < BLOOMDB_BLOCK_WORDS; w++) mask[w] = 0;
+
+    uint64_t x = h.h2;
+    for (int i = 0; i < bf->num_hashes; i++) {
+        if (i > 0 && i % 7 == 0) x = remix(h.h2 + (uint64_t)i);
+        unsigned pos = (unsigned)(x & (BLOOMDB_BLOCK_BITS - 1));
+        mask[pos >> 6] |= 1ULL << (pos & 63);
+        x >>= 9;
+    }
+}
+
+// ============================================================================
+// API PÚBLICA - Extended (error explícito)
+// ============================================================================
+
+BloomDBError bloomdb_blocked_create_ex(size_t bits, int num_hashes, uint64_t seed, BloomDBBlocked** out_bf) {
+    if (!out_bf) return BLOOMDB_ERR_INVALID_ARGUMENT;
+    if (bits == 0 || num_hashes <= 0 || num_hashes > BLOOMDB_BLOCKED_MAX_HASHES) {
+        return BLOOMDB_ERR_INVALID_ARGUMENT;
+    }
+
+    size_t block_count = (bits + BLOOMDB_BLOCK_BITS - 1) / BLOOMDB_BLOCK_BITS;
+    if (block_count > SIZE_MAX / 64 - 1) return BLOOMDB_ERR_INVALID_ARGUMENT;
+
+    BloomDBBlocked* bf = malloc(sizeof(BloomDBBlocked));
+    if (!bf) return BLOOMDB_ERR_ALLOC;
+
+    // calloc + alineado manual: conserva las páginas en cero perezosas de
+    // calloc para filtros grandes (aligned_alloc + memset las tocaría todas)
+    bf->alloc = calloc(block_count * 64 + 63, 1);
+    if (!bf->alloc) {
+        free(bf);
+        return BLOOMDB_ERR_ALLOC;
+    }
+    bf->blocks = (uint64_t*)(((uintptr_t)bf->alloc + 63) & ~(uintptr_t)63);
+    bf->block_count = block_count;
+    bf->bit_count = block_count * BLOOMDB_BLOCK_BITS;
+    bf->num_hashes = num_hashes;
+    bf->seed = seed;
+
+    *out_bf = bf;
+    return BLOOMDB_OK;
+}
+
+BloomDBError bloomdb_blocked_insert_ex(BloomDBBlocked* bf, const void* key, size_t len) {
+    if (!bf || !key || len == 0) return BLOOMDB_ERR_INVALID_ARGUMENT;
+
+    size_t block;
+    uint64_t mask[BLOOMDB_BLOCK_WORDS];
+    block_mask(bf, hash128(key, len, bf->seed), &block, mask);
+
+    uint64_t* b = bf->blocks + block * BLOOMDB_BLOCK_WORDS;
+    for (int w = 0; w < BLOOMDB_BLOCK_WORDS; w++) b[w] |= mask[w];
+    return BLOOMDB_OK;
+}
+
+BloomDBError bloomdb_blocked_might_contain_ex(const BloomDBBlocked* bf, const void* key, size_t len, bool* out_result) {
+    if (!bf || !key || len == 0 || !out_result) return BLOOMDB_ERR_INVALID_ARGUMENT;
+
+    size_t block;
+    uint64_t mask[BLOOMDB_BLOCK_WORDS];
+    block_mask(bf, hash128(key, len, bf->seed), &block, mask);
+
+    // Sin ramas: se acumulan los bits que faltan de las 8 palabras
+    const uint64_t* b = bf->blocks + block * BLOOMDB_BLOCK_WORDS;
+    uint64_t missing = 0;
+    for (int w = 0; w < BLOOMDB_BLOCK_WORDS; w++) missing |= mask[w] & ~b[w];
+
+    *out_result = missing == 0;
+    return BLOOMDB_OK;
+}
+
+// ============================================================================
+// API PÚBLICA - Simple (wrappers sobre _ex)
+// ============================================================================
+
+BloomDBBlocked* bloomdb_blocked_create(size_t bits, int num_hashes, uint64_t seed) {
+    BloomDBBlocked* bf = NULL;
+    if (bloomdb_blocked_create_ex(bits, num_hashes, seed, &bf) != BLOOMDB_OK) {
+        return NULL;
+    }
+    return bf;
+}
+
+void bloomdb_blocked_free(BloomDBBlocked* bf) {
+    if (!bf) return;
+    free(bf->alloc);
+    free(bf);
+}
+
+bool bloomdb_blocked_insert(BloomDBBlocked* bf, const void* key, size_t len) {
+    return bloomdb_blocked_insert_ex(bf, key, len) == BLOOMDB_OK;
+}
+
+bool bloomdb_blocked_might_contain(const BloomDBBlocked* bf, const void* key, size_t len) {
+    bool result = false;
+    if (bloomdb_blocked_might_contain_ex(bf, key, len, &result) != BLOOMDB_OK) {
+        return false;
+    }
+    return result;
+}
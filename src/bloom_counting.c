@@ -0,0 +1,183 @@
+#include "bloom_counting.h"
+#include "hash64.h"
+#include "bloomdb_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+// ============================================================================
+// INTERNAS
+// ============================================================================
+
+// Índice del contador para la sonda i: mismo doble hashing y reducción que
+// BloomDB, para que to_bloomdb sea exacto
+static inline size_t counter_index(const BloomDBCounting* cf, uint64_t h) {
+    if (cf->index_mode == BLOOMDB_INDEX_MASK) return (size_t)(h & (cf->counter_count - 1));
+    return fastrange64(h, cf->counter_count);
+}
+
+static inline unsigned counter_get(const BloomDBCounting* cf, size_t c) {
+    return (unsigned)(cf->words[c >> 4] >> ((c & 15) * 4)) & 0xF;
+}
+
+/**
+ * Actualizaciones SWAR sin ramas: el incremento (o decremento) se suma
+ * directamente a la palabra en la posición del nibble, anulado si el
+ * contador ya está saturado (o a cero). Como el nibble no desborda, nunca
+ * hay acarreo hacia el contador vecino.
+ */
+static inline void counter_inc(BloomDBCounting* cf, size_t c) {
+    uint64_t* w = cf->words + (c >> 4);
+    unsigned shift = (unsigned)(c & 15) * 4;
+    uint64_t nib = (*w >> shift) & 0xF;
+    *w += (uint64_t)(nib != BLOOMDB_COUNTER_MAX) << shift;
+}
+
+static inline void counter_dec(BloomDBCounting* cf, size_t c) {
+    uint64_t* w = cf->words + (c >> 4);
+    unsigned shift = (unsigned)(c & 15) * 4;
+    uint64_t nib = (*w >> shift) & 0xF;
+    *w -= (uint64_t)(nib != 0 && nib != BLOOMDB_COUNTER_MAX) << shift;
+}
+
+static bool all_counters_set(const BloomDBCounting* cf, hash128_t h) {
+    uint64_t x = h.h1;
+    for (int i = 0; i < cf->num_hashes; i++, x += h.h2) {
+        if (counter_get(cf, counter_index(cf, x)) == 0) return false;
+    }
+    return true;
+}
+
+/**
+ * 16 contadores -> 16 bits (contador != 0). Primero cada nibble se reduce a
+ * su bit bajo, luego los bits (separados 4 posiciones) se compactan por
+ * pasos. Sin ramas ni tablas; el bucle que lo usa se autovectoriza.
+ */
+static inline uint16_t nonzero_nibbles(uint64_t w) {
+    uint64_t x = w | (w >> 1);
+    x = (x | (x >> 2)) & 0x1111111111111111ULL;
+    x = (x | (x >> 3)) & 0x0303030303030303ULL;
+    x = (x | (x >> 6)) & 0x000F000F000F000FULL;
+    x = (x | (x >> 12)) & 0x000000FF000000FFULL;
+    x = (x | (x >> 24)) & 0xFFFFULL;
+    return (uint16_t)x;
+}
+
+// ============================================================================
+// API PÚBLICA - Extended (error explícito)
+// ============================================================================
+
+BloomDBError bloomdb_counting_create_ex(size_t counters, int num_hashes, uint64_t seed, BloomDBCounting** out_cf) {
+    if (!out_cf) return BLOOMDB_ERR_INVALID_ARGUMENT;
+    if (counters == 0 || num_hashes <= 0) return BLOOMDB_ERR_INVALID_ARGUMENT;
+
+    BloomDBCounting* cf = malloc(sizeof(BloomDBCounting));
+    if (!cf) return BLOOMDB_ERR_ALLOC;
+
+    cf->counter_count = counters;
+    cf->word_count = (counters + 15) / 16;
+    cf->num_hashes = num_hashes;
+    cf->seed = seed;
+    cf->index_mode = (counters & (counters - 1)) == 0 ? BLOOMDB_INDEX_MASK : BLOOMDB_INDEX_FASTRANGE;
+
+    cf->words = calloc(cf->word_count, sizeof(uint64_t));
+    if (!cf->words) {
+        free(cf);
+        return BLOOMDB_ERR_ALLOC;
+    }
+
+    *out_cf = cf;
+    return BLOOMDB_OK;
+}
+
+BloomDBError bloomdb_counting_insert_ex(BloomDBCounting* cf, const void* key, size_t len) {
+    if (!cf || !key || len == 0) return BLOOMDB_ERR_INVALID_ARGUMENT;
+
+    hash128_t h = hash128(key, len, cf->seed);
+    uint64_t x = h.h1;
+    for (int i = 0; i < cf->num_hashes; i++, x += h.h2) {
+        counter_inc(cf, counter_index(cf, x));
+    }
+    return BLOOMDB_OK;
+}
+
+BloomDBError bloomdb_counting_remove_ex(BloomDBCounting* cf, const void* key, size_t len) {
+    if (!cf || !key || len == 0) return BLOOMDB_ERR_INVALID_ARGUMENT;
+
+    hash128_t h = hash128(key, len, cf->seed);
+    if (!all_counters_set(cf, h)) return BLOOMDB_ERR_INVALID_ARGUMENT;
+
+    uint64_t x = h.h1;
+    for (int i = 0; i < cf->num_hashes; i++, x += h.h2) {
+        counter_dec(cf, counter_index(cf, x));
+    }
+    return BLOOMDB_OK;
+}
+
+BloomDBError bloomdb_counting_might_contain_ex(const BloomDBCounting* cf, const void* key, size_t len, bool* out_result) {
+    if (!cf || !key || len == 0 || !out_result) return BLOOMDB_ERR_INVALID_ARGUMENT;
+
+    *out_result = all_counters_set(cf, hash128(key, len, cf->seed));
+    return BLOOMDB_OK;
+}
+
+BloomDBError bloomdb_counting_to_bloomdb_ex(const BloomDBCounting* cf, BloomDB** out_db) {
+    if (!cf || !out_db) return BLOOMDB_ERR_INVALID_ARGUMENT;
+
+    BloomDB* db = NULL;
+    BloomDBError err = bloomdb_create_ex(cf->counter_count, cf->num_hashes, cf->seed, &db);
+    if (err != BLOOMDB_OK) return err;
+    db->index_mode = cf->index_mode;
+
+    // Palabra w -> bytes 2w y 2w+1 del bitarray (contador i = bit i)
+    uint8_t* out = db->bitarray;
+    for (size_t w = 0; w < cf->word_count; w++) {
+        uint16_t bits = nonzero_nibbles(cf->words[w]);
+        out[2 * w] = (uint8_t)bits;
+        if (2 * w + 1 < db->byte_count) out[2 * w + 1] = (uint8_t)(bits >> 8);
+    }
+
+    *out_db = db;
+    return BLOOMDB_OK;
+}
+
+// ============================================================================
+// API PÚBLICA - Simple (wrappers sobre _ex)
+// ============================================================================
+
+BloomDBCounting* bloomdb_counting_create(size_t counters, int num_hashes, uint64_t seed) {
+    BloomDBCounting* cf = NULL;
+    if (bloomdb_counting_create_ex(counters, num_hashes, seed, &cf) != BLOOMDB_OK) {
+        return NULL;
+    }
+    return cf;
+}
+
+void bloomdb_counting_free(BloomDBCounting* cf) {
+    if (!cf) return;
+    free(cf->words);
+    free(cf);
+}
+
+bool bloomdb_counting_insert(BloomDBCounting* cf, const void* key, size_t len) {
+    return bloomdb_counting_insert_ex(cf, key, len) == BLOOMDB_OK;
+}
+
+bool bloomdb_counting_remove(BloomDBCounting* cf, const void* key, size_t len) {
+    return bloomdb_counting_remove_ex(cf, key, len) == BLOOMDB_OK;
+}
+
+bool bloomdb_counting_might_contain(const BloomDBCounting* cf, const void* key, size_t len) {
+    bool result = false;
+    if (bloomdb_counting_might_contain_ex(cf, key, len, &result) != BLOOMDB_OK) {
+        return false;
+    }
+    return result;
+}
+
+BloomDB* bloomdb_counting_to_bloomdb(const BloomDBCounting* cf) {
+    BloomDB* db = NULL;
+    if (bloomdb_counting_to_bloomdb_ex(cf, &db) != BLOOMDB_OK) {
+        return NULL;
+    }
+    return db;
+}
@@ -0,0 +1,254 @@
+#include "bloom_cuckoo.h"
+#include "hash64.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Claves por grupo en la consulta por lotes (mismo criterio que BloomDB)
+#define CUCKOO_BATCH_GROUP 16
+
+#define LANES_LO 0x0001000100010001ULL
+#define LANES_HI 0x8000800080008000ULL
+
+// ============================================================================
+// INTERNAS
+// ============================================================================
+
+// Huella de 16 bits de la parte alta de h2 (0 marca hueco vacío)
+static inline uint16_t cuckoo_fingerprint(hash128_t h) {
+    uint16_t fp = (uint16_t)(h.h2 >> 48);
+    return fp ? fp : 1;
+}
+
+/**
+ * Cubeta alternativa: i ^ mix(fp). Es una involución (alt(alt(i)) == i),
+ * por eso basta la huella para mover una entrada entre sus dos cubetas.
+ */
+static inline size_t alt_index(const BloomDBCuckoo* cf, size_t i, uint16_t fp) {
+    return (i ^ (size_t)((fp * 0xc4ceb9fe1a85ec53ULL) >> 16)) & (cf->bucket_count - 1);
+}
+
+// ¿Alguna de las 4 huellas de la cubeta es fp? (SWAR: hay un carril a cero
+// en w ^ fp replicado; la prueba es exacta para "alguno")
+static inline bool bucket_has(uint64_t w, uint16_t fp) {
+    uint64_t x = w ^ (fp * LANES_LO);
+    return ((x - LANES_LO) & ~x & LANES_HI) != 0;
+}
+
+static inline uint16_t lane_get(uint64_t w, int s) {
+    return (uint16_t)(w >> (16 * s));
+}
+
+static inline uint64_t lane_set(uint64_t w, int s, uint16_t fp) {
+    return (w & ~(0xffffULL << (16 * s))) | ((uint64_t)fp << (16 * s));
+}
+
+static bool bucket_put(BloomDBCuckoo* cf, size_t i, uint16_t fp) {
+    uint64_t w = cf->buckets[i];
+    for (int s = 0; s < BLOOMDB_CUCKOO_SLOTS; s++) {
+        if (lane_get(w, s) == 0) {
+            cf->buckets[i] = lane_set(w, s, fp);
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool bucket_take(BloomDBCuckoo* cf, size_t i, uint16_t fp) {
+    uint64_t w = cf->buckets[i];
+    for (int s = 0; s < BLOOMDB_CUCKOO_SLOTS; s++) {
+        if (lane_get(w, s) == fp) {
+            cf->buckets[i] = lane_set(w, s, 0);
+            return true;
+        }
+    }
+    return false;
+}
+
+static inline uint64_t xorshift64(uint64_t* state) {
+    uint64_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return *state = x;
+}
+
+static inline bool victim_matches(const BloomDBCuckoo* cf, size_t i1, size_t i2, uint16_t fp) {
+    return cf->has_victim && cf->victim_fp == fp && (cf->victim_index == i1 || cf->victim_index == i2);
+}
+
+static bool query_hashed(const BloomDBCuckoo* cf, hash128_t h) {
+    const uint16_t fp = cuckoo_fingerprint(h);
+    const size_t i1 = (size_t)h.h1 & (cf->bucket_count - 1);
+    const size_t i2 = alt_index(cf, i1, fp);
+    // Las dos lecturas son independientes: sin salida temprana entre ellas
+    bool found = bucket_has(cf->buckets[i1], fp) | bucket_has(cf->buckets[i2], fp);
+    return found || victim_matches(cf, i1, i2, fp);
+}
+
+/**
+ * Coloca fp en la cubeta i o en su alternativa. Si ambas están llenas se
+ * expulsa una huella al azar hacia su otra cubeta, y así sucesivamente.
+ * Tras MAX_KICKS la última huella expulsada queda como víctima: no se
+ * pierde ninguna clave, pero no se aceptan más inserciones hasta que un
+ * borrado le haga sitio.
+ */
+static void place(BloomDBCuckoo* cf, size_t i, uint16_t fp) {
+    if (bucket_put(cf, i, fp)) return;
+    i = alt_index(cf, i, fp);
+    if (bucket_put(cf, i, fp)) return;
+
+    for (int kick = 0; kick < BLOOMDB_CUCKOO_MAX_KICKS; kick++) {
+        int s = (int)(xorshift64(&cf->rng) & (BLOOMDB_CUCKOO_SLOTS - 1));
+        uint16_t out = lane_get(cf->buckets[i], s);
+        cf->buckets[i] = lane_set(cf->buckets[i], s, fp);
+        fp = out;
+        i = alt_index(cf, i, fp);
+        if (bucket_put(cf, i, fp)) return;
+    }
+
+    cf->victim_index = i;
+    cf->victim_fp = fp;
+    cf->has_victim = true;
+}
+
+// ============================================================================
+// API PÚBLICA - Extended (error explícito)
+// ============================================================================
+
+BloomDBError bloomdb_cuckoo_create_ex(size_t capacity, uint64_t seed, BloomDBCuckoo** out_cf) {
+    if (!out_cf) return BLOOMDB_ERR_INVALID_ARGUMENT;
+    if (capacity == 0 || capacity > SIZE_MAX / 16) return BLOOMDB_ERR_INVALID_ARGUMENT;
+
+    size_t needed = (size_t)((double)capacity / (BLOOMDB_CUCKOO_SLOTS * BLOOMDB_CUCKOO_LOAD)) + 1;
+    size_t buckets = 2;
+    while (buckets < needed) buckets <<= 1;
+
+    BloomDBCuckoo* cf = calloc(1, sizeof(BloomDBCuckoo));
+    if (!cf) return BLOOMDB_ERR_ALLOC;
+
+    cf->buckets = calloc(buckets, sizeof(uint64_t));
+    if (!cf->buckets) {
+        free(cf);
+        return BLOOMDB_ERR_ALLOC;
+    }
+    cf->bucket_count = buckets;
+    cf->seed = seed;
+    cf->rng = seed ^ 0x9e3779b97f4a7c15ULL;
+    if (cf->rng == 0) cf->rng = 1;
+
+    *out_cf = cf;
+    return BLOOMDB_OK;
+}
+
+BloomDBError bloomdb_cuckoo_insert_ex(BloomDBCuckoo* cf, const void* key, size_t len) {
+    if (!cf || !key || len == 0) return BLOOMDB_ERR_INVALID_ARGUMENT;
+    if (cf->has_victim) return BLOOMDB_ERR_FULL;
+
+    hash128_t h = hash128(key, len, cf->seed);
+    place(cf, (size_t)h.h1 & (cf->bucket_count - 1), cuckoo_fingerprint(h));
+    cf->count++;
+    return BLOOMDB_OK;
+}
+
+BloomDBError bloomdb_cuckoo_remove_ex(BloomDBCuckoo* cf, const void* key, size_t len) {
+    if (!cf || !key || len == 0) return BLOOMDB_ERR_INVALID_ARGUMENT;
+
+    hash128_t h = hash128(key, len, cf->seed);
+    uint16_t fp = cuckoo_fingerprint(h);
+    size_t i1 = (size_t)h.h1 & (cf->bucket_count - 1);
+    size_t i2 = alt_index(cf, i1, fp);
+
+    if (victim_matches(cf, i1, i2, fp)) {
+        cf->has_victim = false;
+    } else if (!bucket_take(cf, i1, fp) && !bucket_take(cf, i2, fp)) {
+        return BLOOMDB_ERR_INVALID_ARGUMENT;
+    }
+    cf->count--;
+
+    // Hay un hueco nuevo: se intenta devolver la víctima a la tabla (con
+    // reubicaciones si hace falta)
+    if (cf->has_victim) {
+        cf->has_victim = false;
+        place(cf, cf->victim_index, cf->victim_fp);
+    }
+    return BLOOMDB_OK;
+}
+
+BloomDBError bloomdb_cuckoo_might_contain_ex(const BloomDBCuckoo* cf, const void* key, size_t len, bool* out_result) {
+    if (!cf || !key || len == 0 || !out_result) return BLOOMDB_ERR_INVALID_ARGUMENT;
+    *out_result = query_hashed(cf, hash128(key, len, cf->seed));
+    return BLOOMDB_OK;
+}
+
+BloomDBError bloomdb_cuckoo_might_contain_batch_ex(const BloomDBCuckoo* cf, const void* const* keys,
+                                                   const size_t* lens, size_t n, uint8_t* out_bitmap) {
+    if (!cf) return BLOOMDB_ERR_INVALID_ARGUMENT;
+    if (n == 0) return BLOOMDB_OK;
+    if (!keys || !lens || !out_bitmap) return BLOOMDB_ERR_INVALID_ARGUMENT;
+    for (size_t i = 0; i < n; i++) {
+        if (!keys[i] || lens[i] == 0) return BLOOMDB_ERR_INVALID_ARGUMENT;
+    }
+
+    memset(out_bitmap, 0, (n + 7) / 8);
+
+    // Por grupo: se hashea, se piden las dos cubetas de cada clave y luego
+    // se comparan, así los fallos de caché del grupo se solapan
+    hash128_t h[CUCKOO_BATCH_GROUP];
+    for (size_t base = 0; base < n; base += CUCKOO_BATCH_GROUP) {
+        size_t g = n - base < CUCKOO_BATCH_GROUP ? n - base : CUCKOO_BATCH_GROUP;
+        hash128_many(keys + base, lens + base, g, cf->seed, h);
+        for (size_t j = 0; j < g; j++) {
+            size_t i1 = (size_t)h[j].h1 & (cf->bucket_count - 1);
+            __builtin_prefetch(&cf->buckets[i1], 0, 3);
+            __builtin_prefetch(&cf->buckets[alt_index(cf, i1, cuckoo_fingerprint(h[j]))], 0, 3);
+        }
+        for (size_t j = 0; j < g; j++) {
+            out_bitmap[(base + j) >> 3] |= (uint8_t)(query_hashed(cf, h[j]) << ((base + j) & 7));
+        }
+    }
+    return BLOOMDB_OK;
+}
+
+// ============================================================================
+// API PÚBLICA - Simple (wrappers sobre _ex)
+// ============================================================================
+
+BloomDBCuckoo* bloomdb_cuckoo_create(size_t capacity, uint64_t seed) {
+    BloomDBCuckoo* cf = NULL;
+    if (bloomdb_cuckoo_create_ex(capacity, seed, &cf) != BLOOMDB_OK) {
+        return NULL;
+    }
+    return cf;
+}
+
+void bloomdb_cuckoo_free(BloomDBCuckoo* cf) {
+    if (!cf) return;
+    free(cf->buckets);
+    free(cf);
+}
+
+bool bloomdb_cuckoo_insert(BloomDBCuckoo* cf, const void* key, size_t len) {
+    return bloomdb_cuckoo_insert_ex(cf, key, len) == BLOOMDB_OK;
+}
+
+bool bloomdb_cuckoo_remove(BloomDBCuckoo* cf, const void* key, size_t len) {
+    return bloomdb_cuckoo_remove_ex(cf, key, len) == BLOOMDB_OK;
+}
+
+bool bloomdb_cuckoo_might_contain(const BloomDBCuckoo* cf, const void* key, size_t len) {
+    bool result = false;
+    if (bloomdb_cuckoo_might_contain_ex(cf, key, len, &result) != BLOOMDB_OK) {
+        return false;
+    }
+    return result;
+}
+
+bool bloomdb_cuckoo_might_contain_batch(const BloomDBCuckoo* cf, const void* const* keys, const size_t* lens,
+                                        size_t n, uint8_t* out_bitmap) {
+    return bloomdb_cuckoo_might_contain_batch_ex(cf, keys, lens, n, out_bitmap) == BLOOMDB_OK;
+}
+
+double bloomdb_cuckoo_load_factor(const BloomDBCuckoo* cf) {
+    if (!cf) return 0.0;
+    return (double)cf->count / (double)(cf->bucket_count * BLOOMDB_CUCKOO_SLOTS);
+}
@@ -0,0 +1,331 @@
+#include "bloom_fuse.h"
+#include "hash64.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+// Semillas probadas antes de rendirse. Con el factor de tamaño elegido cada
+// intento falla con probabilidad muy baja, así que casi siempre basta uno.
+#define FUSE_MAX_ITERATIONS 100
+
+// ============================================================================
+// INTERNAS
+// ============================================================================
+
+// Finalizador de MurmurHash3: mezcla el hash64 de la clave con fuse_seed
+static inline uint64_t fuse_mix(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+static inline uint64_t splitmix64(uint64_t* state) {
+    uint64_t z = (*state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+static inline uint8_t fuse_fingerprint(uint64_t h) {
+    return (uint8_t)(h ^ (h >> 32));
+}
+
+/**
+ * Posición i (0..2) de un hash: el segmento inicial sale de los bits altos
+ * (mulhi sobre segment_count_length), las posiciones 1 y 2 están en los dos
+ * segmentos siguientes y dentro de cada uno el desplazamiento sale de 18
+ * bits distintos del hash.
+ */
+static inline uint32_t fuse_position(const BloomDBFuse* ff, uint64_t h, int i) {
+    uint64_t p = (uint64_t)(((__uint128_t)h * ff->segment_count_length) >> 64);
+    p += (uint64_t)i * ff->segment_length;
+    uint64_t low = h & ((1ULL << 36) - 1);
+    p ^= (low >> (36 - 18 * i)) & ff->segment_length_mask;
+    return (uint32_t)p;
+}
+
+/**
+ * Dimensiones para n claves (parámetros de Graf & Lemire para aridad 3):
+ * segmentos de 2^floor(log_3.33(n) + 2.25) posiciones (máx. 2^18) y
+ * n * max(1.125, 0.875 + 0.25 * ln(10^6) / ln(n)) posiciones en total.
+ */
+static void fuse_layout(BloomDBFuse* ff, size_t n) {
+    uint32_t seg_len = 4;
+    if (n > 0) {
+        int e = (int)floor(log((double)n) / log(3.33) + 2.25);
+        seg_len = e >= 18 ? 1u << 18 : 1u << e;
+    }
+
+    double capacity = 0.0;
+    if (n > 1) {
+        double factor = 0.875 + 0.25 * log(1000000.0) / log((double)n);
+        if (factor < 1.125) factor = 1.125;
+        capacity = round((double)n * factor);
+    }
+
+    uint32_t segments = (uint32_t)ceil(capacity / seg_len);
+    segments = segments <= 2 ? 1 : segments - 2;
+
+    ff->segment_length = seg_len;
+    ff->segment_length_mask = seg_len - 1;
+    ff->segment_count = segments;
+    ff->segment_count_length = segments * seg_len;
+    ff->array_length = (segments + 2) * seg_len;
+}
+
+static int cmp_u64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+static size_t sort_unique(uint64_t* v, size_t n) {
+    if (n == 0) return 0;
+    qsort(v, n, sizeof(uint64_t), cmp_u64);
+    size_t out = 1;
+    for (size_t i = 1; i < n; i++) {
+        if (v[i] != v[out - 1]) v[out++] = v[i];
+    }
+    return out;
+}
+
+/**
+ * Construcción sobre los hash64 de las claves (keys se reordena si hay
+ * repetidos). Cada posición guarda cuántas claves la usan (count >> 2), en
+ * qué índice 0..2 (count & 3, XOR acumulado) y el XOR de sus hashes: cuando
+ * queda una sola clave, t2hash es exactamente esa clave. Las claves se
+ * reparten antes por segmento inicial para que el recorrido sea secuencial
+ * en memoria.
+ */
+static BloomDBError fuse_populate(BloomDBFuse* ff, uint64_t* keys, size_t size) {
+    const uint32_t capacity = ff->array_length;
+
+    uint64_t* reverse_order = calloc(size + 1, sizeof(uint64_t));
+    uint8_t* reverse_h = malloc(size ? size : 1);
+    uint32_t* alone = malloc((size_t)capacity * sizeof(uint32_t));
+    uint8_t* t2count = calloc(capacity, 1);
+    uint64_t* t2hash = calloc(capacity, sizeof(uint64_t));
+
+    uint32_t block_bits = 1;
+    while ((1u << block_bits) < ff->segment_count) block_bits++;
+    const uint32_t block = 1u << block_bits;
+    uint32_t* start_pos = malloc(block * sizeof(uint32_t));
+
+    BloomDBError err = BLOOMDB_OK;
+    if (!reverse_order || !reverse_h || !alone || !t2count || !t2hash || !start_pos) {
+        err = BLOOMDB_ERR_ALLOC;
+        goto done;
+    }
+
+    uint64_t rng = 0x726b2b9d438b9d4dULL;
+    size_t stack_size = 0;
+
+    for (int loop = 0;; loop++) {
+        if (loop == FUSE_MAX_ITERATIONS) {
+            err = BLOOMDB_ERR_INTERNAL;
+            goto done;
+        }
+        ff->fuse_seed = splitmix64(&rng);
+        reverse_order[size] = 1;   // centinela: el reparto nunca pasa del final
+
+        // Reparto por segmento inicial (bits altos del hash)
+        for (uint32_t i = 0; i < block; i++) {
+            start_pos[i] = (uint32_t)(((uint64_t)i * size) >> block_bits);
+        }
+        for (size_t i = 0; i < size; i++) {
+            uint64_t h = fuse_mix(keys[i] + ff->fuse_seed);
+            uint64_t seg = h >> (64 - block_bits);
+            while (reverse_order[start_pos[seg]] != 0) seg = (seg + 1) & (block - 1);
+            reverse_order[start_pos[seg]++] = h;
+        }
+
+        bool failed = false;
+        size_t duplicates = 0;
+        for (size_t i = 0; i < size; i++) {
+            uint64_t h = reverse_order[i];
+            uint32_t p0 = fuse_position(ff, h, 0);
+            uint32_t p1 = fuse_position(ff, h, 1);
+            uint32_t p2 = fuse_position(ff, h, 2);
+            t2count[p0] += 4;
+            t2hash[p0] ^= h;
+            t2count[p1] += 4;
+            t2count[p1] ^= 1;
+            t2hash[p1] ^= h;
+            t2count[p2] += 4;
+            t2count[p2] ^= 2;
+            t2hash[p2] ^= h;
+
+            // Dos veces el mismo hash: se deshace la segunda para no
+            // bloquear el peeling
+            if ((t2hash[p0] & t2hash[p1] & t2hash[p2]) == 0 &&
+                ((t2hash[p0] == 0 && t2count[p0] == 8) ||
+                 (t2hash[p1] == 0 && t2count[p1] == 8) ||
+                 (t2hash[p2] == 0 && t2count[p2] == 8))) {
+                duplicates++;
+                t2count[p0] -= 4;
+                t2hash[p0] ^= h;
+                t2count[p1] -= 4;
+                t2count[p1] ^= 1;
+                t2hash[p1] ^= h;
+                t2count[p2] -= 4;
+                t2count[p2] ^= 2;
+                t2hash[p2] ^= h;
+            }
+            // El contador de 6 bits desbordó: demasiadas claves en una posición
+            failed |= t2count[p0] < 4 || t2count[p1] < 4 || t2count[p2] < 4;
+        }
+
+        if (!failed) {
+            // Peeling: se sacan las posiciones con una sola clave
+            uint32_t qsize = 0;
+            for (uint32_t i = 0; i < capacity; i++) {
+                alone[qsize] = i;
+                qsize += (t2count[i] >> 2) == 1;
+            }
+            stack_size = 0;
+            while (qsize > 0) {
+                uint32_t index = alone[--qsize];
+                if ((t2count[index] >> 2) != 1) continue;
+
+                uint64_t h = t2hash[index];
+                uint8_t found = t2count[index] & 3;
+                uint32_t p[5];
+                p[0] = fuse_position(ff, h, 0);
+                p[1] = fuse_position(ff, h, 1);
+                p[2] = fuse_position(ff, h, 2);
+                p[3] = p[0];
+                p[4] = p[1];
+                reverse_h[stack_size] = found;
+                reverse_order[stack_size++] = h;
+
+                for (int j = 1; j <= 2; j++) {
+                    uint32_t other = p[found + j];
+                    alone[qsize] = other;
+                    qsize += (t2count[other] >> 2) == 2;
+                    t2count[other] -= 4;
+                    t2count[other] ^= (uint8_t)((found + j) % 3);
+                    t2hash[other] ^= h;
+                }
+            }
+            if (stack_size + duplicates == size) break;
+            if (duplicates > 0) size = sort_unique(keys, size);
+        }
+
+        memset(reverse_order, 0, size * sizeof(uint64_t));
+        memset(t2count, 0, capacity);
+        memset(t2hash, 0, (size_t)capacity * sizeof(uint64_t));
+    }
+
+    // Asignación en orden inverso al peeling: la posición libre de cada
+    // clave se fija de forma que el XOR de sus tres huellas sea su huella
+    for (size_t i = stack_size; i-- > 0;) {
+        uint64_t h = reverse_order[i];
+        uint8_t found = reverse_h[i];
+        uint32_t p[5];
+        p[0] = fuse_position(ff, h, 0);
+        p[1] = fuse_position(ff, h, 1);
+        p[2] = fuse_position(ff, h, 2);
+        p[3] = p[0];
+        p[4] = p[1];
+        ff->fingerprints[p[found]] = fuse_fingerprint(h) ^ ff->fingerprints[p[found + 1]] ^
+                                     ff->fingerprints[p[found + 2]];
+    }
+    ff->key_count = stack_size;
+
+done:
+    free(reverse_order);
+    free(reverse_h);
+    free(alone);
+    free(t2count);
+    free(t2hash);
+    free(start_pos);
+    return err;
+}
+
+// ============================================================================
+// API PÚBLICA - Extended (error explícito)
+// ============================================================================
+
+BloomDBError bloomdb_fuse_build_ex(const void* const* keys, const size_t* lens, size_t n, uint64_t seed,
+                                   BloomDBFuse** out_ff) {
+    if (!out_ff) return BLOOMDB_ERR_INVALID_ARGUMENT;
+    if (n > BLOOMDB_FUSE_MAX_KEYS || (n > 0 && (!keys || !lens))) return BLOOMDB_ERR_INVALID_ARGUMENT;
+    for (size_t i = 0; i < n; i++) {
+        if (!keys[i] || lens[i] == 0) return BLOOMDB_ERR_INVALID_ARGUMENT;
+    }
+
+    BloomDBFuse* ff = calloc(1, sizeof(BloomDBFuse));
+    if (!ff) return BLOOMDB_ERR_ALLOC;
+    ff->seed = seed;
+    fuse_layout(ff, n);
+
+    ff->fingerprints = calloc(ff->array_length, 1);
+    uint64_t* hashes = malloc((n ? n : 1) * sizeof(uint64_t));
+    if (!ff->fingerprints || !hashes) {
+        free(hashes);
+        bloomdb_fuse_free(ff);
+        return BLOOMDB_ERR_ALLOC;
+    }
+
+    // hash64(k) == hash128(k).h1: se hashea por grupos con el kernel multi-clave
+    hash128_t h[64];
+    for (size_t base = 0; base < n; base += 64) {
+        size_t g = n - base < 64 ? n - base : 64;
+        hash128_many(keys + base, lens + base, g, seed, h);
+        for (size_t j = 0; j < g; j++) hashes[base + j] = h[j].h1;
+    }
+
+    BloomDBError err = fuse_populate(ff, hashes, n);
+    free(hashes);
+    if (err != BLOOMDB_OK) {
+        bloomdb_fuse_free(ff);
+        return err;
+    }
+
+    *out_ff = ff;
+    return BLOOMDB_OK;
+}
+
+BloomDBError bloomdb_fuse_might_contain_ex(const BloomDBFuse* ff, const void* key, size_t len, bool* out_result) {
+    if (!ff || !key || len == 0 || !out_result) return BLOOMDB_ERR_INVALID_ARGUMENT;
+
+    uint64_t h = fuse_mix(hash64(key, len, ff->seed) + ff->fuse_seed);
+    uint8_t f = fuse_fingerprint(h);
+    f ^= ff->fingerprints[fuse_position(ff, h, 0)];
+    f ^= ff->fingerprints[fuse_position(ff, h, 1)];
+    f ^= ff->fingerprints[fuse_position(ff, h, 2)];
+    *out_result = f == 0;
+    return BLOOMDB_OK;
+}
+
+// ============================================================================
+// API PÚBLICA - Simple (wrappers sobre _ex)
+// ============================================================================
+
+BloomDBFuse* bloomdb_fuse_build(const void* const* keys, const size_t* lens, size_t n, uint64_t seed) {
+    BloomDBFuse* ff = NULL;
+    if (bloomdb_fuse_build_ex(keys, lens, n, seed, &ff) != BLOOMDB_OK) {
+        return NULL;
+    }
+    return ff;
+}
+
+void bloomdb_fuse_free(BloomDBFuse* ff) {
+    if (!ff) return;
+    free(ff->fingerprints);
+    free(ff);
+}
+
+bool bloomdb_fuse_might_contain(const BloomDBFuse* ff, const void* key, size_t len) {
+    bool result = false;
+    if (bloomdb_fuse_might_contain_ex(ff, key, len, &result) != BLOOMDB_OK) {
+        return false;
+    }
+    return result;
+}
+
+size_t bloomdb_fuse_size_bytes(const BloomDBFuse* ff) {
+    return ff ? ff->array_length : 0;
+}
@@ -0,0 +1,121 @@
+#include "bloom_partitioned.h"
+#include "hash64.h"
+#include <stdlib.h>
+
+// ============================================================================
+// INTERNAS
+// ============================================================================
+
+/**
+ * Posición global del bit de la sonda i: partición i, desplazamiento
+ * (h1 + i*h2) & (slice_bits - 1). Calcula n posiciones a partir de la sonda
+ * first antes de tocar memoria, para que las cargas no dependan unas de otras.
+ */
+static inline void partition_positions(const BloomDBPartitioned* pf, hash128_t h, int first, int n, size_t* pos) {
+    const uint64_t mask = pf->slice_bits - 1;
+    uint64_t x = h.h1 + (uint64_t)first * h.h2;
+    size_t base = (size_t)first * pf->slice_bits;
+    for (int i = 0; i < n; i++, x += h.h2, base += pf->slice_bits) {
+        pos[i] = base + (size_t)(x & mask);
+    }
+}
+
+// ============================================================================
+// API PÚBLICA - Extended (error explícito)
+// ============================================================================
+
+BloomDBError bloomdb_partitioned_create_ex(size_t bits, int num_hashes, uint64_t seed, BloomDBPartitioned** out_pf) {
+    if (!out_pf) return BLOOMDB_ERR_INVALID_ARGUMENT;
+    if (bits == 0 || num_hashes <= 0 || num_hashes > BLOOMDB_PARTITIONED_MAX_HASHES) {
+        return BLOOMDB_ERR_INVALID_ARGUMENT;
+    }
+
+    // Partición = menor potencia de 2 (>= 64) que cubre bits / k
+    size_t per_slice = (bits + (size_t)num_hashes - 1) / (size_t)num_hashes;
+    size_t slice_bits = 64;
+    while (slice_bits < per_slice) {
+        if (slice_bits > SIZE_MAX / 2 / BLOOMDB_PARTITIONED_MAX_HASHES) return BLOOMDB_ERR_INVALID_ARGUMENT;
+        slice_bits <<= 1;
+    }
+
+    BloomDBPartitioned* pf = malloc(sizeof(BloomDBPartitioned));
+    if (!pf) return BLOOMDB_ERR_ALLOC;
+
+    pf->slice_bits = slice_bits;
+    pf->bit_count = slice_bits * (size_t)num_hashes;
+    pf->num_hashes = num_hashes;
+    pf->seed = seed;
+
+    pf->words = calloc(pf->bit_count / 64, sizeof(uint64_t));
+    if (!pf->words) {
+        free(pf);
+        return BLOOMDB_ERR_ALLOC;
+    }
+
+    *out_pf = pf;
+    return BLOOMDB_OK;
+}
+
+BloomDBError bloomdb_partitioned_insert_ex(BloomDBPartitioned* pf, const void* key, size_t len) {
+    if (!pf || !key || len == 0) return BLOOMDB_ERR_INVALID_ARGUMENT;
+
+    size_t pos[BLOOMDB_PARTITIONED_MAX_HASHES];
+    partition_positions(pf, hash128(key, len, pf->seed), 0, pf->num_hashes, pos);
+    for (int i = 0; i < pf->num_hashes; i++) {
+        pf->words[pos[i] >> 6] |= 1ULL << (pos[i] & 63);
+    }
+    return BLOOMDB_OK;
+}
+
+BloomDBError bloomdb_partitioned_might_contain_ex(const BloomDBPartitioned* pf, const void* key, size_t len, bool* out_result) {
+    if (!pf || !key || len == 0 || !out_result) return BLOOMDB_ERR_INVALID_ARGUMENT;
+
+    hash128_t h = hash128(key, len, pf->seed);
+
+    // Grupos de 4 sondas sin ramas, salida temprana entre grupos (igual que
+    // los kernels de BloomDB): las claves ausentes suelen descartarse en el
+    // primer grupo sin calcular las demás posiciones
+    for (int i = 0; i < pf->num_hashes; i += 4) {
+        const int n = pf->num_hashes - i < 4 ? pf->num_hashes - i : 4;
+        size_t pos[4];
+        partition_positions(pf, h, i, n, pos);
+        uint64_t all = 1;
+        for (int j = 0; j < n; j++) all &= pf->words[pos[j] >> 6] >> (pos[j] & 63);
+        if (!(all & 1)) {
+            *out_result = false;
+            return BLOOMDB_OK;
+        }
+    }
+    *out_result = true;
+    return BLOOMDB_OK;
+}
+
+// ============================================================================
+// API PÚBLICA - Simple (wrappers sobre _ex)
+// ============================================================================
+
+BloomDBPartitioned* bloomdb_partitioned_create(size_t bits, int num_hashes, uint64_t seed) {
+    BloomDBPartitioned* pf = NULL;
+    if (bloomdb_partitioned_create_ex(bits, num_hashes, seed, &pf) != BLOOMDB_OK) {
+        return NULL;
+    }
+    return pf;
+}
+
+void bloomdb_partitioned_free(BloomDBPartitioned* pf) {
+    if (!pf) return;
+    free(pf->words);
+    free(pf);
+}
+
+bool bloomdb_partitioned_insert(BloomDBPartitioned* pf, const void* key, size_t len) {
+    return bloomdb_partitioned_insert_ex(pf, key, len) == BLOOMDB_OK;
+}
+
+bool bloomdb_partitioned_might_contain(const BloomDBPartitioned* pf, const void* key, size_t len) {
+    bool result = false;
+    if (bloomdb_partitioned_might_contain_ex(pf, key, len, &result) != BLOOMDB_OK) {
+        return false;
+    }
+    return result;
+}
@@ -0,0 +1,155 @@
+#include "bloom_range.h"
+#include <stdlib.h>
+
+// ============================================================================
+// INTERNAS
+// ============================================================================
+
+typedef struct {
+    const BloomDBRange* rf;
+    int budget;           //sondas que quedan en esta consulta
+} RangeProbe;
+
+// Máscara de los bits bajos de un intervalo del nivel l (tamaño 2^l - 1)
+static inline uint64_t span_mask(int level) {
+    return level >= 64 ? UINT64_MAX : (1ULL << level) - 1;
+}
+
+static bool probe(RangeProbe* rp, uint64_t prefix, int level) {
+    bool hit = false;
+    rp->budget--;
+    bloomdb_might_contain_u128_ex(rp->rf->db, prefix, (uint64_t)level, &hit);
+    return hit;
+}
+
+/**
+ * Confirma un prefijo positivo bajando por sus hijos hasta el nivel 0: una
+ * clave real tiene todos sus prefijos, así que algún hijo debe dar positivo
+ * en cada nivel. Primero en profundidad; un rango con claves se confirma
+ * en ~2 sondas por nivel, y las ramas falsas mueren en cuanto falla una.
+ */
+static bool descend(RangeProbe* rp, uint64_t prefix, int level) {
+    if (level == 0) return true;
+    // Se recorren los dos hijos por su bit: con un contador, prefix << 1 | 1
+    // == UINT64_MAX desbordaría y seguiría por la clave 0
+    for (int b = 0; b < 2; b++) {
+        uint64_t child = prefix << 1 | (uint64_t)b;
+        if (rp->budget <= 0) return true;
+        if (probe(rp, child, level - 1) && descend(rp, child, level - 1)) return true;
+    }
+    return false;
+}
+
+static bool check_interval(RangeProbe* rp, uint64_t prefix, int level) {
+    if (rp->budget <= 0) return true;
+    return probe(rp, prefix, level) && descend(rp, prefix, level);
+}
+
+// Descomposición diádica de [lo, hi] de izquierda a derecha
+static bool range_hit(const BloomDBRange* rf, uint64_t lo, uint64_t hi) {
+    RangeProbe rp = { rf, BLOOMDB_RANGE_MAX_PROBES };
+    const int top = rf->levels - 1;
+
+    for (;;) {
+        // Mayor intervalo alineado que empieza en lo y no pasa de hi
+        int level = lo ? __builtin_ctzll(lo) : 64;
+        while (level > 0 && hi - lo < span_mask(level)) level--;
+
+        if (level <= top) {
+            if (check_interval(&rp, lo >> level, level)) return true;
+        } else {
+            // Más ancho que el nivel superior: sus 2^(level - top) trozos
+            int extra = level - top;
+            if (extra >= 31 || (1 << extra) > rp.budget) return true;
+            uint64_t first = lo >> top;
+            for (uint64_t i = 0; i < (1ULL << extra); i++) {
+                if (check_interval(&rp, first + i, top)) return true;
+            }
+        }
+
+        uint64_t last = lo + span_mask(level);
+        if (last >= hi) return false;
+        lo = last + 1;
+    }
+}
+
+// ============================================================================
+// API PÚBLICA - Extended (error explícito)
+// ============================================================================
+
+BloomDBError bloomdb_range_create_ex(size_t bits, int num_hashes, int levels, uint64_t seed, BloomDBRange** out_rf) {
+    if (!out_rf) return BLOOMDB_ERR_INVALID_ARGUMENT;
+    if (levels <= 0 || levels > BLOOMDB_RANGE_MAX_LEVELS) return BLOOMDB_ERR_INVALID_ARGUMENT;
+
+    BloomDBRange* rf = calloc(1, sizeof(BloomDBRange));
+    if (!rf) return BLOOMDB_ERR_ALLOC;
+
+    BloomDBError err = bloomdb_create_ex(bits, num_hashes, seed, &rf->db);
+    if (err != BLOOMDB_OK) {
+        free(rf);
+        return err;
+    }
+    rf->levels = levels;
+
+    *out_rf = rf;
+    return BLOOMDB_OK;
+}
+
+BloomDBError bloomdb_range_insert_ex(BloomDBRange* rf, uint64_t key) {
+    if (!rf) return BLOOMDB_ERR_INVALID_ARGUMENT;
+    for (int level = 0; level < rf->levels; level++) {
+        BloomDBError err = bloomdb_insert_u128_ex(rf->db, key >> level, (uint64_t)level);
+        if (err != BLOOMDB_OK) return err;
+    }
+    rf->count++;
+    return BLOOMDB_OK;
+}
+
+BloomDBError bloomdb_range_might_contain_ex(const BloomDBRange* rf, uint64_t key, bool* out_result) {
+    if (!rf || !out_result) return BLOOMDB_ERR_INVALID_ARGUMENT;
+    return bloomdb_might_contain_u128_ex(rf->db, key, 0, out_result);
+}
+
+BloomDBError bloomdb_range_might_contain_range_ex(const BloomDBRange* rf, uint64_t lo, uint64_t hi, bool* out_result) {
+    if (!rf || !out_result || lo > hi) return BLOOMDB_ERR_INVALID_ARGUMENT;
+    *out_result = range_hit(rf, lo, hi);
+    return BLOOMDB_OK;
+}
+
+// ============================================================================
+// API PÚBLICA - Simple (wrappers sobre _ex)
+// ============================================================================
+
+BloomDBRange* bloomdb_range_create(size_t bits, int num_hashes, int levels, uint64_t seed) {
+    BloomDBRange* rf = NULL;
+    if (bloomdb_range_create_ex(bits, num_hashes, levels, seed, &rf) != BLOOMDB_OK) {
+        return NULL;
+    }
+    return rf;
+}
+
+void bloomdb_range_free(BloomDBRange* rf) {
+    if (!rf) return;
+    bloomdb_free(rf->db);
+    free(rf);
+}
+
+bool bloomdb_range_insert(BloomDBRange* rf, uint64_t key) {
+    return bloomdb_range_insert_ex(rf, key) == BLOOMDB_OK;
+}
+
+bool bloomdb_range_might_contain(const BloomDBRange* rf, uint64_t key) {
+    bool result = false;
+    if (bloomdb_range_might_contain_ex(rf, key, &result) != BLOOMDB_OK) {
+        return false;
+    }
+    return result;
+}
+
+bool bloomdb_range_might_contain_range(const BloomDBRange* rf, uint64_t lo, uint64_t hi) {
+    bool result = false;
+    if (bloomdb_range_might_contain_range_ex(rf, lo, hi, &result) != BLOOMDB_OK) {
+        return false;
+    }
+    return result;
+}
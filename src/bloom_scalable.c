@@ -0,0 +1,156 @@
+#include "bloom_scalable.h"
+#include <stdlib.h>
+#include <math.h>
+
+// ============================================================================
+// INTERNAS
+// ============================================================================
+
+// Error objetivo de la slice i: fpr * (1 - r) * r^i (serie geométrica < fpr)
+static double slice_error(const BloomDBScalable* sf, size_t i) {
+    return sf->fpr * (1.0 - BLOOMDB_SCALABLE_TIGHTENING) * pow(BLOOMDB_SCALABLE_TIGHTENING, (double)i);
+}
+
+static double slice_capacity(const BloomDBScalable* sf, size_t i) {
+    return (double)sf->initial_capacity * pow(BLOOMDB_SCALABLE_GROWTH, (double)i);
+}
+
+/**
+ * Añade la slice siguiente, dimensionada para su capacidad y error:
+ * m = n * ln(1/p) / ln(2)^2, k = ceil(log2(1/p)). Al 50% de ocupación su
+ * FPR es 0.5^k <= p, lo que ocurre hacia su capacidad nominal.
+ */
+static BloomDBError add_slice(BloomDBScalable* sf) {
+    if (sf->slice_count == BLOOMDB_SCALABLE_MAX_SLICES) return BLOOMDB_ERR_ALLOC;
+
+    double p = slice_error(sf, sf->slice_count);
+    double n = slice_capacity(sf, sf->slice_count);
+    double bits = ceil(n * -log(p) / (M_LN2 * M_LN2));
+    if (bits < 64) bits = 64;
+    if (bits > (double)(SIZE_MAX / 2)) return BLOOMDB_ERR_ALLOC;
+    int k = (int)ceil(-log2(p));
+    if (k < 1) k = 1;
+
+    BloomDB* db = NULL;
+    BloomDBError err = bloomdb_create_ex((size_t)bits, k, sf->seed, &db);
+    if (err != BLOOMDB_OK) return err;
+
+    sf->slices[sf->slice_count++] = db;
+    sf->inserted = 0;
+    sf->next_check = 0;   // la primera inserción programa el primer control
+    return BLOOMDB_OK;
+}
+
+/**
+ * La slice activa llegó a su punto de control: se mide la ocupación real
+ * (las claves repetidas no ponen bits, así que contar inserciones no basta).
+ * Si aún no llega al umbral, el siguiente control se programa a mitad de
+ * las inserciones que faltan según 1 - e^(-k*n/m), con un paso mínimo de
+ * 1/1024 de la capacidad: O(log) popcounts por slice y la slice se cierra
+ * a lo sumo un 0.1% de claves después del umbral.
+ */
+static BloomDBError check_fill(BloomDBScalable* sf) {
+    const BloomDB* db = sf->slices[sf->slice_count - 1];
+    double fill = (double)bloomdb_count_set_bits(db) / (double)db->bit_count;
+    if (fill >= BLOOMDB_SCALABLE_FILL) return add_slice(sf);
+
+    double per_key = (double)db->num_hashes / (double)db->bit_count;
+    double remaining = (log(1.0 - fill) - log(1.0 - BLOOMDB_SCALABLE_FILL)) / per_key;
+    double min_step = slice_capacity(sf, sf->slice_count - 1) / 1024;
+    double step = remaining / 2 > min_step ? remaining / 2 : min_step;
+    sf->next_check = sf->inserted + (step > 1.0 ? (uint64_t)step : 1);
+    return BLOOMDB_OK;
+}
+
+// ============================================================================
+// API PÚBLICA - Extended (error explícito)
+// ============================================================================
+
+BloomDBError bloomdb_scalable_create_ex(size_t initial_capacity, double fpr, uint64_t seed, BloomDBScalable** out_sf) {
+    if (!out_sf) return BLOOMDB_ERR_INVALID_ARGUMENT;
+    if (initial_capacity == 0 || !(fpr > 0.0 && fpr < 1.0)) return BLOOMDB_ERR_INVALID_ARGUMENT;
+
+    BloomDBScalable* sf = calloc(1, sizeof(BloomDBScalable));
+    if (!sf) return BLOOMDB_ERR_ALLOC;
+
+    sf->initial_capacity = initial_capacity;
+    sf->fpr = fpr;
+    sf->seed = seed;
+
+    BloomDBError err = add_slice(sf);
+    if (err != BLOOMDB_OK) {
+        free(sf);
+        return err;
+    }
+
+    *out_sf = sf;
+    return BLOOMDB_OK;
+}
+
+BloomDBError bloomdb_scalable_insert_ex(BloomDBScalable* sf, const void* key, size_t len) {
+    if (!sf || !key || len == 0) return BLOOMDB_ERR_INVALID_ARGUMENT;
+
+    if (sf->inserted >= sf->next_check) {
+        BloomDBError err = check_fill(sf);
+        if (err != BLOOMDB_OK) return err;
+    }
+
+    BloomDBDigest d = bloomdb_hash(sf->seed, key, len);
+    BloomDBError err = bloomdb_insert_digest_ex(sf->slices[sf->slice_count - 1], &d);
+    if (err != BLOOMDB_OK) return err;
+    sf->inserted++;
+    return BLOOMDB_OK;
+}
+
+BloomDBError bloomdb_scalable_might_contain_ex(const BloomDBScalable* sf, const void* key, size_t len, bool* out_result) {
+    if (!sf || !key || len == 0 || !out_result) return BLOOMDB_ERR_INVALID_ARGUMENT;
+
+    // Un hash por clave; las slices nuevas son las más grandes y las que
+    // tienen las claves recientes, así que se miran primero
+    BloomDBDigest d = bloomdb_hash(sf->seed, key, len);
+    for (size_t i = sf->slice_count; i-- > 0;) {
+        if (bloomdb_might_contain_digest(sf->slices[i], &d)) {
+            *out_result = true;
+            return BLOOMDB_OK;
+        }
+    }
+    *out_result = false;
+    return BLOOMDB_OK;
+}
+
+// ============================================================================
+// API PÚBLICA - Simple (wrappers sobre _ex)
+// ============================================================================
+
+BloomDBScalable* bloomdb_scalable_create(size_t initial_capacity, double fpr, uint64_t seed) {
+    BloomDBScalable* sf = NULL;
+    if (bloomdb_scalable_create_ex(initial_capacity, fpr, seed, &sf) != BLOOMDB_OK) {
+        return NULL;
+    }
+    return sf;
+}
+
+void bloomdb_scalable_free(BloomDBScalable* sf) {
+    if (!sf) return;
+    for (size_t i = 0; i < sf->slice_count; i++) bloomdb_free(sf->slices[i]);
+    free(sf);
+}
+
+bool bloomdb_scalable_insert(BloomDBScalable* sf, const void* key, size_t len) {
+    return bloomdb_scalable_insert_ex(sf, key, len) == BLOOMDB_OK;
+}
+
+bool bloomdb_scalable_might_contain(const BloomDBScalable* sf, const void* key, size_t len) {
+    bool result = false;
+    if (bloomdb_scalable_might_contain_ex(sf, key, len, &result) != BLOOMDB_OK) {
+        return false;
+    }
+    return result;
+}
+
+double bloomdb_scalable_fpr_bound(const BloomDBScalable* sf) {
+    if (!sf) return 0.0;
+    double sum = 0.0;
+    for (size_t i = 0; i < sf->slice_count; i++) sum += slice_error(sf, i);
+    return sum;
+}
@@ -0,0 +1,147 @@
+#include "bloom_split.h"
+#include "hash64.h"
+#include "bloomdb_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef BLOOMDB_HAVE_X86
+#include <immintrin.h>
+#endif
+
+// ============================================================================
+// INTERNAS
+// ============================================================================
+
+// Sales por palabra (las mismas constantes impares que el SBBF de Parquet)
+static const uint32_t SPLIT_SALT[BLOOMDB_SPLIT_BLOCK_WORDS] = {
+    0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+    0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U
+};
+
+/**
+ * Máscara de la clave dentro de su bloque.
+ * h1 elige el bloque (fastrange) y los 32 bits bajos de h2, multiplicados por
+ * la sal de cada palabra, dan en sus 5 bits altos la posición dentro de ella.
+ */
+static inline void split_mask(uint32_t key32, uint32_t mask[BLOOMDB_SPLIT_BLOCK_WORDS]) {
+    for (int w = 0; w < BLOOMDB_SPLIT_BLOCK_WORDS; w++) {
+        mask[w] = 1U << ((key32 * SPLIT_SALT[w]) >> 27);
+    }
+}
+
+void split_insert_scalar(uint32_t* b, uint32_t key32) {
+    uint32_t mask[BLOOMDB_SPLIT_BLOCK_WORDS];
+    split_mask(key32, mask);
+    for (int w = 0; w < BLOOMDB_SPLIT_BLOCK_WORDS; w++) b[w] |= mask[w];
+}
+
+bool split_query_scalar(const uint32_t* b, uint32_t key32) {
+    uint32_t mask[BLOOMDB_SPLIT_BLOCK_WORDS];
+    split_mask(key32, mask);
+
+    // Sin ramas: se acumulan los bits que faltan de las 8 palabras
+    uint32_t missing = 0;
+    for (int w = 0; w < BLOOMDB_SPLIT_BLOCK_WORDS; w++) missing |= mask[w] & ~b[w];
+    return missing == 0;
+}
+
+#ifdef BLOOMDB_HAVE_X86
+
+__attribute__((target("avx2")))
+static inline __m256i split_mask_avx2(uint32_t key32) {
+    const __m256i salt = _mm256_loadu_si256((const __m256i*)SPLIT_SALT);
+    __m256i x = _mm256_mullo_epi32(_mm256_set1_epi32((int)key32), salt);
+    x = _mm256_srli_epi32(x, 27);
+    return _mm256_sllv_epi32(_mm256_set1_epi32(1), x);
+}
+
+__attribute__((target("avx2")))
+void split_insert_avx2(uint32_t* b, uint32_t key32) {
+    __m256i* p = (__m256i*)b;
+    _mm256_store_si256(p, _mm256_or_si256(_mm256_load_si256(p), split_mask_avx2(key32)));
+}
+
+__attribute__((target("avx2")))
+bool split_query_avx2(const uint32_t* b, uint32_t key32) {
+    // testc: (~bloque & máscara) == 0
+    return _mm256_testc_si256(_mm256_load_si256((const __m256i*)b), split_mask_avx2(key32)) != 0;
+}
+
+#endif
+
+// ============================================================================
+// API PÚBLICA - Extended (error explícito)
+// ============================================================================
+
+BloomDBError bloomdb_split_create_ex(size_t bits, uint64_t seed, BloomDBSplit** out_sf) {
+    if (!out_sf) return BLOOMDB_ERR_INVALID_ARGUMENT;
+    if (bits == 0) return BLOOMDB_ERR_INVALID_ARGUMENT;
+
+    size_t block_count = (bits + BLOOMDB_SPLIT_BLOCK_BITS - 1) / BLOOMDB_SPLIT_BLOCK_BITS;
+    if (block_count > SIZE_MAX / 32 - 1) return BLOOMDB_ERR_INVALID_ARGUMENT;
+
+    BloomDBSplit* sf = malloc(sizeof(BloomDBSplit));
+    if (!sf) return BLOOMDB_ERR_ALLOC;
+
+    // calloc + alineado manual, igual que el filtro bloqueado
+    sf->alloc = calloc(block_count * 32 + 31, 1);
+    if (!sf->alloc) {
+        free(sf);
+        return BLOOMDB_ERR_ALLOC;
+    }
+    sf->blocks = (uint32_t*)(((uintptr_t)sf->alloc + 31) & ~(uintptr_t)31);
+    sf->block_count = block_count;
+    sf->bit_count = block_count * BLOOMDB_SPLIT_BLOCK_BITS;
+    sf->seed = seed;
+
+    *out_sf = sf;
+    return BLOOMDB_OK;
+}
+
+BloomDBError bloomdb_split_insert_ex(BloomDBSplit* sf, const void* key, size_t len) {
+    if (!sf || !key || len == 0) return BLOOMDB_ERR_INVALID_ARGUMENT;
+
+    hash128_t h = hash128(key, len, sf->seed);
+    size_t block = fastrange64(h.h1, sf->block_count);
+    bloomdb_kernels.split_insert(sf->blocks + block * BLOOMDB_SPLIT_BLOCK_WORDS, (uint32_t)h.h2);
+    return BLOOMDB_OK;
+}
+
+BloomDBError bloomdb_split_might_contain_ex(const BloomDBSplit* sf, const void* key, size_t len, bool* out_result) {
+    if (!sf || !key || len == 0 || !out_result) return BLOOMDB_ERR_INVALID_ARGUMENT;
+
+    hash128_t h = hash128(key, len, sf->seed);
+    size_t block = fastrange64(h.h1, sf->block_count);
+    *out_result = bloomdb_kernels.split_query(sf->blocks + block * BLOOMDB_SPLIT_BLOCK_WORDS, (uint32_t)h.h2);
+    return BLOOMDB_OK;
+}
+
+// ============================================================================
+// API PÚBLICA - Simple (wrappers sobre _ex)
+// ============================================================================
+
+BloomDBSplit* bloomdb_split_create(size_t bits, uint64_t seed) {
+    BloomDBSplit* sf = NULL;
+    if (bloomdb_split_create_ex(bits, seed, &sf) != BLOOMDB_OK) {
+        return NULL;
+    }
+    return sf;
+}
+
+void bloomdb_split_free(BloomDBSplit* sf) {
+    if (!sf) return;
+    free(sf->alloc);
+    free(sf);
+}
+
+bool bloomdb_split_insert(BloomDBSplit* sf, const void* key, size_t len) {
+    return bloomdb_split_insert_ex(sf, key, len) == BLOOMDB_OK;
+}
+
+bool bloomdb_split_might_contain(const BloomDBSplit* sf, const void* key, size_t len) {
+    bool result = false;
+    if (bloomdb_split_might_contain_ex(sf, key, len, &result) != BLOOMDB_OK) {
+        return false;
+    }
+    return result;
+}
@@ -0,0 +1,167 @@
+#include "bloom_windowed.h"
+#include "bitarray.h"
+#include "hash64.h"
+#include "bloomdb_internal.h"
+#include <stdlib.h>
+
+// ============================================================================
+// INTERNAS
+// ============================================================================
+
+// Posición de la sonda: mismo doble hashing y reducción que BloomDB
+static inline size_t lane_index(const BloomDBWindowed* wf, uint64_t h) {
+    if (wf->index_mode == BLOOMDB_INDEX_MASK) return (size_t)(h & (wf->positions - 1));
+    return fastrange64(h, wf->positions);
+}
+
+// Los carriles nunca cruzan un byte (W divide a 8)
+static inline unsigned lane_get(const BloomDBWindowed* wf, size_t p) {
+    size_t bit = p * (size_t)wf->lane_bits;
+    return (unsigned)(wf->lanes[bit >> 3] >> (bit & 7));
+}
+
+static inline void lane_set(BloomDBWindowed* wf, size_t p) {
+    size_t bit = p * (size_t)wf->lane_bits + (size_t)wf->current;
+    wf->lanes[bit >> 3] |= (uint8_t)(1u << (bit & 7));
+}
+
+static inline unsigned generations_mask(const BloomDBWindowed* wf) {
+    return (1u << wf->generations) - 1;
+}
+
+/**
+ * Generaciones que contienen todas las sondas (AND de los k carriles).
+ * Grupos de 4 sondas sin ramas con salida temprana entre grupos, igual que
+ * los kernels de BloomDB.
+ */
+static unsigned present_in(const BloomDBWindowed* wf, hash128_t h) {
+    unsigned acc = generations_mask(wf);
+    uint64_t x = h.h1;
+    for (int i = 0; i < wf->num_hashes; i += 4) {
+        const int n = wf->num_hashes - i < 4 ? wf->num_hashes - i : 4;
+        for (int j = 0; j < n; j++, x += h.h2) acc &= lane_get(wf, lane_index(wf, x));
+        if (!acc) return 0;
+    }
+    return acc;
+}
+
+static void insert_hashed(BloomDBWindowed* wf, hash128_t h) {
+    uint64_t x = h.h1;
+    for (int i = 0; i < wf->num_hashes; i++, x += h.h2) lane_set(wf, lane_index(wf, x));
+}
+
+// ============================================================================
+// API PÚBLICA - Extended (error explícito)
+// ============================================================================
+
+BloomDBError bloomdb_windowed_create_ex(size_t bits, int num_hashes, int generations, uint64_t seed,
+                                        BloomDBWindowed** out_wf) {
+    if (!out_wf) return BLOOMDB_ERR_INVALID_ARGUMENT;
+    if (bits == 0 || bits > SIZE_MAX / 8 || num_hashes <= 0 ||
+        generations <= 0 || generations > BLOOMDB_WINDOWED_MAX_GENERATIONS) {
+        return BLOOMDB_ERR_INVALID_ARGUMENT;
+    }
+
+    BloomDBWindowed* wf = calloc(1, sizeof(BloomDBWindowed));
+    if (!wf) return BLOOMDB_ERR_ALLOC;
+
+    int w = 1;
+    while (w < generations) w <<= 1;
+
+    wf->positions = bits;
+    wf->lane_bits = w;
+    wf->byte_count = (bits * (size_t)w + 7) / 8;
+    wf->generations = generations;
+    wf->num_hashes = num_hashes;
+    wf->seed = seed;
+    wf->index_mode = (bits & (bits - 1)) == 0 ? BLOOMDB_INDEX_MASK : BLOOMDB_INDEX_FASTRANGE;
+
+    wf->lanes = calloc(wf->byte_count, 1);
+    if (!wf->lanes) {
+        free(wf);
+        return BLOOMDB_ERR_ALLOC;
+    }
+
+    *out_wf = wf;
+    return BLOOMDB_OK;
+}
+
+BloomDBError bloomdb_windowed_insert_ex(BloomDBWindowed* wf, const void* key, size_t len) {
+    if (!wf || !key || len == 0) return BLOOMDB_ERR_INVALID_ARGUMENT;
+    insert_hashed(wf, hash128(key, len, wf->seed));
+    return BLOOMDB_OK;
+}
+
+BloomDBError bloomdb_windowed_might_contain_ex(const BloomDBWindowed* wf, const void* key, size_t len, bool* out_result) {
+    if (!wf || !key || len == 0 || !out_result) return BLOOMDB_ERR_INVALID_ARGUMENT;
+    *out_result = present_in(wf, hash128(key, len, wf->seed)) != 0;
+    return BLOOMDB_OK;
+}
+
+BloomDBError bloomdb_windowed_test_and_insert_ex(BloomDBWindowed* wf, const void* key, size_t len, bool* out_seen) {
+    if (!wf || !key || len == 0 || !out_seen) return BLOOMDB_ERR_INVALID_ARGUMENT;
+
+    hash128_t h = hash128(key, len, wf->seed);
+    // Si ya está en la generación actual no hace falta escribir: las
+    // claves repetidas dentro de una generación solo leen
+    unsigned gens = present_in(wf, h);
+    *out_seen = gens != 0;
+    if (!(gens & (1u << wf->current))) insert_hashed(wf, h);
+    return BLOOMDB_OK;
+}
+
+BloomDBError bloomdb_windowed_rotate_ex(BloomDBWindowed* wf) {
+    if (!wf) return BLOOMDB_ERR_INVALID_ARGUMENT;
+
+    wf->current = (wf->current + 1) % wf->generations;
+
+    // Máscara con el bit de la nueva generación a 0 en cada carril del byte
+    uint8_t clear = 0;
+    for (int shift = wf->current; shift < 8; shift += wf->lane_bits) clear |= (uint8_t)(1u << shift);
+    bitarray_and_mask(wf->lanes, (uint8_t)~clear, wf->byte_count);
+
+    wf->rotations++;
+    return BLOOMDB_OK;
+}
+
+// ============================================================================
+// API PÚBLICA - Simple (wrappers sobre _ex)
+// ============================================================================
+
+BloomDBWindowed* bloomdb_windowed_create(size_t bits, int num_hashes, int generations, uint64_t seed) {
+    BloomDBWindowed* wf = NULL;
+    if (bloomdb_windowed_create_ex(bits, num_hashes, generations, seed, &wf) != BLOOMDB_OK) {
+        return NULL;
+    }
+    return wf;
+}
+
+void bloomdb_windowed_free(BloomDBWindowed* wf) {
+    if (!wf) return;
+    free(wf->lanes);
+    free(wf);
+}
+
+bool bloomdb_windowed_insert(BloomDBWindowed* wf, const void* key, size_t len) {
+    return bloomdb_windowed_insert_ex(wf, key, len) == BLOOMDB_OK;
+}
+
+bool bloomdb_windowed_might_contain(const BloomDBWindowed* wf, const void* key, size_t len) {
+    bool result = false;
+    if (bloomdb_windowed_might_contain_ex(wf, key, len, &result) != BLOOMDB_OK) {
+        return false;
+    }
+    return result;
+}
+
+bool bloomdb_windowed_test_and_insert(BloomDBWindowed* wf, const void* key, size_t len) {
+    bool seen = false;
+    if (bloomdb_windowed_test_and_insert_ex(wf, key, len, &seen) != BLOOMDB_OK) {
+        return false;
+    }
+    return seen;
+}
+
+bool bloomdb_windowed_rotate(BloomDBWindowed* wf) {
+    return bloomdb_windowed_rotate_ex(wf) == BLOOMDB_OK;
+}
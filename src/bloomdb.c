@@ -1,21 +1,25 @@
 #include "bloomdb.h"
+#include "hash64.h"
+#include "bloomdb_internal.h"
+#include "bitarray.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <sys/mman.h>
 
 // ============================================================================
 // INTERNAS (no forman parte de la API).
 // ============================================================================
 
 /**
- * Hash simple de 64 bits.
+ * Hash byte a byte original (BLOOMDB_HASH_LEGACY).
  *
  * Nota:
- * - Este hash NO ES seguro criptográficamente.
- * - El objetivo es velocidad y buena distribución para Bloom Filters.
- * - Más adelante mi idea es reemplazarlo por xxHash o Murmur3.
+ * - Solo se conserva para que los filtros guardados antes de MurmurHash3
+ *   sigan respondiendo igual al cargarlos.
+ * - Los filtros nuevos usan hash128() (ver hash64.c).
  */
-static uint64_t hash_function(const void* key, size_t len, uint64_t seed) {
+static uint64_t legacy_hash_function(const void* key, size_t len, uint64_t seed) {
     const uint8_t* data = (const uint8_t*)key;
     uint64_t hash = seed;
 
@@ -28,15 +32,41 @@ static uint64_t hash_function(const void* key, size_t len, uint64_t seed) {
 }
 
 /**
- * Deriva el índice de bit para el hash número hash_num.
- * Implementa doble hashing: h(i) = h1 + i*h2.
+ * Índice de bit legacy para el hash número hash_num.
+ * Recorre la clave dos veces por sonda: h(i) = h1 + i*h2(i).
  */
-static size_t get_bit_index(const BloomDB* db, const void* key, size_t len, int hash_num) {
-    uint64_t h1 = hash_function(key, len, db->seed);
-    uint64_t h2 = hash_function(key, len, db->seed + hash_num + 1);
+static size_t legacy_bit_index(const BloomDB* db, const void* key, size_t len, int hash_num) {
+    uint64_t h1 = legacy_hash_function(key, len, db->seed);
+    uint64_t h2 = legacy_hash_function(key, len, db->seed + hash_num + 1);
     return (h1 + (uint64_t)hash_num * h2) % db->bit_count;
 }
 
+/**
+ * Reduce un hash de 64 bits a [0, bit_count).
+ * - MASK: potencias de 2, un AND.
+ * - FASTRANGE: multiply-shift de Lemire, usa los bits altos del hash.
+ * - MODULO: la división original; solo para filtros guardados con ella.
+ */
+static inline size_t reduce_index(const BloomDB* db, uint64_t h) {
+    switch (db->index_mode) {
+        case BLOOMDB_INDEX_MASK:
+            return (size_t)(h & (db->bit_count - 1));
+        case BLOOMDB_INDEX_FASTRANGE:
+            return fastrange64(h, db->bit_count);
+        default:
+            return (size_t)(h % db->bit_count);
+    }
+}
+
+/**
+ * Deriva el índice de bit para la sonda i a partir del digest de la clave.
+ * Implementa doble hashing (Kirsch-Mitzenmacher): h(i) = h1 + i*h2.
+ * La clave se hashea una sola vez por operación.
+ */
+static inline size_t get_bit_index(const BloomDB* db, hash128_t h, int i) {
+    return reduce_index(db, h.h1 + (uint64_t)i * h.h2);
+}
+
 // Manipulación de bits (estas funciones son intencionalmente pequeñas)
 static inline void set_bit(uint8_t* arr, size_t bit) {
     arr[bit >> 3] |= (1 << (bit & 7));
@@ -46,6 +76,242 @@ static inline bool get_bit(const uint8_t* arr, size_t bit) {
     return (arr[bit >> 3] & (1 << (bit & 7))) != 0;
 }
 
+/**
+ * Modo concurrente (bloomdb_set_concurrent_ex): los bits se escriben con
+ * fetch-or atómico y se leen con cargas atómicas relaxed, ambos sobre
+ * palabras de 64 bits. create_ex redondea el bitarray a múltiplo de 8 bytes
+ * para que la última palabra también sea del filtro.
+ *
+ * En little-endian el bit b es el bit (b & 63) de la palabra b >> 6, así que
+ * el layout en bytes no cambia; en big-endian se usan atómicos de byte.
+ */
+typedef uint64_t __attribute__((may_alias)) bloom_word_t;
+
+static inline void atomic_set_bit(uint8_t* arr, size_t bit) {
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    __atomic_fetch_or((bloom_word_t*)arr + (bit >> 6), (uint64_t)1 << (bit & 63), __ATOMIC_RELAXED);
+#else
+    __atomic_fetch_or(arr + (bit >> 3), (uint8_t)(1 << (bit & 7)), __ATOMIC_RELAXED);
+#endif
+}
+
+static inline bool atomic_get_bit(const uint8_t* arr, size_t bit) {
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    return (__atomic_load_n((const bloom_word_t*)arr + (bit >> 6), __ATOMIC_RELAXED) >> (bit & 63)) & 1;
+#else
+    return (__atomic_load_n(arr + (bit >> 3), __ATOMIC_RELAXED) >> (bit & 7)) & 1;
+#endif
+}
+
+// Acceso a un bit del filtro según el modo; atomic es constante en los kernels
+static inline void store_bit(uint8_t* arr, size_t bit, bool atomic) {
+    if (atomic) atomic_set_bit(arr, bit);
+    else set_bit(arr, bit);
+}
+
+static inline bool load_bit(const uint8_t* arr, size_t bit, bool atomic) {
+    return atomic ? atomic_get_bit(arr, bit) : get_bit(arr, bit);
+}
+
+/**
+ * Marca la página del bit en db->dirty (bloomdb_track_dirty_ex). En modo
+ * concurrente se lee antes la palabra: casi siempre la página ya está
+ * marcada y así no se pide la línea en exclusiva en cada inserción.
+ */
+static inline void mark_dirty(BloomDB* db, size_t bit, bool atomic) {
+    const size_t page = bit >> (3 + BLOOMDB_DIRTY_PAGE_SHIFT);
+    uint64_t* w = db->dirty + (page >> 6);
+    const uint64_t m = (uint64_t)1 << (page & 63);
+    if (!atomic) {
+        *w |= m;
+    } else if (!(__atomic_load_n(w, __ATOMIC_RELAXED) & m)) {
+        __atomic_fetch_or(w, m, __ATOMIC_RELAXED);
+    }
+}
+
+// ============================================================================
+// Kernels de sondas por k
+//
+// Con k conocido en compilación el compilador desenrolla el bucle: los k
+// índices se calculan primero (h1 + i*h2 incremental, con la reducción
+// elegida fuera del bucle) y después se tocan los bits. La consulta va por
+// grupos de 4 sondas: dentro de un grupo las cargas salen a la vez y se
+// combinan con AND sin ramas; entre grupos hay una salida temprana, así una
+// clave ausente suele costar un solo grupo y el salto solo se evalúa cada 4
+// sondas.
+// ============================================================================
+
+#define BLOOMDB_MAX_SPECIALIZED_K 16
+
+static inline __attribute__((always_inline))
+void probe_indices(const BloomDB* db, uint64_t h1, uint64_t h2, int k, size_t* idx) {
+    uint64_t h = h1;
+    switch (db->index_mode) {
+        case BLOOMDB_INDEX_MASK: {
+            const uint64_t mask = db->bit_count - 1;
+            for (int i = 0; i < k; i++, h += h2) idx[i] = (size_t)(h & mask);
+            break;
+        }
+        case BLOOMDB_INDEX_FASTRANGE:
+            for (int i = 0; i < k; i++, h += h2) idx[i] = fastrange64(h, db->bit_count);
+            break;
+        default:
+            for (int i = 0; i < k; i++, h += h2) idx[i] = (size_t)(h % db->bit_count);
+            break;
+    }
+}
+
+static inline __attribute__((always_inline))
+void probe_insert_k(BloomDB* db, uint64_t h1, uint64_t h2, int k, bool atomic, bool tracked) {
+    size_t idx[BLOOMDB_MAX_SPECIALIZED_K];
+    probe_indices(db, h1, h2, k, idx);
+    for (int i = 0; i < k; i++) store_bit(db->bitarray, idx[i], atomic);
+    if (tracked) {
+        for (int i = 0; i < k; i++) mark_dirty(db, idx[i], atomic);
+    }
+}
+
+static inline __attribute__((always_inline))
+bool probe_query_k(const BloomDB* db, uint64_t h1, uint64_t h2, int k, bool atomic) {
+    // Grupos de 4 sondas combinados con AND, sin ramas dentro del grupo.
+    // Entre grupos se sale si ya falta un bit: con el filtro a media
+    // ocupación casi todas las claves ausentes se descartan en el primero
+    // sin calcular ni cargar las demás sondas.
+    uint64_t h = h1;
+    for (int i = 0; i < k; i += 4) {
+        const int n = k - i < 4 ? k - i : 4;
+        size_t idx[4];
+        probe_indices(db, h, h2, n, idx);
+        h += (uint64_t)n * h2;
+
+        unsigned all = 1;
+        for (int j = 0; j < n; j++) all &= load_bit(db->bitarray, idx[j], atomic);
+        if (!(all & 1)) return false;
+    }
+    return true;
+}
+
+// Cada k tiene su par normal y su par concurrente (atómicos), más la
+// inserción que marca páginas sucias de cada uno
+#define DEFINE_PROBE_KERNELS(K)                                              \
+    static void probe_insert_##K(BloomDB* db, uint64_t h1, uint64_t h2) {    \
+        probe_insert_k(db, h1, h2, K, false, false);                         \
+    }                                                                        \
+    static void probe_insert_tracked_##K(BloomDB* db, uint64_t h1, uint64_t h2) { \
+        probe_insert_k(db, h1, h2, K, false, true);                          \
+    }                                                                        \
+    static bool probe_query_##K(const BloomDB* db, uint64_t h1, uint64_t h2) { \
+        return probe_query_k(db, h1, h2, K, false);                          \
+    }                                                                        \
+    static void probe_insert_atomic_##K(BloomDB* db, uint64_t h1, uint64_t h2) { \
+        probe_insert_k(db, h1, h2, K, true, false);                          \
+    }                                                                        \
+    static void probe_insert_tracked_atomic_##K(BloomDB* db, uint64_t h1, uint64_t h2) { \
+        probe_insert_k(db, h1, h2, K, true, true);                           \
+    }                                                                        \
+    static bool probe_query_atomic_##K(const BloomDB* db, uint64_t h1, uint64_t h2) { \
+        return probe_query_k(db, h1, h2, K, true);                           \
+    }
+
+DEFINE_PROBE_KERNELS(1)
+DEFINE_PROBE_KERNELS(2)
+DEFINE_PROBE_KERNELS(3)
+DEFINE_PROBE_KERNELS(4)
+DEFINE_PROBE_KERNELS(5)
+DEFINE_PROBE_KERNELS(6)
+DEFINE_PROBE_KERNELS(7)
+DEFINE_PROBE_KERNELS(8)
+DEFINE_PROBE_KERNELS(9)
+DEFINE_PROBE_KERNELS(10)
+DEFINE_PROBE_KERNELS(11)
+DEFINE_PROBE_KERNELS(12)
+DEFINE_PROBE_KERNELS(13)
+DEFINE_PROBE_KERNELS(14)
+DEFINE_PROBE_KERNELS(15)
+DEFINE_PROBE_KERNELS(16)
+
+// k > 16: bucle genérico con salida temprana
+static inline __attribute__((always_inline))
+void probe_insert_loop(BloomDB* db, uint64_t h1, uint64_t h2, bool atomic, bool tracked) {
+    hash128_t h = { h1, h2 };
+    for (int i = 0; i < db->num_hashes; i++) {
+        const size_t bit = get_bit_index(db, h, i);
+        store_bit(db->bitarray, bit, atomic);
+        if (tracked) mark_dirty(db, bit, atomic);
+    }
+}
+
+static inline __attribute__((always_inline))
+bool probe_query_loop(const BloomDB* db, uint64_t h1, uint64_t h2, bool atomic) {
+    hash128_t h = { h1, h2 };
+    for (int i = 0; i < db->num_hashes; i++) {
+        if (!load_bit(db->bitarray, get_bit_index(db, h, i), atomic)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void probe_insert_generic(BloomDB* db, uint64_t h1, uint64_t h2) {
+    probe_insert_loop(db, h1, h2, false, false);
+}
+
+static void probe_insert_tracked_generic(BloomDB* db, uint64_t h1, uint64_t h2) {
+    probe_insert_loop(db, h1, h2, false, true);
+}
+
+static bool probe_query_generic(const BloomDB* db, uint64_t h1, uint64_t h2) {
+    return probe_query_loop(db, h1, h2, false);
+}
+
+static void probe_insert_atomic_generic(BloomDB* db, uint64_t h1, uint64_t h2) {
+    probe_insert_loop(db, h1, h2, true, false);
+}
+
+static void probe_insert_tracked_atomic_generic(BloomDB* db, uint64_t h1, uint64_t h2) {
+    probe_insert_loop(db, h1, h2, true, true);
+}
+
+static bool probe_query_atomic_generic(const BloomDB* db, uint64_t h1, uint64_t h2) {
+    return probe_query_loop(db, h1, h2, true);
+}
+
+typedef struct {
+    void (*insert)(BloomDB*, uint64_t, uint64_t);
+    void (*insert_tracked)(BloomDB*, uint64_t, uint64_t);
+    bool (*query)(const BloomDB*, uint64_t, uint64_t);
+} ProbeKernels;
+
+#define PROBE_KERNEL_ENTRY(K) { probe_insert_##K, probe_insert_tracked_##K, probe_query_##K }
+#define PROBE_KERNEL_ENTRY_ATOMIC(K) \
+    { probe_insert_atomic_##K, probe_insert_tracked_atomic_##K, probe_query_atomic_##K }
+
+static const ProbeKernels PROBE_KERNELS[BLOOMDB_MAX_SPECIALIZED_K + 1] = {
+    { probe_insert_generic, probe_insert_tracked_generic, probe_query_generic },
+    PROBE_KERNEL_ENTRY(1),  PROBE_KERNEL_ENTRY(2),  PROBE_KERNEL_ENTRY(3),  PROBE_KERNEL_ENTRY(4),
+    PROBE_KERNEL_ENTRY(5),  PROBE_KERNEL_ENTRY(6),  PROBE_KERNEL_ENTRY(7),  PROBE_KERNEL_ENTRY(8),
+    PROBE_KERNEL_ENTRY(9),  PROBE_KERNEL_ENTRY(10), PROBE_KERNEL_ENTRY(11), PROBE_KERNEL_ENTRY(12),
+    PROBE_KERNEL_ENTRY(13), PROBE_KERNEL_ENTRY(14), PROBE_KERNEL_ENTRY(15), PROBE_KERNEL_ENTRY(16),
+};
+
+static const ProbeKernels PROBE_KERNELS_ATOMIC[BLOOMDB_MAX_SPECIALIZED_K + 1] = {
+    { probe_insert_atomic_generic, probe_insert_tracked_atomic_generic, probe_query_atomic_generic },
+    PROBE_KERNEL_ENTRY_ATOMIC(1),  PROBE_KERNEL_ENTRY_ATOMIC(2),  PROBE_KERNEL_ENTRY_ATOMIC(3),
+    PROBE_KERNEL_ENTRY_ATOMIC(4),  PROBE_KERNEL_ENTRY_ATOMIC(5),  PROBE_KERNEL_ENTRY_ATOMIC(6),
+    PROBE_KERNEL_ENTRY_ATOMIC(7),  PROBE_KERNEL_ENTRY_ATOMIC(8),  PROBE_KERNEL_ENTRY_ATOMIC(9),
+    PROBE_KERNEL_ENTRY_ATOMIC(10), PROBE_KERNEL_ENTRY_ATOMIC(11), PROBE_KERNEL_ENTRY_ATOMIC(12),
+    PROBE_KERNEL_ENTRY_ATOMIC(13), PROBE_KERNEL_ENTRY_ATOMIC(14), PROBE_KERNEL_ENTRY_ATOMIC(15),
+    PROBE_KERNEL_ENTRY_ATOMIC(16),
+};
+
+void bloomdb_select_kernels(BloomDB* db) {
+    int k = db->num_hashes;
+    if (k < 1 || k > BLOOMDB_MAX_SPECIALIZED_K) k = 0;
+    const ProbeKernels* table = db->concurrent ? PROBE_KERNELS_ATOMIC : PROBE_KERNELS;
+    db->probe_insert = db->dirty ? table[k].insert_tracked : table[k].insert;
+    db->probe_query = table[k].query;
+}
+
 // ============================================================================
 // API PÚBLICA - Extended (error explícito)
 // ============================================================================
@@ -64,6 +330,12 @@ const char* bloomdb_strerror(BloomDBError err) {
             return "Invalid file format";
         case BLOOMDB_ERR_INTERNAL:
             return "Internal error";
+        case BLOOMDB_ERR_FULL:
+            return "Filter is full";
+        case BLOOMDB_ERR_READ_ONLY:
+            return "Filter is read-only";
+        case BLOOMDB_ERR_CHECKSUM:
+            return "Checksum mismatch";
         default:
             return "Unknown error";
     }
@@ -80,8 +352,21 @@ BloomDBError bloomdb_create_ex(size_t bits, int num_hashes, uint64_t seed, Bloom
     db->byte_count = (bits + 7) / 8;
     db->num_hashes = num_hashes;
     db->seed = seed;
+    db->hash_algo = BLOOMDB_HASH_MURMUR3;
+    db->index_mode = (bits & (bits - 1)) == 0 ? BLOOMDB_INDEX_MASK : BLOOMDB_INDEX_FASTRANGE;
+    db->concurrent = 0;
+    db->read_only = 0;
+    db->mapping = NULL;
+    db->mapping_size = 0;
+    db->chunk_crcs = NULL;
+    db->chunk_shift = 0;
+    db->dirty = NULL;
+    db->base_lag = NULL;
+    db->delta_lag = NULL;
+    bloomdb_select_kernels(db);
 
-    db->bitarray = calloc(db->byte_count, 1);
+    // Múltiplo de 8 bytes: el modo concurrente trabaja por palabras de 64 bits
+    db->bitarray = calloc((db->byte_count + 7) & ~(size_t)7, 1);
     if (!db->bitarray) {
         free(db);
         return BLOOMDB_ERR_ALLOC;
@@ -91,27 +376,388 @@ BloomDBError bloomdb_create_ex(size_t bits, int num_hashes, uint64_t seed, Bloom
     return BLOOMDB_OK;
 }
 
+bool bloomdb_words_aligned(const BloomDB* db) {
+    if (!db->mapping) return true;   // create_ex: calloc redondeado a 8 bytes
+    size_t offset = (size_t)(db->bitarray - (uint8_t*)db->mapping);
+    return ((uintptr_t)db->bitarray & 7) == 0 &&
+           offset + ((db->byte_count + 7) & ~(size_t)7) <= db->mapping_size;
+}
+
+// Sondas sobre un digest ya calculado (filtros no legacy)
+static inline void insert_hashed(BloomDB* db, hash128_t h) {
+    db->probe_insert(db, h.h1, h.h2);
+}
+
+static inline bool query_hashed(const BloomDB* db, hash128_t h) {
+    return db->probe_query(db, h.h1, h.h2);
+}
+
 BloomDBError bloomdb_insert_ex(BloomDB* db, const void* key, size_t len) {
     if (!db || !key || len == 0) return BLOOMDB_ERR_INVALID_ARGUMENT;
+    if (db->read_only) return BLOOMDB_ERR_READ_ONLY;
 
-    for (int i = 0; i < db->num_hashes; i++) {
-        size_t bit = get_bit_index(db, key, len, i);
-        set_bit(db->bitarray, bit);
+    if (db->hash_algo == BLOOMDB_HASH_LEGACY) {
+        for (int i = 0; i < db->num_hashes; i++) {
+            const size_t bit = legacy_bit_index(db, key, len, i);
+            store_bit(db->bitarray, bit, db->concurrent);
+            if (db->dirty) mark_dirty(db, bit, db->concurrent);
+        }
+        return BLOOMDB_OK;
     }
+
+    insert_hashed(db, hash128(key, len, db->seed));
     return BLOOMDB_OK;
 }
 
 BloomDBError bloomdb_might_contain_ex(const BloomDB* db, const void* key, size_t len, bool* out_result) {
     if (!db || !key || len == 0 || !out_result) return BLOOMDB_ERR_INVALID_ARGUMENT;
 
+    if (db->hash_algo == BLOOMDB_HASH_LEGACY) {
+        for (int i = 0; i < db->num_hashes; i++) {
+            if (!load_bit(db->bitarray, legacy_bit_index(db, key, len, i), db->concurrent)) {
+                *out_result = false;
+                return BLOOMDB_OK;
+            }
+        }
+        *out_result = true;
+        return BLOOMDB_OK;
+    }
+
+    *out_result = query_hashed(db, hash128(key, len, db->seed));
+    return BLOOMDB_OK;
+}
+
+// ============================================================================
+// API PÚBLICA - Filtro completo (popcount / merge por ISA)
+// ============================================================================
+
+size_t bloomdb_count_set_bits(const BloomDB* db) {
+    if (!db) return 0;
+    return bitarray_popcount(db->bitarray, db->byte_count);
+}
+
+BloomDBError bloomdb_merge_ex(BloomDB* dst, const BloomDB* src) {
+    if (!dst || !src) return BLOOMDB_ERR_INVALID_ARGUMENT;
+    if (dst->bit_count != src->bit_count || dst->num_hashes != src->num_hashes ||
+        dst->seed != src->seed || dst->hash_algo != src->hash_algo ||
+        dst->index_mode != src->index_mode) {
+        return BLOOMDB_ERR_INVALID_ARGUMENT;
+    }
+    if (dst->read_only) return BLOOMDB_ERR_READ_ONLY;
+
+    if (dst->dirty) {
+        // Solo las páginas donde src aporta algún bit
+        const size_t pages = bloomdb_page_count(dst);
+        for (size_t p = 0; p < pages; p++) {
+            const size_t start = p << BLOOMDB_DIRTY_PAGE_SHIFT;
+            size_t len = dst->byte_count - start;
+            if (len > BLOOMDB_DIRTY_PAGE_SIZE) len = BLOOMDB_DIRTY_PAGE_SIZE;
+            const uint8_t* page = src->bitarray + start;
+            if (page[0] || memcmp(page, page + 1, len - 1) != 0) {
+                dst->dirty[p >> 6] |= (uint64_t)1 << (p & 63);
+            }
+        }
+    }
+    bitarray_or(dst->bitarray, src->bitarray, dst->byte_count);
+    return BLOOMDB_OK;
+}
+
+// ============================================================================
+// API PÚBLICA - Modo concurrente
+// ============================================================================
+
+BloomDBError bloomdb_set_concurrent_ex(BloomDB* db, bool enabled) {
+    if (!db) return BLOOMDB_ERR_INVALID_ARGUMENT;
+    // Los atómicos van por palabras de 64 bits alineadas
+    if (enabled && !bloomdb_words_aligned(db)) return BLOOMDB_ERR_INVALID_ARGUMENT;
+
+    // Solo cambia los kernels: los bits y el layout son los mismos
+    db->concurrent = enabled ? 1 : 0;
+    bloomdb_select_kernels(db);
+    return BLOOMDB_OK;
+}
+
+// ============================================================================
+// API PÚBLICA - Páginas sucias (guardado incremental)
+// ============================================================================
+
+size_t bloomdb_page_count(const BloomDB* db) {
+    if (!db) return 0;
+    return (db->byte_count + BLOOMDB_DIRTY_PAGE_SIZE - 1) >> BLOOMDB_DIRTY_PAGE_SHIFT;
+}
+
+BloomDBError bloomdb_track_dirty_ex(BloomDB* db, bool enabled) {
+    if (!db) return BLOOMDB_ERR_INVALID_ARGUMENT;
+    if (enabled && db->read_only) return BLOOMDB_ERR_READ_ONLY;
+
+    if (enabled && !db->dirty) {
+        const size_t words = (bloomdb_page_count(db) + 63) / 64;
+        db->dirty = calloc(words, sizeof(uint64_t));
+        if (!db->dirty) return BLOOMDB_ERR_ALLOC;
+    } else if (!enabled) {
+        free(db->dirty);
+        free(db->base_lag);
+        free(db->delta_lag);
+        db->dirty = db->base_lag = db->delta_lag = NULL;
+    }
+    bloomdb_select_kernels(db);
+    return BLOOMDB_OK;
+}
+
+size_t bloomdb_dirty_pages(const BloomDB* db) {
+    if (!db || !db->dirty) return 0;
+    const size_t words = (bloomdb_page_count(db) + 63) / 64;
+    size_t n = 0;
+    for (size_t i = 0; i < words; i++) n += (size_t)__builtin_popcountll(db->dirty[i]);
+    return n;
+}
+
+// ============================================================================
+// API PÚBLICA - Digest (una clave hasheada, muchos filtros)
+// ============================================================================
+
+BloomDBDigest bloomdb_hash(uint64_t seed, const void* key, size_t len) {
+    hash128_t h = hash128(key, len, seed);
+    BloomDBDigest d = { h.h1, h.h2, seed };
+    return d;
+}
+
+/**
+ * Un digest solo sirve para filtros con la misma seed y el hash por digest;
+ * aceptar otro daría falsos negativos silenciosos.
+ */
+static bool digest_matches(const BloomDB* db, const BloomDBDigest* digest) {
+    return db->hash_algo == BLOOMDB_HASH_MURMUR3 && digest->seed == db->seed;
+}
+
+BloomDBError bloomdb_insert_digest_ex(BloomDB* db, const BloomDBDigest* digest) {
+    if (!db || !digest || !digest_matches(db, digest)) return BLOOMDB_ERR_INVALID_ARGUMENT;
+    if (db->read_only) return BLOOMDB_ERR_READ_ONLY;
+
+    hash128_t h = { digest->h1, digest->h2 };
+    insert_hashed(db, h);
+    return BLOOMDB_OK;
+}
+
+BloomDBError bloomdb_might_contain_digest_ex(const BloomDB* db, const BloomDBDigest* digest, bool* out_result) {
+    if (!db || !digest || !out_result || !digest_matches(db, digest)) return BLOOMDB_ERR_INVALID_ARGUMENT;
+
+    hash128_t h = { digest->h1, digest->h2 };
+    *out_result = query_hashed(db, h);
+    return BLOOMDB_OK;
+}
+
+// ============================================================================
+// API PÚBLICA - Batch (prefetch por grupos)
+// ============================================================================
+
+/**
+ * Claves por grupo. Se hashea el grupo entero, se emiten los prefetch de
+ * todas sus sondas y solo después se tocan los bits: los fallos de caché de
+ * las G claves se solapan en lugar de esperarse uno detrás de otro.
+ * 16 claves * k sondas caben de sobra en los buffers de fallos de un core.
+ */
+#define BLOOMDB_BATCH_GROUP 16
+
+// Valida todo el lote antes de tocar el filtro (sin inserciones parciales)
+static bool batch_args_valid(const void* const* keys, const size_t* lens, size_t n) {
+    if (n == 0) return true;
+    if (!keys || !lens) return false;
+    for (size_t i = 0; i < n; i++) {
+        if (!keys[i] || lens[i] == 0) return false;
+    }
+    return true;
+}
+
+static inline void prefetch_probes(const BloomDB* db, hash128_t h, int rw) {
     for (int i = 0; i < db->num_hashes; i++) {
-        size_t bit = get_bit_index(db, key, len, i);
-        if (!get_bit(db->bitarray, bit)) {
-            *out_result = false;
-            return BLOOMDB_OK;
+        const uint8_t* p = db->bitarray + (get_bit_index(db, h, i) >> 3);
+        if (rw) __builtin_prefetch(p, 1, 3);
+        else    __builtin_prefetch(p, 0, 3);
+    }
+}
+
+// Un grupo ya hasheado: prefetch de todas las sondas y luego los bits
+static void insert_group(BloomDB* db, const hash128_t* h, size_t g) {
+    for (size_t j = 0; j < g; j++) prefetch_probes(db, h[j], 1);
+    for (size_t j = 0; j < g; j++) insert_hashed(db, h[j]);
+}
+
+// Resultados del grupo en los bits base..base+g-1 de out_bitmap (ya a cero)
+static void query_group(const BloomDB* db, const hash128_t* h, size_t g,
+                        size_t base, uint8_t* out_bitmap) {
+    if (g == 1) {
+        // Nada con qué solapar: la consulta normal con salida temprana
+        out_bitmap[base >> 3] |= (uint8_t)(query_hashed(db, h[0]) << (base & 7));
+        return;
+    }
+
+    // Etapa 1: solo la primera sonda de cada clave. La mayoría de las
+    // claves ausentes se descartan aquí, igual que con la salida
+    // temprana de query_hashed, sin pagar las k líneas.
+    for (size_t j = 0; j < g; j++) {
+        __builtin_prefetch(db->bitarray + (get_bit_index(db, h[j], 0) >> 3), 0, 3);
+    }
+    unsigned alive = 0;
+    for (size_t j = 0; j < g; j++) {
+        alive |= (unsigned)load_bit(db->bitarray, get_bit_index(db, h[j], 0), db->concurrent) << j;
+    }
+
+    // Etapa 2: las supervivientes piden el resto de sondas a la vez
+    for (unsigned m = alive; m; m &= m - 1) {
+        const hash128_t hj = h[__builtin_ctz(m)];
+        for (int i = 1; i < db->num_hashes; i++) {
+            __builtin_prefetch(db->bitarray + (get_bit_index(db, hj, i) >> 3), 0, 3);
+        }
+    }
+    for (unsigned m = alive; m; m &= m - 1) {
+        size_t j = (size_t)__builtin_ctz(m);
+        unsigned all = 1;
+        for (int i = 1; i < db->num_hashes; i++) {
+            all &= load_bit(db->bitarray, get_bit_index(db, h[j], i), db->concurrent);
+        }
+        out_bitmap[(base + j) >> 3] |= (uint8_t)(all << ((base + j) & 7));
+    }
+}
+
+static inline size_t group_len(size_t n, size_t base) {
+    return n - base < BLOOMDB_BATCH_GROUP ? n - base : BLOOMDB_BATCH_GROUP;
+}
+
+BloomDBError bloomdb_insert_batch_ex(BloomDB* db, const void* const* keys, const size_t* lens, size_t n) {
+    if (!db || !batch_args_valid(keys, lens, n)) return BLOOMDB_ERR_INVALID_ARGUMENT;
+    if (db->read_only) return BLOOMDB_ERR_READ_ONLY;
+
+    if (db->hash_algo == BLOOMDB_HASH_LEGACY) {
+        for (size_t i = 0; i < n; i++) bloomdb_insert_ex(db, keys[i], lens[i]);
+        return BLOOMDB_OK;
+    }
+
+    hash128_t h[BLOOMDB_BATCH_GROUP];
+    for (size_t base = 0; base < n; base += BLOOMDB_BATCH_GROUP) {
+        size_t g = group_len(n, base);
+        hash128_many(keys + base, lens + base, g, db->seed, h);
+        insert_group(db, h, g);
+    }
+    return BLOOMDB_OK;
+}
+
+BloomDBError bloomdb_might_contain_batch_ex(const BloomDB* db, const void* const* keys, const size_t* lens,
+                                            size_t n, uint8_t* out_bitmap) {
+    if (!db || !batch_args_valid(keys, lens, n)) return BLOOMDB_ERR_INVALID_ARGUMENT;
+    if (n == 0) return BLOOMDB_OK;
+    if (!out_bitmap) return BLOOMDB_ERR_INVALID_ARGUMENT;
+
+    memset(out_bitmap, 0, (n + 7) / 8);
+
+    if (db->hash_algo == BLOOMDB_HASH_LEGACY) {
+        for (size_t i = 0; i < n; i++) {
+            bool r = false;
+            bloomdb_might_contain_ex(db, keys[i], lens[i], &r);
+            if (r) set_bit(out_bitmap, i);
+        }
+        return BLOOMDB_OK;
+    }
+
+    hash128_t h[BLOOMDB_BATCH_GROUP];
+    for (size_t base = 0; base < n; base += BLOOMDB_BATCH_GROUP) {
+        size_t g = group_len(n, base);
+        hash128_many(keys + base, lens + base, g, db->seed, h);
+        query_group(db, h, g, base, out_bitmap);
+    }
+    return BLOOMDB_OK;
+}
+
+// ============================================================================
+// API PÚBLICA - Claves enteras
+//
+// El digest de un entero es el de sus bytes en memoria (ver hash128_u64), así
+// que un filtro no necesita recordar con qué API se insertó: bloomdb_insert
+// (&v, 8) y bloomdb_insert_u64(v) ponen los mismos bits.
+// ============================================================================
+
+BloomDBError bloomdb_insert_u64_ex(BloomDB* db, uint64_t value) {
+    if (!db) return BLOOMDB_ERR_INVALID_ARGUMENT;
+    if (db->read_only) return BLOOMDB_ERR_READ_ONLY;
+    if (db->hash_algo == BLOOMDB_HASH_LEGACY) return bloomdb_insert_ex(db, &value, sizeof(value));
+
+    insert_hashed(db, hash128_u64(value, db->seed));
+    return BLOOMDB_OK;
+}
+
+BloomDBError bloomdb_might_contain_u64_ex(const BloomDB* db, uint64_t value, bool* out_result) {
+    if (!db || !out_result) return BLOOMDB_ERR_INVALID_ARGUMENT;
+    if (db->hash_algo == BLOOMDB_HASH_LEGACY) return bloomdb_might_contain_ex(db, &value, sizeof(value), out_result);
+
+    *out_result = query_hashed(db, hash128_u64(value, db->seed));
+    return BLOOMDB_OK;
+}
+
+BloomDBError bloomdb_insert_u128_ex(BloomDB* db, uint64_t lo, uint64_t hi) {
+    if (!db) return BLOOMDB_ERR_INVALID_ARGUMENT;
+    if (db->read_only) return BLOOMDB_ERR_READ_ONLY;
+    if (db->hash_algo == BLOOMDB_HASH_LEGACY) {
+        uint64_t key[2] = { lo, hi };
+        return bloomdb_insert_ex(db, key, sizeof(key));
+    }
+
+    insert_hashed(db, hash128_u128(lo, hi, db->seed));
+    return BLOOMDB_OK;
+}
+
+BloomDBError bloomdb_might_contain_u128_ex(const BloomDB* db, uint64_t lo, uint64_t hi, bool* out_result) {
+    if (!db || !out_result) return BLOOMDB_ERR_INVALID_ARGUMENT;
+    if (db->hash_algo == BLOOMDB_HASH_LEGACY) {
+        uint64_t key[2] = { lo, hi };
+        return bloomdb_might_contain_ex(db, key, sizeof(key), out_result);
+    }
+
+    *out_result = query_hashed(db, hash128_u128(lo, hi, db->seed));
+    return BLOOMDB_OK;
+}
+
+BloomDBError bloomdb_insert_u64_batch_ex(BloomDB* db, const uint64_t* values, size_t n) {
+    if (!db || (n > 0 && !values)) return BLOOMDB_ERR_INVALID_ARGUMENT;
+    if (db->read_only) return BLOOMDB_ERR_READ_ONLY;
+
+    if (db->hash_algo == BLOOMDB_HASH_LEGACY) {
+        for (size_t i = 0; i < n; i++) bloomdb_insert_ex(db, &values[i], sizeof(uint64_t));
+        return BLOOMDB_OK;
+    }
+
+    // hash128_fixed usa el kernel AVX2 de 8 bytes cuando está disponible
+    hash128_t h[BLOOMDB_BATCH_GROUP];
+    for (size_t base = 0; base < n; base += BLOOMDB_BATCH_GROUP) {
+        size_t g = group_len(n, base);
+        hash128_fixed(values + base, sizeof(uint64_t), g, db->seed, h);
+        insert_group(db, h, g);
+    }
+    return BLOOMDB_OK;
+}
+
+BloomDBError bloomdb_might_contain_u64_batch_ex(const BloomDB* db, const uint64_t* values, size_t n,
+                                                uint8_t* out_bitmap) {
+    if (!db || (n > 0 && !values)) return BLOOMDB_ERR_INVALID_ARGUMENT;
+    if (n == 0) return BLOOMDB_OK;
+    if (!out_bitmap) return BLOOMDB_ERR_INVALID_ARGUMENT;
+
+    memset(out_bitmap, 0, (n + 7) / 8);
+
+    if (db->hash_algo == BLOOMDB_HASH_LEGACY) {
+        for (size_t i = 0; i < n; i++) {
+            bool r = false;
+            bloomdb_might_contain_ex(db, &values[i], sizeof(uint64_t), &r);
+            if (r) set_bit(out_bitmap, i);
         }
+        return BLOOMDB_OK;
+    }
+
+    hash128_t h[BLOOMDB_BATCH_GROUP];
+    for (size_t base = 0; base < n; base += BLOOMDB_BATCH_GROUP) {
+        size_t g = group_len(n, base);
+        hash128_fixed(values + base, sizeof(uint64_t), g, db->seed, h);
+        query_group(db, h, g, base, out_bitmap);
     }
-    *out_result = true;
     return BLOOMDB_OK;
 }
 
@@ -129,7 +775,11 @@ BloomDB* bloomdb_create(size_t bits, int num_hashes, uint64_t seed) {
 
 void bloomdb_free(BloomDB* db) {
     if (!db) return;
-    free(db->bitarray);
+    if (db->mapping) bloomdb_unmap(db);
+    else free(db->bitarray);
+    free(db->dirty);
+    free(db->base_lag);
+    free(db->delta_lag);
     free(db);
 }
 
@@ -144,3 +794,68 @@ bool bloomdb_might_contain(const BloomDB* db, const void* key, size_t len) {
     }
     return result;
 }
+
+bool bloomdb_insert_digest(BloomDB* db, const BloomDBDigest* digest) {
+    return bloomdb_insert_digest_ex(db, digest) == BLOOMDB_OK;
+}
+
+bool bloomdb_might_contain_digest(const BloomDB* db, const BloomDBDigest* digest) {
+    bool result = false;
+    if (bloomdb_might_contain_digest_ex(db, digest, &result) != BLOOMDB_OK) {
+        return false;
+    }
+    return result;
+}
+
+bool bloomdb_insert_batch(BloomDB* db, const void* const* keys, const size_t* lens, size_t n) {
+    return bloomdb_insert_batch_ex(db, keys, lens, n) == BLOOMDB_OK;
+}
+
+bool bloomdb_might_contain_batch(const BloomDB* db, const void* const* keys, const size_t* lens,
+                                 size_t n, uint8_t* out_bitmap) {
+    return bloomdb_might_contain_batch_ex(db, keys, lens, n, out_bitmap) == BLOOMDB_OK;
+}
+
+bool bloomdb_insert_u64(BloomDB* db, uint64_t value) {
+    return bloomdb_insert_u64_ex(db, value) == BLOOMDB_OK;
+}
+
+bool bloomdb_might_contain_u64(const BloomDB* db, uint64_t value) {
+    bool result = false;
+    if (bloomdb_might_contain_u64_ex(db, value, &result) != BLOOMDB_OK) {
+        return false;
+    }
+    return result;
+}
+
+bool bloomdb_insert_u128(BloomDB* db, uint64_t lo, uint64_t hi) {
+    return bloomdb_insert_u128_ex(db, lo, hi) == BLOOMDB_OK;
+}
+
+bool bloomdb_might_contain_u128(const BloomDB* db, uint64_t lo, uint64_t hi) {
+    bool result = false;
+    if (bloomdb_might_contain_u128_ex(db, lo, hi, &result) != BLOOMDB_OK) {
+        return false;
+    }
+    return result;
+}
+
+bool bloomdb_insert_u64_batch(BloomDB* db, const uint64_t* values, size_t n) {
+    return bloomdb_insert_u64_batch_ex(db, values, n) == BLOOMDB_OK;
+}
+
+bool bloomdb_might_contain_u64_batch(const BloomDB* db, const uint64_t* values, size_t n, uint8_t* out_bitmap) {
+    return bloomdb_might_contain_u64_batch_ex(db, values, n, out_bitmap) == BLOOMDB_OK;
+}
+
+bool bloomdb_set_concurrent(BloomDB* db, bool enabled) {
+    return bloomdb_set_concurrent_ex(db, enabled) == BLOOMDB_OK;
+}
+
+bool bloomdb_track_dirty(BloomDB* db, bool enabled) {
+    return bloomdb_track_dirty_ex(db, enabled) == BLOOMDB_OK;
+}
+
+bool bloomdb_merge(BloomDB* dst, const BloomDB* src) {
+    return bloomdb_merge_ex(dst, src) == BLOOMDB_OK;
+}
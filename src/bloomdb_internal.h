@@ -0,0 +1,128 @@
+#ifndef BLOOMDB_INTERNAL_H
+#define BLOOMDB_INTERNAL_H
+
+// ============================================================================
+// Utilidades internas compartidas por los filtros (no forman parte de la API).
+// ============================================================================
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "hash64.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define BLOOMDB_HAVE_X86 1
+#endif
+
+// Parte alta de a*b (128 bits)
+static inline uint64_t mulhi64(uint64_t a, uint64_t b) {
+#ifdef __SIZEOF_INT128__
+    return (uint64_t)(((unsigned __int128)a * b) >> 64);
+#else
+    uint64_t a_lo = (uint32_t)a, a_hi = a >> 32;
+    uint64_t b_lo = (uint32_t)b, b_hi = b >> 32;
+    uint64_t lo_lo = a_lo * b_lo;
+    uint64_t hi_lo = a_hi * b_lo;
+    uint64_t lo_hi = a_lo * b_hi;
+    uint64_t cross = (lo_lo >> 32) + (uint32_t)hi_lo + lo_hi;
+    return a_hi * b_hi + (hi_lo >> 32) + (cross >> 32);
+#endif
+}
+
+// Reducción de Lemire: mapea h uniformemente a [0, n) sin dividir
+static inline size_t fastrange64(uint64_t h, size_t n) {
+    return (size_t)mulhi64(h, (uint64_t)n);
+}
+
+// Enteros little-endian de anchura fija (formatos en disco, independientes
+// de la CPU)
+static inline void put_le32(uint8_t* p, uint32_t v) {
+    for (int i = 0; i < 4; i++) p[i] = (uint8_t)(v >> (8 * i));
+}
+
+static inline void put_le64(uint8_t* p, uint64_t v) {
+    for (int i = 0; i < 8; i++) p[i] = (uint8_t)(v >> (8 * i));
+}
+
+static inline uint32_t get_le32(const uint8_t* p) {
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+static inline uint64_t get_le64(const uint8_t* p) {
+    return (uint64_t)get_le32(p) | (uint64_t)get_le32(p + 4) << 32;
+}
+
+// Elige los kernels de sondas de un filtro según su num_hashes (bloomdb.c)
+struct BloomDB;
+void bloomdb_select_kernels(struct BloomDB* db);
+
+// ¿Se puede trabajar por palabras de 64 bits (modo concurrente)? Siempre en
+// el heap; en un archivo mapeado depende del desplazamiento del bitarray.
+bool bloomdb_words_aligned(const struct BloomDB* db);
+
+// Deshace el mapeo de bloomdb_open_mmap; en un mapeo v2 escribible antes
+// deja la tabla de CRC al día y quita la marca de CRC atrasados (storage.c)
+void bloomdb_unmap(struct BloomDB* db);
+
+// ============================================================================
+// Tabla de kernels por ISA (dispatch.c)
+//
+// Cada kernel caliente tiene una variante escalar y, en x86, variantes
+// compiladas con target("..."), así que la librería no necesita -march.
+// dispatch.c rellena la tabla al cargar la librería con la mejor ISA que
+// soporta la CPU; bloomdb_set_isa() la puede bajar (tests, benchmarks).
+// Todas las variantes de un kernel dan resultados idénticos bit a bit.
+// ============================================================================
+
+typedef struct {
+    void (*hash_many)(const void* const* keys, const size_t* lens, size_t n,
+                      uint64_t seed, hash128_t* out);
+    void (*hash_fixed)(const void* keys, size_t key_len, size_t n,
+                       uint64_t seed, hash128_t* out);
+    void (*split_insert)(uint32_t* block, uint32_t key32);
+    bool (*split_query)(const uint32_t* block, uint32_t key32);
+    size_t (*popcount)(const uint8_t* data, size_t nbytes);
+    void (*merge_or)(uint8_t* dst, const uint8_t* src, size_t nbytes);
+    void (*and_mask)(uint8_t* arr, uint8_t mask, size_t nbytes);
+    uint32_t (*crc32c)(uint32_t crc, const uint8_t* data, size_t nbytes);   // estado crudo, sin invertir
+} BloomDBKernels;
+
+extern BloomDBKernels bloomdb_kernels;
+
+// hash64.c
+void hash128_many_scalar(const void* const* keys, const size_t* lens, size_t n, uint64_t seed, hash128_t* out);
+void hash128_fixed_scalar(const void* keys, size_t key_len, size_t n, uint64_t seed, hash128_t* out);
+
+// bloom_split.c
+void split_insert_scalar(uint32_t* block, uint32_t key32);
+bool split_query_scalar(const uint32_t* block, uint32_t key32);
+
+// bitarray.c
+size_t bitarray_popcount_scalar(const uint8_t* data, size_t nbytes);
+void bitarray_or_scalar(uint8_t* dst, const uint8_t* src, size_t nbytes);
+void bitarray_and_mask_scalar(uint8_t* arr, uint8_t mask, size_t nbytes);
+
+// crc32c.c
+uint32_t crc32c_scalar(uint32_t crc, const uint8_t* data, size_t nbytes);
+
+#ifdef BLOOMDB_HAVE_X86
+void hash128_many_avx2(const void* const* keys, const size_t* lens, size_t n, uint64_t seed, hash128_t* out);
+void hash128_fixed_avx2(const void* keys, size_t key_len, size_t n, uint64_t seed, hash128_t* out);
+void hash128_fixed_avx512(const void* keys, size_t key_len, size_t n, uint64_t seed, hash128_t* out);
+
+void split_insert_avx2(uint32_t* block, uint32_t key32);
+bool split_query_avx2(const uint32_t* block, uint32_t key32);
+
+size_t bitarray_popcount_popcnt(const uint8_t* data, size_t nbytes);
+size_t bitarray_popcount_avx2(const uint8_t* data, size_t nbytes);
+size_t bitarray_popcount_avx512(const uint8_t* data, size_t nbytes);
+void bitarray_or_avx2(uint8_t* dst, const uint8_t* src, size_t nbytes);
+void bitarray_or_avx512(uint8_t* dst, const uint8_t* src, size_t nbytes);
+void bitarray_and_mask_avx2(uint8_t* arr, uint8_t mask, size_t nbytes);
+void bitarray_and_mask_avx512(uint8_t* arr, uint8_t mask, size_t nbytes);
+
+uint32_t crc32c_sse42(uint32_t crc, const uint8_t* data, size_t nbytes);
+#endif
+
+#endif
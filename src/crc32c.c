@@ -0,0 +1,145 @@
+#include "crc32c.h"
+#include <string.h>
+
+#include "bloomdb_internal.h"
+
+#ifdef BLOOMDB_HAVE_X86
+#include <immintrin.h>
+#endif
+
+// ============================================================================
+// CRC32C
+//
+// Los kernels trabajan con el estado crudo (sin las inversiones inicial y
+// final), que es lineal: crc(A || B) = shift(crc(A), |B|) ^ crc_0(B), donde
+// shift aplica |B| bytes a cero. La variante SSE4.2 lo usa para llevar tres
+// flujos independientes a la vez (la instrucción crc32 tiene latencia 3 y
+// rendimiento 1) y combinarlos al final de cada tramo.
+// ============================================================================
+
+#define CRC32C_POLY 0x82f63b78u   // 0x1EDC6F41 reflejado
+
+#define CRC32C_LONG  8192         // tramos de los tres flujos
+#define CRC32C_SHORT 256
+
+static uint32_t crc_table[8][256];           // slicing-by-8
+static uint32_t crc_long_shift[4][256];      // aplicar CRC32C_LONG bytes a cero
+static uint32_t crc_short_shift[4][256];     // aplicar CRC32C_SHORT bytes a cero
+
+// Matriz 32x32 sobre GF(2) por vector
+static uint32_t gf2_times(const uint32_t* mat, uint32_t vec) {
+    uint32_t sum = 0;
+    for (; vec; vec >>= 1, mat++) {
+        if (vec & 1) sum ^= *mat;
+    }
+    return sum;
+}
+
+static void gf2_square(uint32_t* square, const uint32_t* mat) {
+    for (int n = 0; n < 32; n++) square[n] = gf2_times(mat, mat[n]);
+}
+
+// Operador que aplica len bytes a cero a un estado (cuadrados sucesivos del
+// operador de un bit, como crc32_combine de zlib)
+static void zeros_operator(uint32_t* even, size_t len) {
+    uint32_t odd[32];
+    odd[0] = CRC32C_POLY;
+    for (int n = 1; n < 32; n++) odd[n] = 1u << (n - 1);
+
+    gf2_square(even, odd);   // 2 bits a cero
+    gf2_square(odd, even);   // 4 bits a cero
+    for (;;) {
+        gf2_square(even, odd);   // 1 byte, 4 bytes, ...
+        len >>= 1;
+        if (len == 0) return;
+        gf2_square(odd, even);
+        len >>= 1;
+        if (len == 0) break;
+    }
+    memcpy(even, odd, sizeof(odd));
+}
+
+// El operador por bytes, en cuatro tablas de 256 entradas
+static void build_shift_table(uint32_t table[4][256], size_t len) {
+    uint32_t op[32];
+    zeros_operator(op, len);
+    for (uint32_t n = 0; n < 256; n++) {
+        for (int b = 0; b < 4; b++) table[b][n] = gf2_times(op, n << (8 * b));
+    }
+}
+
+__attribute__((constructor))
+static void crc32c_init(void) {
+    for (uint32_t n = 0; n < 256; n++) {
+        uint32_t crc = n;
+        for (int b = 0; b < 8; b++) crc = (crc >> 1) ^ (CRC32C_POLY & (0u - (crc & 1)));
+        crc_table[0][n] = crc;
+    }
+    for (uint32_t n = 0; n < 256; n++) {
+        for (int t = 1; t < 8; t++) {
+            crc_table[t][n] = (crc_table[t - 1][n] >> 8) ^ crc_table[0][crc_table[t - 1][n] & 0xff];
+        }
+    }
+    build_shift_table(crc_long_shift, CRC32C_LONG);
+    build_shift_table(crc_short_shift, CRC32C_SHORT);
+}
+
+uint32_t crc32c_scalar(uint32_t crc, const uint8_t* p, size_t n) {
+    for (; n >= 8; n -= 8, p += 8) {
+        uint32_t lo = crc ^ ((uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24);
+        crc = crc_table[7][lo & 0xff] ^ crc_table[6][(lo >> 8) & 0xff] ^
+              crc_table[5][(lo >> 16) & 0xff] ^ crc_table[4][lo >> 24] ^
+              crc_table[3][p[4]] ^ crc_table[2][p[5]] ^ crc_table[1][p[6]] ^ crc_table[0][p[7]];
+    }
+    for (; n; n--) crc = (crc >> 8) ^ crc_table[0][(crc ^ *p++) & 0xff];
+    return crc;
+}
+
+#ifdef BLOOMDB_HAVE_X86
+
+static inline uint32_t shift_crc(uint32_t table[4][256], uint32_t crc) {
+    return table[0][crc & 0xff] ^ table[1][(crc >> 8) & 0xff] ^
+           table[2][(crc >> 16) & 0xff] ^ table[3][crc >> 24];
+}
+
+static inline uint64_t load64(const uint8_t* p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+// Tres flujos de span bytes: p[0, span), p[span, 2 span), p[2 span, 3 span)
+__attribute__((target("sse4.2")))
+static uint32_t crc32c_three_way(uint32_t crc, const uint8_t* p, size_t span, uint32_t table[4][256]) {
+    uint64_t c0 = crc, c1 = 0, c2 = 0;
+    for (const uint8_t* end = p + span; p < end; p += 8) {
+        c0 = _mm_crc32_u64(c0, load64(p));
+        c1 = _mm_crc32_u64(c1, load64(p + span));
+        c2 = _mm_crc32_u64(c2, load64(p + 2 * span));
+    }
+    uint32_t out = shift_crc(table, (uint32_t)c0) ^ (uint32_t)c1;
+    return shift_crc(table, out) ^ (uint32_t)c2;
+}
+
+__attribute__((target("sse4.2")))
+uint32_t crc32c_sse42(uint32_t crc, const uint8_t* p, size_t n) {
+    for (; n && ((uintptr_t)p & 7); n--) crc = _mm_crc32_u8(crc, *p++);
+    for (; n >= 3 * CRC32C_LONG; n -= 3 * CRC32C_LONG, p += 3 * CRC32C_LONG) {
+        crc = crc32c_three_way(crc, p, CRC32C_LONG, crc_long_shift);
+    }
+    for (; n >= 3 * CRC32C_SHORT; n -= 3 * CRC32C_SHORT, p += 3 * CRC32C_SHORT) {
+        crc = crc32c_three_way(crc, p, CRC32C_SHORT, crc_short_shift);
+    }
+    uint64_t c = crc;
+    for (; n >= 8; n -= 8, p += 8) c = _mm_crc32_u64(c, load64(p));
+    crc = (uint32_t)c;
+    for (; n; n--) crc = _mm_crc32_u8(crc, *p++);
+    return crc;
+}
+
+#endif
+
+uint32_t crc32c(uint32_t crc, const void* data, size_t len) {
+    if (!data || len == 0) return crc;
+    return ~bloomdb_kernels.crc32c(~crc, (const uint8_t*)data, len);
+}
@@ -0,0 +1,110 @@
+#include "bloomdb.h"
+#include "bloomdb_internal.h"
+
+// ============================================================================
+// Dispatch de kernels por ISA
+//
+// La tabla arranca con las variantes escalares (válidas en cualquier CPU) y
+// un constructor la cambia a la mejor ISA disponible al cargar la librería.
+// bloomdb_set_isa() permite bajar de nivel, p. ej. para comparar variantes.
+// Cambiar la ISA no es seguro mientras otros hilos usan la librería.
+// ============================================================================
+
+BloomDBKernels bloomdb_kernels = {
+    hash128_many_scalar,
+    hash128_fixed_scalar,
+    split_insert_scalar,
+    split_query_scalar,
+    bitarray_popcount_scalar,
+    bitarray_or_scalar,
+    bitarray_and_mask_scalar,
+    crc32c_scalar,
+};
+
+static BloomDBIsa active_isa = BLOOMDB_ISA_SCALAR;
+
+#ifdef BLOOMDB_HAVE_X86
+static bool cpu_has_vpopcntdq(void) {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx512vpopcntdq");
+}
+#endif
+
+BloomDBIsa bloomdb_cpu_isa(void) {
+#ifdef BLOOMDB_HAVE_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq") &&
+        __builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx512vl")) {
+        return BLOOMDB_ISA_AVX512;
+    }
+    if (__builtin_cpu_supports("avx2")) return BLOOMDB_ISA_AVX2;
+    if (__builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("popcnt")) return BLOOMDB_ISA_SSE42;
+#endif
+    return BLOOMDB_ISA_SCALAR;
+}
+
+BloomDBIsa bloomdb_get_isa(void) {
+    return active_isa;
+}
+
+BloomDBError bloomdb_set_isa(BloomDBIsa isa) {
+    if ((int)isa < BLOOMDB_ISA_SCALAR || isa > bloomdb_cpu_isa()) return BLOOMDB_ERR_INVALID_ARGUMENT;
+
+    BloomDBKernels k = {
+        hash128_many_scalar,
+        hash128_fixed_scalar,
+        split_insert_scalar,
+        split_query_scalar,
+        bitarray_popcount_scalar,
+        bitarray_or_scalar,
+        bitarray_and_mask_scalar,
+        crc32c_scalar,
+    };
+
+#ifdef BLOOMDB_HAVE_X86
+    if (isa >= BLOOMDB_ISA_SSE42) {
+        k.popcount = bitarray_popcount_popcnt;
+        k.crc32c = crc32c_sse42;
+    }
+    if (isa >= BLOOMDB_ISA_AVX2) {
+        k.hash_many = hash128_many_avx2;
+        k.hash_fixed = hash128_fixed_avx2;
+        k.split_insert = split_insert_avx2;
+        k.split_query = split_query_avx2;
+        k.popcount = bitarray_popcount_avx2;
+        k.merge_or = bitarray_or_avx2;
+        k.and_mask = bitarray_and_mask_avx2;
+    }
+    if (isa >= BLOOMDB_ISA_AVX512) {
+        // Los bloques split son de 256 bits: AVX2 ya es su ancho natural
+        k.hash_fixed = hash128_fixed_avx512;
+        k.merge_or = bitarray_or_avx512;
+        k.and_mask = bitarray_and_mask_avx512;
+        if (cpu_has_vpopcntdq()) k.popcount = bitarray_popcount_avx512;
+    }
+#endif
+
+    bloomdb_kernels = k;
+    active_isa = isa;
+    return BLOOMDB_OK;
+}
+
+const char* bloomdb_isa_name(BloomDBIsa isa) {
+    switch (isa) {
+        case BLOOMDB_ISA_SCALAR:
+            return "scalar";
+        case BLOOMDB_ISA_SSE42:
+            return "sse4.2";
+        case BLOOMDB_ISA_AVX2:
+            return "avx2";
+        case BLOOMDB_ISA_AVX512:
+            return "avx512";
+        default:
+            return "unknown";
+    }
+}
+
+__attribute__((constructor))
+static void dispatch_init(void) {
+    bloomdb_set_isa(bloomdb_cpu_isa());
+}
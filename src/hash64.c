@@ -1,13 +1,563 @@
 #include "hash64.h"
+#include <string.h>
+#include <stdbool.h>
 
-uint64_t hash64(const void* key, size_t len, uint64_t seed) {
+#include "bloomdb_internal.h"
+
+#ifdef BLOOMDB_HAVE_X86
+#include <immintrin.h>
+#define HASH64_HAVE_X86 1
+#endif
+
+// ============================================================================
+// MurmurHash3 x64_128 (Austin Appleby, dominio público).
+//
+// Procesa la clave en bloques de 16 bytes (dos palabras de 64 bits por paso)
+// y produce un digest de 128 bits. Las lecturas son little-endian para que
+// el resultado no dependa de la arquitectura (los índices del filtro se
+// derivan de este valor y terminan en disco).
+// ============================================================================
+
+#define C1 0x87c37b91114253d5ULL
+#define C2 0x4cf5ad432745937fULL
+
+static inline uint64_t rotl64(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+static inline uint64_t load64_le(const uint8_t* p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    v = __builtin_bswap64(v);
+#endif
+    return v;
+}
+
+static inline uint64_t fmix64(uint64_t k) {
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccdULL;
+    k ^= k >> 33;
+    k *= 0xc4ceb9fe1a85ec53ULL;
+    k ^= k >> 33;
+    return k;
+}
+
+// Cola (len & 15 bytes desde tail) + finalización sobre el estado (h1, h2)
+static inline hash128_t murmur_finish(uint64_t h1, uint64_t h2, const uint8_t* tail, size_t len) {
+    uint64_t k1 = 0;
+    uint64_t k2 = 0;
+
+    switch (len & 15) {
+        case 15: k2 ^= (uint64_t)tail[14] << 48; /* fallthrough */
+        case 14: k2 ^= (uint64_t)tail[13] << 40; /* fallthrough */
+        case 13: k2 ^= (uint64_t)tail[12] << 32; /* fallthrough */
+        case 12: k2 ^= (uint64_t)tail[11] << 24; /* fallthrough */
+        case 11: k2 ^= (uint64_t)tail[10] << 16; /* fallthrough */
+        case 10: k2 ^= (uint64_t)tail[9]  << 8;  /* fallthrough */
+        case 9:  k2 ^= (uint64_t)tail[8];
+                 k2 *= C2; k2 = rotl64(k2, 33); k2 *= C1; h2 ^= k2;
+                 /* fallthrough */
+        case 8:  k1 ^= (uint64_t)tail[7] << 56; /* fallthrough */
+        case 7:  k1 ^= (uint64_t)tail[6] << 48; /* fallthrough */
+        case 6:  k1 ^= (uint64_t)tail[5] << 40; /* fallthrough */
+        case 5:  k1 ^= (uint64_t)tail[4] << 32; /* fallthrough */
+        case 4:  k1 ^= (uint64_t)tail[3] << 24; /* fallthrough */
+        case 3:  k1 ^= (uint64_t)tail[2] << 16; /* fallthrough */
+        case 2:  k1 ^= (uint64_t)tail[1] << 8;  /* fallthrough */
+        case 1:  k1 ^= (uint64_t)tail[0];
+                 k1 *= C1; k1 = rotl64(k1, 31); k1 *= C2; h1 ^= k1;
+    }
+
+    // Finalización
+    h1 ^= (uint64_t)len;
+    h2 ^= (uint64_t)len;
+
+    h1 += h2;
+    h2 += h1;
+
+    h1 = fmix64(h1);
+    h2 = fmix64(h2);
+
+    h1 += h2;
+    h2 += h1;
+
+    hash128_t out = { h1, h2 };
+    return out;
+}
+
+hash128_t hash128(const void* key, size_t len, uint64_t seed) {
     const uint8_t* data = (const uint8_t*)key;
-    uint64_t hash = seed;
+    const size_t nblocks = len / 16;
+
+    uint64_t h1 = seed;
+    uint64_t h2 = seed;
+
+    // Cuerpo: 16 bytes por iteración
+    for (size_t i = 0; i < nblocks; i++) {
+        uint64_t k1 = load64_le(data + i * 16);
+        uint64_t k2 = load64_le(data + i * 16 + 8);
+
+        k1 *= C1; k1 = rotl64(k1, 31); k1 *= C2; h1 ^= k1;
+        h1 = rotl64(h1, 27); h1 += h2; h1 = h1 * 5 + 0x52dce729;
+
+        k2 *= C2; k2 = rotl64(k2, 33); k2 *= C1; h2 ^= k2;
+        h2 = rotl64(h2, 31); h2 += h1; h2 = h2 * 5 + 0x38495ab5;
+    }
+
+    return murmur_finish(h1, h2, data + nblocks * 16, len);
+}
+
+uint64_t hash64(const void* key, size_t len, uint64_t seed) {
+    return hash128(key, len, seed).h1;
+}
+
+// ============================================================================
+// Claves enteras: MurmurHash3 especializado para 8 y 16 bytes
+//
+// Toda la clave está en registros: sin bucle de bloques ni switch de cola.
+// El resultado es el mismo que hashear los bytes en memoria del valor, de
+// modo que insertar con bloomdb_insert(&v, 8) y consultar con la variante
+// u64 (o al revés) nunca da falsos negativos.
+// ============================================================================
+
+// Representación en memoria del entero leída como little-endian
+static inline uint64_t native_as_le(uint64_t v) {
+    uint8_t b[8];
+    memcpy(b, &v, sizeof(v));
+    return load64_le(b);
+}
+
+static inline hash128_t murmur_fmix_pair(uint64_t h1, uint64_t h2, uint64_t len) {
+    h1 ^= len;
+    h2 ^= len;
+
+    h1 += h2;
+    h2 += h1;
+
+    h1 = fmix64(h1);
+    h2 = fmix64(h2);
+
+    h1 += h2;
+    h2 += h1;
+
+    hash128_t out = { h1, h2 };
+    return out;
+}
+
+hash128_t hash128_u64(uint64_t value, uint64_t seed) {
+    // 8 bytes: todo es cola, solo se mezcla k1
+    uint64_t k1 = native_as_le(value);
+    k1 *= C1; k1 = rotl64(k1, 31); k1 *= C2;
+    return murmur_fmix_pair(seed ^ k1, seed, 8);
+}
+
+hash128_t hash128_u128(uint64_t lo, uint64_t hi, uint64_t seed) {
+    // 16 bytes (lo y luego hi en memoria): un bloque completo y cola vacía
+    uint64_t h1 = seed;
+    uint64_t h2 = seed;
+    uint64_t k1 = native_as_le(lo);
+    uint64_t k2 = native_as_le(hi);
+
+    k1 *= C1; k1 = rotl64(k1, 31); k1 *= C2; h1 ^= k1;
+    h1 = rotl64(h1, 27); h1 += h2; h1 = h1 * 5 + 0x52dce729;
+
+    k2 *= C2; k2 = rotl64(k2, 33); k2 *= C1; h2 ^= k2;
+    h2 = rotl64(h2, 31); h2 += h1; h2 = h2 * 5 + 0x38495ab5;
+
+    return murmur_fmix_pair(h1, h2, 16);
+}
+
+// ============================================================================
+// Multi-key: varias claves por llamada
+//
+// La versión AVX2 mantiene el estado (h1, h2) de 4 claves en los 4 carriles
+// de 64 bits de un registro y avanza todas a la vez, bloque a bloque. Las
+// claves de longitudes distintas avanzan en paralelo hasta el bloque máximo;
+// los carriles que ya terminaron quedan congelados con un blend. La cola y
+// la finalización también son vectoriales, así que las claves de 8/16 bytes
+// (IDs u64, UUIDs) no tocan el camino escalar.
+//
+// El resultado es bit a bit idéntico a hash128() para cada clave.
+// ============================================================================
+
+// 0..7 bytes como palabra little-endian, sin memcpy de longitud variable.
+// Las lecturas solapadas escriben los mismos bytes en las mismas posiciones.
+static inline uint64_t load_partial(const uint8_t* p, size_t n) {
+    if (n >= 4) {
+        uint32_t lo, hi;
+        memcpy(&lo, p, 4);
+        memcpy(&hi, p + n - 4, 4);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        lo = __builtin_bswap32(lo);
+        hi = __builtin_bswap32(hi);
+#endif
+        return (uint64_t)lo | ((uint64_t)hi << (8 * (n - 4)));
+    }
+    if (n == 0) return 0;
+    return (uint64_t)p[0] |
+           ((uint64_t)p[n >> 1] << (8 * (n >> 1))) |
+           ((uint64_t)p[n - 1] << (8 * (n - 1)));
+}
+
+// Bytes de la cola (len & 15) como dos palabras little-endian. Equivale al
+// switch de hash128(): mezclar k1/k2 == 0 no altera h1/h2.
+static inline void load_tail(const uint8_t* key, size_t len, uint64_t* k1, uint64_t* k2) {
+    const size_t t = len & 15;
+    const uint8_t* tail = key + len - t;
+
+    if (t == 0) {
+        *k1 = *k2 = 0;
+    } else if (len >= 16) {
+        // Leer los últimos 16 bytes de la clave y desplazar el par (hi:lo)
+        uint64_t lo = load64_le(key + len - 16);
+        uint64_t hi = load64_le(key + len - 8);
+        unsigned shift = (unsigned)(128 - 8 * t);
+        if (shift >= 64) {
+            *k1 = hi >> (shift - 64);
+            *k2 = 0;
+        } else {
+            *k1 = (lo >> shift) | (hi << (64 - shift));
+            *k2 = hi >> shift;
+        }
+    } else if (t >= 8) {
+        *k1 = load64_le(tail);
+        *k2 = load_partial(tail + 8, t - 8);
+    } else {
+        *k1 = load_partial(tail, t);
+        *k2 = 0;
+    }
+}
+
+void hash128_many_scalar(const void* const* keys, const size_t* lens, size_t n,
+                         uint64_t seed, hash128_t* out) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = hash128(keys[i], lens[i], seed);
+    }
+}
+
+#ifdef HASH64_HAVE_X86
+
+#define AVX2_FN __attribute__((target("avx2"), always_inline)) static inline
+
+// Producto 64x64 -> 64 (bits bajos) con tres multiplicaciones de 32 bits:
+// a*c = lo(a)*lo(c) + ((hi(a)*lo(c) + lo(a)*hi(c)) << 32)
+AVX2_FN __m256i mul64_avx2(__m256i a, __m256i c) {
+    __m256i lo    = _mm256_mul_epu32(a, c);
+    __m256i a_hi  = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), c);
+    __m256i c_hi  = _mm256_mul_epu32(a, _mm256_srli_epi64(c, 32));
+    __m256i cross = _mm256_slli_epi64(_mm256_add_epi64(a_hi, c_hi), 32);
+    return _mm256_add_epi64(lo, cross);
+}
+
+#define ROTL64_AVX2(x, r) \
+    _mm256_or_si256(_mm256_slli_epi64((x), (r)), _mm256_srli_epi64((x), 64 - (r)))
+
+AVX2_FN __m256i fmix64_avx2(__m256i k) {
+    const __m256i m1 = _mm256_set1_epi64x((long long)0xff51afd7ed558ccdULL);
+    const __m256i m2 = _mm256_set1_epi64x((long long)0xc4ceb9fe1a85ec53ULL);
+    k = _mm256_xor_si256(k, _mm256_srli_epi64(k, 33));
+    k = mul64_avx2(k, m1);
+    k = _mm256_xor_si256(k, _mm256_srli_epi64(k, 33));
+    k = mul64_avx2(k, m2);
+    k = _mm256_xor_si256(k, _mm256_srli_epi64(k, 33));
+    return k;
+}
+
+AVX2_FN __m256i mix_k1_avx2(__m256i k1) {
+    k1 = mul64_avx2(k1, _mm256_set1_epi64x((long long)C1));
+    k1 = ROTL64_AVX2(k1, 31);
+    return mul64_avx2(k1, _mm256_set1_epi64x((long long)C2));
+}
+
+AVX2_FN __m256i mix_k2_avx2(__m256i k2) {
+    k2 = mul64_avx2(k2, _mm256_set1_epi64x((long long)C2));
+    k2 = ROTL64_AVX2(k2, 33);
+    return mul64_avx2(k2, _mm256_set1_epi64x((long long)C1));
+}
+
+// x*5 + c
+AVX2_FN __m256i mul5_add(__m256i x, uint32_t c) {
+    __m256i x5 = _mm256_add_epi64(_mm256_slli_epi64(x, 2), x);
+    return _mm256_add_epi64(x5, _mm256_set1_epi64x(c));
+}
+
+// Un bloque de 16 bytes en los carriles activos (los demás no cambian)
+AVX2_FN void block_avx2(__m256i* h1, __m256i* h2, __m256i k1, __m256i k2, __m256i active) {
+    __m256i n1 = _mm256_xor_si256(*h1, mix_k1_avx2(k1));
+    n1 = ROTL64_AVX2(n1, 27);
+    n1 = _mm256_add_epi64(n1, *h2);
+    n1 = mul5_add(n1, 0x52dce729);
+
+    __m256i n2 = _mm256_xor_si256(*h2, mix_k2_avx2(k2));
+    n2 = ROTL64_AVX2(n2, 31);
+    n2 = _mm256_add_epi64(n2, n1);
+    n2 = mul5_add(n2, 0x38495ab5);
+
+    *h1 = _mm256_blendv_epi8(*h1, n1, active);
+    *h2 = _mm256_blendv_epi8(*h2, n2, active);
+}
+
+// Finalización de 4 claves (la cola ya mezclada en h1/h2) y escritura en out[0..3]
+AVX2_FN void finish_avx2(__m256i a, __m256i c, __m256i vlen, hash128_t* out) {
+    a = _mm256_xor_si256(a, vlen);
+    c = _mm256_xor_si256(c, vlen);
+    a = _mm256_add_epi64(a, c);
+    c = _mm256_add_epi64(c, a);
+    a = fmix64_avx2(a);
+    c = fmix64_avx2(c);
+    a = _mm256_add_epi64(a, c);
+    c = _mm256_add_epi64(c, a);
+
+    // Intercalar (h1, h2) por clave: out es un arreglo de hash128_t
+    __m256i lo = _mm256_unpacklo_epi64(a, c);   // [a0 c0 | a2 c2]
+    __m256i hi = _mm256_unpackhi_epi64(a, c);   // [a1 c1 | a3 c3]
+    _mm256_storeu_si256((__m256i*)&out[0], _mm256_permute2x128_si256(lo, hi, 0x20));
+    _mm256_storeu_si256((__m256i*)&out[2], _mm256_permute2x128_si256(lo, hi, 0x31));
+}
+
+/**
+ * Núcleo AVX2 para G grupos de 4 claves de longitud variable (G = 1 ó 2).
+ * Con G = 2 las dos cadenas de dependencias se intercalan y la latencia de
+ * las multiplicaciones queda cubierta. Los bloques se leen con gathers
+ * enmascarados: un carril inactivo nunca lee fuera de su clave.
+ */
+AVX2_FN void hash128_avx2_groups(const void* const* keys, const size_t* lens,
+                                 uint64_t seed, hash128_t* out, const int G) {
+    __m256i h1[2], h2[2], addr[2], nblk[2];
+    size_t max_blocks = 0;
+
+    for (int g = 0; g < G; g++) {
+        const size_t* L = lens + 4 * g;
+        const void* const* K = keys + 4 * g;
+        h1[g] = _mm256_set1_epi64x((long long)seed);
+        h2[g] = h1[g];
+        addr[g] = _mm256_set_epi64x((long long)(uintptr_t)K[3], (long long)(uintptr_t)K[2],
+                                    (long long)(uintptr_t)K[1], (long long)(uintptr_t)K[0]);
+        nblk[g] = _mm256_set_epi64x((long long)(L[3] / 16), (long long)(L[2] / 16),
+                                    (long long)(L[1] / 16), (long long)(L[0] / 16));
+        for (int l = 0; l < 4; l++) {
+            if (L[l] / 16 > max_blocks) max_blocks = L[l] / 16;
+        }
+    }
+
+    // Cuerpo
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i eight = _mm256_set1_epi64x(8);
+    for (size_t b = 0; b < max_blocks; b++) {
+        const __m256i vb = _mm256_set1_epi64x((long long)b);
+        const __m256i off = _mm256_set1_epi64x((long long)(b * 16));
+        for (int g = 0; g < G; g++) {
+            __m256i active = _mm256_cmpgt_epi64(nblk[g], vb);
+            __m256i p = _mm256_add_epi64(addr[g], off);
+            __m256i k1 = _mm256_mask_i64gather_epi64(zero, (const long long*)0, p, active, 1);
+            __m256i k2 = _mm256_mask_i64gather_epi64(zero, (const long long*)0,
+                                                     _mm256_add_epi64(p, eight), active, 1);
+            block_avx2(&h1[g], &h2[g], k1, k2, active);
+        }
+    }
+
+    // Cola + finalización
+    for (int g = 0; g < G; g++) {
+        uint64_t k1s[4], k2s[4];
+        for (int l = 0; l < 4; l++) {
+            const int i = 4 * g + l;
+            load_tail((const uint8_t*)keys[i], lens[i], &k1s[l], &k2s[l]);
+        }
+        __m256i k1 = _mm256_set_epi64x((long long)k1s[3], (long long)k1s[2],
+                                       (long long)k1s[1], (long long)k1s[0]);
+        __m256i k2 = _mm256_set_epi64x((long long)k2s[3], (long long)k2s[2],
+                                       (long long)k2s[1], (long long)k2s[0]);
+        __m256i vlen = _mm256_set_epi64x((long long)lens[4 * g + 3], (long long)lens[4 * g + 2],
+                                         (long long)lens[4 * g + 1], (long long)lens[4 * g + 0]);
+
+        finish_avx2(_mm256_xor_si256(h1[g], mix_k1_avx2(k1)),
+                    _mm256_xor_si256(h2[g], mix_k2_avx2(k2)), vlen, out + 4 * g);
+    }
+}
+
+/**
+ * Claves contiguas de 8 bytes (IDs u64): toda la clave es cola, así que se
+ * carga directamente con una lectura vectorial y solo se mezcla k1.
+ */
+__attribute__((target("avx2")))
+static void hash128_fixed8_avx2(const uint8_t* base, size_t n, uint64_t seed, hash128_t* out) {
+    const __m256i vseed = _mm256_set1_epi64x((long long)seed);
+    const __m256i vlen = _mm256_set1_epi64x(8);
+    for (size_t i = 0; i + 8 <= n; i += 8) {
+        __m256i k1a = _mm256_loadu_si256((const __m256i*)(base + i * 8));
+        __m256i k1b = _mm256_loadu_si256((const __m256i*)(base + i * 8 + 32));
+        finish_avx2(_mm256_xor_si256(vseed, mix_k1_avx2(k1a)), vseed, vlen, out + i);
+        finish_avx2(_mm256_xor_si256(vseed, mix_k1_avx2(k1b)), vseed, vlen, out + i + 4);
+    }
+}
+
+/**
+ * Claves contiguas de 16 bytes (UUIDs): un único bloque y cola vacía.
+ */
+__attribute__((target("avx2")))
+static void hash128_fixed16_avx2(const uint8_t* base, size_t n, uint64_t seed, hash128_t* out) {
+    const __m256i vseed = _mm256_set1_epi64x((long long)seed);
+    const __m256i vlen = _mm256_set1_epi64x(16);
+    const __m256i all = _mm256_set1_epi64x(-1);
+    for (size_t i = 0; i + 4 <= n; i += 4) {
+        __m256i v0 = _mm256_loadu_si256((const __m256i*)(base + i * 16));       // k1_0 k2_0 k1_1 k2_1
+        __m256i v1 = _mm256_loadu_si256((const __m256i*)(base + i * 16 + 32));  // k1_2 k2_2 k1_3 k2_3
+        __m256i k1 = _mm256_permute4x64_epi64(_mm256_unpacklo_epi64(v0, v1), 0xD8);
+        __m256i k2 = _mm256_permute4x64_epi64(_mm256_unpackhi_epi64(v0, v1), 0xD8);
+        __m256i h1 = vseed, h2 = vseed;
+        block_avx2(&h1, &h2, k1, k2, all);
+        finish_avx2(h1, h2, vlen, out + i);
+    }
+}
+
+#endif /* HASH64_HAVE_X86 */
+
+// ============================================================================
+// Variantes por ISA (las elige dispatch.c; ver bloomdb_internal.h)
+// ============================================================================
+
+void hash128_fixed_scalar(const void* keys, size_t key_len, size_t n,
+                          uint64_t seed, hash128_t* out) {
+    const uint8_t* base = (const uint8_t*)keys;
+    for (size_t i = 0; i < n; i++) {
+        out[i] = hash128(base + i * key_len, key_len, seed);
+    }
+}
+
+#ifdef HASH64_HAVE_X86
+
+__attribute__((target("avx2")))
+void hash128_many_avx2(const void* const* keys, const size_t* lens, size_t n,
+                       uint64_t seed, hash128_t* out) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) hash128_avx2_groups(keys + i, lens + i, seed, out + i, 2);
+    for (; i + 4 <= n; i += 4) hash128_avx2_groups(keys + i, lens + i, seed, out + i, 1);
+    hash128_many_scalar(keys + i, lens + i, n - i, seed, out + i);
+}
+
+__attribute__((target("avx2")))
+void hash128_fixed_avx2(const void* keys, size_t key_len, size_t n,
+                        uint64_t seed, hash128_t* out) {
+    const uint8_t* base = (const uint8_t*)keys;
+    size_t i = 0;
+
+    if (key_len == 8) {
+        i = n & ~(size_t)7;
+        hash128_fixed8_avx2(base, i, seed, out);
+    } else if (key_len == 16) {
+        i = n & ~(size_t)3;
+        hash128_fixed16_avx2(base, i, seed, out);
+    }
+
+    const void* ptrs[8];
+    size_t lens[8];
+    for (int l = 0; l < 8; l++) lens[l] = key_len;
+
+    for (; i + 8 <= n; i += 8) {
+        for (int l = 0; l < 8; l++) ptrs[l] = base + (i + l) * key_len;
+        hash128_avx2_groups(ptrs, lens, seed, out + i, 2);
+    }
+    hash128_fixed_scalar(base + i * key_len, key_len, n - i, seed, out + i);
+}
+
+// ----------------------------------------------------------------------------
+// AVX-512: multiplicación de 64 bits nativa (vpmullq) y rotación (vprolq).
+// Solo el camino de 8 bytes, que es el de los IDs u64; el resto usa AVX2.
+// ----------------------------------------------------------------------------
+
+#define AVX512_FN __attribute__((target("avx512f,avx512dq"), always_inline)) static inline
+
+AVX512_FN __m512i fmix64_avx512(__m512i k) {
+    const __m512i m1 = _mm512_set1_epi64((long long)0xff51afd7ed558ccdULL);
+    const __m512i m2 = _mm512_set1_epi64((long long)0xc4ceb9fe1a85ec53ULL);
+    k = _mm512_xor_si512(k, _mm512_srli_epi64(k, 33));
+    k = _mm512_mullo_epi64(k, m1);
+    k = _mm512_xor_si512(k, _mm512_srli_epi64(k, 33));
+    k = _mm512_mullo_epi64(k, m2);
+    k = _mm512_xor_si512(k, _mm512_srli_epi64(k, 33));
+    return k;
+}
+
+/**
+ * 8 claves de 8 bytes por registro; la última vuelta usa carga y escritura
+ * enmascaradas, así que no hay cola escalar.
+ */
+__attribute__((target("avx512f,avx512dq")))
+static void hash128_fixed8_avx512(const uint8_t* base, size_t n, uint64_t seed, hash128_t* out) {
+    const __m512i vseed = _mm512_set1_epi64((long long)seed);
+    const __m512i vlen = _mm512_set1_epi64(8);
+    const __m512i c1 = _mm512_set1_epi64((long long)C1);
+    const __m512i c2 = _mm512_set1_epi64((long long)C2);
+    const __m512i idx_lo = _mm512_set_epi64(11, 3, 10, 2, 9, 1, 8, 0);
+    const __m512i idx_hi = _mm512_set_epi64(15, 7, 14, 6, 13, 5, 12, 4);
+
+    for (size_t i = 0; i < n; i += 8) {
+        const size_t left = n - i;
+        const __mmask8 m = left >= 8 ? (__mmask8)0xFF : (__mmask8)((1u << left) - 1);
+
+        __m512i k1 = _mm512_maskz_loadu_epi64(m, base + i * 8);
+        k1 = _mm512_mullo_epi64(k1, c1);
+        k1 = _mm512_rol_epi64(k1, 31);
+        k1 = _mm512_mullo_epi64(k1, c2);
+
+        __m512i h1 = _mm512_xor_si512(_mm512_xor_si512(vseed, k1), vlen);
+        __m512i h2 = _mm512_xor_si512(vseed, vlen);
+        h1 = _mm512_add_epi64(h1, h2);
+        h2 = _mm512_add_epi64(h2, h1);
+        h1 = fmix64_avx512(h1);
+        h2 = fmix64_avx512(h2);
+        h1 = _mm512_add_epi64(h1, h2);
+        h2 = _mm512_add_epi64(h2, h1);
+
+        // Intercalar (h1, h2) por clave
+        const __mmask8 m_lo = (__mmask8)(left >= 4 ? 0xFF : (1u << (2 * left)) - 1);
+        const __mmask8 m_hi = (__mmask8)(left >= 8 ? 0xFF : left <= 4 ? 0 : (1u << (2 * (left - 4))) - 1);
+        _mm512_mask_storeu_epi64(&out[i], m_lo, _mm512_permutex2var_epi64(h1, idx_lo, h2));
+        _mm512_mask_storeu_epi64(&out[i + 4], m_hi, _mm512_permutex2var_epi64(h1, idx_hi, h2));
+    }
+}
+
+__attribute__((target("avx512f,avx512dq")))
+void hash128_fixed_avx512(const void* keys, size_t key_len, size_t n,
+                          uint64_t seed, hash128_t* out) {
+    if (key_len == 8) {
+        hash128_fixed8_avx512((const uint8_t*)keys, n, seed, out);
+        return;
+    }
+    hash128_fixed_avx2(keys, key_len, n, seed, out);
+}
+
+#endif /* HASH64_HAVE_X86 */
+
+// ============================================================================
+// API pública multi-key (a través de la tabla de kernels)
+// ============================================================================
+
+void hash128_x4(const void* const keys[4], const size_t lens[4], uint64_t seed, hash128_t out[4]) {
+    bloomdb_kernels.hash_many(keys, lens, 4, seed, out);
+}
+
+void hash128_x8(const void* const keys[8], const size_t lens[8], uint64_t seed, hash128_t out[8]) {
+    bloomdb_kernels.hash_many(keys, lens, 8, seed, out);
+}
+
+void hash128_many(const void* const* keys, const size_t* lens, size_t n,
+                  uint64_t seed, hash128_t* out) {
+    bloomdb_kernels.hash_many(keys, lens, n, seed, out);
+}
+
+void hash128_fixed(const void* keys, size_t key_len, size_t n,
+                   uint64_t seed, hash128_t* out) {
+    bloomdb_kernels.hash_fixed(keys, key_len, n, seed, out);
+}
 
-    for (size_t i = 0; i < len; i++) {
-        hash ^= data[i];
-        hash *= 0x5bd1e995;
-        hash ^= hash >> 15;
+void hash64_many(const void* const* keys, const size_t* lens, size_t n,
+                 uint64_t seed, uint64_t* out) {
+    hash128_t tmp[8];
+    for (size_t i = 0; i < n; i += 8) {
+        size_t g = n - i < 8 ? n - i : 8;
+        bloomdb_kernels.hash_many(keys + i, lens + i, g, seed, tmp);
+        for (size_t l = 0; l < g; l++) out[i + l] = tmp[l].h1;
     }
-    return hash;
 }
@@ -0,0 +1,472 @@
+#include "insert_log.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <libgen.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "bloomdb_internal.h"
+#include "crc32c.h"
+#include "storage.h"
+
+// ============================================================================
+// Formato (little-endian)
+//
+// Cabecera de 32 bytes:
+//    0 uint32 magic (LOG_MAGIC)   4 uint32 version (1)
+//    8 uint64 seed               16 uint32 hash_algo   20 uint32 reservado (0)
+//   24 uint32 CRC32C de los bytes 0..23               28 uint32 reservado (0)
+// Frames, uno por grupo:
+//    uint32 count, uint32 CRC32C de (count || registros), count registros
+//    de 16 bytes (uint64 h1, uint64 h2)
+// ============================================================================
+
+#define LOG_MAGIC        0x47424442u   // "BDBG"
+#define LOG_VERSION      1u
+#define LOG_HEADER_SIZE  32
+#define FRAME_HEADER     8
+#define RECORD_SIZE      16
+#define LOG_MAX_RECORDS  (BLOOMDB_LOG_MAX_GROUP_BYTES / RECORD_SIZE)
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void encode_header(uint8_t* out, uint64_t seed) {
+    memset(out, 0, LOG_HEADER_SIZE);
+    put_le32(out, LOG_MAGIC);
+    put_le32(out + 4, LOG_VERSION);
+    put_le64(out + 8, seed);
+    put_le32(out + 16, BLOOMDB_HASH_MURMUR3);
+    put_le32(out + 24, crc32c(0, out, 24));
+}
+
+static BloomDBError check_header(const uint8_t* in, uint64_t seed) {
+    if (get_le32(in) != LOG_MAGIC || get_le32(in + 4) != LOG_VERSION) return BLOOMDB_ERR_FORMAT;
+    if (get_le32(in + 24) != crc32c(0, in, 24)) return BLOOMDB_ERR_CHECKSUM;
+    // Un log de otra seed pondría bits que nunca se consultan
+    if (get_le64(in + 8) != seed || get_le32(in + 16) != BLOOMDB_HASH_MURMUR3) return BLOOMDB_ERR_FORMAT;
+    return BLOOMDB_OK;
+}
+
+static bool write_all(int fd, const uint8_t* buf, size_t len, uint64_t offset) {
+    while (len > 0) {
+        ssize_t n = pwrite(fd, buf, len, (off_t)offset);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        buf += n;
+        len -= (size_t)n;
+        offset += (uint64_t)n;
+    }
+    return true;
+}
+
+static bool read_all(int fd, uint8_t* buf, size_t len, uint64_t offset) {
+    while (len > 0) {
+        ssize_t n = pread(fd, buf, len, (off_t)offset);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        buf += n;
+        len -= (size_t)n;
+        offset += (uint64_t)n;
+    }
+    return true;
+}
+
+// Un archivo recién creado o renombrado solo sobrevive al crash si también
+// se sincroniza su directorio
+static BloomDBError fsync_parent_dir(const char* path) {
+    char* copy = strdup(path);
+    if (!copy) return BLOOMDB_ERR_ALLOC;
+    int dfd = open(dirname(copy), O_RDONLY | O_DIRECTORY);
+    free(copy);
+    if (dfd < 0) return BLOOMDB_ERR_FILE_IO;
+    int rc = fsync(dfd);
+    close(dfd);
+    return rc == 0 ? BLOOMDB_OK : BLOOMDB_ERR_FILE_IO;
+}
+
+static BloomDBError fsync_path(const char* path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return BLOOMDB_ERR_FILE_IO;
+    int rc = fsync(fd);
+    close(fd);
+    return rc == 0 ? BLOOMDB_OK : BLOOMDB_ERR_FILE_IO;
+}
+
+// ============================================================================
+// Group commit
+// ============================================================================
+
+static size_t group_capacity(const BloomDBLog* log) {
+    size_t cap = log->group_bytes / RECORD_SIZE;
+    return cap ? cap : 1;
+}
+
+// Con io_lock tomado: un frame, un pwrite y un fdatasync
+static BloomDBError write_frame(BloomDBLog* log, uint8_t* frame, size_t count) {
+    const size_t len = FRAME_HEADER + count * RECORD_SIZE;
+    put_le32(frame, (uint32_t)count);
+    put_le32(frame + 4, crc32c(crc32c(0, frame, 4), frame + FRAME_HEADER, count * RECORD_SIZE));
+    if (!write_all(log->fd, frame, len, log->file_size) || fdatasync(log->fd) != 0) {
+        return BLOOMDB_ERR_FILE_IO;
+    }
+    log->file_size += len;
+    log->syncs++;
+    return BLOOMDB_OK;
+}
+
+/**
+ * Con io_lock tomado. Cambia de buffer bajo lock (las inserciones siguen en
+ * el otro mientras este se escribe) y deja el primer error en log->error
+ * para que lo vea la siguiente inserción.
+ */
+static BloomDBError flush_locked(BloomDBLog* log) {
+    pthread_mutex_lock(&log->lock);
+    BloomDBError err = log->error;
+    const size_t count = log->pending;
+    uint8_t* frame = log->active;
+    if (err == BLOOMDB_OK && count > 0) {
+        log->active = log->spare;
+        log->spare = frame;
+        log->pending = 0;
+    }
+    pthread_mutex_unlock(&log->lock);
+    if (err != BLOOMDB_OK || count == 0) return err;
+
+    err = write_frame(log, frame, count);
+    if (err != BLOOMDB_OK) {
+        pthread_mutex_lock(&log->lock);
+        if (log->error == BLOOMDB_OK) log->error = err;
+        pthread_mutex_unlock(&log->lock);
+    }
+    return err;
+}
+
+static BloomDBError flush_group(BloomDBLog* log) {
+    pthread_mutex_lock(&log->io_lock);
+    BloomDBError err = flush_locked(log);
+    pthread_mutex_unlock(&log->io_lock);
+    return err;
+}
+
+static BloomDBError append_record(BloomDBLog* log, hash128_t h) {
+    const size_t cap = group_capacity(log);
+    for (;;) {
+        pthread_mutex_lock(&log->lock);
+        if (log->error != BLOOMDB_OK) {
+            BloomDBError err = log->error;
+            pthread_mutex_unlock(&log->lock);
+            return err;
+        }
+        if (log->pending < cap) break;
+        // Otro hilo llenó el grupo y aún no lo ha cambiado de buffer
+        pthread_mutex_unlock(&log->lock);
+        flush_group(log);
+    }
+
+    uint8_t* rec = log->active + FRAME_HEADER + log->pending * RECORD_SIZE;
+    put_le64(rec, h.h1);
+    put_le64(rec + 8, h.h2);
+    if (log->pending++ == 0) {
+        log->oldest_ns = now_ns();
+        if (log->flusher_running) pthread_cond_signal(&log->wake);
+    }
+    log->appended++;
+    const bool full = log->pending == cap;
+    pthread_mutex_unlock(&log->lock);
+
+    return full ? flush_group(log) : BLOOMDB_OK;
+}
+
+// Escribe el grupo cuando su registro más antiguo cumple group_interval_ms
+static void* flusher_main(void* arg) {
+    BloomDBLog* log = (BloomDBLog*)arg;
+    const uint64_t interval = (uint64_t)log->group_interval_ms * 1000000ull;
+
+    pthread_mutex_lock(&log->lock);
+    while (!log->stopping) {
+        if (log->pending == 0) {
+            pthread_cond_wait(&log->wake, &log->lock);
+            continue;
+        }
+        uint64_t deadline = log->oldest_ns + interval;
+        if (now_ns() >= deadline) {
+            pthread_mutex_unlock(&log->lock);
+            flush_group(log);
+            pthread_mutex_lock(&log->lock);
+            continue;
+        }
+        struct timespec ts = { (time_t)(deadline / 1000000000ull), (long)(deadline % 1000000000ull) };
+        pthread_cond_timedwait(&log->wake, &log->lock, &ts);
+    }
+    pthread_mutex_unlock(&log->lock);
+    return NULL;
+}
+
+// ============================================================================
+// Recovery
+// ============================================================================
+
+/**
+ * Reaplica los frames completos y válidos desde LOG_HEADER_SIZE. Se para en
+ * el primero que no lo es (escritura cortada por el crash) y devuelve su
+ * desplazamiento: ahí empieza el siguiente frame.
+ */
+static BloomDBError replay(BloomDBLog* log, uint64_t size, uint64_t* out_end) {
+    uint64_t off = LOG_HEADER_SIZE;
+    uint8_t* buf = NULL;
+    size_t buf_cap = 0;
+    BloomDBError err = BLOOMDB_OK;
+
+    while (off + FRAME_HEADER <= size) {
+        uint8_t head[FRAME_HEADER];
+        if (!read_all(log->fd, head, FRAME_HEADER, off)) {
+            err = BLOOMDB_ERR_FILE_IO;
+            break;
+        }
+        const uint32_t count = get_le32(head);
+        if (count == 0 || count > LOG_MAX_RECORDS ||
+            off + FRAME_HEADER + (uint64_t)count * RECORD_SIZE > size) {
+            break;
+        }
+
+        const size_t len = (size_t)count * RECORD_SIZE;
+        if (len > buf_cap) {
+            uint8_t* grown = realloc(buf, len);
+            if (!grown) {
+                err = BLOOMDB_ERR_ALLOC;
+                break;
+            }
+            buf = grown;
+            buf_cap = len;
+        }
+        if (!read_all(log->fd, buf, len, off + FRAME_HEADER)) {
+            err = BLOOMDB_ERR_FILE_IO;
+            break;
+        }
+        if (crc32c(crc32c(0, head, 4), buf, len) != get_le32(head + 4)) break;
+
+        for (uint32_t i = 0; i < count; i++) {
+            BloomDBDigest d = { get_le64(buf + i * RECORD_SIZE), get_le64(buf + i * RECORD_SIZE + 8), log->db->seed };
+            bloomdb_insert_digest_ex(log->db, &d);
+        }
+        log->replayed += count;
+        off += FRAME_HEADER + len;
+    }
+
+    free(buf);
+    *out_end = off;
+    return err;
+}
+
+// Cabecera nueva o reaplicación del log existente; deja file_size al final
+// del último frame válido
+static BloomDBError prepare_file(BloomDBLog* log, const char* path) {
+    struct stat st;
+    if (fstat(log->fd, &st) != 0) return BLOOMDB_ERR_FILE_IO;
+
+    // Vacío, o cortado antes de terminar la cabecera: log nuevo
+    if ((uint64_t)st.st_size < LOG_HEADER_SIZE) {
+        uint8_t head[LOG_HEADER_SIZE];
+        encode_header(head, log->db->seed);
+        if (ftruncate(log->fd, 0) != 0 || !write_all(log->fd, head, sizeof(head), 0) ||
+            fdatasync(log->fd) != 0) {
+            return BLOOMDB_ERR_FILE_IO;
+        }
+        log->file_size = LOG_HEADER_SIZE;
+        return fsync_parent_dir(path);
+    }
+
+    uint8_t head[LOG_HEADER_SIZE];
+    if (!read_all(log->fd, head, sizeof(head), 0)) return BLOOMDB_ERR_FILE_IO;
+    BloomDBError err = check_header(head, log->db->seed);
+    if (err != BLOOMDB_OK) return err;
+
+    uint64_t end;
+    err = replay(log, (uint64_t)st.st_size, &end);
+    if (err != BLOOMDB_OK) return err;
+    if (end < (uint64_t)st.st_size && (ftruncate(log->fd, (off_t)end) != 0 || fdatasync(log->fd) != 0)) {
+        return BLOOMDB_ERR_FILE_IO;
+    }
+    log->file_size = end;
+    return BLOOMDB_OK;
+}
+
+// ============================================================================
+// Extended API (explicit error handling)
+// ============================================================================
+
+static void log_destroy(BloomDBLog* log) {
+    if (log->fd >= 0) close(log->fd);
+    pthread_cond_destroy(&log->wake);
+    pthread_mutex_destroy(&log->io_lock);
+    pthread_mutex_destroy(&log->lock);
+    free(log->active);
+    free(log->spare);
+    free(log);
+}
+
+BloomDBError bloomdb_log_open_ex(BloomDB* db, const char* path, const BloomDBLogOptions* opts,
+                                 BloomDBLog** out_log) {
+    const BloomDBLogOptions defaults = { BLOOMDB_LOG_DEFAULT_GROUP_BYTES, BLOOMDB_LOG_DEFAULT_GROUP_INTERVAL };
+    if (!opts) opts = &defaults;
+    if (!db || !path || !out_log || opts->group_bytes > BLOOMDB_LOG_MAX_GROUP_BYTES ||
+        db->hash_algo != BLOOMDB_HASH_MURMUR3) {
+        return BLOOMDB_ERR_INVALID_ARGUMENT;
+    }
+    if (db->read_only) return BLOOMDB_ERR_READ_ONLY;
+
+    BloomDBLog* log = calloc(1, sizeof(BloomDBLog));
+    if (!log) return BLOOMDB_ERR_ALLOC;
+    log->db = db;
+    log->group_bytes = opts->group_bytes;
+    log->group_interval_ms = opts->group_interval_ms;
+    pthread_mutex_init(&log->lock, NULL);
+    pthread_mutex_init(&log->io_lock, NULL);
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&log->wake, &attr);
+    pthread_condattr_destroy(&attr);
+
+    const size_t frame = FRAME_HEADER + group_capacity(log) * RECORD_SIZE;
+    log->active = malloc(frame);
+    log->spare = malloc(frame);
+    log->fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    BloomDBError err = !log->active || !log->spare ? BLOOMDB_ERR_ALLOC
+                     : log->fd < 0                 ? BLOOMDB_ERR_FILE_IO
+                                                   : prepare_file(log, path);
+    if (err == BLOOMDB_OK && log->group_interval_ms > 0) {
+        if (pthread_create(&log->flusher, NULL, flusher_main, log) == 0) {
+            log->flusher_running = 1;
+        } else {
+            err = BLOOMDB_ERR_INTERNAL;
+        }
+    }
+    if (err != BLOOMDB_OK) {
+        log_destroy(log);
+        return err;
+    }
+
+    *out_log = log;
+    return BLOOMDB_OK;
+}
+
+BloomDBError bloomdb_log_close_ex(BloomDBLog* log) {
+    if (!log) return BLOOMDB_ERR_INVALID_ARGUMENT;
+
+    if (log->flusher_running) {
+        pthread_mutex_lock(&log->lock);
+        log->stopping = 1;
+        pthread_cond_signal(&log->wake);
+        pthread_mutex_unlock(&log->lock);
+        pthread_join(log->flusher, NULL);
+    }
+    BloomDBError err = flush_group(log);
+    log_destroy(log);
+    return err;
+}
+
+BloomDBError bloomdb_log_insert_ex(BloomDBLog* log, const void* key, size_t len) {
+    if (!log || !key || len == 0) return BLOOMDB_ERR_INVALID_ARGUMENT;
+
+    hash128_t h = hash128(key, len, log->db->seed);
+    BloomDBDigest d = { h.h1, h.h2, log->db->seed };
+    BloomDBError err = bloomdb_insert_digest_ex(log->db, &d);
+    return err == BLOOMDB_OK ? append_record(log, h) : err;
+}
+
+// Mismo registro que insert(&value, 8): hash128_u64 da el mismo digest
+BloomDBError bloomdb_log_insert_u64_ex(BloomDBLog* log, uint64_t value) {
+    if (!log) return BLOOMDB_ERR_INVALID_ARGUMENT;
+
+    hash128_t h = hash128_u64(value, log->db->seed);
+    BloomDBDigest d = { h.h1, h.h2, log->db->seed };
+    BloomDBError err = bloomdb_insert_digest_ex(log->db, &d);
+    return err == BLOOMDB_OK ? append_record(log, h) : err;
+}
+
+BloomDBError bloomdb_log_sync_ex(BloomDBLog* log) {
+    if (!log) return BLOOMDB_ERR_INVALID_ARGUMENT;
+    return flush_group(log);
+}
+
+/**
+ * io_lock se mantiene todo el checkpoint: el grupo pendiente se escribe
+ * antes del snapshot y nada se añade al log hasta truncarlo. Si el proceso
+ * muere entre el rename y el truncado, el siguiente open reaplica registros
+ * que el snapshot ya tiene, sin efecto.
+ */
+BloomDBError bloomdb_log_checkpoint_ex(BloomDBLog* log, const char* snapshot_path) {
+    if (!log) return BLOOMDB_ERR_INVALID_ARGUMENT;
+    if (!snapshot_path && (!log->db->mapping || log->db->read_only)) return BLOOMDB_ERR_INVALID_ARGUMENT;
+
+    pthread_mutex_lock(&log->io_lock);
+    BloomDBError err = flush_locked(log);
+
+    if (err == BLOOMDB_OK && snapshot_path) {
+        size_t n = strlen(snapshot_path);
+        char* tmp = malloc(n + 5);
+        if (!tmp) {
+            err = BLOOMDB_ERR_ALLOC;
+        } else {
+            memcpy(tmp, snapshot_path, n);
+            memcpy(tmp + n, ".tmp", 5);
+            err = bloomdb_save_ex(log->db, tmp);
+            if (err == BLOOMDB_OK) err = fsync_path(tmp);
+            if (err == BLOOMDB_OK && rename(tmp, snapshot_path) != 0) err = BLOOMDB_ERR_FILE_IO;
+            if (err == BLOOMDB_OK) err = fsync_parent_dir(snapshot_path);
+            if (err != BLOOMDB_OK) unlink(tmp);
+            free(tmp);
+        }
+    } else if (err == BLOOMDB_OK) {
+        err = bloomdb_sync_ex(log->db);
+    }
+
+    if (err == BLOOMDB_OK) {
+        if (ftruncate(log->fd, LOG_HEADER_SIZE) != 0 || fdatasync(log->fd) != 0) {
+            err = BLOOMDB_ERR_FILE_IO;
+        } else {
+            log->file_size = LOG_HEADER_SIZE;
+        }
+    }
+    pthread_mutex_unlock(&log->io_lock);
+    return err;
+}
+
+// ============================================================================
+// Simple API
+// ============================================================================
+
+BloomDBLog* bloomdb_log_open(BloomDB* db, const char* path, const BloomDBLogOptions* opts) {
+    BloomDBLog* log = NULL;
+    if (bloomdb_log_open_ex(db, path, opts, &log) != BLOOMDB_OK) return NULL;
+    return log;
+}
+
+void bloomdb_log_close(BloomDBLog* log) {
+    if (log) bloomdb_log_close_ex(log);
+}
+
+bool bloomdb_log_insert(BloomDBLog* log, const void* key, size_t len) {
+    return bloomdb_log_insert_ex(log, key, len) == BLOOMDB_OK;
+}
+
+bool bloomdb_log_insert_u64(BloomDBLog* log, uint64_t value) {
+    return bloomdb_log_insert_u64_ex(log, value) == BLOOMDB_OK;
+}
+
+bool bloomdb_log_sync(BloomDBLog* log) {
+    return bloomdb_log_sync_ex(log) == BLOOMDB_OK;
+}
+
+bool bloomdb_log_checkpoint(BloomDBLog* log, const char* snapshot_path) {
+    return bloomdb_log_checkpoint_ex(log, snapshot_path) == BLOOMDB_OK;
+}
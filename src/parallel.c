@@ -0,0 +1,97 @@
+#include "bloomdb.h"
+#include "bloomdb_internal.h"
+#include <pthread.h>
+#include <unistd.h>
+
+// ============================================================================
+// Construcción paralela
+//
+// Las claves se reparten en rangos contiguos, uno por hilo, y cada hilo los
+// inserta con el camino batch (hash por grupos + prefetch). Todos escriben
+// en el mismo bitarray con los kernels atómicos del modo concurrente: OR es
+// conmutativo, así que el resultado es idéntico bit a bit al serie sin
+// copias por hilo (un filtro de miles de millones de claves no cabe T veces
+// en memoria) ni merge final.
+// ============================================================================
+
+// Por debajo de este número de claves por hilo no compensa crear hilos
+#define BUILD_MIN_KEYS_PER_THREAD 16384
+#define BUILD_MAX_THREADS 256
+
+typedef struct {
+    BloomDB* db;
+    const void* const* keys;
+    const size_t* lens;
+    size_t n;
+} BuildChunk;
+
+static void* build_worker(void* arg) {
+    BuildChunk* c = (BuildChunk*)arg;
+    bloomdb_insert_batch_ex(c->db, c->keys, c->lens, c->n);
+    return NULL;
+}
+
+static int build_thread_count(int threads, size_t n) {
+    if (threads <= 0) {
+        long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = ncpu > 0 ? (int)ncpu : 1;
+    }
+    if (threads > BUILD_MAX_THREADS) threads = BUILD_MAX_THREADS;
+
+    size_t useful = n / BUILD_MIN_KEYS_PER_THREAD;
+    if (useful < 1) useful = 1;
+    if ((size_t)threads > useful) threads = (int)useful;
+    return threads;
+}
+
+BloomDBError bloomdb_build_parallel_ex(BloomDB* db, const void* const* keys, const size_t* lens,
+                                       size_t n, int threads) {
+    if (!db) return BLOOMDB_ERR_INVALID_ARGUMENT;
+    if (n == 0) return BLOOMDB_OK;
+    if (!keys || !lens) return BLOOMDB_ERR_INVALID_ARGUMENT;
+
+    // Todo el lote se valida antes de insertar nada (igual que insert_batch)
+    for (size_t i = 0; i < n; i++) {
+        if (!keys[i] || lens[i] == 0) return BLOOMDB_ERR_INVALID_ARGUMENT;
+    }
+
+    if (db->read_only) return BLOOMDB_ERR_READ_ONLY;
+
+    // Los hilos escriben con atómicos de 64 bits: sin palabras alineadas
+    // (archivo mapeado) se construye en el hilo llamador
+    threads = bloomdb_words_aligned(db) ? build_thread_count(threads, n) : 1;
+    if (threads == 1) return bloomdb_insert_batch_ex(db, keys, lens, n);
+
+    // Vista concurrente del filtro: comparte el bitarray y usa los kernels
+    // atómicos, sin cambiar el modo de db para el llamador
+    BloomDB shared = *db;
+    shared.concurrent = 1;
+    bloomdb_select_kernels(&shared);
+
+    BuildChunk chunks[BUILD_MAX_THREADS];
+    pthread_t tid[BUILD_MAX_THREADS];
+    bool started[BUILD_MAX_THREADS] = { false };
+    size_t per = n / (size_t)threads, extra = n % (size_t)threads, base = 0;
+    for (int t = 0; t < threads; t++) {
+        size_t len = per + ((size_t)t < extra ? 1 : 0);
+        chunks[t] = (BuildChunk){ &shared, keys + base, lens + base, len };
+        base += len;
+    }
+
+    // El hilo llamador se queda el rango 0. Si no se puede crear un hilo,
+    // su rango también lo inserta el llamador: nunca se pierde una clave.
+    for (int t = 1; t < threads; t++) {
+        started[t] = pthread_create(&tid[t], NULL, build_worker, &chunks[t]) == 0;
+    }
+    build_worker(&chunks[0]);
+    for (int t = 1; t < threads; t++) {
+        if (started[t]) pthread_join(tid[t], NULL);
+        else build_worker(&chunks[t]);
+    }
+    return BLOOMDB_OK;
+}
+
+bool bloomdb_build_parallel(BloomDB* db, const void* const* keys, const size_t* lens,
+                            size_t n, int threads) {
+    return bloomdb_build_parallel_ex(db, keys, lens, n, threads) == BLOOMDB_OK;
+}
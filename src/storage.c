@@ -5,80 +5,2101 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
+#include <pthread.h>
 #include <errno.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "bloomdb_internal.h"
+#include "bitarray.h"
+#include "crc32c.h"
+
+// ============================================================================
+// Metadata extension
+//
+// Bloque opcional que sigue al bitarray en archivos v1 (solo lectura; v2
+// guarda estos campos en su cabecera):
+//   uint32_t magic  (BLOOMDB_EXT_MAGIC)
+//   uint32_t count  (número de campos)
+//   uint32_t fields[count]
+//
+// Los archivos antiguos terminan justo después del bitarray; al no tener
+// extensión (o tener menos campos) se cargan con los valores de entonces:
+// hash legacy e índice por módulo.
+// ============================================================================
+
+#define BLOOMDB_EXT_MAGIC 0x58424442u   // "BDBX"
+
+enum {
+    EXT_FIELD_HASH_ALGO = 0,
+    EXT_FIELD_INDEX_MODE,
+    EXT_FIELD_COUNT
+};
+
+static BloomDBError read_extension(BloomDB* db, FILE* f) {
+    uint32_t header[2];
+    size_t got = fread(header, sizeof(uint32_t), 2, f);
+    if (got == 0 && feof(f)) {
+        db->hash_algo = BLOOMDB_HASH_LEGACY;   // archivo sin extensión
+        db->index_mode = BLOOMDB_INDEX_MODULO;
+        return BLOOMDB_OK;
+    }
+    if (got != 2 || header[0] != BLOOMDB_EXT_MAGIC ||
+        header[1] == 0 || header[1] > EXT_FIELD_COUNT) {
+        return BLOOMDB_ERR_FORMAT;
+    }
+
+    uint32_t fields[EXT_FIELD_COUNT];
+    fields[EXT_FIELD_INDEX_MODE] = BLOOMDB_INDEX_MODULO;
+    if (fread(fields, sizeof(uint32_t), header[1], f) != header[1]) {
+        return BLOOMDB_ERR_FORMAT;
+    }
+
+    if (fields[EXT_FIELD_HASH_ALGO] != BLOOMDB_HASH_LEGACY &&
+        fields[EXT_FIELD_HASH_ALGO] != BLOOMDB_HASH_MURMUR3) {
+        return BLOOMDB_ERR_FORMAT;
+    }
+    if (fields[EXT_FIELD_INDEX_MODE] > BLOOMDB_INDEX_MASK ||
+        (fields[EXT_FIELD_INDEX_MODE] == BLOOMDB_INDEX_MASK &&
+         (db->bit_count & (db->bit_count - 1)) != 0)) {
+        return BLOOMDB_ERR_FORMAT;
+    }
+    db->hash_algo = (int)fields[EXT_FIELD_HASH_ALGO];
+    db->index_mode = (int)fields[EXT_FIELD_INDEX_MODE];
+    return BLOOMDB_OK;
+}
+
+// ============================================================================
+// Formato v2
+//
+// Cabecera de anchos fijos, todo little-endian (igual en cualquier CPU):
+//    0 uint32 magic (BLOOMDB_V2_MAGIC)     4 uint32 version (2)
+//    8 uint32 endian (0x01020304)          12 uint32 chunk_shift
+//   16 uint64 bit_count                    24 uint64 byte_count
+//   32 uint32 num_hashes                   36 uint32 hash_algo
+//   40 uint32 index_mode                   44 uint32 flags
+//   48 uint64 seed                         56 uint64 payload_offset
+//   64 uint64 chunk_count                  72 uint64 crc_offset
+//   80 uint32 header_crc (CRC32C de los bytes 0..79)
+//   84 uint32 reserved (0)
+// Ceros hasta payload_offset (4096: el bitarray empieza en página propia y
+// se puede mapear y usar por palabras), el bitarray, relleno a 8 bytes y en
+// crc_offset chunk_count CRC32C uint32, uno por cada 2^chunk_shift bytes del
+// bitarray (el último puede ser parcial).
+//
+// Con flags = BLOOMDB_V2_FLAG_SPARSE (bloomdb_save_encoded) el payload
+// empieza justo tras la cabecera, crc_offset es 0 y cada chunk va
+// codificado con su CRC (ver "Sparse encoding"); no se puede mapear.
+//
+// BLOOMDB_V2_FLAG_STALE marca un archivo abierto con un mapeo escribible:
+// las inserciones van al archivo sin tocar la tabla de CRC, que solo se
+// rehace en bloomdb_sync y al cerrar. Se escribe (con msync) al abrir y se
+// quita al cerrar con bloomdb_free; si el proceso muere antes, la marca
+// sigue ahí y load acepta el bitarray sin comparar los CRC en vez de dar
+// CHECKSUM por una tabla que se sabe atrasada.
+//
+// v1 (bloomdb_save anterior): size_t bit_count, size_t byte_count,
+// int num_hashes, uint64_t seed en formato nativo, los bits desde el byte
+// 28 y la extensión BDBX opcional. Se distingue porque sus 8 primeros bytes
+// son bit_count, que nunca vale magic | 2 << 32 en un filtro real.
+//
+// Cada tipo de fichero lleva su propio magic "BDB?" y no pueden repetirse,
+// porque el magic es lo que devuelve FORMAT al abrir un fichero con el
+// loader equivocado: BDB2 (BloomDB), BDBX (extensión v1), BDBD (delta),
+// BDBK (blocked), BDBS (split), BDBP (partitioned), BDBF (fuse),
+// BDBU (cuckoo), BDBW (windowed), BDBC (counting), BDBL (scalable),
+// BDBR (range) y BDBG (log de inserciones, insert_log.c).
+// ============================================================================
+
+#define BLOOMDB_V2_MAGIC        0x32424442u   // "BDB2"
+#define BLOOMDB_V2_VERSION      2u
+#define BLOOMDB_V2_ENDIAN       0x01020304u
+#define BLOOMDB_V2_HEADER_SIZE  88
+#define BLOOMDB_V2_PAYLOAD      4096
+#define BLOOMDB_V2_CHUNK_SHIFT  20            // CRC por MiB de bitarray
+#define BLOOMDB_V2_MIN_SHIFT    12
+#define BLOOMDB_V2_MAX_SHIFT    30
+#define BLOOMDB_V2_FLAG_SPARSE  1u            // chunks codificados
+#define BLOOMDB_V2_FLAG_STALE   2u            // tabla de CRC atrasada (mapeo escribible)
+
+typedef struct {
+    uint64_t bit_count;
+    uint64_t byte_count;
+    uint64_t seed;
+    uint64_t payload_offset;
+    uint64_t chunk_count;
+    uint64_t crc_offset;
+    uint32_t num_hashes;
+    uint32_t hash_algo;
+    uint32_t index_mode;
+    uint32_t chunk_shift;
+    uint32_t flags;
+} V2Header;
+
+static inline uint64_t round8(uint64_t n) {
+    return (n + 7) & ~(uint64_t)7;
+}
+
+static bool is_v2(const uint8_t* head, size_t got) {
+    return got >= 8 && get_le32(head) == BLOOMDB_V2_MAGIC && get_le32(head + 4) == BLOOMDB_V2_VERSION;
+}
+
+static void encode_v2_header(const BloomDB* db, uint32_t flags, uint8_t* out) {
+    const uint64_t chunk_count = (db->byte_count + (1ULL << BLOOMDB_V2_CHUNK_SHIFT) - 1) >> BLOOMDB_V2_CHUNK_SHIFT;
+    memset(out, 0, BLOOMDB_V2_HEADER_SIZE);
+    put_le32(out, BLOOMDB_V2_MAGIC);
+    put_le32(out + 4, BLOOMDB_V2_VERSION);
+    put_le32(out + 8, BLOOMDB_V2_ENDIAN);
+    put_le32(out + 12, BLOOMDB_V2_CHUNK_SHIFT);
+    put_le64(out + 16, db->bit_count);
+    put_le64(out + 24, db->byte_count);
+    put_le32(out + 32, (uint32_t)db->num_hashes);
+    put_le32(out + 36, (uint32_t)db->hash_algo);
+    put_le32(out + 40, (uint32_t)db->index_mode);
+    put_le32(out + 44, flags);
+    put_le64(out + 48, db->seed);
+    put_le64(out + 64, chunk_count);
+    if (flags & BLOOMDB_V2_FLAG_SPARSE) {
+        put_le64(out + 56, BLOOMDB_V2_HEADER_SIZE);
+    } else {
+        put_le64(out + 56, BLOOMDB_V2_PAYLOAD);
+        put_le64(out + 72, BLOOMDB_V2_PAYLOAD + round8(db->byte_count));
+    }
+    put_le32(out + 80, crc32c(0, out, 80));
+}
+
+// Valida la cabecera entera: CHECKSUM si su CRC no cuadra, FORMAT si los
+// campos no son coherentes entre sí
+static BloomDBError decode_v2_header(const uint8_t* in, V2Header* h) {
+    if (get_le32(in + 8) != BLOOMDB_V2_ENDIAN) return BLOOMDB_ERR_FORMAT;
+    if (get_le32(in + 80) != crc32c(0, in, 80)) return BLOOMDB_ERR_CHECKSUM;
+
+    h->chunk_shift = get_le32(in + 12);
+    h->bit_count = get_le64(in + 16);
+    h->byte_count = get_le64(in + 24);
+    h->num_hashes = get_le32(in + 32);
+    h->hash_algo = get_le32(in + 36);
+    h->index_mode = get_le32(in + 40);
+    h->flags = get_le32(in + 44);
+    h->seed = get_le64(in + 48);
+    h->payload_offset = get_le64(in + 56);
+    h->chunk_count = get_le64(in + 64);
+    h->crc_offset = get_le64(in + 72);
+
+    if ((h->flags & ~(BLOOMDB_V2_FLAG_SPARSE | BLOOMDB_V2_FLAG_STALE)) != 0 ||
+        h->flags == (BLOOMDB_V2_FLAG_SPARSE | BLOOMDB_V2_FLAG_STALE) ||
+        h->chunk_shift < BLOOMDB_V2_MIN_SHIFT || h->chunk_shift > BLOOMDB_V2_MAX_SHIFT ||
+        h->bit_count == 0 || h->bit_count > SIZE_MAX / 2 || h->byte_count != (h->bit_count + 7) / 8 ||
+        h->num_hashes == 0 || h->num_hashes > INT32_MAX ||
+        (h->hash_algo != BLOOMDB_HASH_LEGACY && h->hash_algo != BLOOMDB_HASH_MURMUR3) ||
+        h->index_mode > BLOOMDB_INDEX_MASK ||
+        (h->index_mode == BLOOMDB_INDEX_MASK && (h->bit_count & (h->bit_count - 1)) != 0) ||
+        h->payload_offset < BLOOMDB_V2_HEADER_SIZE || h->payload_offset % 8 != 0 ||
+        h->payload_offset > UINT64_MAX / 2 ||
+        h->chunk_count != (h->byte_count + (1ULL << h->chunk_shift) - 1) >> h->chunk_shift ||
+        h->crc_offset != (h->flags & BLOOMDB_V2_FLAG_SPARSE ? 0 : h->payload_offset + round8(h->byte_count))) {
+        return BLOOMDB_ERR_FORMAT;
+    }
+    return BLOOMDB_OK;
+}
+
+// Tamaño mínimo de un archivo v2 con esta cabecera
+static uint64_t v2_file_size(const V2Header* h) {
+    return h->crc_offset + 4 * h->chunk_count;
+}
+
+static uint32_t chunk_crc(const BloomDB* db, size_t chunk, int shift) {
+    size_t start = chunk << shift;
+    size_t len = db->byte_count - start;
+    if (len > (size_t)1 << shift) len = (size_t)1 << shift;
+    return crc32c(0, db->bitarray + start, len);
+}
+
+// ============================================================================
+// Extended API (explicit error handling)
+// ============================================================================
+
+typedef uint64_t __attribute__((may_alias)) live_word_t;
+
+/**
+ * Copia un tramo del bitarray mientras otros hilos insertan: cargas
+ * atómicas relaxed por palabra (por byte si el mapeo no está alineado). Los
+ * bits solo pasan de 0 a 1, así que la copia tiene todo lo insertado antes
+ * de empezar, aunque no sea una foto de un único instante.
+ */
+static void copy_live(const BloomDB* db, uint8_t* dst, size_t start, size_t len) {
+    const uint8_t* src = db->bitarray + start;
+    size_t i = 0;
+    if (bloomdb_words_aligned(db)) {
+        for (; i + 8 <= len; i += 8) {
+            uint64_t w = __atomic_load_n((const live_word_t*)(src + i), __ATOMIC_RELAXED);
+            memcpy(dst + i, &w, sizeof(w));
+        }
+    }
+    for (; i < len; i++) dst[i] = __atomic_load_n(src + i, __ATOMIC_RELAXED);
+}
+
+/**
+ * Escribe un archivo v2 chunk a chunk: el CRC de cada chunk se calcula justo
+ * antes de escribirlo (aún en caché) y la tabla va al final. Con live, cada
+ * chunk se copia antes a un buffer y CRC y escritura salen de la copia, para
+ * que cuadren aunque el filtro cambie mientras tanto.
+ */
+static BloomDBError write_v2(const BloomDB* db, FILE* f, bool live) {
+    const size_t chunk = (size_t)1 << BLOOMDB_V2_CHUNK_SHIFT;
+    const size_t chunk_count = (db->byte_count + chunk - 1) >> BLOOMDB_V2_CHUNK_SHIFT;
+    uint8_t* crcs = malloc(chunk_count * 4);
+    uint8_t* copy = live ? malloc(chunk) : NULL;
+    if (!crcs || (live && !copy)) {
+        free(crcs);
+        free(copy);
+        return BLOOMDB_ERR_ALLOC;
+    }
+
+    static const uint8_t zeros[BLOOMDB_V2_PAYLOAD];
+    uint8_t head[BLOOMDB_V2_HEADER_SIZE];
+    encode_v2_header(db, 0, head);
+    bool ok = fwrite(head, 1, sizeof(head), f) == sizeof(head) &&
+              fwrite(zeros, 1, BLOOMDB_V2_PAYLOAD - sizeof(head), f) == BLOOMDB_V2_PAYLOAD - sizeof(head);
+
+    for (size_t i = 0; ok && i < chunk_count; i++) {
+        const size_t start = i * chunk;
+        const size_t len = db->byte_count - start < chunk ? db->byte_count - start : chunk;
+        const uint8_t* data = db->bitarray + start;
+        if (live) {
+            copy_live(db, copy, start, len);
+            data = copy;
+        }
+        put_le32(crcs + 4 * i, crc32c(0, data, len));
+        ok = fwrite(data, 1, len, f) == len;
+    }
+
+    const size_t pad = (size_t)(round8(db->byte_count) - db->byte_count);
+    ok = ok && fwrite(zeros, 1, pad, f) == pad && fwrite(crcs, 4, chunk_count, f) == chunk_count;
+    free(crcs);
+    free(copy);
+    return ok ? BLOOMDB_OK : BLOOMDB_ERR_FILE_IO;
+}
+
+BloomDBError bloomdb_save_ex(const BloomDB* db, const char* path) {
+    if (!db || !path) return BLOOMDB_ERR_INVALID_ARGUMENT;
+
+    FILE* f = fopen(path, "wb");
+    if (!f) return BLOOMDB_ERR_FILE_IO;
+
+    BloomDBError err = write_v2(db, f, false);
+    if (fclose(f) != 0 && err == BLOOMDB_OK) err = BLOOMDB_ERR_FILE_IO;
+    return err;
+}
+
+// ============================================================================
+// Sparse encoding
+//
+// Con BLOOMDB_V2_FLAG_SPARSE cada chunk es un registro:
+//   uint32 encoding (BLOOMDB_CHUNK_RAW / BLOOMDB_CHUNK_RUNS)
+//   uint32 encoded_len
+//   uint32 CRC32C del chunk decodificado (el mismo que la tabla de v2)
+//   encoded_len bytes
+// RAW son los bytes tal cual. RUNS es run-length de los ceros: por cada
+// bit a 1, en orden, un varint LEB128 con los bits a 0 que lo preceden
+// desde el anterior (un índice disperso por diferencias). Un chunk sin bits
+// es un registro RUNS de 0 bytes.
+//
+// La codificación de cada chunk sale de su ocupación medida (popcount): con
+// pocos bits los saltos caben en 1-2 bytes y RUNS ocupa ~1 byte por bit,
+// frente a 1/8 de byte por bit de RAW. Si aun así RUNS no cabe en el
+// tamaño del chunk (bits agrupados de forma rara), el chunk va en RAW.
+// ============================================================================
+
+#define BLOOMDB_CHUNK_RAW   0u
+#define BLOOMDB_CHUNK_RUNS  1u
+#define BLOOMDB_CHUNK_HEAD  12
+
+// RUNS cuando menos de 1 de cada BLOOMDB_SPARSE_FILL_DIV bits está a 1
+#define BLOOMDB_SPARSE_FILL_DIV 16
+
+static bool sparse_fill(size_t set_bits, size_t nbytes) {
+    return set_bits * BLOOMDB_SPARSE_FILL_DIV < nbytes * 8;
+}
+
+static size_t put_varint(uint8_t* out, uint64_t v) {
+    size_t n = 0;
+    for (; v >= 0x80; v >>= 7) out[n++] = (uint8_t)(v | 0x80);
+    out[n++] = (uint8_t)v;
+    return n;
+}
+
+/**
+ * Codifica len bytes en RUNS sobre out (cap bytes). Recorre palabras de 64
+ * bits y salta las vacías. SIZE_MAX si no cabe.
+ */
+static size_t encode_runs(const uint8_t* data, size_t len, uint8_t* out, size_t cap) {
+    size_t n = 0;
+    uint64_t next = 0;   // primer bit después del último codificado
+    for (size_t i = 0; i < len; i += 8) {
+        uint64_t w;
+        if (len - i >= 8) {
+            w = get_le64(data + i);
+        } else {
+            uint8_t tail[8] = { 0 };
+            memcpy(tail, data + i, len - i);
+            w = get_le64(tail);
+        }
+        for (; w; w &= w - 1) {
+            const uint64_t bit = (uint64_t)i * 8 + (uint64_t)__builtin_ctzll(w);
+            if (cap - n < 10) return SIZE_MAX;
+            n += put_varint(out + n, bit - next);
+            next = bit + 1;
+        }
+    }
+    return n;
+}
+
+// Decodifica RUNS sobre dst (a cero, len bytes); FORMAT si se sale del chunk
+static BloomDBError decode_runs(const uint8_t* in, size_t n, uint8_t* dst, size_t len) {
+    const uint64_t nbits = (uint64_t)len * 8;
+    uint64_t next = 0;
+    size_t i = 0;
+    while (i < n) {
+        uint64_t gap = 0;
+        int shift = 0;
+        uint8_t b;
+        do {
+            if (i == n || shift > 56) return BLOOMDB_ERR_FORMAT;
+            b = in[i++];
+            gap |= (uint64_t)(b & 0x7f) << shift;
+            shift += 7;
+        } while (b & 0x80);
+        if (gap >= nbits - next) return BLOOMDB_ERR_FORMAT;
+        const uint64_t bit = next + gap;
+        dst[bit >> 3] |= (uint8_t)(1 << (bit & 7));
+        next = bit + 1;
+    }
+    return BLOOMDB_OK;
+}
+
+static BloomDBError write_sparse(const BloomDB* db, FILE* f) {
+    const size_t chunk = (size_t)1 << BLOOMDB_V2_CHUNK_SHIFT;
+    const size_t chunk_count = (db->byte_count + chunk - 1) >> BLOOMDB_V2_CHUNK_SHIFT;
+    uint8_t* buf = malloc(chunk);
+    if (!buf) return BLOOMDB_ERR_ALLOC;
+
+    uint8_t head[BLOOMDB_V2_HEADER_SIZE];
+    encode_v2_header(db, BLOOMDB_V2_FLAG_SPARSE, head);
+    bool ok = fwrite(head, 1, sizeof(head), f) == sizeof(head);
+
+    for (size_t i = 0; ok && i < chunk_count; i++) {
+        const size_t start = i * chunk;
+        const size_t len = db->byte_count - start < chunk ? db->byte_count - start : chunk;
+        const uint8_t* data = db->bitarray + start;
+        size_t n = SIZE_MAX;
+        if (sparse_fill(bitarray_popcount(data, len), len)) n = encode_runs(data, len, buf, len);
+
+        uint8_t rec[BLOOMDB_CHUNK_HEAD];
+        put_le32(rec, n == SIZE_MAX ? BLOOMDB_CHUNK_RAW : BLOOMDB_CHUNK_RUNS);
+        put_le32(rec + 4, (uint32_t)(n == SIZE_MAX ? len : n));
+        put_le32(rec + 8, crc32c(0, data, len));
+        ok = fwrite(rec, 1, sizeof(rec), f) == sizeof(rec) &&
+             (n == SIZE_MAX ? fwrite(data, 1, len, f) == len : fwrite(buf, 1, n, f) == n);
+    }
+    free(buf);
+    return ok ? BLOOMDB_OK : BLOOMDB_ERR_FILE_IO;
+}
+
+// Chunk a chunk directamente sobre el bitarray: RAW se lee en su sitio y
+// RUNS se decodifica desde un buffer del tamaño de un chunk
+static BloomDBError load_sparse(FILE* f, const V2Header* h, BloomDB* db) {
+    const size_t chunk = (size_t)1 << h->chunk_shift;
+    if (fseeko(f, (off_t)h->payload_offset, SEEK_SET) != 0) return BLOOMDB_ERR_FORMAT;
+    uint8_t* buf = malloc(db->byte_count < chunk ? db->byte_count : chunk);
+    if (!buf) return BLOOMDB_ERR_ALLOC;
+
+    BloomDBError err = BLOOMDB_OK;
+    for (size_t i = 0; err == BLOOMDB_OK && i < h->chunk_count; i++) {
+        const size_t start = i * chunk;
+        const size_t len = db->byte_count - start < chunk ? db->byte_count - start : chunk;
+        uint8_t* dst = db->bitarray + start;
+        uint8_t rec[BLOOMDB_CHUNK_HEAD];
+        if (fread(rec, 1, sizeof(rec), f) != sizeof(rec)) {
+            err = BLOOMDB_ERR_FORMAT;
+            break;
+        }
+        const uint32_t encoding = get_le32(rec);
+        const size_t n = get_le32(rec + 4);
+        if (encoding == BLOOMDB_CHUNK_RAW && n == len) {
+            if (fread(dst, 1, len, f) != len) err = BLOOMDB_ERR_FORMAT;
+        } else if (encoding == BLOOMDB_CHUNK_RUNS && n <= len) {
+            err = fread(buf, 1, n, f) == n ? decode_runs(buf, n, dst, len) : BLOOMDB_ERR_FORMAT;
+        } else {
+            err = BLOOMDB_ERR_FORMAT;
+        }
+        if (err == BLOOMDB_OK && crc32c(0, dst, len) != get_le32(rec + 8)) err = BLOOMDB_ERR_CHECKSUM;
+    }
+    free(buf);
+    return err;
+}
+
+static BloomDBError write_encoded(const BloomDB* db, FILE* f, BloomDBEncoding encoding) {
+    if (encoding == BLOOMDB_ENCODING_AUTO) {
+        encoding = sparse_fill(bloomdb_count_set_bits(db), db->byte_count) ? BLOOMDB_ENCODING_SPARSE
+                                                                            : BLOOMDB_ENCODING_RAW;
+    }
+    return encoding == BLOOMDB_ENCODING_SPARSE ? write_sparse(db, f) : write_v2(db, f, false);
+}
+
+static bool encoding_valid(BloomDBEncoding encoding) {
+    return encoding == BLOOMDB_ENCODING_RAW || encoding == BLOOMDB_ENCODING_SPARSE ||
+           encoding == BLOOMDB_ENCODING_AUTO;
+}
+
+BloomDBError bloomdb_save_encoded_ex(const BloomDB* db, const char* path, BloomDBEncoding encoding) {
+    if (!db || !path || !encoding_valid(encoding)) return BLOOMDB_ERR_INVALID_ARGUMENT;
+
+    FILE* f = fopen(path, "wb");
+    if (!f) return BLOOMDB_ERR_FILE_IO;
+
+    BloomDBError err = write_encoded(db, f, encoding);
+    if (fclose(f) != 0 && err == BLOOMDB_OK) err = BLOOMDB_ERR_FILE_IO;
+    return err;
+}
+
+BloomDBError bloomdb_serialize_ex(const BloomDB* db, BloomDBEncoding encoding, uint8_t** out_buf, size_t* out_len) {
+    if (!db || !out_buf || !out_len || !encoding_valid(encoding)) return BLOOMDB_ERR_INVALID_ARGUMENT;
+
+    char* buf = NULL;
+    size_t len = 0;
+    FILE* f = open_memstream(&buf, &len);
+    if (!f) return BLOOMDB_ERR_ALLOC;
+
+    BloomDBError err = write_encoded(db, f, encoding);
+    if (fclose(f) != 0 && err == BLOOMDB_OK) err = BLOOMDB_ERR_ALLOC;
+    if (err != BLOOMDB_OK) {
+        free(buf);
+        return err == BLOOMDB_ERR_FILE_IO ? BLOOMDB_ERR_ALLOC : err;   // en memoria solo falla la reserva
+    }
+    *out_buf = (uint8_t*)buf;
+    *out_len = len;
+    return BLOOMDB_OK;
+}
+
+// Cabecera v1; el bitarray empieza justo después
+#define BLOOMDB_HEADER_SIZE (2 * sizeof(size_t) + sizeof(int) + sizeof(uint64_t))
+
+static BloomDBError read_header(FILE* f, size_t* bits, size_t* bytes, int* num_hashes, uint64_t* seed) {
+    if (fread(bits, sizeof(size_t), 1, f) != 1 ||
+        fread(bytes, sizeof(size_t), 1, f) != 1 ||
+        fread(num_hashes, sizeof(int), 1, f) != 1 ||
+        fread(seed, sizeof(uint64_t), 1, f) != 1) {
+        return BLOOMDB_ERR_FORMAT;
+    }
+
+    // Validar valores razonables
+    if (*bits == 0 || *num_hashes <= 0 || *bytes != (*bits + 7) / 8) {
+        return BLOOMDB_ERR_FORMAT;
+    }
+    return BLOOMDB_OK;
+}
+
+static BloomDBError load_v1(FILE* f, BloomDB** out_db) {
+    size_t bits, bytes;
+    int num_hashes;
+    uint64_t seed;
+
+    BloomDBError err = read_header(f, &bits, &bytes, &num_hashes, &seed);
+    if (err != BLOOMDB_OK) return err;
+
+    BloomDB* db = NULL;
+    err = bloomdb_create_ex(bits, num_hashes, seed, &db);
+    if (err != BLOOMDB_OK) return err;
+
+    if (fread(db->bitarray, 1, bytes, f) != bytes) {
+        bloomdb_free(db);
+        return BLOOMDB_ERR_FORMAT;
+    }
+
+    err = read_extension(db, f);
+    if (err != BLOOMDB_OK) {
+        bloomdb_free(db);
+        return err;
+    }
+    *out_db = db;
+    return BLOOMDB_OK;
+}
+
+/**
+ * Lee primero la tabla de CRC y después el bitarray chunk a chunk,
+ * comprobando cada uno recién leído (aún en caché): la verificación no
+ * vuelve a recorrer el archivo. Con BLOOMDB_V2_FLAG_STALE la tabla no
+ * cuenta.
+ */
+static BloomDBError load_raw(FILE* f, const V2Header* h, BloomDB* db) {
+    uint8_t* crcs = malloc((size_t)h->chunk_count * 4);
+    if (!crcs) return BLOOMDB_ERR_ALLOC;
+    if (fseeko(f, (off_t)h->crc_offset, SEEK_SET) != 0 ||
+        fread(crcs, 4, (size_t)h->chunk_count, f) != h->chunk_count ||
+        fseeko(f, (off_t)h->payload_offset, SEEK_SET) != 0) {
+        free(crcs);
+        return BLOOMDB_ERR_FORMAT;
+    }
+
+    BloomDBError err = BLOOMDB_OK;
+    const size_t chunk = (size_t)1 << h->chunk_shift;
+    const bool stale = (h->flags & BLOOMDB_V2_FLAG_STALE) != 0;
+    for (size_t i = 0; err == BLOOMDB_OK && i < h->chunk_count; i++) {
+        size_t start = i * chunk;
+        size_t len = db->byte_count - start < chunk ? db->byte_count - start : chunk;
+        if (fread(db->bitarray + start, 1, len, f) != len) {
+            err = BLOOMDB_ERR_FORMAT;
+        } else if (!stale && crc32c(0, db->bitarray + start, len) != get_le32(crcs + 4 * i)) {
+            err = BLOOMDB_ERR_CHECKSUM;
+        }
+    }
+    free(crcs);
+    return err;
+}
+
+static BloomDBError load_v2(FILE* f, const uint8_t* head, BloomDB** out_db) {
+    V2Header h;
+    BloomDBError err = decode_v2_header(head, &h);
+    if (err != BLOOMDB_OK) return err;
+
+    BloomDB* db = NULL;
+    err = bloomdb_create_ex((size_t)h.bit_count, (int)h.num_hashes, h.seed, &db);
+    if (err != BLOOMDB_OK) return err;
+    db->hash_algo = (int)h.hash_algo;
+    db->index_mode = (int)h.index_mode;
+
+    err = h.flags & BLOOMDB_V2_FLAG_SPARSE ? load_sparse(f, &h, db) : load_raw(f, &h, db);
+    if (err != BLOOMDB_OK) {
+        bloomdb_free(db);
+        return err;
+    }
+    *out_db = db;
+    return BLOOMDB_OK;
+}
+
+static BloomDBError load_stream(FILE* f, BloomDB** out_db) {
+    uint8_t head[BLOOMDB_V2_HEADER_SIZE];
+    size_t got = fread(head, 1, sizeof(head), f);
+
+    if (is_v2(head, got)) {
+        return got == sizeof(head) ? load_v2(f, head, out_db) : BLOOMDB_ERR_FORMAT;
+    }
+    rewind(f);
+    return load_v1(f, out_db);
+}
+
+BloomDBError bloomdb_load_ex(const char* path, BloomDB** out_db) {
+    if (!path || !out_db) return BLOOMDB_ERR_INVALID_ARGUMENT;
+
+    FILE* f = fopen(path, "rb");
+    if (!f) return BLOOMDB_ERR_FILE_IO;
+
+    BloomDBError err = load_stream(f, out_db);
+    fclose(f);
+    return err;
+}
+
+BloomDBError bloomdb_deserialize_ex(const void* buf, size_t len, BloomDB** out_db) {
+    if (!buf || len == 0 || !out_db) return BLOOMDB_ERR_INVALID_ARGUMENT;
+
+    FILE* f = fmemopen((void*)buf, len, "rb");
+    if (!f) return BLOOMDB_ERR_ALLOC;
+
+    BloomDBError err = load_stream(f, out_db);
+    fclose(f);
+    return err;
+}
+
+// ============================================================================
+// Memory-mapped open
+// ============================================================================
+
+// Cabecera v1 y extensión leídas con stdio (mismas validaciones que
+// load_ex, saltando el bitarray con fseek)
+static BloomDBError read_v1_mapped_header(int fd, const struct stat* st, BloomDB* db) {
+    FILE* f = fdopen(dup(fd), "rb");
+    if (!f) return BLOOMDB_ERR_FILE_IO;
+
+    BloomDBError err = read_header(f, &db->bit_count, &db->byte_count, &db->num_hashes, &db->seed);
+    // Truncado: fseek más allá del final no falla, se comprueba el tamaño
+    if (err == BLOOMDB_OK && (uint64_t)st->st_size < BLOOMDB_HEADER_SIZE + (uint64_t)db->byte_count) {
+        err = BLOOMDB_ERR_FORMAT;
+    }
+    if (err == BLOOMDB_OK && fseeko(f, (off_t)db->byte_count, SEEK_CUR) != 0) err = BLOOMDB_ERR_FILE_IO;
+    if (err == BLOOMDB_OK) err = read_extension(db, f);
+    fclose(f);
+    return err;
+}
+
+static void refresh_crcs(const BloomDB* db) {
+    const size_t chunks = bloomdb_chunk_count(db);
+    for (size_t i = 0; i < chunks; i++) put_le32(db->chunk_crcs + 4 * i, chunk_crc(db, i, db->chunk_shift));
+}
+
+// Cambia flags en la cabecera mapeada (con su CRC) y la lleva a disco
+static BloomDBError write_mapped_flags(const BloomDB* db, uint32_t flags) {
+    uint8_t* head = (uint8_t*)db->mapping;
+    put_le32(head + 44, flags);
+    put_le32(head + 80, crc32c(0, head, 80));
+    return msync(db->mapping, BLOOMDB_V2_HEADER_SIZE, MS_SYNC) == 0 ? BLOOMDB_OK : BLOOMDB_ERR_FILE_IO;
+}
+
+// Al abrir escribible la marca llega a disco antes que cualquier inserción.
+// Si ya estaba (un mapeo anterior que no se cerró), la tabla se rehace ahora.
+static BloomDBError mark_stale(const BloomDB* db, bool was_stale) {
+    if (was_stale) {
+        refresh_crcs(db);
+        return BLOOMDB_OK;
+    }
+    return write_mapped_flags(db, BLOOMDB_V2_FLAG_STALE);
+}
+
+void bloomdb_unmap(BloomDB* db) {
+    if (!db->read_only && db->chunk_crcs) {
+        // Primero tabla y bitarray en disco y después se quita la marca: un
+        // crash entre medias deja el archivo marcado, que load acepta
+        refresh_crcs(db);
+        if (msync(db->mapping, db->mapping_size, MS_SYNC) == 0) write_mapped_flags(db, 0);
+    }
+    munmap(db->mapping, db->mapping_size);
+}
+
+/**
+ * Se valida la cabecera y después se mapea el archivo entero; bitarray
+ * apunta dentro del mapeo (payload_offset en v2, alineado a página;
+ * BLOOMDB_HEADER_SIZE en v1). En v2 chunk_crcs apunta a la tabla de CRC
+ * del mapeo, que se comprueba al abrir solo con BLOOMDB_MMAP_VERIFY. Un
+ * mapeo escribible marca el archivo con BLOOMDB_V2_FLAG_STALE.
+ */
+BloomDBError bloomdb_open_mmap_ex(const char* path, int flags, BloomDB** out_db) {
+    const int known = BLOOMDB_MMAP_WRITABLE | BLOOMDB_MMAP_POPULATE | BLOOMDB_MMAP_RANDOM |
+                      BLOOMDB_MMAP_WILLNEED | BLOOMDB_MMAP_VERIFY;
+    if (!path || !out_db || (flags & ~known)) return BLOOMDB_ERR_INVALID_ARGUMENT;
+    const bool writable = (flags & BLOOMDB_MMAP_WRITABLE) != 0;
+
+    int fd = open(path, writable ? O_RDWR : O_RDONLY);
+    if (fd < 0) return BLOOMDB_ERR_FILE_IO;
+    struct stat st;
+    uint8_t head[BLOOMDB_V2_HEADER_SIZE];
+    ssize_t got;
+    if (fstat(fd, &st) != 0 || (got = pread(fd, head, sizeof(head), 0)) < 0) {
+        close(fd);
+        return BLOOMDB_ERR_FILE_IO;
+    }
+
+    BloomDB* db = calloc(1, sizeof(BloomDB));
+    if (!db) {
+        close(fd);
+        return BLOOMDB_ERR_ALLOC;
+    }
+
+    const bool v2 = is_v2(head, (size_t)got);
+    V2Header h;
+    BloomDBError err;
+    if (v2) {
+        err = (size_t)got == sizeof(head) ? decode_v2_header(head, &h) : BLOOMDB_ERR_FORMAT;
+        // Los chunks codificados no se pueden usar en sitio: bloomdb_load
+        if (err == BLOOMDB_OK && ((h.flags & BLOOMDB_V2_FLAG_SPARSE) || (uint64_t)st.st_size < v2_file_size(&h))) {
+            err = BLOOMDB_ERR_FORMAT;
+        }
+        if (err == BLOOMDB_OK) {
+            db->bit_count = (size_t)h.bit_count;
+            db->byte_count = (size_t)h.byte_count;
+            db->num_hashes = (int)h.num_hashes;
+            db->seed = h.seed;
+            db->hash_algo = (int)h.hash_algo;
+            db->index_mode = (int)h.index_mode;
+        }
+    } else {
+        err = read_v1_mapped_header(fd, &st, db);
+    }
+    if (err != BLOOMDB_OK) {
+        free(db);
+        close(fd);
+        return err;
+    }
+
+    int prot = PROT_READ | (writable ? PROT_WRITE : 0);
+    int map_flags = MAP_SHARED;
+#ifdef MAP_POPULATE
+    if (flags & BLOOMDB_MMAP_POPULATE) map_flags |= MAP_POPULATE;
+#endif
+    void* map = mmap(NULL, (size_t)st.st_size, prot, map_flags, fd, 0);
+    close(fd);   // el mapeo mantiene el archivo abierto
+    if (map == MAP_FAILED) {
+        free(db);
+        return BLOOMDB_ERR_FILE_IO;
+    }
+    if (flags & BLOOMDB_MMAP_RANDOM) madvise(map, (size_t)st.st_size, MADV_RANDOM);
+    if (flags & BLOOMDB_MMAP_WILLNEED) madvise(map, (size_t)st.st_size, MADV_WILLNEED);
+
+    db->bitarray = (uint8_t*)map + (v2 ? h.payload_offset : BLOOMDB_HEADER_SIZE);
+    db->mapping = map;
+    db->mapping_size = (size_t)st.st_size;
+    db->read_only = writable ? 0 : 1;
+    if (v2) {
+        db->chunk_crcs = (uint8_t*)map + h.crc_offset;
+        db->chunk_shift = (int)h.chunk_shift;
+        err = writable ? mark_stale(db, h.flags & BLOOMDB_V2_FLAG_STALE) : BLOOMDB_OK;
+        // Tabla atrasada de un mapeo que no se cerró: sin CRC con que comparar
+        if (!writable && (h.flags & BLOOMDB_V2_FLAG_STALE)) db->chunk_crcs = NULL;
+    }
+    bloomdb_select_kernels(db);
+
+    if (err == BLOOMDB_OK && (flags & BLOOMDB_MMAP_VERIFY)) {
+        if (!v2) err = BLOOMDB_ERR_FORMAT;
+        else if (db->chunk_crcs) err = bloomdb_verify_ex(db, 0);
+    }
+    if (err != BLOOMDB_OK) {
+        // Se deja la tabla como estaba: un archivo dañado sigue dando CHECKSUM
+        if (writable && v2 && !(h.flags & BLOOMDB_V2_FLAG_STALE)) write_mapped_flags(db, h.flags);
+        db->chunk_crcs = NULL;
+        bloomdb_free(db);
+        return err;
+    }
+
+    *out_db = db;
+    return BLOOMDB_OK;
+}
+
+// En v2 la tabla de CRC se recalcula antes del msync para que el archivo
+// quede verificable. La marca de CRC atrasados se queda mientras el mapeo
+// siga siendo escribible: la próxima inserción vuelve a dejar la tabla atrás.
+BloomDBError bloomdb_sync_ex(const BloomDB* db) {
+    if (!db || !db->mapping) return BLOOMDB_ERR_INVALID_ARGUMENT;
+    if (db->read_only) return BLOOMDB_OK;
+    refresh_crcs(db);
+    return msync(db->mapping, db->mapping_size, MS_SYNC) == 0 ? BLOOMDB_OK : BLOOMDB_ERR_FILE_IO;
+}
+
+// ============================================================================
+// Chunk verification
+//
+// verify_ex reparte los chunks en rangos contiguos, uno por hilo (el
+// llamador se queda el primero, como build_parallel). Cada hilo lee su
+// parte del mapeo una sola vez.
+// ============================================================================
+
+#define VERIFY_MAX_THREADS 64
+#define VERIFY_MIN_CHUNKS_PER_THREAD 4
+
+typedef struct {
+    const BloomDB* db;
+    size_t first;
+    size_t count;
+    BloomDBError err;
+} VerifyRange;
+
+static void* verify_worker(void* arg) {
+    VerifyRange* r = (VerifyRange*)arg;
+    r->err = bloomdb_verify_chunks_ex(r->db, r->first, r->count);
+    return NULL;
+}
+
+size_t bloomdb_chunk_count(const BloomDB* db) {
+    if (!db || !db->chunk_crcs) return 0;
+    return (db->byte_count + ((size_t)1 << db->chunk_shift) - 1) >> db->chunk_shift;
+}
+
+BloomDBError bloomdb_verify_chunks_ex(const BloomDB* db, size_t first, size_t count) {
+    const size_t chunks = bloomdb_chunk_count(db);
+    if (!chunks || first > chunks || count > chunks - first) return BLOOMDB_ERR_INVALID_ARGUMENT;
+    for (size_t i = first; i < first + count; i++) {
+        if (chunk_crc(db, i, db->chunk_shift) != get_le32(db->chunk_crcs + 4 * i)) return BLOOMDB_ERR_CHECKSUM;
+    }
+    return BLOOMDB_OK;
+}
+
+BloomDBError bloomdb_verify_ex(const BloomDB* db, int threads) {
+    const size_t chunks = bloomdb_chunk_count(db);
+    if (!chunks) return BLOOMDB_ERR_INVALID_ARGUMENT;
+
+    if (threads <= 0) {
+        long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = ncpu > 0 ? (int)ncpu : 1;
+    }
+    if (threads > VERIFY_MAX_THREADS) threads = VERIFY_MAX_THREADS;
+    size_t useful = chunks / VERIFY_MIN_CHUNKS_PER_THREAD;
+    if (useful < 1) useful = 1;
+    if ((size_t)threads > useful) threads = (int)useful;
+    if (threads == 1) return bloomdb_verify_chunks_ex(db, 0, chunks);
+
+    VerifyRange ranges[VERIFY_MAX_THREADS];
+    pthread_t tid[VERIFY_MAX_THREADS];
+    bool started[VERIFY_MAX_THREADS] = { false };
+    size_t per = chunks / (size_t)threads, extra = chunks % (size_t)threads, base = 0;
+    for (int t = 0; t < threads; t++) {
+        size_t len = per + ((size_t)t < extra ? 1 : 0);
+        ranges[t] = (VerifyRange){ db, base, len, BLOOMDB_OK };
+        base += len;
+    }
+
+    for (int t = 1; t < threads; t++) {
+        started[t] = pthread_create(&tid[t], NULL, verify_worker, &ranges[t]) == 0;
+    }
+    verify_worker(&ranges[0]);
+    BloomDBError err = ranges[0].err;
+    for (int t = 1; t < threads; t++) {
+        if (started[t]) pthread_join(tid[t], NULL);
+        else verify_worker(&ranges[t]);
+        if (err == BLOOMDB_OK) err = ranges[t].err;
+    }
+    return err;
+}
+
+// ============================================================================
+// Background snapshots
+//
+// El hilo escribe path.tmp con write_v2 en modo live, hace fsync y lo
+// renombra sobre path (con fsync del directorio): quien abra path ve el
+// snapshot anterior o el nuevo completo, nunca uno a medias.
+// ============================================================================
+
+static BloomDBError fsync_dir_of(const char* path) {
+    const char* slash = strrchr(path, '/');
+    char* dir = slash ? strndup(path, (size_t)(slash - path) + 1) : strdup(".");
+    if (!dir) return BLOOMDB_ERR_ALLOC;
+    int dfd = open(dir, O_RDONLY | O_DIRECTORY);
+    free(dir);
+    if (dfd < 0) return BLOOMDB_ERR_FILE_IO;
+    int rc = fsync(dfd);
+    close(dfd);
+    return rc == 0 ? BLOOMDB_OK : BLOOMDB_ERR_FILE_IO;
+}
+
+static BloomDBError write_snapshot(const BloomDB* db, const char* path) {
+    const size_t n = strlen(path);
+    char* tmp = malloc(n + 5);
+    if (!tmp) return BLOOMDB_ERR_ALLOC;
+    memcpy(tmp, path, n);
+    memcpy(tmp + n, ".tmp", 5);
+
+    BloomDBError err = BLOOMDB_ERR_FILE_IO;
+    FILE* f = fopen(tmp, "wb");
+    if (f) {
+        err = write_v2(db, f, true);
+        if (err == BLOOMDB_OK && (fflush(f) != 0 || fsync(fileno(f)) != 0)) err = BLOOMDB_ERR_FILE_IO;
+        if (fclose(f) != 0 && err == BLOOMDB_OK) err = BLOOMDB_ERR_FILE_IO;
+        if (err == BLOOMDB_OK && rename(tmp, path) != 0) err = BLOOMDB_ERR_FILE_IO;
+        if (err == BLOOMDB_OK) err = fsync_dir_of(path);
+        if (err != BLOOMDB_OK) unlink(tmp);
+    }
+    free(tmp);
+    return err;
+}
+
+static void* snapshot_main(void* arg) {
+    BloomDBSnapshot* snap = (BloomDBSnapshot*)arg;
+    snap->status = write_snapshot(snap->db, snap->path);
+    if (snap->callback) snap->callback(snap->status, snap->path, snap->user);
+    return NULL;
+}
+
+BloomDBError bloomdb_snapshot_async_ex(const BloomDB* db, const char* path, BloomDBSnapshotCallback callback,
+                                       void* user, BloomDBSnapshot** out_snap) {
+    // Sin modo concurrente las inserciones del llamador son |= de byte y
+    // competirían con las cargas atómicas del hilo (carrera de datos)
+    if (!db || !path || !out_snap || !db->concurrent) return BLOOMDB_ERR_INVALID_ARGUMENT;
+
+    BloomDBSnapshot* snap = calloc(1, sizeof(BloomDBSnapshot));
+    if (!snap) return BLOOMDB_ERR_ALLOC;
+    snap->path = strdup(path);
+    if (!snap->path) {
+        free(snap);
+        return BLOOMDB_ERR_ALLOC;
+    }
+    snap->db = db;
+    snap->callback = callback;
+    snap->user = user;
+    if (pthread_create(&snap->thread, NULL, snapshot_main, snap) != 0) {
+        free(snap->path);
+        free(snap);
+        return BLOOMDB_ERR_INTERNAL;
+    }
+
+    *out_snap = snap;
+    return BLOOMDB_OK;
+}
+
+BloomDBError bloomdb_snapshot_wait_ex(BloomDBSnapshot* snap) {
+    if (!snap) return BLOOMDB_ERR_INVALID_ARGUMENT;
+    pthread_join(snap->thread, NULL);
+    BloomDBError status = snap->status;
+    free(snap->path);
+    free(snap);
+    return status;
+}
+
+// ============================================================================
+// Periodic snapshots
+// ============================================================================
+
+static uint64_t monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// Un snapshot cada interval_ms contados desde el final del anterior: si
+// escribir tarda más que el intervalo, no se acumulan
+static void* scheduler_main(void* arg) {
+    BloomDBSnapshotScheduler* s = (BloomDBSnapshotScheduler*)arg;
+    const uint64_t interval = (uint64_t)s->interval_ms * 1000000ull;
+
+    pthread_mutex_lock(&s->lock);
+    uint64_t deadline = monotonic_ns() + interval;
+    while (!s->stopping) {
+        if (monotonic_ns() < deadline) {
+            struct timespec ts = { (time_t)(deadline / 1000000000ull), (long)(deadline % 1000000000ull) };
+            pthread_cond_timedwait(&s->wake, &s->lock, &ts);
+            continue;
+        }
+        pthread_mutex_unlock(&s->lock);
+        BloomDBError status = write_snapshot(s->db, s->path);
+        if (s->callback) s->callback(status, s->path, s->user);
+        pthread_mutex_lock(&s->lock);
+        s->snapshots++;
+        s->last_status = status;
+        deadline = monotonic_ns() + interval;
+    }
+    pthread_mutex_unlock(&s->lock);
+    return NULL;
+}
+
+BloomDBError bloomdb_snapshot_scheduler_start_ex(const BloomDB* db, const char* path, uint32_t interval_ms,
+                                                 BloomDBSnapshotCallback callback, void* user,
+                                                 BloomDBSnapshotScheduler** out_sched) {
+    if (!db || !path || interval_ms == 0 || !out_sched || !db->concurrent) return BLOOMDB_ERR_INVALID_ARGUMENT;
+
+    BloomDBSnapshotScheduler* s = calloc(1, sizeof(BloomDBSnapshotScheduler));
+    if (!s) return BLOOMDB_ERR_ALLOC;
+    s->path = strdup(path);
+    if (!s->path) {
+        free(s);
+        return BLOOMDB_ERR_ALLOC;
+    }
+    s->db = db;
+    s->interval_ms = interval_ms;
+    s->callback = callback;
+    s->user = user;
+    s->last_status = BLOOMDB_OK;
+    pthread_mutex_init(&s->lock, NULL);
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&s->wake, &attr);
+    pthread_condattr_destroy(&attr);
+
+    if (pthread_create(&s->thread, NULL, scheduler_main, s) != 0) {
+        pthread_cond_destroy(&s->wake);
+        pthread_mutex_destroy(&s->lock);
+        free(s->path);
+        free(s);
+        return BLOOMDB_ERR_INTERNAL;
+    }
+
+    *out_sched = s;
+    return BLOOMDB_OK;
+}
+
+BloomDBError bloomdb_snapshot_scheduler_stop_ex(BloomDBSnapshotScheduler* sched) {
+    if (!sched) return BLOOMDB_ERR_INVALID_ARGUMENT;
+
+    pthread_mutex_lock(&sched->lock);
+    sched->stopping = 1;
+    pthread_cond_signal(&sched->wake);
+    pthread_mutex_unlock(&sched->lock);
+    pthread_join(sched->thread, NULL);
+
+    BloomDBError status = sched->last_status;
+    pthread_cond_destroy(&sched->wake);
+    pthread_mutex_destroy(&sched->lock);
+    free(sched->path);
+    free(sched);
+    return status;
+}
+
+// ============================================================================
+// Incremental save
+//
+// bloomdb_save_incremental escribe solo las páginas marcadas por
+// bloomdb_track_dirty: sobre el archivo base con pwrite (más el CRC de los
+// chunks que las contienen) y/o en un archivo delta que se aplica a otras
+// copias con bloomdb_apply_delta. El delta (little-endian):
+//   cabecera de BLOOMDB_DELTA_HEADER_SIZE bytes:
+//     0  magic, version, page_shift, flags (0)
+//     16 bit_count, seed
+//     32 num_hashes, hash_algo, index_mode, reservado (0)
+//     48 page_count (entradas)
+//     56 CRC32C de los bytes 0..55
+//   por entrada, en orden creciente de página:
+//     uint64_t page, los bytes de la página (la última del filtro puede ser
+//     más corta), uint32_t CRC32C de page y bytes
+// Los bytes de cada página se aplican con OR: como los bits solo pasan de 0
+// a 1, aplicar un delta dos veces, o sobre una copia que ya tenga parte de
+// los bits, da el mismo filtro.
+// ============================================================================
+
+#define BLOOMDB_DELTA_MAGIC       0x44424442u   // "BDBD"
+#define BLOOMDB_DELTA_VERSION     1u
+#define BLOOMDB_DELTA_HEADER_SIZE 64
+
+static size_t page_len(const BloomDB* db, size_t page) {
+    const size_t start = page << BLOOMDB_DIRTY_PAGE_SHIFT;
+    return db->byte_count - start < BLOOMDB_DIRTY_PAGE_SIZE ? db->byte_count - start : BLOOMDB_DIRTY_PAGE_SIZE;
+}
+
+static size_t page_words(const BloomDB* db) {
+    return (bloomdb_page_count(db) + 63) / 64;
+}
+
+static bool page_marked(const uint64_t* marks, size_t page) {
+    return (marks[page >> 6] >> (page & 63)) & 1;
+}
+
+// Primera página marcada >= page (pages si no hay), saltando palabras vacías
+static size_t next_marked(const uint64_t* marks, size_t page, size_t pages) {
+    while (page < pages) {
+        const uint64_t w = marks[page >> 6] >> (page & 63);
+        if (w) {
+            page += (size_t)__builtin_ctzll(w);
+            return page < pages ? page : pages;
+        }
+        page = (page | 63) + 1;
+    }
+    return pages;
+}
+
+static bool pwrite_all(int fd, const uint8_t* buf, size_t len, uint64_t offset) {
+    while (len > 0) {
+        ssize_t n = pwrite(fd, buf, len, (off_t)offset);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        buf += n;
+        len -= (size_t)n;
+        offset += (uint64_t)n;
+    }
+    return true;
+}
+
+/**
+ * Actualiza un archivo v2 de este mismo filtro: cada tramo de páginas
+ * marcadas seguidas es un pwrite, y después el CRC de cada chunk tocado
+ * (recalculado en memoria). Las páginas nunca cruzan un chunk porque
+ * BLOOMDB_V2_MIN_SHIFT == BLOOMDB_DIRTY_PAGE_SHIFT.
+ */
+static BloomDBError update_in_place(const BloomDB* db, const uint64_t* marks, int fd, const V2Header* h) {
+    const size_t pages = bloomdb_page_count(db);
+    const int per_chunk = (int)h->chunk_shift - BLOOMDB_DIRTY_PAGE_SHIFT;
+    size_t last_chunk = SIZE_MAX;
+
+    for (size_t first = next_marked(marks, 0, pages), end; first < pages; first = next_marked(marks, end, pages)) {
+        for (end = first + 1; end < pages && page_marked(marks, end); end++) {}
+        const size_t off = first << BLOOMDB_DIRTY_PAGE_SHIFT;
+        const size_t len = ((end - 1) << BLOOMDB_DIRTY_PAGE_SHIFT) + page_len(db, end - 1) - off;
+        if (!pwrite_all(fd, db->bitarray + off, len, h->payload_offset + off)) return BLOOMDB_ERR_FILE_IO;
+
+        for (size_t c = first >> per_chunk; c <= (end - 1) >> per_chunk; c++) {
+            if (c == last_chunk) continue;
+            uint8_t crc[4];
+            put_le32(crc, chunk_crc(db, c, (int)h->chunk_shift));
+            if (!pwrite_all(fd, crc, sizeof(crc), h->crc_offset + 4 * c)) return BLOOMDB_ERR_FILE_IO;
+            last_chunk = c;
+        }
+    }
+    return fdatasync(fd) == 0 ? BLOOMDB_OK : BLOOMDB_ERR_FILE_IO;
+}
+
+// ¿Es el archivo un v2 de este filtro (mismos parámetros y tamaño)?
+static bool base_matches(const BloomDB* db, int fd, V2Header* h) {
+    uint8_t head[BLOOMDB_V2_HEADER_SIZE];
+    struct stat st;
+    if (fstat(fd, &st) != 0 || pread(fd, head, sizeof(head), 0) != (ssize_t)sizeof(head)) return false;
+    return is_v2(head, sizeof(head)) && decode_v2_header(head, h) == BLOOMDB_OK &&
+           h->bit_count == db->bit_count && h->num_hashes == (uint32_t)db->num_hashes &&
+           h->seed == db->seed && h->hash_algo == (uint32_t)db->hash_algo &&
+           h->index_mode == (uint32_t)db->index_mode && h->flags == 0 && (uint64_t)st.st_size >= v2_file_size(h);
+}
+
+static BloomDBError save_base(const BloomDB* db, const uint64_t* marks, const char* path) {
+    int fd = open(path, O_RDWR);
+    V2Header h;
+    if (fd >= 0 && base_matches(db, fd, &h)) {
+        BloomDBError err = update_in_place(db, marks, fd, &h);
+        if (close(fd) != 0 && err == BLOOMDB_OK) err = BLOOMDB_ERR_FILE_IO;
+        return err;
+    }
+    if (fd >= 0) close(fd);
+
+    // Sin base válida: se escribe entero y sirve de base para la siguiente
+    FILE* f = fopen(path, "wb");
+    if (!f) return BLOOMDB_ERR_FILE_IO;
+    BloomDBError err = write_v2(db, f, false);
+    if (err == BLOOMDB_OK && (fflush(f) != 0 || fsync(fileno(f)) != 0)) err = BLOOMDB_ERR_FILE_IO;
+    if (fclose(f) != 0 && err == BLOOMDB_OK) err = BLOOMDB_ERR_FILE_IO;
+    return err;
+}
+
+static void encode_delta_header(const BloomDB* db, uint64_t page_count, uint8_t* out) {
+    memset(out, 0, BLOOMDB_DELTA_HEADER_SIZE);
+    put_le32(out, BLOOMDB_DELTA_MAGIC);
+    put_le32(out + 4, BLOOMDB_DELTA_VERSION);
+    put_le32(out + 8, BLOOMDB_DIRTY_PAGE_SHIFT);
+    put_le64(out + 16, db->bit_count);
+    put_le64(out + 24, db->seed);
+    put_le32(out + 32, (uint32_t)db->num_hashes);
+    put_le32(out + 36, (uint32_t)db->hash_algo);
+    put_le32(out + 40, (uint32_t)db->index_mode);
+    put_le64(out + 48, page_count);
+    put_le32(out + 56, crc32c(0, out, 56));
+}
+
+static BloomDBError save_delta(const BloomDB* db, const uint64_t* marks, const char* path) {
+    FILE* f = fopen(path, "wb");
+    if (!f) return BLOOMDB_ERR_FILE_IO;
+
+    const size_t pages = bloomdb_page_count(db);
+    uint64_t count = 0;
+    for (size_t i = 0; i < page_words(db); i++) count += (uint64_t)__builtin_popcountll(marks[i]);
+    uint8_t head[BLOOMDB_DELTA_HEADER_SIZE];
+    encode_delta_header(db, count, head);
+    bool ok = fwrite(head, 1, sizeof(head), f) == sizeof(head);
+    for (size_t p = next_marked(marks, 0, pages); ok && p < pages; p = next_marked(marks, p + 1, pages)) {
+        const uint8_t* data = db->bitarray + (p << BLOOMDB_DIRTY_PAGE_SHIFT);
+        const size_t len = page_len(db, p);
+        uint8_t index[8], crc[4];
+        put_le64(index, p);
+        put_le32(crc, crc32c(crc32c(0, index, sizeof(index)), data, len));
+        ok = fwrite(index, 1, sizeof(index), f) == sizeof(index) && fwrite(data, 1, len, f) == len &&
+             fwrite(crc, 1, sizeof(crc), f) == sizeof(crc);
+    }
+
+    BloomDBError err = ok ? BLOOMDB_OK : BLOOMDB_ERR_FILE_IO;
+    if (err == BLOOMDB_OK && (fflush(f) != 0 || fsync(fileno(f)) != 0)) err = BLOOMDB_ERR_FILE_IO;
+    if (fclose(f) != 0 && err == BLOOMDB_OK) err = BLOOMDB_ERR_FILE_IO;
+    return err;
+}
+
+// marks = dirty | lag: lo marcado ahora más lo que este destino se saltó
+static void pending_pages(const BloomDB* db, const uint64_t* lag, uint64_t* marks) {
+    for (size_t i = 0; i < page_words(db); i++) marks[i] = db->dirty[i] | (lag ? lag[i] : 0);
+}
+
+// Tras una llamada con éxito: el destino escrito queda al día y el que se
+// saltó acumula lo marcado para la próxima vez que se escriba
+static void settle_lag(const BloomDB* db, uint64_t** lag, bool written) {
+    if (written) {
+        free(*lag);
+        *lag = NULL;
+    } else {
+        for (size_t i = 0; i < page_words(db); i++) (*lag)[i] |= db->dirty[i];
+    }
+}
+
+/**
+ * Base y delta llevan cada uno las páginas marcadas desde la última vez que
+ * se escribieron, no desde la última llamada: una llamada solo con delta no
+ * puede dejar el archivo base sin unas páginas cuyo CRC sí se reescribe
+ * después (ni una solo con base dejar huecos en la cadena de deltas).
+ */
+BloomDBError bloomdb_save_incremental_ex(BloomDB* db, const char* path, const char* delta_path) {
+    if (!db || !db->dirty || (!path && !delta_path)) return BLOOMDB_ERR_INVALID_ARGUMENT;
+
+    const size_t words = page_words(db);
+    if (!path && !db->base_lag && !(db->base_lag = calloc(words, sizeof(uint64_t)))) return BLOOMDB_ERR_ALLOC;
+    if (!delta_path && !db->delta_lag && !(db->delta_lag = calloc(words, sizeof(uint64_t)))) return BLOOMDB_ERR_ALLOC;
+    uint64_t* marks = malloc(words * sizeof(uint64_t));
+    if (!marks) return BLOOMDB_ERR_ALLOC;
+
+    BloomDBError err = BLOOMDB_OK;
+    if (delta_path) {
+        pending_pages(db, db->delta_lag, marks);
+        err = save_delta(db, marks, delta_path);
+    }
+    if (err == BLOOMDB_OK && path) {
+        pending_pages(db, db->base_lag, marks);
+        err = save_base(db, marks, path);
+    }
+    free(marks);
+    if (err != BLOOMDB_OK) return err;   // los bitmaps se conservan: el siguiente intento lo reescribe
+
+    settle_lag(db, &db->base_lag, path != NULL);
+    settle_lag(db, &db->delta_lag, delta_path != NULL);
+    memset(db->dirty, 0, words * sizeof(uint64_t));
+    return BLOOMDB_OK;
+}
+
+/**
+ * Lee una entrada del delta en buf; FORMAT si el archivo se acaba o las
+ * páginas no van en orden, CHECKSUM si el CRC de la entrada no cuadra.
+ */
+static BloomDBError read_delta_entry(const BloomDB* db, FILE* f, size_t min_page, size_t* page, uint8_t* buf) {
+    uint8_t index[8], crc[4];
+    if (fread(index, 1, sizeof(index), f) != sizeof(index)) return BLOOMDB_ERR_FORMAT;
+    const uint64_t p = get_le64(index);
+    if (p < min_page || p >= bloomdb_page_count(db)) return BLOOMDB_ERR_FORMAT;
+    const size_t len = page_len(db, (size_t)p);
+    if (fread(buf, 1, len, f) != len || fread(crc, 1, sizeof(crc), f) != sizeof(crc)) return BLOOMDB_ERR_FORMAT;
+    if (get_le32(crc) != crc32c(crc32c(0, index, sizeof(index)), buf, len)) return BLOOMDB_ERR_CHECKSUM;
+    *page = (size_t)p;
+    return BLOOMDB_OK;
+}
+
+BloomDBError bloomdb_apply_delta_ex(BloomDB* db, const char* delta_path) {
+    if (!db || !delta_path) return BLOOMDB_ERR_INVALID_ARGUMENT;
+    if (db->read_only) return BLOOMDB_ERR_READ_ONLY;
+
+    FILE* f = fopen(delta_path, "rb");
+    if (!f) return BLOOMDB_ERR_FILE_IO;
+
+    uint8_t head[BLOOMDB_DELTA_HEADER_SIZE];
+    BloomDBError err = BLOOMDB_OK;
+    if (fread(head, 1, sizeof(head), f) != sizeof(head) || get_le32(head) != BLOOMDB_DELTA_MAGIC ||
+        get_le32(head + 4) != BLOOMDB_DELTA_VERSION) {
+        err = BLOOMDB_ERR_FORMAT;
+    } else if (get_le32(head + 56) != crc32c(0, head, 56)) {
+        err = BLOOMDB_ERR_CHECKSUM;
+    } else if (get_le32(head + 8) != BLOOMDB_DIRTY_PAGE_SHIFT) {
+        err = BLOOMDB_ERR_FORMAT;
+    } else if (get_le64(head + 16) != db->bit_count || get_le64(head + 24) != db->seed ||
+               get_le32(head + 32) != (uint32_t)db->num_hashes || get_le32(head + 36) != (uint32_t)db->hash_algo ||
+               get_le32(head + 40) != (uint32_t)db->index_mode) {
+        err = BLOOMDB_ERR_INVALID_ARGUMENT;   // delta de otro filtro, como en merge
+    } else if (get_le64(head + 48) > bloomdb_page_count(db)) {
+        err = BLOOMDB_ERR_FORMAT;
+    }
+    const size_t count = err == BLOOMDB_OK ? (size_t)get_le64(head + 48) : 0;
+    uint8_t* buf = err == BLOOMDB_OK ? malloc(BLOOMDB_DIRTY_PAGE_SIZE) : NULL;
+    if (err == BLOOMDB_OK && !buf) err = BLOOMDB_ERR_ALLOC;
+
+    // Primera pasada: se comprueba el delta entero antes de tocar el
+    // filtro, así un delta cortado o dañado no se aplica a medias
+    size_t page = 0;
+    for (size_t i = 0; err == BLOOMDB_OK && i < count; i++) {
+        err = read_delta_entry(db, f, i ? page + 1 : 0, &page, buf);
+    }
+    if (err == BLOOMDB_OK && fgetc(f) != EOF) err = BLOOMDB_ERR_FORMAT;
+
+    if (err == BLOOMDB_OK && fseek(f, BLOOMDB_DELTA_HEADER_SIZE, SEEK_SET) != 0) err = BLOOMDB_ERR_FILE_IO;
+    for (size_t i = 0; err == BLOOMDB_OK && i < count; i++) {
+        if (read_delta_entry(db, f, i ? page + 1 : 0, &page, buf) != BLOOMDB_OK) {
+            err = BLOOMDB_ERR_FILE_IO;   // cambió entre las dos pasadas
+            break;
+        }
+        bitarray_or(db->bitarray + (page << BLOOMDB_DIRTY_PAGE_SHIFT), buf, page_len(db, page));
+        if (db->dirty) db->dirty[page >> 6] |= (uint64_t)1 << (page & 63);
+    }
+
+    free(buf);
+    fclose(f);
+    return err;
+}
+
+// ============================================================================
+// Blocked Bloom filter
+//
+// Formato (anchos fijos):
+//   uint32_t magic (BLOOMDB_BLOCKED_MAGIC), uint32_t version
+//   uint64_t block_count, uint32_t num_hashes, uint32_t reserved
+//   uint64_t seed
+//   block_count * 64 bytes de bloques
+// ============================================================================
+
+#define BLOOMDB_BLOCKED_MAGIC   0x4b424442u   // "BDBK"
+#define BLOOMDB_BLOCKED_VERSION 1u
+
+BloomDBError bloomdb_blocked_save_ex(const BloomDBBlocked* bf, const char* path) {
+    if (!bf || !path) return BLOOMDB_ERR_INVALID_ARGUMENT;
+
+    FILE* f = fopen(path, "wb");
+    if (!f) return BLOOMDB_ERR_FILE_IO;
+
+    uint32_t head[2] = { BLOOMDB_BLOCKED_MAGIC, BLOOMDB_BLOCKED_VERSION };
+    uint64_t block_count = bf->block_count;
+    uint32_t params[2] = { (uint32_t)bf->num_hashes, 0 };
+
+    size_t written = 0;
+    written += fwrite(head, sizeof(uint32_t), 2, f);
+    written += fwrite(&block_count, sizeof(uint64_t), 1, f);
+    written += fwrite(params, sizeof(uint32_t), 2, f);
+    written += fwrite(&bf->seed, sizeof(uint64_t), 1, f);
+
+    if (written != 6 ||
+        fwrite(bf->blocks, BLOOMDB_BLOCK_BITS / 8, bf->block_count, f) != bf->block_count) {
+        fclose(f);
+        return BLOOMDB_ERR_FILE_IO;
+    }
+
+    if (fclose(f) != 0) return BLOOMDB_ERR_FILE_IO;
+    return BLOOMDB_OK;
+}
+
+BloomDBError bloomdb_blocked_load_ex(const char* path, BloomDBBlocked** out_bf) {
+    if (!path || !out_bf) return BLOOMDB_ERR_INVALID_ARGUMENT;
+
+    FILE* f = fopen(path, "rb");
+    if (!f) return BLOOMDB_ERR_FILE_IO;
+
+    uint32_t head[2];
+    uint64_t block_count;
+    uint32_t params[2];
+    uint64_t seed;
+
+    if (fread(head, sizeof(uint32_t), 2, f) != 2 ||
+        fread(&block_count, sizeof(uint64_t), 1, f) != 1 ||
+        fread(params, sizeof(uint32_t), 2, f) != 2 ||
+        fread(&seed, sizeof(uint64_t), 1, f) != 1) {
+        fclose(f);
+        return BLOOMDB_ERR_FORMAT;
+    }
+
+    if (head[0] != BLOOMDB_BLOCKED_MAGIC || head[1] != BLOOMDB_BLOCKED_VERSION ||
+        block_count == 0 || block_count > SIZE_MAX / BLOOMDB_BLOCK_BITS ||
+        params[0] == 0 || params[0] > BLOOMDB_BLOCKED_MAX_HASHES) {
+        fclose(f);
+        return BLOOMDB_ERR_FORMAT;
+    }
+
+    BloomDBBlocked* bf = NULL;
+    BloomDBError err = bloomdb_blocked_create_ex((size_t)block_count * BLOOMDB_BLOCK_BITS,
+                                                 (int)params[0], seed, &bf);
+    if (err != BLOOMDB_OK) {
+        fclose(f);
+        return err;
+    }
+
+    if (fread(bf->blocks, BLOOMDB_BLOCK_BITS / 8, bf->block_count, f) != bf->block_count) {
+        bloomdb_blocked_free(bf);
+        fclose(f);
+        return BLOOMDB_ERR_FORMAT;
+    }
+
+    fclose(f);
+    *out_bf = bf;
+    return BLOOMDB_OK;
+}
+
+// ============================================================================
+// Split-block Bloom filter
+//
+// Formato (anchos fijos):
+//   uint32_t magic (BLOOMDB_SPLIT_MAGIC), uint32_t version
+//   uint64_t block_count, uint64_t seed
+//   block_count * 32 bytes de bloques
+// ============================================================================
+
+#define BLOOMDB_SPLIT_MAGIC   0x53424442u   // "BDBS"
+#define BLOOMDB_SPLIT_VERSION 1u
+
+BloomDBError bloomdb_split_save_ex(const BloomDBSplit* sf, const char* path) {
+    if (!sf || !path) return BLOOMDB_ERR_INVALID_ARGUMENT;
+
+    FILE* f = fopen(path, "wb");
+    if (!f) return BLOOMDB_ERR_FILE_IO;
+
+    uint32_t head[2] = { BLOOMDB_SPLIT_MAGIC, BLOOMDB_SPLIT_VERSION };
+    uint64_t block_count = sf->block_count;
+
+    size_t written = 0;
+    written += fwrite(head, sizeof(uint32_t), 2, f);
+    written += fwrite(&block_count, sizeof(uint64_t), 1, f);
+    written += fwrite(&sf->seed, sizeof(uint64_t), 1, f);
+
+    if (written != 4 ||
+        fwrite(sf->blocks, BLOOMDB_SPLIT_BLOCK_BITS / 8, sf->block_count, f) != sf->block_count) {
+        fclose(f);
+        return BLOOMDB_ERR_FILE_IO;
+    }
+
+    if (fclose(f) != 0) return BLOOMDB_ERR_FILE_IO;
+    return BLOOMDB_OK;
+}
+
+BloomDBError bloomdb_split_load_ex(const char* path, BloomDBSplit** out_sf) {
+    if (!path || !out_sf) return BLOOMDB_ERR_INVALID_ARGUMENT;
+
+    FILE* f = fopen(path, "rb");
+    if (!f) return BLOOMDB_ERR_FILE_IO;
+
+    uint32_t head[2];
+    uint64_t block_count;
+    uint64_t seed;
+
+    if (fread(head, sizeof(uint32_t), 2, f) != 2 ||
+        fread(&block_count, sizeof(uint64_t), 1, f) != 1 ||
+        fread(&seed, sizeof(uint64_t), 1, f) != 1) {
+        fclose(f);
+        return BLOOMDB_ERR_FORMAT;
+    }
+
+    if (head[0] != BLOOMDB_SPLIT_MAGIC || head[1] != BLOOMDB_SPLIT_VERSION ||
+        block_count == 0 || block_count > SIZE_MAX / BLOOMDB_SPLIT_BLOCK_BITS) {
+        fclose(f);
+        return BLOOMDB_ERR_FORMAT;
+    }
+
+    BloomDBSplit* sf = NULL;
+    BloomDBError err = bloomdb_split_create_ex((size_t)block_count * BLOOMDB_SPLIT_BLOCK_BITS, seed, &sf);
+    if (err != BLOOMDB_OK) {
+        fclose(f);
+        return err;
+    }
+
+    if (fread(sf->blocks, BLOOMDB_SPLIT_BLOCK_BITS / 8, sf->block_count, f) != sf->block_count) {
+        bloomdb_split_free(sf);
+        fclose(f);
+        return BLOOMDB_ERR_FORMAT;
+    }
+
+    fclose(f);
+    *out_sf = sf;
+    return BLOOMDB_OK;
+}
+
+// ============================================================================
+// Partitioned Bloom filter
+//
+// Formato (anchos fijos):
+//   uint32_t magic (BLOOMDB_PARTITIONED_MAGIC), uint32_t version
+//   uint64_t slice_bits, uint32_t num_hashes, uint32_t reserved
+//   uint64_t seed
+//   num_hashes * slice_bits / 64 palabras uint64_t, partición 0 primero
+// ============================================================================
+
+#define BLOOMDB_PARTITIONED_MAGIC   0x50424442u   // "BDBP"
+#define BLOOMDB_PARTITIONED_VERSION 1u
+
+BloomDBError bloomdb_partitioned_save_ex(const BloomDBPartitioned* pf, const char* path) {
+    if (!pf || !path) return BLOOMDB_ERR_INVALID_ARGUMENT;
+
+    FILE* f = fopen(path, "wb");
+    if (!f) return BLOOMDB_ERR_FILE_IO;
+
+    uint32_t head[2] = { BLOOMDB_PARTITIONED_MAGIC, BLOOMDB_PARTITIONED_VERSION };
+    uint64_t slice_bits = pf->slice_bits;
+    uint32_t params[2] = { (uint32_t)pf->num_hashes, 0 };
+    size_t word_count = pf->bit_count / 64;
+
+    size_t written = 0;
+    written += fwrite(head, sizeof(uint32_t), 2, f);
+    written += fwrite(&slice_bits, sizeof(uint64_t), 1, f);
+    written += fwrite(params, sizeof(uint32_t), 2, f);
+    written += fwrite(&pf->seed, sizeof(uint64_t), 1, f);
+
+    if (written != 6 || fwrite(pf->words, sizeof(uint64_t), word_count, f) != word_count) {
+        fclose(f);
+        return BLOOMDB_ERR_FILE_IO;
+    }
+
+    if (fclose(f) != 0) return BLOOMDB_ERR_FILE_IO;
+    return BLOOMDB_OK;
+}
+
+BloomDBError bloomdb_partitioned_load_ex(const char* path, BloomDBPartitioned** out_pf) {
+    if (!path || !out_pf) return BLOOMDB_ERR_INVALID_ARGUMENT;
+
+    FILE* f = fopen(path, "rb");
+    if (!f) return BLOOMDB_ERR_FILE_IO;
+
+    uint32_t head[2];
+    uint64_t slice_bits;
+    uint32_t params[2];
+    uint64_t seed;
+
+    if (fread(head, sizeof(uint32_t), 2, f) != 2 ||
+        fread(&slice_bits, sizeof(uint64_t), 1, f) != 1 ||
+        fread(params, sizeof(uint32_t), 2, f) != 2 ||
+        fread(&seed, sizeof(uint64_t), 1, f) != 1) {
+        fclose(f);
+        return BLOOMDB_ERR_FORMAT;
+    }
+
+    // slice_bits debe ser potencia de 2 >= 64: si no, create_ex lo
+    // redondearía y los bits no corresponderían
+    if (head[0] != BLOOMDB_PARTITIONED_MAGIC || head[1] != BLOOMDB_PARTITIONED_VERSION ||
+        params[0] == 0 || params[0] > BLOOMDB_PARTITIONED_MAX_HASHES ||
+        slice_bits < 64 || (slice_bits & (slice_bits - 1)) != 0 ||
+        slice_bits > SIZE_MAX / 2 / BLOOMDB_PARTITIONED_MAX_HASHES) {
+        fclose(f);
+        return BLOOMDB_ERR_FORMAT;
+    }
+
+    BloomDBPartitioned* pf = NULL;
+    BloomDBError err = bloomdb_partitioned_create_ex((size_t)slice_bits * params[0], (int)params[0], seed, &pf);
+    if (err != BLOOMDB_OK) {
+        fclose(f);
+        return err;
+    }
+
+    size_t word_count = pf->bit_count / 64;
+    if (pf->slice_bits != slice_bits ||
+        fread(pf->words, sizeof(uint64_t), word_count, f) != word_count) {
+        bloomdb_partitioned_free(pf);
+        fclose(f);
+        return BLOOMDB_ERR_FORMAT;
+    }
+
+    fclose(f);
+    *out_pf = pf;
+    return BLOOMDB_OK;
+}
+
+// ============================================================================
+// Binary fuse filter
+//
+// Formato (anchos fijos):
+//   uint32_t magic (BLOOMDB_FUSE_MAGIC), uint32_t version
+//   uint32_t segment_length, uint32_t segment_count
+//   uint64_t seed, uint64_t fuse_seed, uint64_t key_count
+//   (segment_count + 2) * segment_length huellas de un byte
+// ============================================================================
+
+#define BLOOMDB_FUSE_MAGIC   0x46424442u   // "BDBF"
+#define BLOOMDB_FUSE_VERSION 1u
+
+BloomDBError bloomdb_fuse_save_ex(const BloomDBFuse* ff, const char* path) {
+    if (!ff || !path) return BLOOMDB_ERR_INVALID_ARGUMENT;
+
+    FILE* f = fopen(path, "wb");
+    if (!f) return BLOOMDB_ERR_FILE_IO;
+
+    uint32_t head[4] = { BLOOMDB_FUSE_MAGIC, BLOOMDB_FUSE_VERSION, ff->segment_length, ff->segment_count };
+    uint64_t params[3] = { ff->seed, ff->fuse_seed, (uint64_t)ff->key_count };
+
+    if (fwrite(head, sizeof(uint32_t), 4, f) != 4 ||
+        fwrite(params, sizeof(uint64_t), 3, f) != 3 ||
+        fwrite(ff->fingerprints, 1, ff->array_length, f) != ff->array_length) {
+        fclose(f);
+        return BLOOMDB_ERR_FILE_IO;
+    }
+
+    if (fclose(f) != 0) return BLOOMDB_ERR_FILE_IO;
+    return BLOOMDB_OK;
+}
+
+BloomDBError bloomdb_fuse_load_ex(const char* path, BloomDBFuse** out_ff) {
+    if (!path || !out_ff) return BLOOMDB_ERR_INVALID_ARGUMENT;
+
+    FILE* f = fopen(path, "rb");
+    if (!f) return BLOOMDB_ERR_FILE_IO;
+
+    uint32_t head[4];
+    uint64_t params[3];
+    if (fread(head, sizeof(uint32_t), 4, f) != 4 ||
+        fread(params, sizeof(uint64_t), 3, f) != 3) {
+        fclose(f);
+        return BLOOMDB_ERR_FORMAT;
+    }
+
+    // segment_length potencia de 2 en [4, 2^18], y el arreglo cabe en 32 bits
+    uint32_t seg_len = head[2], seg_count = head[3];
+    if (head[0] != BLOOMDB_FUSE_MAGIC || head[1] != BLOOMDB_FUSE_VERSION ||
+        seg_len < 4 || seg_len > (1u << 18) || (seg_len & (seg_len - 1)) != 0 ||
+        seg_count == 0 || seg_count > UINT32_MAX / seg_len - 2) {
+        fclose(f);
+        return BLOOMDB_ERR_FORMAT;
+    }
+
+    BloomDBFuse* ff = calloc(1, sizeof(BloomDBFuse));
+    if (!ff) {
+        fclose(f);
+        return BLOOMDB_ERR_ALLOC;
+    }
+    ff->segment_length = seg_len;
+    ff->segment_length_mask = seg_len - 1;
+    ff->segment_count = seg_count;
+    ff->segment_count_length = seg_count * seg_len;
+    ff->array_length = (seg_count + 2) * seg_len;
+    ff->seed = params[0];
+    ff->fuse_seed = params[1];
+    ff->key_count = (size_t)params[2];
+
+    ff->fingerprints = malloc(ff->array_length);
+    if (!ff->fingerprints) {
+        free(ff);
+        fclose(f);
+        return BLOOMDB_ERR_ALLOC;
+    }
+    if (fread(ff->fingerprints, 1, ff->array_length, f) != ff->array_length) {
+        bloomdb_fuse_free(ff);
+        fclose(f);
+        return BLOOMDB_ERR_FORMAT;
+    }
+
+    fclose(f);
+    *out_ff = ff;
+    return BLOOMDB_OK;
+}
+
+// ============================================================================
+// Cuckoo filter
+//
+// Formato (anchos fijos):
+//   uint32_t magic (BLOOMDB_CUCKOO_MAGIC), uint32_t version
+//   uint64_t bucket_count, uint64_t count, uint64_t seed, uint64_t rng
+//   uint64_t victim_index, uint32_t victim_fp, uint32_t has_victim
+//   bucket_count cubetas uint64_t
+// ============================================================================
+
+#define BLOOMDB_CUCKOO_MAGIC   0x55424442u   // "BDBU"
+#define BLOOMDB_CUCKOO_VERSION 1u
+
+BloomDBError bloomdb_cuckoo_save_ex(const BloomDBCuckoo* cf, const char* path) {
+    if (!cf || !path) return BLOOMDB_ERR_INVALID_ARGUMENT;
+
+    FILE* f = fopen(path, "wb");
+    if (!f) return BLOOMDB_ERR_FILE_IO;
+
+    uint32_t head[2] = { BLOOMDB_CUCKOO_MAGIC, BLOOMDB_CUCKOO_VERSION };
+    uint64_t params[5] = { cf->bucket_count, cf->count, cf->seed, cf->rng, cf->victim_index };
+    uint32_t victim[2] = { cf->victim_fp, cf->has_victim ? 1u : 0u };
+
+    if (fwrite(head, sizeof(uint32_t), 2, f) != 2 ||
+        fwrite(params, sizeof(uint64_t), 5, f) != 5 ||
+        fwrite(victim, sizeof(uint32_t), 2, f) != 2 ||
+        fwrite(cf->buckets, sizeof(uint64_t), cf->bucket_count, f) != cf->bucket_count) {
+        fclose(f);
+        return BLOOMDB_ERR_FILE_IO;
+    }
+
+    if (fclose(f) != 0) return BLOOMDB_ERR_FILE_IO;
+    return BLOOMDB_OK;
+}
+
+BloomDBError bloomdb_cuckoo_load_ex(const char* path, BloomDBCuckoo** out_cf) {
+    if (!path || !out_cf) return BLOOMDB_ERR_INVALID_ARGUMENT;
+
+    FILE* f = fopen(path, "rb");
+    if (!f) return BLOOMDB_ERR_FILE_IO;
+
+    uint32_t head[2];
+    uint64_t params[5];
+    uint32_t victim[2];
+    if (fread(head, sizeof(uint32_t), 2, f) != 2 ||
+        fread(params, sizeof(uint64_t), 5, f) != 5 ||
+        fread(victim, sizeof(uint32_t), 2, f) != 2) {
+        fclose(f);
+        return BLOOMDB_ERR_FORMAT;
+    }
+
+    uint64_t buckets = params[0];
+    if (head[0] != BLOOMDB_CUCKOO_MAGIC || head[1] != BLOOMDB_CUCKOO_VERSION ||
+        buckets < 2 || (buckets & (buckets - 1)) != 0 || buckets > SIZE_MAX / sizeof(uint64_t) ||
+        params[1] > buckets * BLOOMDB_CUCKOO_SLOTS + 1 || params[3] == 0 ||
+        victim[1] > 1 || victim[0] > 0xffff || (victim[1] && (victim[0] == 0 || params[4] >= buckets))) {
+        fclose(f);
+        return BLOOMDB_ERR_FORMAT;
+    }
+
+    BloomDBCuckoo* cf = calloc(1, sizeof(BloomDBCuckoo));
+    if (!cf) {
+        fclose(f);
+        return BLOOMDB_ERR_ALLOC;
+    }
+    cf->buckets = malloc((size_t)buckets * sizeof(uint64_t));
+    if (!cf->buckets) {
+        free(cf);
+        fclose(f);
+        return BLOOMDB_ERR_ALLOC;
+    }
+    cf->bucket_count = (size_t)buckets;
+    cf->count = (size_t)params[1];
+    cf->seed = params[2];
+    cf->rng = params[3];
+    cf->victim_index = (size_t)params[4];
+    cf->victim_fp = (uint16_t)victim[0];
+    cf->has_victim = victim[1] != 0;
+
+    if (fread(cf->buckets, sizeof(uint64_t), cf->bucket_count, f) != cf->bucket_count) {
+        bloomdb_cuckoo_free(cf);
+        fclose(f);
+        return BLOOMDB_ERR_FORMAT;
+    }
+
+    fclose(f);
+    *out_cf = cf;
+    return BLOOMDB_OK;
+}
 
 // ============================================================================
-// Extended API (explicit error handling)
+// Windowed Bloom filter
+//
+// Formato (anchos fijos):
+//   uint32_t magic (BLOOMDB_WINDOWED_MAGIC), uint32_t version
+//   uint64_t positions, uint32_t num_hashes, uint32_t generations
+//   uint32_t current, uint32_t reserved, uint64_t seed, uint64_t rotations
+//   byte_count bytes de carriles
 // ============================================================================
 
-BloomDBError bloomdb_save_ex(const BloomDB* db, const char* path) {
-    if (!db || !path) return BLOOMDB_ERR_INVALID_ARGUMENT;
+#define BLOOMDB_WINDOWED_MAGIC   0x57424442u   // "BDBW"
+#define BLOOMDB_WINDOWED_VERSION 1u
+
+BloomDBError bloomdb_windowed_save_ex(const BloomDBWindowed* wf, const char* path) {
+    if (!wf || !path) return BLOOMDB_ERR_INVALID_ARGUMENT;
 
     FILE* f = fopen(path, "wb");
     if (!f) return BLOOMDB_ERR_FILE_IO;
 
-    size_t written = 0;
-    written += fwrite(&db->bit_count,  sizeof(size_t), 1, f);
-    written += fwrite(&db->byte_count, sizeof(size_t), 1, f);
-    written += fwrite(&db->num_hashes, sizeof(int),    1, f);
-    written += fwrite(&db->seed,       sizeof(uint64_t), 1, f);
-    
-    if (written != 4) {
+    uint32_t head[2] = { BLOOMDB_WINDOWED_MAGIC, BLOOMDB_WINDOWED_VERSION };
+    uint64_t positions = wf->positions;
+    uint32_t params[4] = { (uint32_t)wf->num_hashes, (uint32_t)wf->generations, (uint32_t)wf->current, 0 };
+    uint64_t tail[2] = { wf->seed, wf->rotations };
+
+    if (fwrite(head, sizeof(uint32_t), 2, f) != 2 ||
+        fwrite(&positions, sizeof(uint64_t), 1, f) != 1 ||
+        fwrite(params, sizeof(uint32_t), 4, f) != 4 ||
+        fwrite(tail, sizeof(uint64_t), 2, f) != 2 ||
+        fwrite(wf->lanes, 1, wf->byte_count, f) != wf->byte_count) {
         fclose(f);
         return BLOOMDB_ERR_FILE_IO;
     }
 
-    if (fwrite(db->bitarray, 1, db->byte_count, f) != db->byte_count) {
+    if (fclose(f) != 0) return BLOOMDB_ERR_FILE_IO;
+    return BLOOMDB_OK;
+}
+
+BloomDBError bloomdb_windowed_load_ex(const char* path, BloomDBWindowed** out_wf) {
+    if (!path || !out_wf) return BLOOMDB_ERR_INVALID_ARGUMENT;
+
+    FILE* f = fopen(path, "rb");
+    if (!f) return BLOOMDB_ERR_FILE_IO;
+
+    uint32_t head[2];
+    uint64_t positions;
+    uint32_t params[4];
+    uint64_t tail[2];
+    if (fread(head, sizeof(uint32_t), 2, f) != 2 ||
+        fread(&positions, sizeof(uint64_t), 1, f) != 1 ||
+        fread(params, sizeof(uint32_t), 4, f) != 4 ||
+        fread(tail, sizeof(uint64_t), 2, f) != 2) {
+        fclose(f);
+        return BLOOMDB_ERR_FORMAT;
+    }
+
+    if (head[0] != BLOOMDB_WINDOWED_MAGIC || head[1] != BLOOMDB_WINDOWED_VERSION ||
+        positions == 0 || positions > SIZE_MAX / 8 || params[0] == 0 || params[0] > INT32_MAX ||
+        params[1] == 0 || params[1] > BLOOMDB_WINDOWED_MAX_GENERATIONS || params[2] >= params[1]) {
         fclose(f);
-        return BLOOMDB_ERR_FILE_IO;
+        return BLOOMDB_ERR_FORMAT;
+    }
+
+    BloomDBWindowed* wf = NULL;
+    BloomDBError err = bloomdb_windowed_create_ex((size_t)positions, (int)params[0], (int)params[1], tail[0], &wf);
+    if (err != BLOOMDB_OK) {
+        fclose(f);
+        return err;
+    }
+    wf->current = (int)params[2];
+    wf->rotations = tail[1];
+
+    if (fread(wf->lanes, 1, wf->byte_count, f) != wf->byte_count) {
+        bloomdb_windowed_free(wf);
+        fclose(f);
+        return BLOOMDB_ERR_FORMAT;
     }
 
     fclose(f);
+    *out_wf = wf;
     return BLOOMDB_OK;
 }
 
-BloomDBError bloomdb_load_ex(const char* path, BloomDB** out_db) {
-    if (!path || !out_db) return BLOOMDB_ERR_INVALID_ARGUMENT;
+// ============================================================================
+// Counting Bloom filter
+//
+// Formato (anchos fijos):
+//   uint32_t magic (BLOOMDB_COUNTING_MAGIC), uint32_t version
+//   uint64_t counter_count, uint32_t num_hashes, uint32_t reserved
+//   uint64_t seed
+//   (counter_count + 15) / 16 palabras uint64_t de contadores
+// El modo de índice se deriva de counter_count, igual que al crearlo.
+// ============================================================================
+
+#define BLOOMDB_COUNTING_MAGIC   0x43424442u   // "BDBC"
+#define BLOOMDB_COUNTING_VERSION 1u
+
+BloomDBError bloomdb_counting_save_ex(const BloomDBCounting* cf, const char* path) {
+    if (!cf || !path) return BLOOMDB_ERR_INVALID_ARGUMENT;
+
+    FILE* f = fopen(path, "wb");
+    if (!f) return BLOOMDB_ERR_FILE_IO;
+
+    uint32_t head[2] = { BLOOMDB_COUNTING_MAGIC, BLOOMDB_COUNTING_VERSION };
+    uint64_t counter_count = cf->counter_count;
+    uint32_t params[2] = { (uint32_t)cf->num_hashes, 0 };
+
+    size_t written = 0;
+    written += fwrite(head, sizeof(uint32_t), 2, f);
+    written += fwrite(&counter_count, sizeof(uint64_t), 1, f);
+    written += fwrite(params, sizeof(uint32_t), 2, f);
+    written += fwrite(&cf->seed, sizeof(uint64_t), 1, f);
+
+    if (written != 6 ||
+        fwrite(cf->words, sizeof(uint64_t), cf->word_count, f) != cf->word_count) {
+        fclose(f);
+        return BLOOMDB_ERR_FILE_IO;
+    }
+
+    if (fclose(f) != 0) return BLOOMDB_ERR_FILE_IO;
+    return BLOOMDB_OK;
+}
+
+BloomDBError bloomdb_counting_load_ex(const char* path, BloomDBCounting** out_cf) {
+    if (!path || !out_cf) return BLOOMDB_ERR_INVALID_ARGUMENT;
 
     FILE* f = fopen(path, "rb");
     if (!f) return BLOOMDB_ERR_FILE_IO;
 
-    size_t bits, bytes;
-    int num_hashes;
+    uint32_t head[2];
+    uint64_t counter_count;
+    uint32_t params[2];
     uint64_t seed;
 
-    if (fread(&bits, sizeof(size_t), 1, f) != 1 ||
-        fread(&bytes, sizeof(size_t), 1, f) != 1 ||
-        fread(&num_hashes, sizeof(int), 1, f) != 1 ||
+    if (fread(head, sizeof(uint32_t), 2, f) != 2 ||
+        fread(&counter_count, sizeof(uint64_t), 1, f) != 1 ||
+        fread(params, sizeof(uint32_t), 2, f) != 2 ||
         fread(&seed, sizeof(uint64_t), 1, f) != 1) {
         fclose(f);
         return BLOOMDB_ERR_FORMAT;
     }
 
-    // Validar valores razonables
-    if (bits == 0 || num_hashes <= 0 || bytes != (bits + 7) / 8) {
+    if (head[0] != BLOOMDB_COUNTING_MAGIC || head[1] != BLOOMDB_COUNTING_VERSION ||
+        counter_count == 0 || counter_count > SIZE_MAX / 4 ||
+        params[0] == 0 || params[0] > INT32_MAX) {
         fclose(f);
         return BLOOMDB_ERR_FORMAT;
     }
 
-    BloomDB* db = NULL;
-    BloomDBError err = bloomdb_create_ex(bits, num_hashes, seed, &db);
+    BloomDBCounting* cf = NULL;
+    BloomDBError err = bloomdb_counting_create_ex((size_t)counter_count, (int)params[0], seed, &cf);
     if (err != BLOOMDB_OK) {
         fclose(f);
         return err;
     }
 
-    if (fread(db->bitarray, 1, bytes, f) != bytes) {
-        bloomdb_free(db);
+    if (fread(cf->words, sizeof(uint64_t), cf->word_count, f) != cf->word_count) {
+        bloomdb_counting_free(cf);
         fclose(f);
         return BLOOMDB_ERR_FORMAT;
     }
 
     fclose(f);
+    *out_cf = cf;
+    return BLOOMDB_OK;
+}
+
+// ============================================================================
+// Scalable Bloom filter
+//
+// Formato (anchos fijos):
+//   uint32_t magic (BLOOMDB_SCALABLE_MAGIC), uint32_t version
+//   uint32_t slice_count, uint32_t reserved
+//   uint64_t initial_capacity, double fpr, uint64_t seed
+//   uint64_t inserted, uint64_t next_check   (estado de la slice activa)
+//   por slice, de la más antigua a la más nueva:
+//     uint64_t bit_count, uint32_t num_hashes, uint32_t index_mode
+//     (bit_count + 7) / 8 bytes de bits
+// ============================================================================
+
+#define BLOOMDB_SCALABLE_MAGIC   0x4c424442u   // "BDBL"
+#define BLOOMDB_SCALABLE_VERSION 1u
+
+// BloomDB dentro de otro formato: bit_count, num_hashes, index_mode y bits
+// (la seed la guarda el contenedor)
+static bool write_embedded_bloomdb(FILE* f, const BloomDB* db) {
+    uint64_t bit_count = db->bit_count;
+    uint32_t params[2] = { (uint32_t)db->num_hashes, (uint32_t)db->index_mode };
+    return fwrite(&bit_count, sizeof(uint64_t), 1, f) == 1 &&
+           fwrite(params, sizeof(uint32_t), 2, f) == 2 &&
+           fwrite(db->bitarray, 1, db->byte_count, f) == db->byte_count;
+}
+
+BloomDBError bloomdb_scalable_save_ex(const BloomDBScalable* sf, const char* path) {
+    if (!sf || !path) return BLOOMDB_ERR_INVALID_ARGUMENT;
+
+    FILE* f = fopen(path, "wb");
+    if (!f) return BLOOMDB_ERR_FILE_IO;
+
+    uint32_t head[4] = { BLOOMDB_SCALABLE_MAGIC, BLOOMDB_SCALABLE_VERSION, (uint32_t)sf->slice_count, 0 };
+    uint64_t initial_capacity = sf->initial_capacity;
+
+    size_t written = 0;
+    written += fwrite(head, sizeof(uint32_t), 4, f);
+    written += fwrite(&initial_capacity, sizeof(uint64_t), 1, f);
+    written += fwrite(&sf->fpr, sizeof(double), 1, f);
+    written += fwrite(&sf->seed, sizeof(uint64_t), 1, f);
+    written += fwrite(&sf->inserted, sizeof(uint64_t), 1, f);
+    written += fwrite(&sf->next_check, sizeof(uint64_t), 1, f);
+
+    bool ok = written == 9;
+    for (size_t i = 0; ok && i < sf->slice_count; i++) ok = write_embedded_bloomdb(f, sf->slices[i]);
+
+    if (!ok) {
+        fclose(f);
+        return BLOOMDB_ERR_FILE_IO;
+    }
+
+    if (fclose(f) != 0) return BLOOMDB_ERR_FILE_IO;
+    return BLOOMDB_OK;
+}
+
+// Lee lo escrito por write_embedded_bloomdb: cabecera validada + bits, con
+// el modo de índice guardado
+static BloomDBError read_embedded_bloomdb(FILE* f, uint64_t seed, BloomDB** out_db) {
+    uint64_t bit_count;
+    uint32_t params[2];
+    if (fread(&bit_count, sizeof(uint64_t), 1, f) != 1 ||
+        fread(params, sizeof(uint32_t), 2, f) != 2) {
+        return BLOOMDB_ERR_FORMAT;
+    }
+    if (bit_count == 0 || bit_count > SIZE_MAX / 2 || params[0] == 0 || params[0] > INT32_MAX ||
+        params[1] > BLOOMDB_INDEX_MASK ||
+        (params[1] == BLOOMDB_INDEX_MASK && (bit_count & (bit_count - 1)) != 0)) {
+        return BLOOMDB_ERR_FORMAT;
+    }
+
+    BloomDB* db = NULL;
+    BloomDBError err = bloomdb_create_ex((size_t)bit_count, (int)params[0], seed, &db);
+    if (err != BLOOMDB_OK) return err;
+    db->index_mode = (int)params[1];
+
+    if (fread(db->bitarray, 1, db->byte_count, f) != db->byte_count) {
+        bloomdb_free(db);
+        return BLOOMDB_ERR_FORMAT;
+    }
     *out_db = db;
     return BLOOMDB_OK;
 }
 
+BloomDBError bloomdb_scalable_load_ex(const char* path, BloomDBScalable** out_sf) {
+    if (!path || !out_sf) return BLOOMDB_ERR_INVALID_ARGUMENT;
+
+    FILE* f = fopen(path, "rb");
+    if (!f) return BLOOMDB_ERR_FILE_IO;
+
+    uint32_t head[4];
+    uint64_t initial_capacity;
+    double fpr;
+    uint64_t seed, inserted, next_check;
+
+    if (fread(head, sizeof(uint32_t), 4, f) != 4 ||
+        fread(&initial_capacity, sizeof(uint64_t), 1, f) != 1 ||
+        fread(&fpr, sizeof(double), 1, f) != 1 ||
+        fread(&seed, sizeof(uint64_t), 1, f) != 1 ||
+        fread(&inserted, sizeof(uint64_t), 1, f) != 1 ||
+        fread(&next_check, sizeof(uint64_t), 1, f) != 1) {
+        fclose(f);
+        return BLOOMDB_ERR_FORMAT;
+    }
+
+    if (head[0] != BLOOMDB_SCALABLE_MAGIC || head[1] != BLOOMDB_SCALABLE_VERSION ||
+        head[2] == 0 || head[2] > BLOOMDB_SCALABLE_MAX_SLICES ||
+        initial_capacity == 0 || initial_capacity > SIZE_MAX || !(fpr > 0.0 && fpr < 1.0)) {
+        fclose(f);
+        return BLOOMDB_ERR_FORMAT;
+    }
+
+    BloomDBScalable* sf = calloc(1, sizeof(BloomDBScalable));
+    if (!sf) {
+        fclose(f);
+        return BLOOMDB_ERR_ALLOC;
+    }
+    sf->initial_capacity = (size_t)initial_capacity;
+    sf->fpr = fpr;
+    sf->seed = seed;
+    sf->inserted = inserted;
+    sf->next_check = next_check;
+
+    for (uint32_t i = 0; i < head[2]; i++) {
+        BloomDBError err = read_embedded_bloomdb(f, seed, &sf->slices[i]);
+        if (err != BLOOMDB_OK) {
+            bloomdb_scalable_free(sf);
+            fclose(f);
+            return err;
+        }
+        sf->slice_count++;
+    }
+
+    fclose(f);
+    *out_sf = sf;
+    return BLOOMDB_OK;
+}
+
+// ============================================================================
+// Range Bloom filter
+//
+// Formato (anchos fijos):
+//   uint32_t magic (BLOOMDB_RANGE_MAGIC), uint32_t version
+//   uint32_t levels, uint32_t reserved, uint64_t seed, uint64_t count
+//   BloomDB de prefijos: uint64_t bit_count, uint32_t num_hashes,
+//   uint32_t index_mode, (bit_count + 7) / 8 bytes de bits
+// ============================================================================
+
+#define BLOOMDB_RANGE_MAGIC   0x52424442u   // "BDBR"
+#define BLOOMDB_RANGE_VERSION 1u
+
+BloomDBError bloomdb_range_save_ex(const BloomDBRange* rf, const char* path) {
+    if (!rf || !path) return BLOOMDB_ERR_INVALID_ARGUMENT;
+
+    FILE* f = fopen(path, "wb");
+    if (!f) return BLOOMDB_ERR_FILE_IO;
+
+    uint32_t head[4] = { BLOOMDB_RANGE_MAGIC, BLOOMDB_RANGE_VERSION, (uint32_t)rf->levels, 0 };
+    uint64_t tail[2] = { rf->db->seed, rf->count };
+
+    if (fwrite(head, sizeof(uint32_t), 4, f) != 4 ||
+        fwrite(tail, sizeof(uint64_t), 2, f) != 2 ||
+        !write_embedded_bloomdb(f, rf->db)) {
+        fclose(f);
+        return BLOOMDB_ERR_FILE_IO;
+    }
+
+    if (fclose(f) != 0) return BLOOMDB_ERR_FILE_IO;
+    return BLOOMDB_OK;
+}
+
+BloomDBError bloomdb_range_load_ex(const char* path, BloomDBRange** out_rf) {
+    if (!path || !out_rf) return BLOOMDB_ERR_INVALID_ARGUMENT;
+
+    FILE* f = fopen(path, "rb");
+    if (!f) return BLOOMDB_ERR_FILE_IO;
+
+    uint32_t head[4];
+    uint64_t tail[2];
+    if (fread(head, sizeof(uint32_t), 4, f) != 4 ||
+        fread(tail, sizeof(uint64_t), 2, f) != 2) {
+        fclose(f);
+        return BLOOMDB_ERR_FORMAT;
+    }
+
+    if (head[0] != BLOOMDB_RANGE_MAGIC || head[1] != BLOOMDB_RANGE_VERSION ||
+        head[2] == 0 || head[2] > BLOOMDB_RANGE_MAX_LEVELS) {
+        fclose(f);
+        return BLOOMDB_ERR_FORMAT;
+    }
+
+    BloomDBRange* rf = calloc(1, sizeof(BloomDBRange));
+    if (!rf) {
+        fclose(f);
+        return BLOOMDB_ERR_ALLOC;
+    }
+    rf->levels = (int)head[2];
+    rf->count = tail[1];
+
+    BloomDBError err = read_embedded_bloomdb(f, tail[0], &rf->db);
+    fclose(f);
+    if (err != BLOOMDB_OK) {
+        free(rf);
+        return err;
+    }
+
+    *out_rf = rf;
+    return BLOOMDB_OK;
+}
+
 // ============================================================================
 // Simple API (wrappers)
 // ============================================================================
@@ -94,3 +2115,175 @@ BloomDB* bloomdb_load(const char* path) {
     }
     return db;
 }
+
+bool bloomdb_save_encoded(const BloomDB* db, const char* path, BloomDBEncoding encoding) {
+    return bloomdb_save_encoded_ex(db, path, encoding) == BLOOMDB_OK;
+}
+
+uint8_t* bloomdb_serialize(const BloomDB* db, BloomDBEncoding encoding, size_t* out_len) {
+    uint8_t* buf = NULL;
+    if (bloomdb_serialize_ex(db, encoding, &buf, out_len) != BLOOMDB_OK) return NULL;
+    return buf;
+}
+
+BloomDB* bloomdb_deserialize(const void* buf, size_t len) {
+    BloomDB* db = NULL;
+    if (bloomdb_deserialize_ex(buf, len, &db) != BLOOMDB_OK) return NULL;
+    return db;
+}
+
+BloomDB* bloomdb_open_mmap(const char* path, int flags) {
+    BloomDB* db = NULL;
+    if (bloomdb_open_mmap_ex(path, flags, &db) != BLOOMDB_OK) {
+        return NULL;
+    }
+    return db;
+}
+
+bool bloomdb_sync(const BloomDB* db) {
+    return bloomdb_sync_ex(db) == BLOOMDB_OK;
+}
+
+bool bloomdb_verify(const BloomDB* db, int threads) {
+    return bloomdb_verify_ex(db, threads) == BLOOMDB_OK;
+}
+
+bool bloomdb_save_incremental(BloomDB* db, const char* path, const char* delta_path) {
+    return bloomdb_save_incremental_ex(db, path, delta_path) == BLOOMDB_OK;
+}
+
+bool bloomdb_apply_delta(BloomDB* db, const char* delta_path) {
+    return bloomdb_apply_delta_ex(db, delta_path) == BLOOMDB_OK;
+}
+
+BloomDBSnapshot* bloomdb_snapshot_async(const BloomDB* db, const char* path, BloomDBSnapshotCallback callback,
+                                        void* user) {
+    BloomDBSnapshot* snap = NULL;
+    if (bloomdb_snapshot_async_ex(db, path, callback, user, &snap) != BLOOMDB_OK) return NULL;
+    return snap;
+}
+
+bool bloomdb_snapshot_wait(BloomDBSnapshot* snap) {
+    return bloomdb_snapshot_wait_ex(snap) == BLOOMDB_OK;
+}
+
+BloomDBSnapshotScheduler* bloomdb_snapshot_scheduler_start(const BloomDB* db, const char* path, uint32_t interval_ms,
+                                                           BloomDBSnapshotCallback callback, void* user) {
+    BloomDBSnapshotScheduler* sched = NULL;
+    if (bloomdb_snapshot_scheduler_start_ex(db, path, interval_ms, callback, user, &sched) != BLOOMDB_OK) {
+        return NULL;
+    }
+    return sched;
+}
+
+void bloomdb_snapshot_scheduler_stop(BloomDBSnapshotScheduler* sched) {
+    if (sched) bloomdb_snapshot_scheduler_stop_ex(sched);
+}
+
+bool bloomdb_blocked_save(const BloomDBBlocked* bf, const char* path) {
+    return bloomdb_blocked_save_ex(bf, path) == BLOOMDB_OK;
+}
+
+BloomDBBlocked* bloomdb_blocked_load(const char* path) {
+    BloomDBBlocked* bf = NULL;
+    if (bloomdb_blocked_load_ex(path, &bf) != BLOOMDB_OK) {
+        return NULL;
+    }
+    return bf;
+}
+
+bool bloomdb_split_save(const BloomDBSplit* sf, const char* path) {
+    return bloomdb_split_save_ex(sf, path) == BLOOMDB_OK;
+}
+
+BloomDBSplit* bloomdb_split_load(const char* path) {
+    BloomDBSplit* sf = NULL;
+    if (bloomdb_split_load_ex(path, &sf) != BLOOMDB_OK) {
+        return NULL;
+    }
+    return sf;
+}
+
+bool bloomdb_partitioned_save(const BloomDBPartitioned* pf, const char* path) {
+    return bloomdb_partitioned_save_ex(pf, path) == BLOOMDB_OK;
+}
+
+BloomDBPartitioned* bloomdb_partitioned_load(const char* path) {
+    BloomDBPartitioned* pf = NULL;
+    if (bloomdb_partitioned_load_ex(path, &pf) != BLOOMDB_OK) {
+        return NULL;
+    }
+    return pf;
+}
+
+bool bloomdb_fuse_save(const BloomDBFuse* ff, const char* path) {
+    return bloomdb_fuse_save_ex(ff, path) == BLOOMDB_OK;
+}
+
+BloomDBFuse* bloomdb_fuse_load(const char* path) {
+    BloomDBFuse* ff = NULL;
+    if (bloomdb_fuse_load_ex(path, &ff) != BLOOMDB_OK) {
+        return NULL;
+    }
+    return ff;
+}
+
+bool bloomdb_cuckoo_save(const BloomDBCuckoo* cf, const char* path) {
+    return bloomdb_cuckoo_save_ex(cf, path) == BLOOMDB_OK;
+}
+
+BloomDBCuckoo* bloomdb_cuckoo_load(const char* path) {
+    BloomDBCuckoo* cf = NULL;
+    if (bloomdb_cuckoo_load_ex(path, &cf) != BLOOMDB_OK) {
+        return NULL;
+    }
+    return cf;
+}
+
+bool bloomdb_windowed_save(const BloomDBWindowed* wf, const char* path) {
+    return bloomdb_windowed_save_ex(wf, path) == BLOOMDB_OK;
+}
+
+BloomDBWindowed* bloomdb_windowed_load(const char* path) {
+    BloomDBWindowed* wf = NULL;
+    if (bloomdb_windowed_load_ex(path, &wf) != BLOOMDB_OK) {
+        return NULL;
+    }
+    return wf;
+}
+
+bool bloomdb_range_save(const BloomDBRange* rf, const char* path) {
+    return bloomdb_range_save_ex(rf, path) == BLOOMDB_OK;
+}
+
+BloomDBRange* bloomdb_range_load(const char* path) {
+    BloomDBRange* rf = NULL;
+    if (bloomdb_range_load_ex(path, &rf) != BLOOMDB_OK) {
+        return NULL;
+    }
+    return rf;
+}
+
+bool bloomdb_counting_save(const BloomDBCounting* cf, const char* path) {
+    return bloomdb_counting_save_ex(cf, path) == BLOOMDB_OK;
+}
+
+BloomDBCounting* bloomdb_counting_load(const char* path) {
+    BloomDBCounting* cf = NULL;
+    if (bloomdb_counting_load_ex(path, &cf) != BLOOMDB_OK) {
+        return NULL;
+    }
+    return cf;
+}
+
+bool bloomdb_scalable_save(const BloomDBScalable* sf, const char* path) {
+    return bloomdb_scalable_save_ex(sf, path) == BLOOMDB_OK;
+}
+
+BloomDBScalable* bloomdb_scalable_load(const char* path) {
+    BloomDBScalable* sf = NULL;
+    if (bloomdb_scalable_load_ex(path, &sf) != BLOOMDB_OK) {
+        return NULL;
+    }
+    return sf;
+}
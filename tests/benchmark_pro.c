@@ -5,6 +5,9 @@
 #include <time.h>
 #include <string.h>
 #include <math.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <fcntl.h>
 #ifdef __linux__
 #include <sched.h>
 #endif
@@ -13,6 +16,16 @@
 #include "hash64.h"
 #include "bloomdb.h"
 #include "storage.h"
+#include "bloom_blocked.h"
+#include "bloom_partitioned.h"
+#include "bloom_fuse.h"
+#include "bloom_cuckoo.h"
+#include "bloom_windowed.h"
+#include "bloom_range.h"
+#include "bloom_split.h"
+#include "bloom_counting.h"
+#include "bloom_scalable.h"
+#include "insert_log.h"
 
 #define RUNS 50        // número de repeticiones por test
 #define N_OPS 1000000  // 1 millón de operaciones por run
@@ -119,6 +132,81 @@ void bench_hash64(FILE* json) {
     }
 
     compute_stats(times, RUNS, "hash64", json);
+
+    // Throughput: hash64() clave a clave vs hash128_many() (AVX2 multi-key)
+    enum { NKEYS = 4096 };
+    static uint8_t storage[NKEYS][200];
+    static uint8_t flat[NKEYS * 16];
+    static const void* keys[NKEYS];
+    static size_t lens[NKEYS];
+    static hash128_t out[NKEYS];
+
+    struct { const char* label; size_t min_len, max_len; } shapes[] = {
+        { "hash_u64",     8,   8 },
+        { "hash_uuid16", 16,  16 },
+        { "hash_url",    40, 200 },
+    };
+
+    for (size_t s_i = 0; s_i < sizeof(shapes) / sizeof(shapes[0]); s_i++) {
+        for (int i = 0; i < NKEYS; i++) {
+            for (int j = 0; j < 200; j++) storage[i][j] = (uint8_t)(rand() & 0xff);
+            keys[i] = storage[i];
+            lens[i] = shapes[s_i].min_len +
+                      (size_t)rand() % (shapes[s_i].max_len - shapes[s_i].min_len + 1);
+        }
+
+        // Longitud fija: claves contiguas (uint64_t[], UUIDs) vía hash128_fixed()
+        const size_t fixed_len = shapes[s_i].min_len == shapes[s_i].max_len ? shapes[s_i].min_len : 0;
+        if (fixed_len) {
+            for (int i = 0; i < NKEYS; i++) {
+                memcpy(flat + (size_t)i * fixed_len, storage[i], fixed_len);
+                keys[i] = flat + (size_t)i * fixed_len;
+            }
+        }
+
+        const int reps = N_OPS / NKEYS;
+        uint64_t sink = 0;
+        uint64_t best_scalar = UINT64_MAX, best_many = UINT64_MAX;
+
+        for (int r = 0; r < RUNS / 5; r++) {
+            uint64_t start = ns();
+            for (int rep = 0; rep < reps; rep++)
+                for (int i = 0; i < NKEYS; i++)
+                    sink += hash64(keys[i], lens[i], (uint64_t)rep);
+            uint64_t mid = ns();
+            for (int rep = 0; rep < reps; rep++) {
+                if (fixed_len)
+                    hash128_fixed(flat, fixed_len, NKEYS, (uint64_t)rep, out);
+                else
+                    hash128_many(keys, lens, NKEYS, (uint64_t)rep, out);
+                sink += out[rep & (NKEYS - 1)].h1;
+            }
+            uint64_t end = ns();
+            if (mid - start < best_scalar) best_scalar = mid - start;
+            if (end - mid < best_many) best_many = end - mid;
+        }
+
+        double total = (double)reps * NKEYS;
+        double scalar_ns = best_scalar / total;
+        double many_ns = best_many / total;
+
+        printf("\n=== %s (%zu..%zu bytes) ===\n", shapes[s_i].label,
+               shapes[s_i].min_len, shapes[s_i].max_len);
+        printf("hash64 scalar: %.2f ns/key (%.1f Mkeys/s)\n", scalar_ns, 1000.0 / scalar_ns);
+        printf("%s: %.2f ns/key (%.1f Mkeys/s)\n",
+               fixed_len ? "hash128_fixed" : "hash128_many ", many_ns, 1000.0 / many_ns);
+        printf("Speedup:       %.2fx   (sink %lu)\n", scalar_ns / many_ns, (unsigned long)(sink & 1));
+
+        if (json) {
+            fprintf(json,
+                "  \"%s\": {\n"
+                "    \"scalar_ns\": %.2f,\n"
+                "    \"many_ns\": %.2f,\n"
+                "    \"speedup\": %.2f\n"
+                "  },\n",
+                shapes[s_i].label, scalar_ns, many_ns, scalar_ns / many_ns);
+        }
+    }
 }
 
 void bench_bloom_insert(FILE* json) {
@@ -148,6 +236,1272 @@ void bench_bloom_insert(FILE* json) {
     bloomdb_free(db);
 }
 
+void bench_index_modes(FILE* json) {
+    // Consulta con cada reducción hash -> índice (claves precalculadas)
+    enum { NKEYS = 4096 };
+    static char keys[NKEYS][32];
+    static size_t lens[NKEYS];
+    uint64_t times[RUNS];
+    uint64_t hits = 0;
+
+    for (int i = 0; i < NKEYS; i++) {
+        snprintf(keys[i], sizeof(keys[i]), "key%d", i * 31);
+        lens[i] = strlen(keys[i]);
+    }
+
+    struct { const char* label; size_t bits; int mode; } modes[] = {
+        { "query_modulo",    1000003, BLOOMDB_INDEX_MODULO },
+        { "query_fastrange", 1000003, BLOOMDB_INDEX_FASTRANGE },
+        { "query_mask",      1 << 20, BLOOMDB_INDEX_MASK },
+    };
+
+    for (size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); m++) {
+        BloomDB* db = bloomdb_create(modes[m].bits, 7, 99);
+        db->index_mode = modes[m].mode;
+        for (int i = 0; i < NKEYS; i += 2) bloomdb_insert(db, keys[i], lens[i]);
+
+        for (int r = 0; r < RUNS; r++) {
+            uint64_t start = ns();
+            for (int i = 0; i < N_OPS; i++) {
+                int k = i & (NKEYS - 1);
+                hits += bloomdb_might_contain(db, keys[k], lens[k]);
+            }
+            uint64_t end = ns();
+            times[r] = (end - start) / N_OPS;
+        }
+        compute_stats(times, RUNS, modes[m].label, json);
+        bloomdb_free(db);
+    }
+    printf("(hits %lu)\n", (unsigned long)(hits & 1));
+}
+
+// Filtros más grandes que la LLC: cada sonda es un fallo de caché
+#define BIG_FILTER_BITS (1ULL << 30)   // 128 MiB
+#define BIG_NKEYS (1 << 16)
+
+static char (*big_keys)[32];
+
+static void big_keys_init(void) {
+    if (big_keys) return;
+    big_keys = malloc(sizeof(*big_keys) * BIG_NKEYS);
+    for (int i = 0; i < BIG_NKEYS; i++) {
+        snprintf(big_keys[i], sizeof(big_keys[i]), "big-key-%d", i * 2654435761u);
+    }
+}
+
+void bench_blocked(FILE* json) {
+    big_keys_init();
+    uint64_t times[RUNS];
+    uint64_t hits = 0;
+
+    BloomDB* db = bloomdb_create(BIG_FILTER_BITS, 7, 5);
+    BloomDBBlocked* bf = bloomdb_blocked_create(BIG_FILTER_BITS, 7, 5);
+
+    // La mitad de las claves presentes: las consultas positivas tocan las k sondas
+    for (int i = 0; i < BIG_NKEYS; i += 2) {
+        bloomdb_insert(db, big_keys[i], strlen(big_keys[i]));
+        bloomdb_blocked_insert(bf, big_keys[i], strlen(big_keys[i]));
+    }
+
+    for (int r = 0; r < RUNS; r++) {
+        uint64_t start = ns();
+        for (int i = 0; i < N_OPS; i++) {
+            const char* k = big_keys[(i * 7) & (BIG_NKEYS - 1)];
+            hits += bloomdb_might_contain(db, k, strlen(k));
+        }
+        uint64_t end = ns();
+        times[r] = (end - start) / N_OPS;
+    }
+    compute_stats(times, RUNS, "query_128MiB_standard", json);
+
+    for (int r = 0; r < RUNS; r++) {
+        uint64_t start = ns();
+        for (int i = 0; i < N_OPS; i++) {
+            const char* k = big_keys[(i * 7) & (BIG_NKEYS - 1)];
+            hits += bloomdb_blocked_might_contain(bf, k, strlen(k));
+        }
+        uint64_t end = ns();
+        times[r] = (end - start) / N_OPS;
+    }
+    compute_stats(times, RUNS, "query_128MiB_blocked", json);
+    printf("(hits %lu)\n", (unsigned long)(hits & 1));
+
+    bloomdb_free(db);
+    bloomdb_blocked_free(bf);
+}
+
+void bench_partitioned(FILE* json) {
+    // k = 8 y tamaños k * 2^j: las particiones no se redondean y ambos
+    // filtros tienen exactamente los mismos bits
+    static const struct { size_t bits; const char* tag; } sizes[] = {
+        { 1ULL << 18, "32KiB" },
+        { BIG_FILTER_BITS, "128MiB" },
+    };
+    big_keys_init();
+    uint64_t times[RUNS];
+    uint64_t hits = 0;
+    char label[64];
+
+    for (int s = 0; s < 2; s++) {
+        BloomDB* db = bloomdb_create(sizes[s].bits, 8, 5);
+        BloomDBPartitioned* pf = bloomdb_partitioned_create(sizes[s].bits, 8, 5);
+
+        for (int r = 0; r < RUNS; r++) {
+            uint64_t start = ns();
+            for (int i = 0; i < N_OPS; i++) {
+                const char* k = big_keys[(i * 2) & (BIG_NKEYS - 1)];
+                bloomdb_insert(db, k, strlen(k));
+            }
+            uint64_t end = ns();
+            times[r] = (end - start) / N_OPS;
+        }
+        snprintf(label, sizeof(label), "insert_%s_standard_k8", sizes[s].tag);
+        compute_stats(times, RUNS, label, json);
+
+        for (int r = 0; r < RUNS; r++) {
+            uint64_t start = ns();
+            for (int i = 0; i < N_OPS; i++) {
+                const char* k = big_keys[(i * 2) & (BIG_NKEYS - 1)];
+                bloomdb_partitioned_insert(pf, k, strlen(k));
+            }
+            uint64_t end = ns();
+            times[r] = (end - start) / N_OPS;
+        }
+        snprintf(label, sizeof(label), "insert_%s_partitioned_k8", sizes[s].tag);
+        compute_stats(times, RUNS, label, json);
+
+        for (int r = 0; r < RUNS; r++) {
+            uint64_t start = ns();
+            for (int i = 0; i < N_OPS; i++) {
+                const char* k = big_keys[(i * 7) & (BIG_NKEYS - 1)];
+                hits += bloomdb_might_contain(db, k, strlen(k));
+            }
+            uint64_t end = ns();
+            times[r] = (end - start) / N_OPS;
+        }
+        snprintf(label, sizeof(label), "query_%s_standard_k8", sizes[s].tag);
+        compute_stats(times, RUNS, label, json);
+
+        for (int r = 0; r < RUNS; r++) {
+            uint64_t start = ns();
+            for (int i = 0; i < N_OPS; i++) {
+                const char* k = big_keys[(i * 7) & (BIG_NKEYS - 1)];
+                hits += bloomdb_partitioned_might_contain(pf, k, strlen(k));
+            }
+            uint64_t end = ns();
+            times[r] = (end - start) / N_OPS;
+        }
+        snprintf(label, sizeof(label), "query_%s_partitioned_k8", sizes[s].tag);
+        compute_stats(times, RUNS, label, json);
+
+        bloomdb_free(db);
+        bloomdb_partitioned_free(pf);
+    }
+    printf("(hits %lu)\n", (unsigned long)(hits & 1));
+}
+
+// Filtros estáticos: binary fuse frente a las variantes Bloom dimensionadas
+// para el mismo FPR (1/256 -> 11.54 bits por clave, k = 8)
+#define FUSE_NKEYS (1 << 22)
+
+typedef bool (*query_fn)(const void* filter, const void* key, size_t len);
+
+static bool q_standard(const void* f, const void* k, size_t n) { return bloomdb_might_contain(f, k, n); }
+static bool q_blocked(const void* f, const void* k, size_t n) { return bloomdb_blocked_might_contain(f, k, n); }
+static bool q_split(const void* f, const void* k, size_t n) { return bloomdb_split_might_contain(f, k, n); }
+static bool q_fuse(const void* f, const void* k, size_t n) { return bloomdb_fuse_might_contain(f, k, n); }
+
+void bench_fuse(FILE* json) {
+    char (*keys)[24] = malloc(sizeof(*keys) * FUSE_NKEYS);
+    const void** ptrs = malloc(sizeof(void*) * FUSE_NKEYS);
+    size_t* lens = malloc(sizeof(size_t) * FUSE_NKEYS);
+    for (size_t i = 0; i < FUSE_NKEYS; i++) {
+        lens[i] = (size_t)snprintf(keys[i], sizeof(keys[i]), "fuse-%zu", i * 2654435761u);
+        ptrs[i] = keys[i];
+    }
+
+    uint64_t start = ns();
+    BloomDBFuse* ff = bloomdb_fuse_build(ptrs, lens, FUSE_NKEYS, 5);
+    printf("\nbuild_fuse (%d claves): %.1f ms\n", FUSE_NKEYS, (ns() - start) / 1e6);
+
+    const size_t bloom_bits = (size_t)(FUSE_NKEYS * 11.54);
+    BloomDB* db = bloomdb_create(bloom_bits, 8, 5);
+    BloomDBBlocked* bf = bloomdb_blocked_create(bloom_bits, 8, 5);
+    BloomDBSplit* sf = bloomdb_split_create(bloom_bits, 5);
+    bloomdb_build_parallel(db, ptrs, lens, FUSE_NKEYS, 1);
+    for (size_t i = 0; i < FUSE_NKEYS; i++) {
+        bloomdb_blocked_insert(bf, ptrs[i], lens[i]);
+        bloomdb_split_insert(sf, ptrs[i], lens[i]);
+    }
+
+    const struct {
+        const char* name;
+        const void* filter;
+        query_fn query;
+        size_t bytes;
+    } variants[] = {
+        { "standard", db, q_standard, db->byte_count },
+        { "blocked", bf, q_blocked, bf->bit_count / 8 },
+        { "split", sf, q_split, sf->bit_count / 8 },
+        { "fuse", ff, q_fuse, bloomdb_fuse_size_bytes(ff) },
+    };
+
+    // Consultas: mitad presentes y mitad ausentes, de dos tablas de 64K claves
+    // para que el costo medido sea el del filtro y no el de leer la clave
+    big_keys_init();
+    uint64_t times[RUNS];
+    uint64_t hits = 0;
+    char label[64];
+    char buf[32];
+
+    for (int v = 0; v < 4; v++) {
+        int fp = 0;
+        for (int i = 0; i < 1000000; i++) {
+            snprintf(buf, sizeof(buf), "absent-%d", i);
+            fp += variants[v].query(variants[v].filter, buf, strlen(buf));
+        }
+        printf("%-9s %7.2f MiB  %5.2f bits/clave  FPR %.3f%%\n", variants[v].name,
+               variants[v].bytes / (1024.0 * 1024.0), 8.0 * variants[v].bytes / FUSE_NKEYS, fp / 1e4);
+
+        for (int r = 0; r < RUNS; r++) {
+            uint64_t t0 = ns();
+            for (int i = 0; i < N_OPS; i++) {
+                const char* k = (i & 1) ? big_keys[(i * 7) & (BIG_NKEYS - 1)] : keys[(i * 7) & (BIG_NKEYS - 1)];
+                hits += variants[v].query(variants[v].filter, k, strlen(k));
+            }
+            times[r] = (ns() - t0) / N_OPS;
+        }
+        snprintf(label, sizeof(label), "query_4M_%s", variants[v].name);
+        compute_stats(times, RUNS, label, json);
+    }
+    printf("(hits %lu)\n", (unsigned long)(hits & 1));
+
+    bloomdb_free(db);
+    bloomdb_blocked_free(bf);
+    bloomdb_split_free(sf);
+    bloomdb_fuse_free(ff);
+    free(keys);
+    free(ptrs);
+    free(lens);
+}
+
+// Cuckoo frente a BloomDB con el mismo FPR (~0.012%: 18.8 bits por clave,
+// k = 13) con 2^20 cubetas llenas al 95% (8 MiB)
+void bench_cuckoo(FILE* json) {
+    const int n = (int)(0.95 * 4 * (1 << 20));
+    char (*keys)[24] = malloc(sizeof(*keys) * n);
+    const void** ptrs = malloc(sizeof(void*) * n);
+    size_t* lens = malloc(sizeof(size_t) * n);
+    for (int i = 0; i < n; i++) {
+        lens[i] = (size_t)snprintf(keys[i], sizeof(keys[i]), "cuckoo-%d", i);
+        ptrs[i] = keys[i];
+    }
+
+    BloomDBCuckoo* cf = bloomdb_cuckoo_create(n, 5);
+    BloomDB* db = bloomdb_create((size_t)(n * 18.8), 13, 5);
+    uint64_t start = ns();
+    for (int i = 0; i < n; i++) bloomdb_cuckoo_insert(cf, ptrs[i], lens[i]);
+    printf("\ninsert_cuckoo (llenado hasta %.0f%%): %.1f ns/op\n",
+           100.0 * bloomdb_cuckoo_load_factor(cf), (double)(ns() - start) / n);
+    start = ns();
+    for (int i = 0; i < n; i++) bloomdb_insert(db, ptrs[i], lens[i]);
+    printf("insert_standard_k13: %.1f ns/op\n", (double)(ns() - start) / n);
+
+    char buf[32];
+    int fp_cuckoo = 0, fp_bloom = 0;
+    for (int i = 0; i < 4000000; i++) {
+        snprintf(buf, sizeof(buf), "absent-%d", i);
+        fp_cuckoo += bloomdb_cuckoo_might_contain(cf, buf, strlen(buf));
+        fp_bloom += bloomdb_might_contain(db, buf, strlen(buf));
+    }
+    printf("cuckoo    %7.2f MiB  %5.2f bits/clave  FPR %.4f%%\n", cf->bucket_count * 8 / (1024.0 * 1024.0),
+           64.0 * cf->bucket_count / n, fp_cuckoo / 4e4);
+    printf("standard  %7.2f MiB  %5.2f bits/clave  FPR %.4f%%\n", db->byte_count / (1024.0 * 1024.0),
+           8.0 * db->byte_count / n, fp_bloom / 4e4);
+
+    // Consultas: mitad presentes y mitad ausentes (tablas de 64K claves)
+    big_keys_init();
+    uint64_t times[RUNS];
+    uint64_t hits = 0;
+    for (int v = 0; v < 2; v++) {
+        for (int r = 0; r < RUNS; r++) {
+            uint64_t t0 = ns();
+            for (int i = 0; i < N_OPS; i++) {
+                const char* k = (i & 1) ? big_keys[(i * 7) & (BIG_NKEYS - 1)] : keys[(i * 7) & (BIG_NKEYS - 1)];
+                hits += v ? bloomdb_might_contain(db, k, strlen(k)) : bloomdb_cuckoo_might_contain(cf, k, strlen(k));
+            }
+            times[r] = (ns() - t0) / N_OPS;
+        }
+        compute_stats(times, RUNS, v ? "query_8MiB_standard_k13" : "query_8MiB_cuckoo", json);
+    }
+
+    // Lotes de 1024 claves con prefetch de las dos cubetas
+    enum { BATCH = 1024 };
+    const void* qk[BATCH];
+    size_t ql[BATCH];
+    uint8_t bitmap[BATCH / 8];
+    for (int i = 0; i < BATCH; i++) {
+        const char* k = (i & 1) ? big_keys[(i * 7) & (BIG_NKEYS - 1)] : keys[(size_t)i * 3889 % n];
+        qk[i] = k;
+        ql[i] = strlen(k);
+    }
+    for (int r = 0; r < RUNS; r++) {
+        uint64_t t0 = ns();
+        for (int i = 0; i < N_OPS / BATCH; i++) {
+            bloomdb_cuckoo_might_contain_batch(cf, qk, ql, BATCH, bitmap);
+            hits += bitmap[i & (BATCH / 8 - 1)];
+        }
+        times[r] = (ns() - t0) / ((N_OPS / BATCH) * BATCH);
+    }
+    compute_stats(times, RUNS, "query_batch_8MiB_cuckoo", json);
+
+    // Borrar + reinsertar (la tabla se mantiene llena al 95%)
+    for (int r = 0; r < RUNS; r++) {
+        uint64_t t0 = ns();
+        for (int i = 0; i < N_OPS / 2; i++) {
+            int j = (int)(((uint64_t)(r * N_OPS + i) * 2654435761u) % (uint64_t)n);
+            bloomdb_cuckoo_remove(cf, ptrs[j], lens[j]);
+            bloomdb_cuckoo_insert(cf, ptrs[j], lens[j]);
+        }
+        times[r] = (ns() - t0) / N_OPS;
+    }
+    compute_stats(times, RUNS, "remove_insert_8MiB_cuckoo", json);
+    printf("(hits %lu)\n", (unsigned long)(hits & 1));
+
+    bloomdb_cuckoo_free(cf);
+    bloomdb_free(db);
+    free(keys);
+    free(ptrs);
+    free(lens);
+}
+
+// Ventana de 4 generaciones de 2^28 bits (128 MiB en total) frente a 4
+// BloomDB separados consultados uno tras otro
+void bench_windowed(FILE* json) {
+    enum { GENS = 4 };
+    const size_t bits = 1ULL << 28;
+    big_keys_init();
+    uint64_t times[RUNS];
+    uint64_t hits = 0;
+
+    BloomDBWindowed* wf = bloomdb_windowed_create(bits, 7, GENS, 5);
+    BloomDB* gens[GENS];
+    for (int g = 0; g < GENS; g++) {
+        gens[g] = bloomdb_create(bits, 7, 5);
+        if (g > 0) bloomdb_windowed_rotate(wf);
+        for (int i = g; i < BIG_NKEYS; i += 2 * GENS) {
+            bloomdb_windowed_insert(wf, big_keys[i], strlen(big_keys[i]));
+            bloomdb_insert(gens[g], big_keys[i], strlen(big_keys[i]));
+        }
+    }
+
+    for (int r = 0; r < RUNS; r++) {
+        uint64_t start = ns();
+        for (int i = 0; i < N_OPS; i++) {
+            const char* k = big_keys[(i * 7) & (BIG_NKEYS - 1)];
+            hits += bloomdb_windowed_might_contain(wf, k, strlen(k));
+        }
+        times[r] = (ns() - start) / N_OPS;
+    }
+    compute_stats(times, RUNS, "query_windowed_4gen", json);
+
+    for (int r = 0; r < RUNS; r++) {
+        uint64_t start = ns();
+        for (int i = 0; i < N_OPS; i++) {
+            const char* k = big_keys[(i * 7) & (BIG_NKEYS - 1)];
+            BloomDBDigest d = bloomdb_hash(5, k, strlen(k));
+            bool found = false;
+            for (int g = GENS - 1; g >= 0 && !found; g--) found = bloomdb_might_contain_digest(gens[g], &d);
+            hits += found;
+        }
+        times[r] = (ns() - start) / N_OPS;
+    }
+    compute_stats(times, RUNS, "query_4_separate_filters", json);
+
+    for (int r = 0; r < RUNS; r++) {
+        uint64_t start = ns();
+        for (int i = 0; i < N_OPS; i++) {
+            const char* k = big_keys[(i * 7) & (BIG_NKEYS - 1)];
+            hits += bloomdb_windowed_test_and_insert(wf, k, strlen(k));
+        }
+        times[r] = (ns() - start) / N_OPS;
+    }
+    compute_stats(times, RUNS, "test_and_insert_windowed_4gen", json);
+
+    // Rotación: un AND por máscara sobre los 128 MiB, con cada ISA
+    for (int isa = BLOOMDB_ISA_SCALAR; isa <= bloomdb_cpu_isa(); isa++) {
+        bloomdb_set_isa((BloomDBIsa)isa);
+        uint64_t best = UINT64_MAX;
+        for (int r = 0; r < 10; r++) {
+            uint64_t start = ns();
+            bloomdb_windowed_rotate(wf);
+            uint64_t t = ns() - start;
+            if (t < best) best = t;
+        }
+        printf("rotate_windowed_128MiB (%s): %.2f ms, %.1f GB/s\n", bloomdb_isa_name((BloomDBIsa)isa),
+               best / 1e6, (double)wf->byte_count / best);
+    }
+    bloomdb_set_isa(bloomdb_cpu_isa());
+    printf("(hits %lu)\n", (unsigned long)(hits & 1));
+
+    bloomdb_windowed_free(wf);
+    for (int g = 0; g < GENS; g++) bloomdb_free(gens[g]);
+}
+
+static uint64_t range_rng = 0x9e3779b97f4a7c15ULL;
+
+static uint64_t range_rand(void) {
+    range_rng ^= range_rng << 13;
+    range_rng ^= range_rng >> 7;
+    range_rng ^= range_rng << 17;
+    return range_rng;
+}
+
+static int range_cmp(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+static bool range_truth(const uint64_t* sorted, size_t n, uint64_t lo, uint64_t hi) {
+    size_t a = 0, b = n;
+    while (a < b) {
+        size_t mid = a + (b - a) / 2;
+        if (sorted[mid] < lo) a = mid + 1;
+        else b = mid;
+    }
+    return a < n && sorted[a] <= hi;
+}
+
+// Rangos vacíos de ancho width que empiezan en una clave al azar + gap:
+// FPR y ns por consulta
+static void range_probe(const BloomDBRange* rf, const uint64_t* sorted, size_t n,
+                        uint64_t width, uint64_t gap, const char* label) {
+    enum { QUERIES = 200000 };
+    uint64_t* lo = malloc(QUERIES * sizeof(uint64_t));
+    int empty = 0;
+    while (empty < QUERIES) {
+        uint64_t x = sorted[range_rand() % n] + 1 + range_rand() % gap;
+        if (x + width - 1 < x || range_truth(sorted, n, x, x + width - 1)) continue;
+        lo[empty++] = x;
+    }
+    int fp = 0;
+    uint64_t start = ns();
+    for (int i = 0; i < QUERIES; i++) fp += bloomdb_range_might_contain_range(rf, lo[i], lo[i] + width - 1);
+    printf("  %-10s ancho %-6lu FPR %7.3f%%  %6.1f ns/consulta\n", label, (unsigned long)width,
+           100.0 * fp / QUERIES, (double)(ns() - start) / QUERIES);
+    free(lo);
+}
+
+// 2^19 claves al azar o en grupos densos; rangos vacíos de varios anchos
+// con distintos niveles y bits por entrada
+void bench_range(FILE* json) {
+    (void)json;
+    const size_t n = 1 << 19;
+    uint64_t* keys = malloc(n * sizeof(uint64_t));
+    const struct { int levels; int bits_per_entry; int k; } configs[] = {
+        { 16, 8, 6 }, { 16, 12, 8 }, { 24, 12, 8 },
+    };
+
+    for (int dataset = 0; dataset < 2; dataset++) {
+        // Agrupadas: 512 grupos de 1024 claves con huecos de 1 a 64
+        for (size_t i = 0; i < n; i++) {
+            if (dataset == 0) keys[i] = range_rand();
+            else keys[i] = (i % 1024 == 0) ? range_rand() >> 4 : keys[i - 1] + 1 + range_rand() % 64;
+        }
+        const char* name = dataset ? "agrupadas" : "aleatorias";
+
+        for (size_t c = 0; c < sizeof(configs) / sizeof(configs[0]); c++) {
+            size_t bits = n * (size_t)configs[c].levels * (size_t)configs[c].bits_per_entry;
+            BloomDBRange* rf = bloomdb_range_create(bits, configs[c].k, configs[c].levels, 9);
+            uint64_t start = ns();
+            for (size_t i = 0; i < n; i++) bloomdb_range_insert(rf, keys[i]);
+            double insert_ns = (double)(ns() - start) / n;
+            qsort(keys, n, sizeof(uint64_t), range_cmp);
+
+            printf("\nrange %s: L=%d, %d bits/entrada, k=%d -> %.0f bits/clave, insert %.1f ns\n", name,
+                   configs[c].levels, configs[c].bits_per_entry, configs[c].k, (double)bits / n, insert_ns);
+            // Aleatorias: rangos lejos de las claves; agrupadas: dentro de
+            // los grupos (huecos de hasta 64)
+            uint64_t gap = dataset ? 64 : UINT64_MAX / 2;
+            const uint64_t widths[] = { 1, 16, 1024, 65536 };
+            for (int w = 0; w < 4; w++) {
+                if (dataset == 1 && widths[w] > 16) break;
+                range_probe(rf, keys, n, widths[w], gap, name);
+            }
+            bloomdb_range_free(rf);
+        }
+    }
+
+    // Referencia: BloomDB puntual (12 bits/clave) recorriendo el rango
+    BloomDB* db = bloomdb_create(n * 12, 8, 9);
+    for (size_t i = 0; i < n; i++) bloomdb_insert_u64(db, keys[i]);
+    const uint64_t widths[] = { 16, 1024 };
+    for (int w = 0; w < 2; w++) {
+        uint64_t start = ns(), hits = 0;
+        for (int q = 0; q < 20000; q++) {
+            uint64_t lo = range_rand();
+            for (uint64_t x = lo; x < lo + widths[w]; x++) {
+                if (bloomdb_might_contain_u64(db, x)) { hits++; break; }
+            }
+        }
+        printf("\npuntual recorriendo ancho %-5lu %8.1f ns/consulta (FPR %.3f%%)\n", (unsigned long)widths[w],
+               (double)(ns() - start) / 20000, hits / 200.0);
+    }
+    bloomdb_free(db);
+    free(keys);
+}
+
+void bench_split(FILE* json) {
+    // Mismo tamaño que bench_blocked: compara contra query_128MiB_blocked
+    big_keys_init();
+    uint64_t times[RUNS];
+    uint64_t hits = 0;
+
+    BloomDBSplit* sf = bloomdb_split_create(BIG_FILTER_BITS, 5);
+
+    for (int r = 0; r < RUNS; r++) {
+        uint64_t start = ns();
+        for (int i = 0; i < N_OPS; i++) {
+            const char* k = big_keys[(i * 2) & (BIG_NKEYS - 1)];
+            bloomdb_split_insert(sf, k, strlen(k));
+        }
+        uint64_t end = ns();
+        times[r] = (end - start) / N_OPS;
+    }
+    compute_stats(times, RUNS, "insert_128MiB_split", json);
+
+    for (int r = 0; r < RUNS; r++) {
+        uint64_t start = ns();
+        for (int i = 0; i < N_OPS; i++) {
+            const char* k = big_keys[(i * 7) & (BIG_NKEYS - 1)];
+            hits += bloomdb_split_might_contain(sf, k, strlen(k));
+        }
+        uint64_t end = ns();
+        times[r] = (end - start) / N_OPS;
+    }
+    compute_stats(times, RUNS, "query_128MiB_split", json);
+    printf("(hits %lu)\n", (unsigned long)(hits & 1));
+
+    bloomdb_split_free(sf);
+}
+
+void bench_counting(FILE* json) {
+    // Mismo tamaño en contadores que bench_blocked en bits (512 MiB de
+    // contadores): insert/remove/query y la conversión a BloomDB
+    big_keys_init();
+    uint64_t times[RUNS];
+    uint64_t hits = 0;
+
+    BloomDBCounting* cf = bloomdb_counting_create(BIG_FILTER_BITS, 7, 5);
+
+    for (int r = 0; r < RUNS; r++) {
+        uint64_t start = ns();
+        for (int i = 0; i < N_OPS; i++) {
+            const char* k = big_keys[(i * 2) & (BIG_NKEYS - 1)];
+            bloomdb_counting_insert(cf, k, strlen(k));
+        }
+        uint64_t mid = ns();
+        for (int i = 0; i < N_OPS; i++) {
+            const char* k = big_keys[(i * 2) & (BIG_NKEYS - 1)];
+            bloomdb_counting_remove(cf, k, strlen(k));
+        }
+        uint64_t end = ns();
+        times[r] = (mid - start) / N_OPS;
+        hits += (end - mid) / N_OPS;
+    }
+    compute_stats(times, RUNS, "insert_counting", json);
+
+    for (int i = 0; i < BIG_NKEYS; i += 2) bloomdb_counting_insert(cf, big_keys[i], strlen(big_keys[i]));
+    for (int r = 0; r < RUNS; r++) {
+        uint64_t start = ns();
+        for (int i = 0; i < N_OPS; i++) {
+            const char* k = big_keys[(i * 7) & (BIG_NKEYS - 1)];
+            hits += bloomdb_counting_might_contain(cf, k, strlen(k));
+        }
+        uint64_t end = ns();
+        times[r] = (end - start) / N_OPS;
+    }
+    compute_stats(times, RUNS, "query_counting", json);
+
+    for (int r = 0; r < 5; r++) {
+        uint64_t start = ns();
+        BloomDB* db = bloomdb_counting_to_bloomdb(cf);
+        times[r] = (ns() - start) / 1000;   // µs por conversión
+        hits += db->bitarray[0];
+        bloomdb_free(db);
+    }
+    compute_stats(times, 5, "counting_to_bloomdb_us", json);
+    printf("(hits %lu)\n", (unsigned long)(hits & 1));
+
+    bloomdb_counting_free(cf);
+}
+
+void bench_scalable(FILE* json) {
+    // 1M claves en una cadena que empieza con capacidad para 1000 (11
+    // slices) frente a un BloomDB dimensionado de antemano para el mismo FPR
+    enum { NKEYS = 1 << 20, SC_RUNS = 5 };
+    uint64_t times_chain[SC_RUNS], times_fixed[SC_RUNS], times_q[SC_RUNS];
+    uint64_t hits = 0;
+    char buf[32];
+
+    for (int r = 0; r < SC_RUNS; r++) {
+        BloomDBScalable* sf = bloomdb_scalable_create(1000, 0.01, 3);
+        BloomDB* db = bloomdb_create((size_t)(NKEYS * 9.6), 7, 3);
+
+        uint64_t start = ns();
+        for (int i = 0; i < NKEYS; i++) {
+            int len = snprintf(buf, sizeof(buf), "sc-%d", i);
+            bloomdb_scalable_insert(sf, buf, (size_t)len);
+        }
+        uint64_t mid = ns();
+        for (int i = 0; i < NKEYS; i++) {
+            int len = snprintf(buf, sizeof(buf), "sc-%d", i);
+            bloomdb_insert(db, buf, (size_t)len);
+        }
+        uint64_t end = ns();
+        // Consultas ausentes: recorren todas las slices
+        for (int i = 0; i < NKEYS; i++) {
+            int len = snprintf(buf, sizeof(buf), "miss-%d", i);
+            hits += bloomdb_scalable_might_contain(sf, buf, (size_t)len);
+        }
+        uint64_t qend = ns();
+
+        times_chain[r] = (mid - start) / NKEYS;
+        times_fixed[r] = (end - mid) / NKEYS;
+        times_q[r] = (qend - end) / NKEYS;
+        if (r == 0) {
+            printf("   slices: %zu, FPR medido %.3f%% (cota %.3f%%)\n", sf->slice_count,
+                   100.0 * (double)hits / NKEYS, 100.0 * bloomdb_scalable_fpr_bound(sf));
+        }
+        bloomdb_scalable_free(sf);
+        bloomdb_free(db);
+    }
+    compute_stats(times_chain, SC_RUNS, "insert_scalable_1M", json);
+    compute_stats(times_fixed, SC_RUNS, "insert_presized_1M", json);
+    compute_stats(times_q, SC_RUNS, "query_miss_scalable_1M", json);
+}
+
+void bench_batch(FILE* json) {
+    // Consultas por lotes sobre un filtro mayor que la LLC; batch=1 es la
+    // línea base (un fallo de caché detrás de otro)
+    big_keys_init();
+    static const size_t sizes[] = { 1, 4, 8, 16, 32, 64, 256 };
+    enum { NSIZES = sizeof(sizes) / sizeof(sizes[0]) };
+    uint64_t times[RUNS];
+    uint64_t hits = 0;
+
+    static const void* keys[BIG_NKEYS];
+    static size_t lens[BIG_NKEYS];
+    for (int i = 0; i < BIG_NKEYS; i++) {
+        const char* k = big_keys[(i * 7) & (BIG_NKEYS - 1)];
+        keys[i] = k;
+        lens[i] = strlen(k);
+    }
+    uint8_t bitmap[256 / 8];
+
+    BloomDB* db = bloomdb_create(BIG_FILTER_BITS, 7, 5);
+    for (int i = 0; i < BIG_NKEYS; i += 2) {
+        bloomdb_insert(db, big_keys[i], strlen(big_keys[i]));
+    }
+
+    for (int s = 0; s < NSIZES; s++) {
+        size_t b = sizes[s];
+        for (int r = 0; r < RUNS; r++) {
+            uint64_t start = ns();
+            for (size_t i = 0; i + b <= N_OPS; i += b) {
+                size_t off = i & (BIG_NKEYS - 1);
+                if (off + b > BIG_NKEYS) off = 0;
+                bloomdb_might_contain_batch(db, keys + off, lens + off, b, bitmap);
+                hits += bitmap[0];
+            }
+            uint64_t end = ns();
+            times[r] = (end - start) / N_OPS;
+        }
+        char name[64];
+        snprintf(name, sizeof(name), "query_128MiB_batch_%zu", b);
+        compute_stats(times, RUNS, name, json);
+    }
+
+    // Inserción por lotes frente a clave a clave
+    for (int r = 0; r < RUNS; r++) {
+        uint64_t start = ns();
+        for (int i = 0; i < N_OPS; i++) {
+            size_t off = i & (BIG_NKEYS - 1);
+            bloomdb_insert(db, keys[off], lens[off]);
+        }
+        uint64_t end = ns();
+        times[r] = (end - start) / N_OPS;
+    }
+    compute_stats(times, RUNS, "insert_128MiB_single", json);
+
+    for (int r = 0; r < RUNS; r++) {
+        uint64_t start = ns();
+        for (int i = 0; i + 64 <= N_OPS; i += 64) {
+            bloomdb_insert_batch(db, keys + (i & (BIG_NKEYS - 1)), lens + (i & (BIG_NKEYS - 1)), 64);
+        }
+        uint64_t end = ns();
+        times[r] = (end - start) / N_OPS;
+    }
+    compute_stats(times, RUNS, "insert_128MiB_batch_64", json);
+    printf("(hits %lu)\n", (unsigned long)(hits & 1));
+
+    bloomdb_free(db);
+}
+
+void bench_u64_keys(FILE* json) {
+    // IDs u64: bytes genéricos frente al kernel entero y el lote
+    enum { NVALS = 4096, BATCH = 64 };
+    static uint64_t vals[NVALS];
+    uint64_t times[RUNS];
+    uint64_t hits = 0;
+    uint8_t bitmap[BATCH / 8];
+
+    for (int i = 0; i < NVALS; i++) vals[i] = (uint64_t)i * 0x9e3779b97f4a7c15ULL;
+
+    BloomDB* db = bloomdb_create(1 << 20, 7, 9);
+    for (int i = 0; i < NVALS; i += 2) bloomdb_insert_u64(db, vals[i]);
+
+    for (int r = 0; r < RUNS; r++) {
+        uint64_t start = ns();
+        for (int i = 0; i < N_OPS; i++) {
+            const uint64_t* v = &vals[i & (NVALS - 1)];
+            hits += bloomdb_might_contain(db, v, sizeof(*v));
+        }
+        uint64_t end = ns();
+        times[r] = (end - start) / N_OPS;
+    }
+    compute_stats(times, RUNS, "query_u64_bytes", json);
+
+    for (int r = 0; r < RUNS; r++) {
+        uint64_t start = ns();
+        for (int i = 0; i < N_OPS; i++) {
+            hits += bloomdb_might_contain_u64(db, vals[i & (NVALS - 1)]);
+        }
+        uint64_t end = ns();
+        times[r] = (end - start) / N_OPS;
+    }
+    compute_stats(times, RUNS, "query_u64_kernel", json);
+
+    for (int r = 0; r < RUNS; r++) {
+        uint64_t start = ns();
+        for (int i = 0; i + BATCH <= N_OPS; i += BATCH) {
+            bloomdb_might_contain_u64_batch(db, &vals[i & (NVALS - 1)], BATCH, bitmap);
+            hits += bitmap[0];
+        }
+        uint64_t end = ns();
+        times[r] = (end - start) / N_OPS;
+    }
+    compute_stats(times, RUNS, "query_u64_batch_64", json);
+    printf("(hits %lu)\n", (unsigned long)(hits & 1));
+
+    bloomdb_free(db);
+}
+
+void bench_probe_kernels(FILE* json) {
+    // Consultas en caché (la mitad presentes) para varios k: mide el coste
+    // de las sondas, no de la memoria. Cada filtro se dimensiona con los
+    // bits/clave óptimos para su k (ocupación ~50%), donde las ramas de
+    // salida temprana son impredecibles.
+    enum { NVALS = 4096 };
+    static const int ks[] = { 3, 7, 12, 16 };
+    static uint64_t vals[NVALS];
+    uint64_t times[RUNS];
+    uint64_t hits = 0;
+
+    for (int i = 0; i < NVALS; i++) vals[i] = (uint64_t)i * 0x9e3779b97f4a7c15ULL;
+
+    for (size_t t = 0; t < sizeof(ks) / sizeof(ks[0]); t++) {
+        BloomDB* db = bloomdb_create((size_t)(NVALS / 2 * ks[t] * 1.4427), ks[t], 3);
+        for (int i = 0; i < NVALS; i += 2) bloomdb_insert_u64(db, vals[i]);
+
+        for (int r = 0; r < RUNS; r++) {
+            uint64_t start = ns();
+            for (int i = 0; i < N_OPS; i++) {
+                hits += bloomdb_might_contain_u64(db, vals[(i * 7) & (NVALS - 1)]);
+            }
+            uint64_t end = ns();
+            times[r] = (end - start) / N_OPS;
+        }
+        char name[64];
+        snprintf(name, sizeof(name), "query_in_cache_k%d", ks[t]);
+        compute_stats(times, RUNS, name, json);
+        bloomdb_free(db);
+    }
+    printf("(hits %lu)\n", (unsigned long)(hits & 1));
+}
+
+void bench_dispatch(FILE* json) {
+    // Cada kernel con cada ISA soportada (ns por operación de 1 MiB / 1 clave)
+    enum { BUF = 1 << 20, NVALS = 4096, REPS = 64 };
+    uint8_t* a = malloc(BUF);
+    uint8_t* b = malloc(BUF);
+    static uint64_t vals[NVALS];
+    static hash128_t out[NVALS];
+    uint64_t times[RUNS];
+    uint64_t sink = 0;
+    char name[64];
+
+    for (size_t i = 0; i < BUF; i++) { a[i] = (uint8_t)(i * 131); b[i] = (uint8_t)(i * 7); }
+    for (int i = 0; i < NVALS; i++) vals[i] = (uint64_t)i * 0x9e3779b97f4a7c15ULL;
+
+    BloomDBIsa best = bloomdb_cpu_isa();
+    for (int isa = BLOOMDB_ISA_SCALAR; isa <= (int)best; isa++) {
+        bloomdb_set_isa((BloomDBIsa)isa);
+        const char* isa_name = bloomdb_isa_name((BloomDBIsa)isa);
+
+        for (int r = 0; r < RUNS; r++) {
+            uint64_t start = ns();
+            for (int i = 0; i < REPS; i++) sink += bitarray_popcount(a, BUF);
+            times[r] = (ns() - start) / REPS;
+        }
+        snprintf(name, sizeof(name), "popcount_1MiB_%s", isa_name);
+        compute_stats(times, RUNS, name, json);
+
+        for (int r = 0; r < RUNS; r++) {
+            uint64_t start = ns();
+            for (int i = 0; i < REPS; i++) bitarray_or(a, b, BUF);
+            times[r] = (ns() - start) / REPS;
+        }
+        snprintf(name, sizeof(name), "merge_1MiB_%s", isa_name);
+        compute_stats(times, RUNS, name, json);
+
+        for (int r = 0; r < RUNS; r++) {
+            uint64_t start = ns();
+            for (int i = 0; i < REPS; i++) hash128_fixed(vals, sizeof(uint64_t), NVALS, 1, out);
+            times[r] = (ns() - start) / ((uint64_t)REPS * NVALS);
+            sink += out[0].h1;
+        }
+        snprintf(name, sizeof(name), "hash_fixed8_%s", isa_name);
+        compute_stats(times, RUNS, name, json);
+    }
+    bloomdb_set_isa(best);
+    printf("(sink %lu)\n", (unsigned long)(sink & 1));
+
+    free(a);
+    free(b);
+}
+
+void bench_fanout(FILE* json) {
+    // Una clave consultada contra 32 filtros con la misma seed
+    enum { FILTERS = 32, NKEYS = 1024, FAN_OPS = N_OPS / FILTERS };
+    BloomDB* parts[FILTERS];
+    static char keys[NKEYS][64];
+    uint64_t times_key[RUNS], times_digest[RUNS];
+    uint64_t hits = 0;
+
+    for (int f = 0; f < FILTERS; f++) parts[f] = bloomdb_create(1 << 20, 7, 777);
+    for (int i = 0; i < NKEYS; i++) {
+        snprintf(keys[i], sizeof(keys[i]), "https://example.com/users/%d/profile?tab=%d", i * 7919, i);
+        bloomdb_insert(parts[i % FILTERS], keys[i], strlen(keys[i]));
+    }
+
+    for (int r = 0; r < RUNS; r++) {
+        uint64_t start = ns();
+        for (int i = 0; i < FAN_OPS; i++) {
+            const char* k = keys[i & (NKEYS - 1)];
+            size_t len = strlen(k);
+            for (int f = 0; f < FILTERS; f++) hits += bloomdb_might_contain(parts[f], k, len);
+        }
+        uint64_t mid = ns();
+        for (int i = 0; i < FAN_OPS; i++) {
+            const char* k = keys[i & (NKEYS - 1)];
+            BloomDBDigest d = bloomdb_hash(777, k, strlen(k));
+            for (int f = 0; f < FILTERS; f++) hits += bloomdb_might_contain_digest(parts[f], &d);
+        }
+        uint64_t end = ns();
+        times_key[r] = (mid - start) / FAN_OPS;
+        times_digest[r] = (end - mid) / FAN_OPS;
+    }
+
+    compute_stats(times_key, RUNS, "fanout32_might_contain", json);
+    compute_stats(times_digest, RUNS, "fanout32_digest", json);
+    printf("(hits %lu)\n", (unsigned long)(hits & 1));
+
+    for (int f = 0; f < FILTERS; f++) bloomdb_free(parts[f]);
+}
+
+// Hilos de bench_concurrent: cada uno en su core (el main está fijado al 0)
+typedef struct {
+    BloomDB* db;
+    pthread_mutex_t* lock;   // NULL = modo concurrente sin locks
+    int id;
+    int cpu;
+    int query;
+    uint64_t hits;
+} ConcWorker;
+
+#define CONC_OPS_PER_THREAD 500000
+
+static void* conc_worker(void* arg) {
+    ConcWorker* w = (ConcWorker*)arg;
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(w->cpu, &set);
+    sched_setaffinity(0, sizeof(set), &set);
+#endif
+    uint64_t base = (uint64_t)w->id << 40;
+    for (int i = 0; i < CONC_OPS_PER_THREAD; i++) {
+        uint64_t v = (base + (uint64_t)i) * 0x9e3779b97f4a7c15ULL;
+        if (w->lock) pthread_mutex_lock(w->lock);
+        if (w->query) w->hits += bloomdb_might_contain_u64(w->db, v);
+        else bloomdb_insert_u64(w->db, v);
+        if (w->lock) pthread_mutex_unlock(w->lock);
+    }
+    return NULL;
+}
+
+void bench_concurrent(FILE* json) {
+    // Escalado 1..N hilos sobre un filtro compartido de 16 MiB (fuera de
+    // caché): mutex alrededor del filtro frente al modo concurrente.
+    // ns por operación agregados (tiempo total / operaciones de todos).
+    enum { CONC_RUNS = 10, MAX_THREADS = 64 };
+    long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+    if (ncpu < 1) ncpu = 1;
+    int max_threads = ncpu < 4 ? 4 : (ncpu > MAX_THREADS ? MAX_THREADS : (int)ncpu);
+    uint64_t times[CONC_RUNS];
+    uint64_t hits = 0;
+    char name[64];
+    pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+
+    BloomDB* db = bloomdb_create((size_t)1 << 27, 7, 9);
+    bloomdb_set_concurrent(db, true);
+
+    static const char* modes[] = { "insert_mutex", "insert_lockfree", "query_mutex", "query_lockfree" };
+    for (int threads = 1; threads <= max_threads; threads *= 2) {
+        for (int m = 0; m < 4; m++) {
+            for (int r = 0; r < CONC_RUNS; r++) {
+                pthread_t tid[MAX_THREADS];
+                ConcWorker w[MAX_THREADS];
+                uint64_t start = ns();
+                for (int t = 0; t < threads; t++) {
+                    w[t] = (ConcWorker){ db, (m & 1) ? NULL : &lock, t, (int)(t % ncpu), m >= 2, 0 };
+                    pthread_create(&tid[t], NULL, conc_worker, &w[t]);
+                }
+                for (int t = 0; t < threads; t++) {
+                    pthread_join(tid[t], NULL);
+                    hits += w[t].hits;
+                }
+                times[r] = (ns() - start) / ((uint64_t)threads * CONC_OPS_PER_THREAD);
+            }
+            snprintf(name, sizeof(name), "%s_%dthreads", modes[m], threads);
+            compute_stats(times, CONC_RUNS, name, json);
+        }
+    }
+    printf("(hits %lu)\n", (unsigned long)(hits & 1));
+    bloomdb_free(db);
+}
+
+// Memoria residente del proceso (Linux), en MiB: anónima (privada) y de
+// archivos mapeados (page cache compartido)
+static void resident_mib(double* anon, double* file) {
+    char line[128];
+    long kb;
+    *anon = *file = 0;
+    FILE* f = fopen("/proc/self/status", "r");
+    if (!f) return;
+    while (fgets(line, sizeof(line), f)) {
+        if (sscanf(line, "RssAnon: %ld", &kb) == 1) *anon = kb / 1024.0;
+        if (sscanf(line, "RssFile: %ld", &kb) == 1) *file = kb / 1024.0;
+    }
+    fclose(f);
+}
+
+// Abrir un filtro guardado de 128 MiB: load_ex (calloc + fread) frente a
+// open_mmap. Tiempo de apertura, RSS añadida y 1M consultas justo después.
+// El archivo acaba de escribirse, así que está en el page cache.
+void bench_open(FILE* json) {
+    (void)json;
+    const char* path = "bench_open.bloom";
+    big_keys_init();
+    BloomDB* src = bloomdb_create(BIG_FILTER_BITS, 7, 5);
+    for (int i = 0; i < BIG_NKEYS; i++) bloomdb_insert(src, big_keys[i], strlen(big_keys[i]));
+    bloomdb_save(src, path);
+    bloomdb_free(src);
+
+    const struct { const char* name; int flags; } modes[] = {
+        { "load_ex", -1 },
+        { "open_mmap", BLOOMDB_MMAP_READ_ONLY },
+        { "open_mmap_random", BLOOMDB_MMAP_RANDOM },
+        { "open_mmap_populate", BLOOMDB_MMAP_POPULATE },
+        { "open_mmap_verify", BLOOMDB_MMAP_VERIFY },
+    };
+    printf("\n");
+    for (size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); m++) {
+        double anon0, file0, anon1, file1, anon2, file2;
+        resident_mib(&anon0, &file0);
+        uint64_t start = ns();
+        BloomDB* db = modes[m].flags < 0 ? bloomdb_load(path) : bloomdb_open_mmap(path, modes[m].flags);
+        uint64_t open_ns = ns() - start;
+        resident_mib(&anon1, &file1);
+
+        uint64_t hits = 0;
+        start = ns();
+        for (int i = 0; i < N_OPS; i++) {
+            const char* k = big_keys[(i * 7) & (BIG_NKEYS - 1)];
+            hits += bloomdb_might_contain(db, k, strlen(k));
+        }
+        uint64_t query_ns = ns() - start;
+        resident_mib(&anon2, &file2);
+        printf("%-19s abrir %8.3f ms  privada +%5.1f MiB  1M consultas %6.1f ms  "
+               "tras consultas: privada +%5.1f MiB, page cache +%5.1f MiB (%lu)\n",
+               modes[m].name, open_ns / 1e6, anon1 - anon0, query_ns / 1e6, anon2 - anon0, file2 - file0,
+               (unsigned long)(hits & 1));
+        bloomdb_free(db);
+    }
+
+    // CRC32C de todos los chunks sobre el mapeo: un hilo frente a uno por CPU
+    BloomDB* db = bloomdb_open_mmap(path, BLOOMDB_MMAP_POPULATE);
+    for (int threads = 1; threads >= 0; threads--) {
+        uint64_t start = ns();
+        BloomDBError err = bloomdb_verify_ex(db, threads);
+        printf("verify %-12s %8.3f ms  (%zu chunks, %s)\n", threads ? "1 hilo" : "todos",
+               (ns() - start) / 1e6, bloomdb_chunk_count(db), bloomdb_strerror(err));
+    }
+    bloomdb_free(db);
+    unlink(path);
+}
+
+void bench_log(FILE* json) {
+    // Coste de durabilidad por inserción: insert_u64 solo frente a la misma
+    // inserción por el log con group commit de distintos tamaños (ns por
+    // clave, fdatasync incluido). La última fila hace fsync en cada clave.
+    enum { LOG_RUNS = 5, NKEYS = 1 << 20, NKEYS_EACH = 2000 };
+    const char* path = "bench_log.bloomlog";
+    uint64_t times[LOG_RUNS];
+    char name[64];
+
+    for (int r = 0; r < LOG_RUNS; r++) {
+        BloomDB* db = bloomdb_create((size_t)1 << 24, 7, 3);
+        uint64_t start = ns();
+        for (int i = 0; i < NKEYS; i++) bloomdb_insert_u64(db, (uint64_t)i * 2654435761u);
+        times[r] = (ns() - start) / NKEYS;
+        bloomdb_free(db);
+    }
+    compute_stats(times, LOG_RUNS, "log_none_insert_u64", json);
+
+    const size_t groups[] = { 0, 4096, 64 * 1024, 1024 * 1024 };
+    for (size_t g = 0; g < sizeof(groups) / sizeof(groups[0]); g++) {
+        const int n = groups[g] ? NKEYS : NKEYS_EACH;
+        for (int r = 0; r < LOG_RUNS; r++) {
+            unlink(path);
+            BloomDB* db = bloomdb_create((size_t)1 << 24, 7, 3);
+            BloomDBLogOptions opts = { groups[g], 0 };
+            BloomDBLog* log = bloomdb_log_open(db, path, &opts);
+            uint64_t start = ns();
+            for (int i = 0; i < n; i++) bloomdb_log_insert_u64(log, (uint64_t)i * 2654435761u);
+            bloomdb_log_sync(log);
+            times[r] = (ns() - start) / (uint64_t)n;
+            bloomdb_log_close(log);
+            bloomdb_free(db);
+        }
+        snprintf(name, sizeof(name), "log_group_%zuK_insert_u64", groups[g] / 1024);
+        compute_stats(times, LOG_RUNS, groups[g] ? name : "log_fsync_each_insert_u64", json);
+    }
+    unlink(path);
+}
+
+static void snapshot_done(BloomDBError status, const char* path, void* user) {
+    (void)status;
+    (void)path;
+    __atomic_store_n((int*)user, 1, __ATOMIC_RELEASE);
+}
+
+void bench_snapshot(FILE* json) {
+    // Filtro de 128 MiB: cuánto bloquea bloomdb_save al llamador frente a
+    // bloomdb_snapshot_async, y cuántas inserciones caben mientras el hilo
+    // del snapshot escribe
+    (void)json;
+    const char* path = "bench_snapshot.bloom";
+    BloomDB* db = bloomdb_create(BIG_FILTER_BITS, 7, 5);
+    for (uint64_t i = 0; i < 1000000; i++) bloomdb_insert_u64(db, i);
+
+    uint64_t start = ns();
+    bloomdb_save(db, path);
+    uint64_t save_ns = ns() - start;
+
+    int done = 0;
+    bloomdb_set_concurrent(db, true);   // lo exige snapshot_async
+    start = ns();
+    BloomDBSnapshot* snap = bloomdb_snapshot_async(db, path, snapshot_done, &done);
+    uint64_t call_ns = ns() - start;
+    uint64_t inserted = 0;
+    // Inserciones en lotes de 4096 hasta que el callback avisa
+    while (!__atomic_load_n(&done, __ATOMIC_ACQUIRE)) {
+        for (int i = 0; i < 4096; i++) bloomdb_insert_u64(db, 1000000 + inserted++);
+    }
+    bloomdb_snapshot_wait(snap);
+    uint64_t total_ns = ns() - start;
+
+    printf("\nsave (bloqueante)       %8.1f ms\n", save_ns / 1e6);
+    printf("snapshot_async: llamada %8.3f ms, snapshot %6.1f ms, %lu inserciones durante\n",
+           call_ns / 1e6, total_ns / 1e6, (unsigned long)inserted);
+    bloomdb_free(db);
+    unlink(path);
+}
+
+// bloomdb_save + fsync: la misma durabilidad que save_incremental (fdatasync)
+static void save_synced(const BloomDB* db, const char* path) {
+    bloomdb_save(db, path);
+    int fd = open(path, O_RDONLY);
+    fsync(fd);
+    close(fd);
+}
+
+void bench_incremental(FILE* json) {
+    // Checkpoint de un filtro de 128 MiB tras pocas inserciones: save entero
+    // frente a save_incremental (solo páginas sucias), y lo que cuesta
+    // marcar las páginas en cada inserción (ns por clave)
+    enum { INC_RUNS = 5, NKEYS = 1 << 20 };
+    const char* path = "bench_incremental.bloom";
+    const char* full = "bench_incremental_full.bloom";
+    uint64_t times[INC_RUNS];
+
+    for (int tracked = 0; tracked <= 1; tracked++) {
+        for (int r = 0; r < INC_RUNS; r++) {
+            BloomDB* db = bloomdb_create((size_t)1 << 24, 7, 3);
+            bloomdb_track_dirty(db, tracked);
+            uint64_t start = ns();
+            for (int i = 0; i < NKEYS; i++) bloomdb_insert_u64(db, (uint64_t)i * 2654435761u);
+            times[r] = (ns() - start) / NKEYS;
+            bloomdb_free(db);
+        }
+        compute_stats(times, INC_RUNS, tracked ? "insert_u64_dirty_tracking" : "insert_u64_untracked", json);
+    }
+
+    BloomDB* db = bloomdb_create(BIG_FILTER_BITS, 7, 5);
+    for (uint64_t i = 0; i < 1000000; i++) bloomdb_insert_u64(db, i);
+    save_synced(db, path);
+    bloomdb_track_dirty(db, true);
+
+    const uint64_t changes[] = { 100, 1000, 10000 };
+    uint64_t next = 1000000;
+    printf("\n");
+    for (size_t c = 0; c < sizeof(changes) / sizeof(changes[0]); c++) {
+        for (uint64_t i = 0; i < changes[c]; i++) bloomdb_insert_u64(db, next++);
+        const size_t pages = bloomdb_dirty_pages(db);
+
+        uint64_t start = ns();
+        save_synced(db, full);
+        uint64_t full_ns = ns() - start;
+        start = ns();
+        bloomdb_save_incremental(db, path, NULL);
+        uint64_t inc_ns = ns() - start;
+
+        printf("%6lu inserciones: %6zu páginas (%7.2f MiB)  save+fsync %8.1f ms  save_incremental %7.2f ms\n",
+               (unsigned long)changes[c], pages, pages * (double)BLOOMDB_DIRTY_PAGE_SIZE / (1 << 20),
+               full_ns / 1e6, inc_ns / 1e6);
+    }
+    bloomdb_free(db);
+    unlink(path);
+    unlink(full);
+}
+
+// Tiempo de bloomdb_load de path en ms
+static double load_ms(const char* path) {
+    uint64_t start = ns();
+    BloomDB* db = bloomdb_load(path);
+    double ms = (ns() - start) / 1e6;
+    bloomdb_free(db);
+    return ms;
+}
+
+static double mib(const char* path) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return 0;
+    fseeko(f, 0, SEEK_END);
+    double size = ftello(f) / (double)(1 << 20);
+    fclose(f);
+    return size;
+}
+
+void bench_encoding(FILE* json) {
+    // Filtro de 128 MiB con distintas ocupaciones: tamaño del snapshot y
+    // tiempo de save/load sin codificar frente a BLOOMDB_ENCODING_AUTO
+    (void)json;
+    const char* raw_path = "bench_encoding_raw.bloom";
+    const char* enc_path = "bench_encoding_auto.bloom";
+    const uint64_t keys[] = { 0, 10000, 100000, 1000000, 5000000 };
+    BloomDB* db = bloomdb_create(BIG_FILTER_BITS, 7, 5);
+    uint64_t inserted = 0;
+
+    printf("\n%9s %7s | %10s %9s %9s | %10s %9s %9s\n", "claves", "ocup.", "RAW MiB", "save ms", "load ms",
+           "AUTO MiB", "save ms", "load ms");
+    for (size_t k = 0; k < sizeof(keys) / sizeof(keys[0]); k++) {
+        for (; inserted < keys[k]; inserted++) bloomdb_insert_u64(db, inserted);
+        const double fill = 100.0 * bloomdb_count_set_bits(db) / db->bit_count;
+
+        uint64_t start = ns();
+        bloomdb_save_encoded(db, raw_path, BLOOMDB_ENCODING_RAW);
+        const double raw_save = (ns() - start) / 1e6;
+        start = ns();
+        bloomdb_save_encoded(db, enc_path, BLOOMDB_ENCODING_AUTO);
+        const double enc_save = (ns() - start) / 1e6;
+
+        printf("%9lu %6.2f%% | %10.2f %9.1f %9.1f | %10.2f %9.1f %9.1f\n", (unsigned long)keys[k], fill,
+               mib(raw_path), raw_save, load_ms(raw_path), mib(enc_path), enc_save, load_ms(enc_path));
+    }
+    bloomdb_free(db);
+    unlink(raw_path);
+    unlink(enc_path);
+}
+
+void bench_parallel_build(FILE* json) {
+    // Build de 2M claves en un filtro de 16 MiB: bucle de bloomdb_insert
+    // frente a bloomdb_build_parallel con 1..N hilos (ns por clave)
+    enum { NKEYS = 1 << 21, BUILD_RUNS = 5 };
+    long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+    int max_threads = ncpu < 4 ? 4 : (int)ncpu;
+    char (*buf)[24] = malloc(sizeof(*buf) * NKEYS);
+    const void** keys = malloc(sizeof(*keys) * NKEYS);
+    size_t* lens = malloc(sizeof(*lens) * NKEYS);
+    uint64_t times[BUILD_RUNS];
+    char name[64];
+
+    for (int i = 0; i < NKEYS; i++) {
+        snprintf(buf[i], sizeof(buf[i]), "build-%d", i * 2654435761u);
+        keys[i] = buf[i];
+        lens[i] = strlen(buf[i]);
+    }
+
+    for (int r = 0; r < BUILD_RUNS; r++) {
+        BloomDB* db = bloomdb_create((size_t)1 << 27, 7, 3);
+        uint64_t start = ns();
+        for (int i = 0; i < NKEYS; i++) bloomdb_insert(db, keys[i], lens[i]);
+        times[r] = (ns() - start) / NKEYS;
+        bloomdb_free(db);
+    }
+    compute_stats(times, BUILD_RUNS, "build_serial_insert", json);
+
+    // main fija el proceso al core 0 y los hilos de build_parallel heredan
+    // la máscara: se abre a todos los cores para medir el escalado real
+#ifdef __linux__
+    cpu_set_t pinned, all;
+    sched_getaffinity(0, sizeof(pinned), &pinned);
+    CPU_ZERO(&all);
+    for (long c = 0; c < ncpu && c < CPU_SETSIZE; c++) CPU_SET(c, &all);
+    sched_setaffinity(0, sizeof(all), &all);
+#endif
+    for (int threads = 1; threads <= max_threads; threads *= 2) {
+        for (int r = 0; r < BUILD_RUNS; r++) {
+            BloomDB* db = bloomdb_create((size_t)1 << 27, 7, 3);
+            uint64_t start = ns();
+            bloomdb_build_parallel(db, keys, lens, NKEYS, threads);
+            times[r] = (ns() - start) / NKEYS;
+            bloomdb_free(db);
+        }
+        snprintf(name, sizeof(name), "build_parallel_%dthreads", threads);
+        compute_stats(times, BUILD_RUNS, name, json);
+    }
+#ifdef __linux__
+    sched_setaffinity(0, sizeof(pinned), &pinned);
+#endif
+
+    free(buf);
+    free(keys);
+    free(lens);
+}
+
 int main() {
     pin_cpu(); // fijar a un solo core para estabilidad
 
@@ -160,7 +1514,29 @@ int main() {
 
     bench_bitarray(json);
     bench_hash64(json);
+    bench_dispatch(json);
     bench_bloom_insert(json);
+    bench_index_modes(json);
+    bench_u64_keys(json);
+    bench_probe_kernels(json);
+    bench_fanout(json);
+    bench_blocked(json);
+    bench_partitioned(json);
+    bench_split(json);
+    bench_counting(json);
+    bench_scalable(json);
+    bench_fuse(json);
+    bench_cuckoo(json);
+    bench_windowed(json);
+    bench_range(json);
+    bench_batch(json);
+    bench_concurrent(json);
+    bench_parallel_build(json);
+    bench_open(json);
+    bench_log(json);
+    bench_snapshot(json);
+    bench_incremental(json);
+    bench_encoding(json);
 
     if (json) {
         // Remove trailing comma from last entry
@@ -0,0 +1,109 @@
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <unistd.h>
+
+#include "bloom_blocked.h"
+#include "storage.h"
+
+static int popcount_block(const uint64_t* b) {
+    int c = 0;
+    for (int w = 0; w < BLOOMDB_BLOCK_WORDS; w++) c += __builtin_popcountll(b[w]);
+    return c;
+}
+
+int main(void) {
+    printf("== test_blocked ==\n");
+
+    // Test 1: argumentos inválidos
+    BloomDBBlocked* bf = NULL;
+    assert(bloomdb_blocked_create_ex(0, 4, 1, &bf) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_blocked_create_ex(4096, 0, 1, &bf) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_blocked_create_ex(4096, BLOOMDB_BLOCKED_MAX_HASHES + 1, 1, &bf) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_blocked_create_ex(4096, 4, 1, NULL) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bf == NULL);
+
+    // Test 2: tamaño redondeado a bloques de 512 bits y alineado a 64 bytes
+    bf = bloomdb_blocked_create(1000, 7, 42);
+    assert(bf != NULL);
+    assert(bf->block_count == 2);
+    assert(bf->bit_count == 1024);
+    assert(((uintptr_t)bf->blocks & 63) == 0);
+
+    bloomdb_blocked_free(bf);
+
+    // Test 3: todos los bits de una clave caen en un único bloque
+
+    bf = bloomdb_blocked_create(512 * 64, 7, 42);
+    assert(bf != NULL);
+    assert(bloomdb_blocked_insert(bf, "single-key", strlen("single-key")));
+    int blocks_touched = 0;
+    for (size_t b = 0; b < bf->block_count; b++) {
+        int c = popcount_block(bf->blocks + b * BLOOMDB_BLOCK_WORDS);
+        if (c) {
+            blocks_touched++;
+            assert(c <= 7);
+        }
+    }
+    assert(blocks_touched == 1);
+    bloomdb_blocked_free(bf);
+
+    // Test 4: sin falsos negativos y FPR razonable (10 bits/clave, k=7: ~1%)
+    const int n = 20000;
+    bf = bloomdb_blocked_create((size_t)n * 10, 7, 1234);
+    assert(bf != NULL);
+    char buf[48];
+    for (int i = 0; i < n; i++) {
+        snprintf(buf, sizeof(buf), "user-%d@example.com", i);
+        assert(bloomdb_blocked_insert(bf, buf, strlen(buf)));
+    }
+    for (int i = 0; i < n; i++) {
+        snprintf(buf, sizeof(buf), "user-%d@example.com", i);
+        assert(bloomdb_blocked_might_contain(bf, buf, strlen(buf)));
+    }
+    int fp = 0;
+    for (int i = 0; i < n; i++) {
+        snprintf(buf, sizeof(buf), "other-%d@example.org", i);
+        fp += bloomdb_blocked_might_contain(bf, buf, strlen(buf));
+    }
+    printf("   FPR (10 bits/clave, k=7) = %.3f%%\n", 100.0 * fp / n);
+    assert(fp < n / 50);   // < 2%
+
+    // Test 5: argumentos inválidos en insert/might_contain
+    bool result;
+    assert(bloomdb_blocked_insert_ex(NULL, "k", 1) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_blocked_insert_ex(bf, NULL, 1) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_blocked_insert_ex(bf, "k", 0) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_blocked_might_contain_ex(bf, "k", 1, NULL) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_blocked_might_contain_ex(NULL, "k", 1, &result) == BLOOMDB_ERR_INVALID_ARGUMENT);
+
+    // Test 6: save/load
+    const char* path = "test_blocked.bloom";
+    assert(bloomdb_blocked_save(bf, path));
+    BloomDBBlocked* loaded = NULL;
+    assert(bloomdb_blocked_load_ex(path, &loaded) == BLOOMDB_OK);
+    assert(loaded->block_count == bf->block_count);
+    assert(loaded->num_hashes == bf->num_hashes);
+    assert(loaded->seed == bf->seed);
+    assert(memcmp(loaded->blocks, bf->blocks, bf->block_count * 64) == 0);
+    for (int i = 0; i < n; i += 97) {
+        snprintf(buf, sizeof(buf), "user-%d@example.com", i);
+        assert(bloomdb_blocked_might_contain(loaded, buf, strlen(buf)));
+    }
+
+    // Test 7: un archivo BloomDB no es un filtro bloqueado
+    BloomDB* plain = bloomdb_create(1000, 3, 1);
+    assert(bloomdb_save(plain, path));
+    BloomDBBlocked* wrong = NULL;
+    assert(bloomdb_blocked_load_ex(path, &wrong) == BLOOMDB_ERR_FORMAT);
+    assert(wrong == NULL);
+    assert(bloomdb_blocked_load_ex("nonexistent.bloom", &wrong) == BLOOMDB_ERR_FILE_IO);
+
+    bloomdb_free(plain);
+    bloomdb_blocked_free(bf);
+    bloomdb_blocked_free(loaded);
+    unlink(path);
+
+    printf("✓ test_blocked: OK\n");
+    return 0;
+}
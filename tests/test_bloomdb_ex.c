@@ -3,6 +3,7 @@
 #include <assert.h>
 
 #include "bloomdb.h"
+#include "hash64.h"
 
 int main(void) {
     printf("== test_bloomdb_ex ==\n");
@@ -36,6 +37,7 @@ int main(void) {
     assert(db->bit_count == 10000);
     assert(db->num_hashes == 5);
     assert(db->seed == 42);
+    assert(db->index_mode == BLOOMDB_INDEX_FASTRANGE);   // 10000 no es potencia de 2
 
     // Test 3: bloomdb_insert_ex con argumentos inválidos
     err = bloomdb_insert_ex(NULL, "key", 3);
@@ -83,6 +85,167 @@ int main(void) {
     assert(strcmp(bloomdb_strerror(BLOOMDB_ERR_ALLOC), "Memory allocation failed") == 0);
     assert(strcmp(bloomdb_strerror(BLOOMDB_ERR_FILE_IO), "File I/O error") == 0);
     assert(strcmp(bloomdb_strerror(BLOOMDB_ERR_FORMAT), "Invalid file format") == 0);
+    assert(strcmp(bloomdb_strerror(BLOOMDB_ERR_FULL), "Filter is full") == 0);
+
+    // Test 8: Digest API (hashear una vez, consultar varios filtros)
+    BloomDB* parts[4];
+    for (int i = 0; i < 4; i++) {
+        parts[i] = bloomdb_create(8192, 6, 42);
+        assert(parts[i] != NULL);
+    }
+    const char* url = "https://example.com/partition/key";
+    BloomDBDigest d = bloomdb_hash(42, url, strlen(url));
+    assert(d.seed == 42);
+
+    assert(bloomdb_insert_digest(parts[2], &d));
+    for (int i = 0; i < 4; i++) {
+        err = bloomdb_might_contain_digest_ex(parts[i], &d, &result);
+        assert(err == BLOOMDB_OK);
+        // El digest debe responder igual que la clave original
+        assert(result == bloomdb_might_contain(parts[i], url, strlen(url)));
+    }
+    assert(bloomdb_might_contain_digest(parts[2], &d) == true);
+
+    // Insertar por clave y consultar por digest
+    assert(bloomdb_insert(parts[0], url, strlen(url)));
+    assert(bloomdb_might_contain_digest(parts[0], &d) == true);
+
+    // Argumentos inválidos
+    err = bloomdb_insert_digest_ex(NULL, &d);
+    assert(err == BLOOMDB_ERR_INVALID_ARGUMENT);
+    err = bloomdb_insert_digest_ex(parts[0], NULL);
+    assert(err == BLOOMDB_ERR_INVALID_ARGUMENT);
+    err = bloomdb_might_contain_digest_ex(parts[0], &d, NULL);
+    assert(err == BLOOMDB_ERR_INVALID_ARGUMENT);
+
+    // Seed distinta => rechazado (evita falsos negativos silenciosos)
+    BloomDBDigest other = bloomdb_hash(7, url, strlen(url));
+    err = bloomdb_might_contain_digest_ex(parts[2], &other, &result);
+    assert(err == BLOOMDB_ERR_INVALID_ARGUMENT);
+    err = bloomdb_insert_digest_ex(parts[2], &other);
+    assert(err == BLOOMDB_ERR_INVALID_ARGUMENT);
+
+    // Filtro con hash legacy => rechazado
+    parts[3]->hash_algo = BLOOMDB_HASH_LEGACY;
+    err = bloomdb_might_contain_digest_ex(parts[3], &d, &result);
+    assert(err == BLOOMDB_ERR_INVALID_ARGUMENT);
+
+    for (int i = 0; i < 4; i++) bloomdb_free(parts[i]);
+
+    // Test 9: Modos de índice (sin división) y el módulo original
+    BloomDB* pow2 = NULL;
+    err = bloomdb_create_ex(1 << 16, 5, 42, &pow2);
+    assert(err == BLOOMDB_OK);
+    assert(pow2->index_mode == BLOOMDB_INDEX_MASK);
+
+    BloomDB* by_mode[3];
+    by_mode[0] = bloomdb_create(12345, 5, 3);   // FASTRANGE
+    by_mode[1] = pow2;                          // MASK
+    by_mode[2] = bloomdb_create(12345, 5, 3);
+    by_mode[2]->index_mode = BLOOMDB_INDEX_MODULO;
+    for (int m = 0; m < 3; m++) {
+        char buf[32];
+        for (int i = 0; i < 300; i++) {
+            snprintf(buf, sizeof(buf), "mode-key-%d", i);
+            assert(bloomdb_insert_cstr(by_mode[m], buf));
+        }
+        for (int i = 0; i < 300; i++) {
+            snprintf(buf, sizeof(buf), "mode-key-%d", i);
+            assert(bloomdb_might_contain_cstr(by_mode[m], buf));
+        }
+        bloomdb_free(by_mode[m]);
+    }
+
+    // Test 10: Batch API (mismos bits y respuestas que clave a clave)
+    enum { BATCH_N = 1000 };
+    static char batch_buf[BATCH_N][32];
+    const void* batch_keys[BATCH_N];
+    size_t batch_lens[BATCH_N];
+    for (int i = 0; i < BATCH_N; i++) {
+        snprintf(batch_buf[i], sizeof(batch_buf[i]), "batch-key-%d", i);
+        batch_keys[i] = batch_buf[i];
+        batch_lens[i] = strlen(batch_buf[i]);
+    }
+
+    BloomDB* one_by_one = bloomdb_create(50000, 6, 11);
+    BloomDB* batched = bloomdb_create(50000, 6, 11);
+    for (int i = 0; i < BATCH_N; i += 2) {
+        assert(bloomdb_insert(one_by_one, batch_keys[i], batch_lens[i]));
+    }
+    // Solo las claves pares, en un lote de tamaño no múltiplo del grupo
+    const void* even_keys[BATCH_N / 2];
+    size_t even_lens[BATCH_N / 2];
+    for (int i = 0; i < BATCH_N / 2; i++) {
+        even_keys[i] = batch_keys[2 * i];
+        even_lens[i] = batch_lens[2 * i];
+    }
+    assert(bloomdb_insert_batch_ex(batched, even_keys, even_lens, BATCH_N / 2) == BLOOMDB_OK);
+    assert(memcmp(one_by_one->bitarray, batched->bitarray, batched->byte_count) == 0);
+
+    uint8_t bitmap[(BATCH_N + 7) / 8];
+    assert(bloomdb_might_contain_batch_ex(batched, batch_keys, batch_lens, BATCH_N, bitmap) == BLOOMDB_OK);
+    for (int i = 0; i < BATCH_N; i++) {
+        bool expected = bloomdb_might_contain(batched, batch_keys[i], batch_lens[i]);
+        assert(((bitmap[i >> 3] >> (i & 7)) & 1) == expected);
+        if (i % 2 == 0) assert(expected);
+    }
+
+    // Lote vacío, argumentos inválidos y clave inválida en medio del lote
+    assert(bloomdb_insert_batch_ex(batched, NULL, NULL, 0) == BLOOMDB_OK);
+    assert(bloomdb_might_contain_batch_ex(batched, NULL, NULL, 0, NULL) == BLOOMDB_OK);
+    assert(bloomdb_insert_batch_ex(NULL, batch_keys, batch_lens, 1) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_insert_batch_ex(batched, NULL, batch_lens, 1) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_might_contain_batch_ex(batched, batch_keys, batch_lens, 1, NULL) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    batch_lens[500] = 0;
+    memcpy(one_by_one->bitarray, batched->bitarray, batched->byte_count);
+    assert(bloomdb_insert_batch_ex(batched, batch_keys, batch_lens, BATCH_N) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(memcmp(one_by_one->bitarray, batched->bitarray, batched->byte_count) == 0);
+    assert(!bloomdb_might_contain_batch(batched, batch_keys, batch_lens, BATCH_N, bitmap));
+
+    bloomdb_free(one_by_one);
+    bloomdb_free(batched);
+
+    // Test 11: kernels especializados por k == fórmula h1 + i*h2 de referencia
+    for (int k = 1; k <= 20; k++) {
+        for (int mode = 0; mode < 3; mode++) {
+            size_t bits = mode == BLOOMDB_INDEX_MASK ? 4096 : 4099;
+            BloomDB* kdb = bloomdb_create(bits, k, 77);
+            assert(kdb->probe_insert != NULL && kdb->probe_query != NULL);
+            kdb->index_mode = mode;
+
+            uint8_t ref[(4099 + 7) / 8] = { 0 };
+            char buf[32];
+            for (int i = 0; i < 40; i++) {
+                snprintf(buf, sizeof(buf), "k-key-%d", i);
+                assert(bloomdb_insert_cstr(kdb, buf));
+                hash128_t h = hash128(buf, strlen(buf), 77);
+                for (int p = 0; p < k; p++) {
+                    uint64_t x = h.h1 + (uint64_t)p * h.h2;
+                    size_t bit = mode == BLOOMDB_INDEX_MASK ? (size_t)(x & (bits - 1))
+                               : mode == BLOOMDB_INDEX_FASTRANGE ? (size_t)(((unsigned __int128)x * bits) >> 64)
+                               : (size_t)(x % bits);
+                    ref[bit >> 3] |= (uint8_t)(1 << (bit & 7));
+                }
+            }
+            assert(memcmp(ref, kdb->bitarray, kdb->byte_count) == 0);
+
+            // Consulta: coincide con la referencia también para ausentes
+            for (int i = 0; i < 200; i++) {
+                snprintf(buf, sizeof(buf), "k-key-%d", i);
+                hash128_t h = hash128(buf, strlen(buf), 77);
+                bool expected = true;
+                for (int p = 0; p < k; p++) {
+                    uint64_t x = h.h1 + (uint64_t)p * h.h2;
+                    size_t bit = mode == BLOOMDB_INDEX_MASK ? (size_t)(x & (bits - 1))
+                               : mode == BLOOMDB_INDEX_FASTRANGE ? (size_t)(((unsigned __int128)x * bits) >> 64)
+                               : (size_t)(x % bits);
+                    expected = expected && (ref[bit >> 3] >> (bit & 7)) & 1;
+                }
+                assert(bloomdb_might_contain_cstr(kdb, buf) == expected);
+            }
+            bloomdb_free(kdb);
+        }
+    }
 
     bloomdb_free(db);
 
@@ -0,0 +1,130 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <pthread.h>
+
+#include "bloomdb.h"
+
+#define THREADS 8
+#define KEYS_PER_THREAD 20000
+
+typedef struct {
+    BloomDB* db;
+    int id;
+    int use_batch;
+    int misses;   // claves del rango ya publicado que no se encontraron
+} Worker;
+
+static uint64_t key_of(int thread, int i) {
+    return ((uint64_t)thread << 32) | (uint64_t)i;
+}
+
+/**
+ * Cada hilo inserta su rango de claves y, entre inserciones, vuelve a
+ * consultar las que él mismo ya insertó (happens-before por orden de
+ * programa) y las de la fase previa del hilo vecino.
+ */
+static void* worker_main(void* arg) {
+    Worker* w = (Worker*)arg;
+    uint64_t batch[64];
+    for (int i = 0; i < KEYS_PER_THREAD; i++) {
+        if (w->use_batch && i % 64 == 0 && i + 64 <= KEYS_PER_THREAD) {
+            for (int j = 0; j < 64; j++) batch[j] = key_of(w->id, i + j);
+            assert(bloomdb_insert_u64_batch(w->db, batch, 64));
+            i += 63;
+        } else {
+            assert(bloomdb_insert_u64(w->db, key_of(w->id, i)));
+        }
+        if (i % 7 == 0 && !bloomdb_might_contain_u64(w->db, key_of(w->id, i / 2))) w->misses++;
+        if (!bloomdb_might_contain_u64(w->db, key_of(THREADS + (w->id + 1) % THREADS, i))) w->misses++;
+    }
+    return NULL;
+}
+
+static void run_stress(int num_hashes, size_t bits, int use_batch) {
+    BloomDB* db = bloomdb_create(bits, num_hashes, 77);
+    BloomDB* serial = bloomdb_create(bits, num_hashes, 77);
+    assert(db && serial);
+    assert(bloomdb_set_concurrent(db, true));
+
+    // Fase previa: claves "publicadas" antes de arrancar los hilos
+    for (int t = 0; t < THREADS; t++) {
+        for (int i = 0; i < KEYS_PER_THREAD; i++) {
+            assert(bloomdb_insert_u64(db, key_of(THREADS + t, i)));
+            assert(bloomdb_insert_u64(serial, key_of(THREADS + t, i)));
+        }
+    }
+
+    pthread_t tid[THREADS];
+    Worker w[THREADS];
+    for (int t = 0; t < THREADS; t++) {
+        w[t] = (Worker){ db, t, use_batch, 0 };
+        assert(pthread_create(&tid[t], NULL, worker_main, &w[t]) == 0);
+    }
+    for (int t = 0; t < THREADS; t++) {
+        assert(pthread_join(tid[t], NULL) == 0);
+        assert(w[t].misses == 0);
+    }
+
+    // Tras el join: ninguna inserción perdida y los mismos bits que en serie
+    for (int t = 0; t < THREADS; t++) {
+        for (int i = 0; i < KEYS_PER_THREAD; i++) {
+            assert(bloomdb_insert_u64(serial, key_of(t, i)));
+            assert(bloomdb_might_contain_u64(db, key_of(t, i)));
+        }
+    }
+    assert(memcmp(db->bitarray, serial->bitarray, db->byte_count) == 0);
+
+    bloomdb_free(db);
+    bloomdb_free(serial);
+}
+
+int main(void) {
+    printf("== test_concurrent ==\n");
+
+    // Test 1: argumentos y cambio de modo
+    assert(bloomdb_set_concurrent_ex(NULL, true) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    BloomDB* db = bloomdb_create(1000, 5, 1);
+    assert(db->concurrent == 0);
+    assert(bloomdb_insert(db, "before", 6));
+    assert(bloomdb_set_concurrent_ex(db, true) == BLOOMDB_OK);
+    assert(db->concurrent == 1);
+    assert(bloomdb_might_contain(db, "before", 6));
+    assert(bloomdb_insert(db, "during", 6));
+    assert(bloomdb_set_concurrent_ex(db, false) == BLOOMDB_OK);
+    assert(bloomdb_might_contain(db, "during", 6));
+    bloomdb_free(db);
+
+    // Test 2: el modo concurrente pone exactamente los mismos bits (k
+    // especializado, k genérico y tamaño no múltiplo de 64)
+    const int ks[] = { 1, 7, 16, 20 };
+    for (int c = 0; c < 4; c++) {
+        BloomDB* a = bloomdb_create(12345, ks[c], 3);
+        BloomDB* b = bloomdb_create(12345, ks[c], 3);
+        assert(bloomdb_set_concurrent(b, true));
+        char buf[32];
+        for (int i = 0; i < 1000; i++) {
+            snprintf(buf, sizeof(buf), "key-%d", i);
+            assert(bloomdb_insert(a, buf, strlen(buf)));
+            assert(bloomdb_insert(b, buf, strlen(buf)));
+        }
+        assert(memcmp(a->bitarray, b->bitarray, a->byte_count) == 0);
+        for (int i = 0; i < 2000; i++) {
+            snprintf(buf, sizeof(buf), "key-%d", i);
+            assert(bloomdb_might_contain(a, buf, strlen(buf)) == bloomdb_might_contain(b, buf, strlen(buf)));
+        }
+        bloomdb_free(a);
+        bloomdb_free(b);
+    }
+
+    // Test 3: estrés con 8 hilos, filtro pequeño (muchas colisiones de
+    // palabra) y grande; inserción una a una y por lotes
+    run_stress(7, 1 << 16, 0);
+    run_stress(7, 1 << 16, 1);
+    run_stress(3, 4000037, 0);
+    run_stress(24, 1000003, 1);
+
+    printf("✓ test_concurrent: OK\n");
+    return 0;
+}
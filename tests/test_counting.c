@@ -0,0 +1,166 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <unistd.h>
+
+#include "bloom_counting.h"
+#include "bloomdb.h"
+#include "storage.h"
+
+static unsigned counter_at(const BloomDBCounting* cf, size_t i) {
+    return (unsigned)(cf->words[i / 16] >> ((i % 16) * 4)) & 0xF;
+}
+
+static size_t sum_counters(const BloomDBCounting* cf) {
+    size_t s = 0;
+    for (size_t i = 0; i < cf->counter_count; i++) s += counter_at(cf, i);
+    return s;
+}
+
+int main(void) {
+    printf("== test_counting ==\n");
+
+    // Test 1: argumentos inválidos
+    BloomDBCounting* cf = NULL;
+    assert(bloomdb_counting_create_ex(0, 4, 1, &cf) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_counting_create_ex(1000, 0, 1, &cf) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_counting_create_ex(1000, 4, 1, NULL) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(cf == NULL);
+
+    // Test 2: 16 contadores por palabra; modo de índice como en BloomDB
+    cf = bloomdb_counting_create(1000, 5, 42);
+    assert(cf != NULL);
+    assert(cf->word_count == 63);
+    assert(cf->index_mode == BLOOMDB_INDEX_FASTRANGE);
+    bloomdb_counting_free(cf);
+    cf = bloomdb_counting_create(1024, 5, 42);
+    assert(cf->index_mode == BLOOMDB_INDEX_MASK);
+    bloomdb_counting_free(cf);
+
+    // Test 3: insertar suma k, borrar resta k y deja todo a cero
+    cf = bloomdb_counting_create(10007, 6, 9);
+    assert(bloomdb_counting_insert(cf, "session-1", 9));
+    assert(sum_counters(cf) == 6);
+    assert(bloomdb_counting_might_contain(cf, "session-1", 9));
+    assert(bloomdb_counting_remove_ex(cf, "session-1", 9) == BLOOMDB_OK);
+    assert(sum_counters(cf) == 0);
+    assert(!bloomdb_counting_might_contain(cf, "session-1", 9));
+
+    // Borrar una clave ausente no toca nada
+    assert(bloomdb_counting_insert(cf, "session-2", 9));
+    assert(bloomdb_counting_remove_ex(cf, "session-1", 9) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(sum_counters(cf) == 6);
+    assert(bloomdb_counting_remove_ex(NULL, "k", 1) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_counting_insert_ex(cf, NULL, 1) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    bool result;
+    assert(bloomdb_counting_might_contain_ex(cf, "k", 0, &result) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    bloomdb_counting_free(cf);
+
+    // Test 4: saturación en 15 (pegajosa: no se decrementa) sin acarreo al
+    // contador vecino
+    cf = bloomdb_counting_create(16, 1, 3);
+    for (int i = 0; i < 40; i++) assert(bloomdb_counting_insert(cf, "hot", 3));
+    size_t hot = 0;
+    for (size_t i = 0; i < 16; i++) {
+        if (counter_at(cf, i)) {
+            hot = i;
+            assert(counter_at(cf, i) == BLOOMDB_COUNTER_MAX);
+        }
+    }
+    assert(sum_counters(cf) == BLOOMDB_COUNTER_MAX);
+    for (int i = 0; i < 40; i++) assert(bloomdb_counting_remove(cf, "hot", 3));
+    assert(counter_at(cf, hot) == BLOOMDB_COUNTER_MAX);
+    bloomdb_counting_free(cf);
+
+    // Test 5: expirar la mitad de las claves; las demás siguen y el FPR de
+    // las borradas baja al nivel de claves nunca vistas
+    const int n = 20000;
+    char buf[48];
+    cf = bloomdb_counting_create((size_t)n * 10, 7, 77);
+    for (int i = 0; i < n; i++) {
+        snprintf(buf, sizeof(buf), "sess-%d", i);
+        assert(bloomdb_counting_insert(cf, buf, strlen(buf)));
+    }
+    for (int i = 0; i < n; i += 2) {
+        snprintf(buf, sizeof(buf), "sess-%d", i);
+        assert(bloomdb_counting_remove(cf, buf, strlen(buf)));
+    }
+    int still = 0;
+    for (int i = 0; i < n; i++) {
+        snprintf(buf, sizeof(buf), "sess-%d", i);
+        bool r = bloomdb_counting_might_contain(cf, buf, strlen(buf));
+        if (i % 2) assert(r);
+        else still += r;
+    }
+    printf("   FPR de claves borradas = %.3f%%\n", 100.0 * still / (n / 2));
+    assert(still < n / 2 / 100);
+
+    // Test 6: to_bloomdb responde igual y coincide con un BloomDB construido
+    // directamente con las claves vivas
+    BloomDB* bits = bloomdb_counting_to_bloomdb(cf);
+    BloomDB* direct = bloomdb_create((size_t)n * 10, 7, 77);
+    assert(bits != NULL && direct != NULL);
+    for (int i = 1; i < n; i += 2) {
+        snprintf(buf, sizeof(buf), "sess-%d", i);
+        assert(bloomdb_insert(direct, buf, strlen(buf)));
+    }
+    for (size_t i = 0; i < cf->counter_count; i++) {
+        bool bit = (bits->bitarray[i >> 3] >> (i & 7)) & 1;
+        assert(bit == (counter_at(cf, i) != 0));
+    }
+    assert(memcmp(bits->bitarray, direct->bitarray, bits->byte_count) == 0);
+    for (int i = 0; i < 2 * n; i++) {
+        snprintf(buf, sizeof(buf), "sess-%d", i);
+        assert(bloomdb_might_contain(bits, buf, strlen(buf)) ==
+               bloomdb_counting_might_contain(cf, buf, strlen(buf)));
+    }
+    bloomdb_free(bits);
+    bloomdb_free(direct);
+
+    // Tamaños que no son múltiplo de 16 contadores ni de 8 bits
+    const size_t odd[] = { 1, 9, 17, 31, 1001 };
+    for (int t = 0; t < 5; t++) {
+        BloomDBCounting* small = bloomdb_counting_create(odd[t], 3, 5);
+        for (int i = 0; i < 10; i++) {
+            snprintf(buf, sizeof(buf), "s-%d", i);
+            bloomdb_counting_insert(small, buf, strlen(buf));
+        }
+        BloomDB* sb = bloomdb_counting_to_bloomdb(small);
+        assert(sb && sb->bit_count == odd[t]);
+        for (size_t i = 0; i < odd[t]; i++) {
+            assert((bool)((sb->bitarray[i >> 3] >> (i & 7)) & 1) == (counter_at(small, i) != 0));
+        }
+        bloomdb_free(sb);
+        bloomdb_counting_free(small);
+    }
+
+    // Test 7: save/load
+    const char* path = "test_counting.bloom";
+    assert(bloomdb_counting_save(cf, path));
+    BloomDBCounting* loaded = NULL;
+    assert(bloomdb_counting_load_ex(path, &loaded) == BLOOMDB_OK);
+    assert(loaded->counter_count == cf->counter_count);
+    assert(loaded->num_hashes == cf->num_hashes);
+    assert(loaded->seed == cf->seed);
+    assert(loaded->index_mode == cf->index_mode);
+    assert(memcmp(loaded->words, cf->words, cf->word_count * sizeof(uint64_t)) == 0);
+    snprintf(buf, sizeof(buf), "sess-%d", 1);
+    assert(bloomdb_counting_remove(loaded, buf, strlen(buf)));
+
+    // Un filtro de bits no es un counting
+    BloomDBCounting* wrong = NULL;
+    BloomDBSplit* sf = bloomdb_split_create(4096, 1);
+    assert(bloomdb_split_save(sf, path));
+    assert(bloomdb_counting_load_ex(path, &wrong) == BLOOMDB_ERR_FORMAT);
+    assert(wrong == NULL);
+    assert(bloomdb_counting_load_ex("nonexistent.bloom", &wrong) == BLOOMDB_ERR_FILE_IO);
+
+    bloomdb_split_free(sf);
+    bloomdb_counting_free(loaded);
+    bloomdb_counting_free(cf);
+    unlink(path);
+
+    printf("✓ test_counting: OK\n");
+    return 0;
+}
@@ -0,0 +1,159 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <unistd.h>
+
+#include "bloom_cuckoo.h"
+#include "storage.h"
+
+static bool contains_i(const BloomDBCuckoo* cf, const char* prefix, int i) {
+    char buf[48];
+    snprintf(buf, sizeof(buf), "%s-%d", prefix, i);
+    return bloomdb_cuckoo_might_contain(cf, buf, strlen(buf));
+}
+
+static BloomDBError insert_i(BloomDBCuckoo* cf, const char* prefix, int i) {
+    char buf[48];
+    snprintf(buf, sizeof(buf), "%s-%d", prefix, i);
+    return bloomdb_cuckoo_insert_ex(cf, buf, strlen(buf));
+}
+
+static BloomDBError remove_i(BloomDBCuckoo* cf, const char* prefix, int i) {
+    char buf[48];
+    snprintf(buf, sizeof(buf), "%s-%d", prefix, i);
+    return bloomdb_cuckoo_remove_ex(cf, buf, strlen(buf));
+}
+
+int main(void) {
+    printf("== test_cuckoo ==\n");
+
+    // Test 1: argumentos inválidos y dimensionado
+    BloomDBCuckoo* cf = NULL;
+    assert(bloomdb_cuckoo_create_ex(0, 1, &cf) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_cuckoo_create_ex(1000, 1, NULL) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(cf == NULL);
+    cf = bloomdb_cuckoo_create(1000, 1);
+    assert(cf->bucket_count == 512);
+    assert(bloomdb_cuckoo_load_factor(cf) == 0.0);
+    bloomdb_cuckoo_free(cf);
+
+    // Test 2: 240000 claves en 2^16 cubetas (92% de ocupación)
+    const int n = 240000;
+    cf = bloomdb_cuckoo_create(n, 7);
+    assert(cf->bucket_count == 65536);
+    for (int i = 0; i < n; i++) assert(insert_i(cf, "user", i) == BLOOMDB_OK);
+    assert(cf->count == (size_t)n);
+    printf("   ocupación = %.3f\n", bloomdb_cuckoo_load_factor(cf));
+    for (int i = 0; i < n; i++) assert(contains_i(cf, "user", i));
+
+    // Test 3: FPR ~ 8 * ocupación / 2^16
+    int fp = 0;
+    const int trials = 2000000;
+    for (int i = 0; i < trials; i++) fp += contains_i(cf, "other", i);
+    double rate = (double)fp / trials;
+    printf("   FPR medido = %.4f%% (teórico ~%.4f%%)\n", 100.0 * rate,
+           100.0 * 8 * bloomdb_cuckoo_load_factor(cf) / 65536);
+    assert(rate > 0.00005 && rate < 0.0002);
+
+    // Test 4: lotes == consultas sueltas (presentes y ausentes mezcladas)
+    const size_t bn = 1003;
+    const void** keys = malloc(bn * sizeof(void*));
+    size_t* lens = malloc(bn * sizeof(size_t));
+    char (*bufs)[48] = malloc(bn * sizeof(*bufs));
+    for (size_t i = 0; i < bn; i++) {
+        snprintf(bufs[i], sizeof(bufs[i]), "%s-%zu", (i % 3) ? "user" : "other", i * 31);
+        keys[i] = bufs[i];
+        lens[i] = strlen(bufs[i]);
+    }
+    uint8_t bitmap[(1003 + 7) / 8];
+    assert(bloomdb_cuckoo_might_contain_batch(cf, keys, lens, bn, bitmap));
+    for (size_t i = 0; i < bn; i++) {
+        bool bit = (bitmap[i >> 3] >> (i & 7)) & 1;
+        assert(bit == bloomdb_cuckoo_might_contain(cf, keys[i], lens[i]));
+    }
+    assert(bloomdb_cuckoo_might_contain_batch_ex(cf, keys, lens, 0, NULL) == BLOOMDB_OK);
+    assert(bloomdb_cuckoo_might_contain_batch_ex(cf, keys, lens, bn, NULL) == BLOOMDB_ERR_INVALID_ARGUMENT);
+
+    // Test 5: borrar la mitad; las demás siguen, las borradas desaparecen
+    // (salvo falsos positivos)
+    for (int i = 0; i < n; i += 2) assert(remove_i(cf, "user", i) == BLOOMDB_OK);
+    assert(cf->count == (size_t)n / 2);
+    int still = 0;
+    for (int i = 0; i < n; i++) {
+        if (i & 1) assert(contains_i(cf, "user", i));
+        else still += contains_i(cf, "user", i);
+    }
+    assert(still < 100);
+    // Una clave ausente no se puede borrar
+    char buf[48];
+    int absent = 0;
+    do snprintf(buf, sizeof(buf), "absent-%d", absent++);
+    while (bloomdb_cuckoo_might_contain(cf, buf, strlen(buf)));
+    assert(bloomdb_cuckoo_remove_ex(cf, buf, strlen(buf)) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(cf->count == (size_t)n / 2);
+
+    // Test 6: una clave insertada dos veces necesita dos borrados
+    assert(bloomdb_cuckoo_insert(cf, "twice", 5));
+    assert(bloomdb_cuckoo_insert(cf, "twice", 5));
+    assert(bloomdb_cuckoo_remove(cf, "twice", 5));
+    assert(bloomdb_cuckoo_might_contain(cf, "twice", 5));
+    assert(bloomdb_cuckoo_remove(cf, "twice", 5));
+    bloomdb_cuckoo_free(cf);
+
+    // Test 7: llenar hasta BLOOMDB_ERR_FULL sin perder claves
+    cf = bloomdb_cuckoo_create(4000, 3);
+    int inserted = 0;
+    BloomDBError err;
+    while ((err = insert_i(cf, "fill", inserted)) == BLOOMDB_OK) inserted++;
+    assert(err == BLOOMDB_ERR_FULL);
+    assert(cf->has_victim);
+    printf("   lleno con %d claves, ocupación = %.3f\n", inserted, bloomdb_cuckoo_load_factor(cf));
+    assert(bloomdb_cuckoo_load_factor(cf) > 0.94);
+    for (int i = 0; i < inserted; i++) assert(contains_i(cf, "fill", i));
+
+    // Test 8: guardar y cargar (con víctima incluida)
+    const char* path = "test_cuckoo.bloom";
+    assert(bloomdb_cuckoo_save(cf, path));
+    BloomDBCuckoo* loaded = NULL;
+    assert(bloomdb_cuckoo_load_ex(path, &loaded) == BLOOMDB_OK);
+    assert(loaded->bucket_count == cf->bucket_count && loaded->count == cf->count);
+    assert(loaded->seed == cf->seed && loaded->rng == cf->rng);
+    assert(loaded->has_victim && loaded->victim_fp == cf->victim_fp && loaded->victim_index == cf->victim_index);
+    assert(memcmp(loaded->buckets, cf->buckets, cf->bucket_count * sizeof(uint64_t)) == 0);
+    for (int i = 0; i < inserted; i++) assert(contains_i(loaded, "fill", i));
+    assert(insert_i(loaded, "fill", inserted) == BLOOMDB_ERR_FULL);
+
+    // Borrar hace sitio: la víctima vuelve a la tabla y se puede insertar
+    for (int i = 0; i < 64; i++) assert(remove_i(cf, "fill", i) == BLOOMDB_OK);
+    assert(!cf->has_victim);
+    assert(insert_i(cf, "fill", inserted) == BLOOMDB_OK);
+    for (int i = 64; i <= inserted; i++) assert(contains_i(cf, "fill", i));
+
+    // Test 9: formato incorrecto y argumentos inválidos
+    BloomDBCuckoo* wrong = NULL;
+    BloomDB* plain = bloomdb_create(1000, 3, 1);
+    assert(bloomdb_save(plain, path));
+    assert(bloomdb_cuckoo_load_ex(path, &wrong) == BLOOMDB_ERR_FORMAT);
+    assert(wrong == NULL);
+    assert(bloomdb_cuckoo_load_ex("nonexistent.bloom", &wrong) == BLOOMDB_ERR_FILE_IO);
+    assert(bloomdb_cuckoo_load("nonexistent.bloom") == NULL);
+    bool result;
+    assert(bloomdb_cuckoo_insert_ex(cf, NULL, 1) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_cuckoo_remove_ex(cf, "k", 0) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_cuckoo_might_contain_ex(cf, "k", 1, NULL) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_cuckoo_might_contain_ex(NULL, "k", 1, &result) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_cuckoo_save_ex(NULL, path) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_cuckoo_load_factor(NULL) == 0.0);
+
+    bloomdb_free(plain);
+    bloomdb_cuckoo_free(cf);
+    bloomdb_cuckoo_free(loaded);
+    free(keys);
+    free(lens);
+    free(bufs);
+    unlink(path);
+
+    printf("✓ test_cuckoo: OK\n");
+    return 0;
+}
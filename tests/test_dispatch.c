@@ -0,0 +1,223 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include "bloomdb.h"
+#include "bitarray.h"
+#include "hash64.h"
+#include "bloom_split.h"
+#include "crc32c.h"
+
+// Generador determinista para los datos de prueba
+static uint64_t rng_state = 0x243f6a8885a308d3ULL;
+
+static uint64_t next_rand(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+static void fill_random(uint8_t* buf, size_t n) {
+    for (size_t i = 0; i < n; i++) buf[i] = (uint8_t)next_rand();
+}
+
+static size_t naive_popcount(const uint8_t* buf, size_t n) {
+    size_t c = 0;
+    for (size_t i = 0; i < n; i++) {
+        for (int b = 0; b < 8; b++) c += (buf[i] >> b) & 1;
+    }
+    return c;
+}
+
+static void check_hash_kernels(void) {
+    // Longitudes variables (0..69), todas las colas y varios bloques
+    enum { NKEYS = 70 };
+    static uint8_t data[NKEYS][80];
+    const void* keys[NKEYS];
+    size_t lens[NKEYS];
+    hash128_t out[NKEYS];
+    for (int i = 0; i < NKEYS; i++) {
+        fill_random(data[i], sizeof(data[i]));
+        keys[i] = data[i];
+        lens[i] = (size_t)i;
+    }
+    for (size_t n = 0; n <= NKEYS; n += 7) {
+        hash128_many(keys, lens, n, 99, out);
+        for (size_t i = 0; i < n; i++) {
+            hash128_t ref = hash128(keys[i], lens[i], 99);
+            assert(out[i].h1 == ref.h1 && out[i].h2 == ref.h2);
+        }
+    }
+
+    // Claves contiguas de ancho fijo, con n que no es múltiplo del vector
+    static uint8_t flat[37 * 16];
+    fill_random(flat, sizeof(flat));
+    const size_t widths[] = { 8, 16, 5 };
+    for (int w = 0; w < 3; w++) {
+        for (size_t n = 0; n <= 37; n++) {
+            hash128_fixed(flat, widths[w], n, 7, out);
+            for (size_t i = 0; i < n; i++) {
+                hash128_t ref = hash128(flat + i * widths[w], widths[w], 7);
+                assert(out[i].h1 == ref.h1 && out[i].h2 == ref.h2);
+            }
+        }
+    }
+}
+
+static void check_popcount_merge(void) {
+    static uint8_t a[4096 + 8], b[4096 + 8], expected[4096 + 8];
+    fill_random(a, sizeof(a));
+    fill_random(b, sizeof(b));
+
+    // Todos los tamaños pequeños y desalineados, y uno grande
+    for (size_t off = 0; off < 8; off++) {
+        for (size_t n = 0; n <= 200; n++) {
+            assert(bitarray_popcount(a + off, n) == naive_popcount(a + off, n));
+        }
+    }
+    assert(bitarray_popcount(a, 4096) == naive_popcount(a, 4096));
+
+    for (size_t off = 0; off < 8; off += 3) {
+        for (size_t n = 0; n <= 300; n += 13) {
+            uint8_t dst[300 + 8];
+            memcpy(dst, a + off, n);
+            for (size_t i = 0; i < n; i++) expected[i] = a[off + i] | b[i];
+            bitarray_or(dst, b, n);
+            assert(memcmp(dst, expected, n) == 0);
+
+            uint8_t mask = b[n];
+            memcpy(dst, a + off, n);
+            for (size_t i = 0; i < n; i++) expected[i] = a[off + i] & mask;
+            bitarray_and_mask(dst, mask, n);
+            assert(memcmp(dst, expected, n) == 0);
+        }
+    }
+}
+
+// CRC32C bit a bit, como referencia
+static uint32_t naive_crc32c(uint32_t crc, const uint8_t* buf, size_t n) {
+    crc = ~crc;
+    for (size_t i = 0; i < n; i++) {
+        crc ^= buf[i];
+        for (int b = 0; b < 8; b++) crc = (crc >> 1) ^ (0x82f63b78u & (0u - (crc & 1)));
+    }
+    return ~crc;
+}
+
+static void check_crc32c(void) {
+    assert(crc32c(0, "123456789", 9) == 0xe3069283u);
+    assert(crc32c(0, "", 0) == 0);
+
+    // Desalineados, colas y tramos de los tres flujos (256 y 8192 bytes)
+    static uint8_t buf[3 * 8192 * 2 + 1000];
+    fill_random(buf, sizeof(buf));
+    for (size_t off = 0; off < 8; off++) {
+        for (size_t n = 0; n <= 800; n += 1 + n / 16) {
+            assert(crc32c(0, buf + off, n) == naive_crc32c(0, buf + off, n));
+        }
+    }
+    const size_t big[] = { 3 * 8192, 3 * 8192 + 5, 3 * 8192 * 2 + 777 };
+    for (int i = 0; i < 3; i++) {
+        uint32_t ref = naive_crc32c(0, buf + 3, big[i]);
+        assert(crc32c(0, buf + 3, big[i]) == ref);
+        // Encadenado por trozos
+        size_t half = big[i] / 2 + 1;
+        assert(crc32c(crc32c(0, buf + 3, half), buf + 3 + half, big[i] - half) == ref);
+    }
+}
+
+static void check_split_kernels(void) {
+    BloomDBSplit* sf = bloomdb_split_create(256 * 32, 5);
+    char buf[32];
+    for (int i = 0; i < 2000; i++) {
+        snprintf(buf, sizeof(buf), "split-%d", i);
+        assert(bloomdb_split_insert(sf, buf, strlen(buf)));
+    }
+
+    // Mismos bits que la variante escalar, que se usa como referencia
+    static uint32_t snapshot[256];
+    static int have_snapshot = 0;
+    if (!have_snapshot) {
+        memcpy(snapshot, sf->blocks, sizeof(snapshot));
+        have_snapshot = 1;
+    } else {
+        assert(memcmp(snapshot, sf->blocks, sizeof(snapshot)) == 0);
+    }
+
+    int positives = 0;
+    for (int i = 0; i < 4000; i++) {
+        snprintf(buf, sizeof(buf), "split-%d", i);
+        bool r = bloomdb_split_might_contain(sf, buf, strlen(buf));
+        if (i < 2000) assert(r);
+        positives += r;
+    }
+    static int ref_positives = -1;
+    if (ref_positives < 0) ref_positives = positives;
+    assert(positives == ref_positives);
+
+    bloomdb_split_free(sf);
+}
+
+static void check_filter_ops(void) {
+    // count/merge y lotes a través de la API pública
+    BloomDB* x = bloomdb_create(100003, 7, 1);
+    BloomDB* y = bloomdb_create(100003, 7, 1);
+    uint64_t vals[500];
+    for (int i = 0; i < 500; i++) vals[i] = next_rand();
+    assert(bloomdb_insert_u64_batch(x, vals, 250));
+    assert(bloomdb_insert_u64_batch(y, vals + 250, 250));
+
+    size_t cx = bloomdb_count_set_bits(x);
+    assert(cx == naive_popcount(x->bitarray, x->byte_count));
+    assert(bloomdb_merge_ex(x, y) == BLOOMDB_OK);
+    assert(bloomdb_count_set_bits(x) >= cx);
+    for (int i = 0; i < 500; i++) assert(bloomdb_might_contain_u64(x, vals[i]));
+
+    BloomDB* other = bloomdb_create(100003, 6, 1);
+    assert(bloomdb_merge_ex(x, other) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_merge_ex(NULL, y) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(!bloomdb_merge(x, NULL));
+
+    bloomdb_free(x);
+    bloomdb_free(y);
+    bloomdb_free(other);
+}
+
+int main(void) {
+    printf("== test_dispatch ==\n");
+
+    // Test 1: al cargar se elige la mejor ISA de la CPU
+    BloomDBIsa best = bloomdb_cpu_isa();
+    assert(bloomdb_get_isa() == best);
+    printf("   CPU: %s\n", bloomdb_isa_name(best));
+    assert(strcmp(bloomdb_isa_name(BLOOMDB_ISA_AVX512), "avx512") == 0);
+    assert(strcmp(bloomdb_isa_name((BloomDBIsa)42), "unknown") == 0);
+
+    // Test 2: ISAs inválidas o no soportadas
+    assert(bloomdb_set_isa((BloomDBIsa)-1) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_set_isa((BloomDBIsa)(BLOOMDB_ISA_AVX512 + 1)) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    if (best < BLOOMDB_ISA_AVX512) {
+        assert(bloomdb_set_isa((BloomDBIsa)(best + 1)) == BLOOMDB_ERR_INVALID_ARGUMENT);
+        assert(bloomdb_get_isa() == best);
+    }
+
+    // Test 3: cada variante soportada da exactamente los mismos resultados
+    for (int isa = BLOOMDB_ISA_SCALAR; isa <= (int)best; isa++) {
+        assert(bloomdb_set_isa((BloomDBIsa)isa) == BLOOMDB_OK);
+        assert(bloomdb_get_isa() == (BloomDBIsa)isa);
+        printf("   %s\n", bloomdb_isa_name((BloomDBIsa)isa));
+
+        check_hash_kernels();
+        check_popcount_merge();
+        check_crc32c();
+        check_split_kernels();
+        check_filter_ops();
+    }
+
+    assert(bloomdb_set_isa(best) == BLOOMDB_OK);
+
+    printf("✓ test_dispatch: OK\n");
+    return 0;
+}
@@ -0,0 +1,152 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "bloomdb.h"
+#include "storage.h"
+
+#define BITS ((size_t)24 << 20)   // 3 MiB: 3 chunks
+
+static const char* PATH = "test_encoding.bloom";
+
+static long file_size(const char* path) {
+    struct stat st;
+    return stat(path, &st) == 0 ? (long)st.st_size : -1;
+}
+
+static void check_same(const BloomDB* a, const BloomDB* b) {
+    assert(a && b);
+    assert(a->bit_count == b->bit_count && a->num_hashes == b->num_hashes && a->seed == b->seed);
+    assert(a->hash_algo == b->hash_algo && a->index_mode == b->index_mode);
+    assert(memcmp(a->bitarray, b->bitarray, a->byte_count) == 0);
+}
+
+// Guarda con encoding, recarga y compara; devuelve el tamaño del archivo
+static long roundtrip(const BloomDB* db, BloomDBEncoding encoding) {
+    assert(bloomdb_save_encoded_ex(db, PATH, encoding) == BLOOMDB_OK);
+    BloomDB* loaded = NULL;
+    assert(bloomdb_load_ex(PATH, &loaded) == BLOOMDB_OK);
+    check_same(db, loaded);
+    bloomdb_free(loaded);
+    return file_size(PATH);
+}
+
+int main(void) {
+    printf("== test_encoding ==\n");
+    unlink(PATH);
+
+    // Test 1: filtro vacío: solo cabecera y registros de chunk
+    BloomDB* db = bloomdb_create(BITS, 7, 42);
+    assert(bloomdb_save(db, PATH));
+    const long raw = file_size(PATH);
+    assert(roundtrip(db, BLOOMDB_ENCODING_RAW) == raw);
+    assert(roundtrip(db, BLOOMDB_ENCODING_SPARSE) == 88 + 3 * 12);
+    assert(roundtrip(db, BLOOMDB_ENCODING_AUTO) == 88 + 3 * 12);
+
+    // Test 2: ~1% de ocupación: mucho más pequeño y las claves siguen
+    for (uint64_t i = 0; i < 30000; i++) assert(bloomdb_insert_u64(db, i));
+    const long sparse = roundtrip(db, BLOOMDB_ENCODING_AUTO);
+    assert(sparse < raw / 4);
+    BloomDB* loaded = bloomdb_load(PATH);
+    for (uint64_t i = 0; i < 30000; i++) assert(bloomdb_might_contain_u64(loaded, i));
+    bloomdb_free(loaded);
+
+    // Un archivo codificado no se mapea ni es base incremental (se
+    // reescribe sin codificar)
+    BloomDB* mapped = NULL;
+    assert(bloomdb_open_mmap_ex(PATH, BLOOMDB_MMAP_READ_ONLY, &mapped) == BLOOMDB_ERR_FORMAT);
+    assert(bloomdb_track_dirty(db, true));
+    assert(bloomdb_insert_u64(db, 999999));
+    assert(bloomdb_save_incremental(db, PATH, NULL));
+    assert(file_size(PATH) == raw);
+    mapped = bloomdb_open_mmap(PATH, BLOOMDB_MMAP_VERIFY);
+    check_same(db, mapped);
+    bloomdb_free(mapped);
+    assert(bloomdb_track_dirty(db, false));
+
+    // Test 3: filtro denso: AUTO guarda sin codificar; SPARSE forzado deja
+    // los chunks en RAW
+    BloomDB* dense = bloomdb_create(BITS, 7, 42);
+    for (uint64_t i = 0; i < 2000000; i++) assert(bloomdb_insert_u64(dense, i));
+    assert(roundtrip(dense, BLOOMDB_ENCODING_AUTO) == raw);
+    assert(roundtrip(dense, BLOOMDB_ENCODING_SPARSE) == 88 + 3 * 12 + (long)dense->byte_count);
+    bloomdb_free(dense);
+
+    // Un chunk muy ocupado y los demás vacíos: cada chunk elige el suyo
+    BloomDB* mixed = bloomdb_create(BITS, 7, 42);
+    memset(mixed->bitarray + (1 << 20), 0x5a, 1 << 20);
+    assert(roundtrip(mixed, BLOOMDB_ENCODING_SPARSE) == 88 + 3 * 12 + (1 << 20));
+    bloomdb_free(mixed);
+
+    // Test 4: tamaños raros, legacy y módulo, último chunk parcial
+    BloomDB* odd = bloomdb_create(8 * (1 << 20) + 12345, 3, 7);
+    odd->hash_algo = BLOOMDB_HASH_LEGACY;
+    odd->index_mode = BLOOMDB_INDEX_MODULO;
+    for (int i = 0; i < 500; i++) {
+        char key[16];
+        snprintf(key, sizeof(key), "k%d", i);
+        assert(bloomdb_insert_cstr(odd, key));
+    }
+    odd->bitarray[odd->byte_count - 1] |= 0x80;   // último bit del filtro
+    roundtrip(odd, BLOOMDB_ENCODING_SPARSE);
+    bloomdb_free(odd);
+
+    // Test 5: en memoria (formato de envío), los mismos bytes que el archivo
+    size_t len = 0;
+    uint8_t* buf = bloomdb_serialize(db, BLOOMDB_ENCODING_AUTO, &len);
+    assert(buf && (long)len < raw / 4);
+    assert(bloomdb_save_encoded(db, PATH, BLOOMDB_ENCODING_AUTO) && file_size(PATH) == (long)len);
+    loaded = bloomdb_deserialize(buf, len);
+    check_same(db, loaded);
+    bloomdb_free(loaded);
+    uint8_t* raw_buf = bloomdb_serialize(db, BLOOMDB_ENCODING_RAW, &len);
+    assert(raw_buf && (long)len == raw);
+    loaded = bloomdb_deserialize(raw_buf, len);
+    check_same(db, loaded);
+    bloomdb_free(loaded);
+    free(raw_buf);
+
+    // Test 6: datos dañados o cortados
+    size_t sparse_len = 0;
+    free(buf);
+    buf = bloomdb_serialize(db, BLOOMDB_ENCODING_SPARSE, &sparse_len);
+    assert(buf);
+    BloomDB* out = NULL;
+    buf[88 + 12 + 1000] ^= 0x01;   // un varint del primer chunk
+    BloomDBError err = bloomdb_deserialize_ex(buf, sparse_len, &out);
+    assert(err == BLOOMDB_ERR_CHECKSUM || err == BLOOMDB_ERR_FORMAT);
+    buf[88 + 12 + 1000] ^= 0x01;
+    buf[88 + 8] ^= 0x01;           // CRC del primer chunk
+    assert(bloomdb_deserialize_ex(buf, sparse_len, &out) == BLOOMDB_ERR_CHECKSUM);
+    buf[88 + 8] ^= 0x01;
+    buf[88] = 7;                   // codificación desconocida
+    assert(bloomdb_deserialize_ex(buf, sparse_len, &out) == BLOOMDB_ERR_FORMAT);
+    buf[88] = 1;
+    assert(bloomdb_deserialize_ex(buf, sparse_len - 1, &out) == BLOOMDB_ERR_FORMAT);
+    assert(bloomdb_deserialize_ex(buf, 50, &out) == BLOOMDB_ERR_FORMAT);
+    buf[44] = 2;                   // flag desconocido (la cabecera lleva CRC)
+    assert(bloomdb_deserialize_ex(buf, sparse_len, &out) == BLOOMDB_ERR_CHECKSUM);
+    buf[44] = 1;
+    assert(bloomdb_deserialize_ex(buf, sparse_len, &out) == BLOOMDB_OK);
+    check_same(db, out);
+    bloomdb_free(out);
+    free(buf);
+
+    // Test 7: argumentos inválidos
+    assert(bloomdb_save_encoded_ex(NULL, PATH, BLOOMDB_ENCODING_AUTO) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_save_encoded_ex(db, NULL, BLOOMDB_ENCODING_AUTO) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_save_encoded_ex(db, PATH, (BloomDBEncoding)9) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_save_encoded_ex(db, "no-such-dir/x.bloom", BLOOMDB_ENCODING_AUTO) == BLOOMDB_ERR_FILE_IO);
+    assert(bloomdb_serialize_ex(db, BLOOMDB_ENCODING_AUTO, NULL, &len) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_deserialize_ex(NULL, 10, &out) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_deserialize_ex("x", 0, &out) == BLOOMDB_ERR_INVALID_ARGUMENT);
+
+    bloomdb_free(db);
+    unlink(PATH);
+
+    printf("✓ test_encoding: OK\n");
+    return 0;
+}
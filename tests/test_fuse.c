@@ -0,0 +1,129 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <unistd.h>
+
+#include "bloom_fuse.h"
+#include "storage.h"
+
+// Claves "prefix-i" para i en [0, n)
+static char (*make_keys(const char* prefix, size_t n, const void** ptrs, size_t* lens))[24] {
+    char (*buf)[24] = malloc(sizeof(*buf) * (n ? n : 1));
+    for (size_t i = 0; i < n; i++) {
+        lens[i] = (size_t)snprintf(buf[i], sizeof(buf[i]), "%s-%zu", prefix, i);
+        ptrs[i] = buf[i];
+    }
+    return buf;
+}
+
+int main(void) {
+    printf("== test_fuse ==\n");
+
+    const size_t n = 1000000;
+    const void** ptrs = malloc(n * sizeof(void*));
+    size_t* lens = malloc(n * sizeof(size_t));
+    char (*keys)[24] = make_keys("user", n, ptrs, lens);
+
+    // Test 1: argumentos inválidos
+    BloomDBFuse* ff = NULL;
+    assert(bloomdb_fuse_build_ex(ptrs, lens, n, 1, NULL) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_fuse_build_ex(NULL, lens, 10, 1, &ff) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_fuse_build_ex(ptrs, NULL, 10, 1, &ff) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    size_t saved = lens[3];
+    lens[3] = 0;
+    assert(bloomdb_fuse_build_ex(ptrs, lens, 10, 1, &ff) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    lens[3] = saved;
+    assert(ff == NULL);
+
+    // Test 2: conjuntos pequeños (incluido el vacío) se construyen siempre
+    for (size_t m = 0; m <= 300; m++) {
+        BloomDBFuse* small = bloomdb_fuse_build(ptrs, lens, m, 9);
+        assert(small != NULL);
+        assert(small->key_count == m);
+        for (size_t i = 0; i < m; i++) {
+            assert(bloomdb_fuse_might_contain(small, ptrs[i], lens[i]));
+        }
+        bloomdb_fuse_free(small);
+    }
+
+    // Test 3: un millón de claves, sin falsos negativos, ~9 bits por clave
+    ff = bloomdb_fuse_build(ptrs, lens, n, 7);
+    assert(ff != NULL);
+    assert(ff->key_count == n);
+    double bits_per_key = 8.0 * bloomdb_fuse_size_bytes(ff) / n;
+    printf("   %.2f bits por clave\n", bits_per_key);
+    assert(bits_per_key > 8.9 && bits_per_key < 9.4);
+    for (size_t i = 0; i < n; i++) {
+        assert(bloomdb_fuse_might_contain(ff, ptrs[i], lens[i]));
+    }
+
+    // Test 4: FPR ~ 1/256
+    const size_t trials = 1000000;
+    int fp = 0;
+    char buf[32];
+    for (size_t i = 0; i < trials; i++) {
+        snprintf(buf, sizeof(buf), "other-%zu", i);
+        fp += bloomdb_fuse_might_contain(ff, buf, strlen(buf));
+    }
+    double rate = (double)fp / trials;
+    printf("   FPR medido = %.4f%% (teórico 0.3906%%)\n", 100.0 * rate);
+    assert(rate > 0.0034 && rate < 0.0044);
+
+    // Test 5: claves repetidas cuentan una vez
+    const size_t m = 20000;
+    const void** dup_ptrs = malloc(3 * m * sizeof(void*));
+    size_t* dup_lens = malloc(3 * m * sizeof(size_t));
+    for (size_t i = 0; i < 3 * m; i++) {
+        dup_ptrs[i] = ptrs[i % m];
+        dup_lens[i] = lens[i % m];
+    }
+    BloomDBFuse* dup = bloomdb_fuse_build(dup_ptrs, dup_lens, 3 * m, 7);
+    assert(dup != NULL);
+    assert(dup->key_count == m);
+    for (size_t i = 0; i < m; i++) {
+        assert(bloomdb_fuse_might_contain(dup, ptrs[i], lens[i]));
+    }
+    bloomdb_fuse_free(dup);
+    free(dup_ptrs);
+    free(dup_lens);
+
+    // Test 6: guardar y cargar
+    const char* path = "test_fuse.bloom";
+    assert(bloomdb_fuse_save(ff, path));
+    BloomDBFuse* loaded = NULL;
+    assert(bloomdb_fuse_load_ex(path, &loaded) == BLOOMDB_OK);
+    assert(loaded->array_length == ff->array_length);
+    assert(loaded->segment_length == ff->segment_length && loaded->segment_count == ff->segment_count);
+    assert(loaded->seed == ff->seed && loaded->fuse_seed == ff->fuse_seed);
+    assert(loaded->key_count == ff->key_count);
+    assert(memcmp(loaded->fingerprints, ff->fingerprints, ff->array_length) == 0);
+    for (size_t i = 0; i < n; i += 13) {
+        assert(bloomdb_fuse_might_contain(loaded, ptrs[i], lens[i]));
+    }
+
+    // Test 7: formato incorrecto y argumentos inválidos
+    BloomDBFuse* wrong = NULL;
+    BloomDB* plain = bloomdb_create(1000, 3, 1);
+    assert(bloomdb_save(plain, path));
+    assert(bloomdb_fuse_load_ex(path, &wrong) == BLOOMDB_ERR_FORMAT);
+    assert(wrong == NULL);
+    assert(bloomdb_fuse_load_ex("nonexistent.bloom", &wrong) == BLOOMDB_ERR_FILE_IO);
+    assert(bloomdb_fuse_load("nonexistent.bloom") == NULL);
+    bool result;
+    assert(bloomdb_fuse_might_contain_ex(ff, NULL, 1, &result) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_fuse_might_contain_ex(ff, "k", 0, &result) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_fuse_might_contain_ex(ff, "k", 1, NULL) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_fuse_save_ex(NULL, path) == BLOOMDB_ERR_INVALID_ARGUMENT);
+
+    bloomdb_free(plain);
+    bloomdb_fuse_free(ff);
+    bloomdb_fuse_free(loaded);
+    free(keys);
+    free(ptrs);
+    free(lens);
+    unlink(path);
+
+    printf("✓ test_fuse: OK\n");
+    return 0;
+}
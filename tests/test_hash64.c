@@ -41,12 +41,139 @@ static void test_different_seeds(void) {
     assert(h2 != h3);
 }
 
+static void test_reference_vectors(void) {
+    // Vectores publicados de MurmurHash3_x64_128 (seed 0)
+    const char* fox = "The quick brown fox jumps over the lazy dog";
+    hash128_t h = hash128(fox, strlen(fox), 0);
+    assert(h.h1 == 0xe34bbc7bbc071b6cULL);
+    assert(h.h2 == 0x7a433ca9c49a9347ULL);
+
+    h = hash128("hello", 5, 0);
+    assert(h.h1 == 0xcbd8a7b341bd9b02ULL);
+    assert(h.h2 == 0x5b1e906a48ae1d19ULL);
+
+    h = hash128("", 0, 0);
+    assert(h.h1 == 0 && h.h2 == 0);
+}
+
+static void test_hash64_is_low_half(void) {
+    const char* key = "https://example.com/a/b/c?x=1";
+    hash128_t h = hash128(key, strlen(key), 77);
+    assert(hash64(key, strlen(key), 77) == h.h1);
+}
+
+static void test_every_tail_length(void) {
+    // Cada longitud 0..47 (bloques + todas las colas) debe dar un hash distinto
+    uint8_t buf[48];
+    uint64_t seen[48];
+    for (size_t i = 0; i < sizeof(buf); i++) buf[i] = (uint8_t)(i * 31 + 7);
+
+    for (size_t len = 0; len < sizeof(buf); len++) {
+        seen[len] = hash64(buf, len, 5);
+        for (size_t j = 0; j < len; j++) {
+            assert(seen[j] != seen[len]);
+        }
+    }
+}
+
+static void test_multi_key_matches_scalar(void) {
+    // Claves de longitudes variables (0..200): cuerpo, cola y carriles
+    // que terminan en bloques distintos
+    enum { N = 203 };
+    static uint8_t data[N][200];
+    const void* keys[N];
+    size_t lens[N];
+    hash128_t out[N];
+    uint64_t out64[N];
+
+    for (size_t i = 0; i < N; i++) {
+        for (size_t j = 0; j < sizeof(data[i]); j++) {
+            data[i][j] = (uint8_t)(i * 131 + j * 7 + 3);
+        }
+        keys[i] = data[i];
+        lens[i] = (i * 37) % 201;
+    }
+
+    hash128_many(keys, lens, N, 0xfeedULL, out);
+    hash64_many(keys, lens, N, 0xfeedULL, out64);
+    for (size_t i = 0; i < N; i++) {
+        hash128_t ref = hash128(keys[i], lens[i], 0xfeedULL);
+        assert(out[i].h1 == ref.h1 && out[i].h2 == ref.h2);
+        assert(out64[i] == ref.h1);
+    }
+
+    hash128_x4(keys, lens, 9, out);
+    for (size_t i = 0; i < 4; i++) {
+        hash128_t ref = hash128(keys[i], lens[i], 9);
+        assert(out[i].h1 == ref.h1 && out[i].h2 == ref.h2);
+    }
+
+    hash128_x8(keys + 8, lens + 8, 9, out);
+    for (size_t i = 0; i < 8; i++) {
+        hash128_t ref = hash128(keys[8 + i], lens[8 + i], 9);
+        assert(out[i].h1 == ref.h1 && out[i].h2 == ref.h2);
+    }
+}
+
+static void test_fixed_length_keys(void) {
+    // IDs u64 y UUIDs de 16 bytes, contiguos en memoria
+    uint64_t ids[37];
+    uint8_t uuids[37][16];
+    hash128_t out[37];
+
+    for (size_t i = 0; i < 37; i++) {
+        ids[i] = 0x9e3779b97f4a7c15ULL * (i + 1);
+        for (size_t j = 0; j < 16; j++) uuids[i][j] = (uint8_t)(i ^ (j * 17));
+    }
+
+    hash128_fixed(ids, sizeof(uint64_t), 37, 123, out);
+    for (size_t i = 0; i < 37; i++) {
+        hash128_t ref = hash128(&ids[i], sizeof(uint64_t), 123);
+        assert(out[i].h1 == ref.h1 && out[i].h2 == ref.h2);
+    }
+
+    hash128_fixed(uuids, 16, 37, 123, out);
+    for (size_t i = 0; i < 37; i++) {
+        hash128_t ref = hash128(uuids[i], 16, 123);
+        assert(out[i].h1 == ref.h1 && out[i].h2 == ref.h2);
+    }
+}
+
+static void test_integer_kernels(void) {
+    // Mismo digest que los bytes del valor en memoria
+    uint64_t seeds[3] = { 0, 42, 0xdeadbeefcafebabeULL };
+    for (int s = 0; s < 3; s++) {
+        uint64_t v = 1;
+        for (int i = 0; i < 200; i++) {
+            hash128_t a = hash128_u64(v, seeds[s]);
+            hash128_t b = hash128(&v, sizeof(v), seeds[s]);
+            assert(a.h1 == b.h1 && a.h2 == b.h2);
+
+            uint64_t pair[2] = { v, ~v * 31 };
+            hash128_t c = hash128_u128(pair[0], pair[1], seeds[s]);
+            hash128_t d = hash128(pair, sizeof(pair), seeds[s]);
+            assert(c.h1 == d.h1 && c.h2 == d.h2);
+
+            v = v * 0x9e3779b97f4a7c15ULL + (uint64_t)i;
+        }
+    }
+    uint64_t zero = 0, ones = ~0ULL;
+    assert(hash128_u64(0, 7).h1 == hash128(&zero, 8, 7).h1);
+    assert(hash128_u64(~0ULL, 7).h2 == hash128(&ones, 8, 7).h2);
+}
+
 int main(void) {
     printf("== test_hash64 ==\n");
 
     test_deterministic();
     test_different_keys();
     test_different_seeds();
+    test_reference_vectors();
+    test_hash64_is_low_half();
+    test_every_tail_length();
+    test_multi_key_matches_scalar();
+    test_fixed_length_keys();
+    test_integer_kernels();
 
     printf("✓ test_hash64: OK\n");
     return 0;
@@ -74,6 +74,54 @@ int main(void) {
     err = bloomdb_might_contain_u64_ex(db, 123, NULL);
     assert(err == BLOOMDB_ERR_INVALID_ARGUMENT);
 
+    // Test 6: kernels enteros y API de bytes ponen los mismos bits
+    BloomDB* by_int = bloomdb_create(1 << 14, 5, 99);
+    BloomDB* by_bytes = bloomdb_create(1 << 14, 5, 99);
+    for (uint64_t v = 1; v < 500; v++) {
+        uint64_t x = v * 0x9e3779b97f4a7c15ULL;
+        uint64_t pair[2] = { x, ~x };
+        assert(bloomdb_insert_u64(by_int, x));
+        assert(bloomdb_insert(by_bytes, &x, sizeof(x)));
+        assert(bloomdb_insert_u128(by_int, pair[0], pair[1]));
+        assert(bloomdb_insert(by_bytes, pair, sizeof(pair)));
+    }
+    assert(memcmp(by_int->bitarray, by_bytes->bitarray, by_int->byte_count) == 0);
+    for (uint64_t v = 1; v < 500; v++) {
+        uint64_t x = v * 0x9e3779b97f4a7c15ULL;
+        assert(bloomdb_might_contain(by_int, &x, sizeof(x)));
+        assert(bloomdb_might_contain_u64(by_bytes, x));
+        assert(bloomdb_might_contain_u128(by_bytes, x, ~x));
+    }
+
+    // Test 7: lotes de u64 (mismos bits y respuestas que uno a uno)
+    enum { NVALS = 1000 };
+    uint64_t vals[NVALS];
+    for (int i = 0; i < NVALS; i++) vals[i] = (uint64_t)i * 0xff51afd7ed558ccdULL + 1;
+    BloomDB* batched = bloomdb_create(1 << 14, 5, 99);
+    BloomDB* single = bloomdb_create(1 << 14, 5, 99);
+    assert(bloomdb_insert_u64_batch_ex(batched, vals, NVALS / 2) == BLOOMDB_OK);
+    for (int i = 0; i < NVALS / 2; i++) assert(bloomdb_insert_u64(single, vals[i]));
+    assert(memcmp(batched->bitarray, single->bitarray, single->byte_count) == 0);
+
+    uint8_t bitmap[(NVALS + 7) / 8];
+    assert(bloomdb_might_contain_u64_batch_ex(batched, vals, NVALS, bitmap) == BLOOMDB_OK);
+    for (int i = 0; i < NVALS; i++) {
+        bool expected = bloomdb_might_contain_u64(batched, vals[i]);
+        assert(((bitmap[i >> 3] >> (i & 7)) & 1) == expected);
+        if (i < NVALS / 2) assert(expected);
+    }
+
+    assert(bloomdb_insert_u64_batch_ex(batched, NULL, 0) == BLOOMDB_OK);
+    assert(bloomdb_insert_u64_batch_ex(NULL, vals, 1) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_insert_u64_batch_ex(batched, NULL, 1) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_might_contain_u64_batch_ex(batched, vals, 1, NULL) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_insert_u128_ex(NULL, 1, 2) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_might_contain_u128_ex(batched, 1, 2, NULL) == BLOOMDB_ERR_INVALID_ARGUMENT);
+
+    bloomdb_free(by_int);
+    bloomdb_free(by_bytes);
+    bloomdb_free(batched);
+    bloomdb_free(single);
     bloomdb_free(db);
 
     printf("✓ test_helpers: OK\n");
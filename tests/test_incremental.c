@@ -0,0 +1,258 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "bloomdb.h"
+#include "storage.h"
+
+#define BITS ((size_t)64 << 20)   // 8 MiB: 2048 páginas, 8 chunks de CRC
+#define THREADS 4
+
+static const char* BASE = "test_incremental.bloom";
+static const char* COPY = "test_incremental_copy.bloom";
+static const char* DELTA = "test_incremental.delta";
+
+static bool page_marked(const BloomDB* db, size_t p) {
+    return (db->dirty[p >> 6] >> (p & 63)) & 1;
+}
+
+// Toda página que difiere de before está marcada
+static void check_marks(const BloomDB* db, const BloomDB* before) {
+    for (size_t p = 0; p < bloomdb_page_count(db); p++) {
+        size_t start = p * BLOOMDB_DIRTY_PAGE_SIZE;
+        size_t len = db->byte_count - start < BLOOMDB_DIRTY_PAGE_SIZE ? db->byte_count - start : BLOOMDB_DIRTY_PAGE_SIZE;
+        bool differs = memcmp(db->bitarray + start, before->bitarray + start, len) != 0;
+        assert(!differs || page_marked(db, p));
+    }
+}
+
+static BloomDB* clone(const BloomDB* db) {
+    BloomDB* c = bloomdb_create(db->bit_count, db->num_hashes, db->seed);
+    assert(c && bloomdb_merge(c, db));
+    return c;
+}
+
+typedef struct {
+    BloomDB* db;
+    uint64_t first;
+} Worker;
+
+static void* insert_worker(void* arg) {
+    Worker* w = (Worker*)arg;
+    for (uint64_t i = 0; i < 2000; i++) assert(bloomdb_insert_u64(w->db, w->first + i));
+    return NULL;
+}
+
+int main(void) {
+    printf("== test_incremental ==\n");
+    unlink(BASE);
+    unlink(COPY);
+    unlink(DELTA);
+
+    // Test 1: sin seguimiento no hay bitmap ni guardado incremental
+    BloomDB* db = bloomdb_create(BITS, 7, 42);
+    for (uint64_t i = 0; i < 20000; i++) assert(bloomdb_insert_u64(db, i));
+    assert(db->dirty == NULL && bloomdb_dirty_pages(db) == 0);
+    assert(bloomdb_page_count(db) == 2048);
+    assert(bloomdb_save_incremental_ex(db, BASE, NULL) == BLOOMDB_ERR_INVALID_ARGUMENT);
+
+    // Test 2: base + seguimiento; pocas inserciones marcan pocas páginas
+    assert(bloomdb_save(db, BASE) && bloomdb_save(db, COPY));
+    assert(bloomdb_track_dirty(db, true) && db->dirty);
+    assert(bloomdb_dirty_pages(db) == 0);
+    BloomDB* before = clone(db);
+    for (uint64_t i = 0; i < 50; i++) assert(bloomdb_insert_u64(db, 1000000 + i));
+    assert(bloomdb_insert(db, "key", 3));
+    const size_t marked = bloomdb_dirty_pages(db);
+    assert(marked > 0 && marked <= 51 * 7);
+    check_marks(db, before);
+
+    // Una página no marcada del archivo no se reescribe en sitio
+    size_t clean = 0;
+    while (page_marked(db, clean)) clean++;
+    int fd = open(BASE, O_RDWR);
+    const off_t sentinel_at = 4096 + (off_t)clean * (off_t)BLOOMDB_DIRTY_PAGE_SIZE;
+    uint8_t old_byte, probe = 0xa5;
+    assert(pread(fd, &old_byte, 1, sentinel_at) == 1);
+    assert(pwrite(fd, &probe, 1, sentinel_at) == 1);
+
+    assert(bloomdb_save_incremental_ex(db, BASE, DELTA) == BLOOMDB_OK);
+    assert(bloomdb_dirty_pages(db) == 0);
+    uint8_t now;
+    assert(pread(fd, &now, 1, sentinel_at) == 1 && now == probe);
+    assert(pwrite(fd, &old_byte, 1, sentinel_at) == 1);
+    close(fd);
+
+    // El archivo base queda igual que el filtro y con los CRC al día
+    BloomDB* loaded = NULL;
+    assert(bloomdb_load_ex(BASE, &loaded) == BLOOMDB_OK);
+    assert(memcmp(loaded->bitarray, db->bitarray, db->byte_count) == 0);
+    bloomdb_free(loaded);
+    BloomDB* mapped = NULL;
+    assert(bloomdb_open_mmap_ex(BASE, BLOOMDB_MMAP_VERIFY, &mapped) == BLOOMDB_OK);
+    bloomdb_free(mapped);
+
+    // Test 3: el delta lleva la copia al mismo estado; aplicarlo dos veces
+    // no cambia nada
+    BloomDB* copy = bloomdb_load(COPY);
+    assert(copy && memcmp(copy->bitarray, db->bitarray, db->byte_count) != 0);
+    assert(bloomdb_apply_delta_ex(copy, DELTA) == BLOOMDB_OK);
+    assert(memcmp(copy->bitarray, db->bitarray, db->byte_count) == 0);
+    assert(bloomdb_apply_delta_ex(copy, DELTA) == BLOOMDB_OK);
+    assert(memcmp(copy->bitarray, db->bitarray, db->byte_count) == 0);
+    assert(bloomdb_might_contain(copy, "key", 3));
+
+    // Con seguimiento en la copia, aplicar marca las páginas del delta
+    assert(bloomdb_track_dirty(copy, true));
+    assert(bloomdb_apply_delta(copy, DELTA) && bloomdb_dirty_pages(copy) == marked);
+    bloomdb_free(copy);
+
+    // Test 4: merge marca solo las páginas donde src tiene bits
+    bloomdb_free(before);
+    before = clone(db);
+    BloomDB* other = bloomdb_create(BITS, 7, 42);
+    assert(bloomdb_insert(other, "merged", 6));
+    assert(bloomdb_merge(db, other));
+    assert(bloomdb_dirty_pages(db) >= 1 && bloomdb_dirty_pages(db) <= 7);
+    check_marks(db, before);
+    bloomdb_free(other);
+
+    // Batch y modo concurrente con varios hilos también marcan
+    const uint64_t vals[3] = { 7, 8, 9 };
+    assert(bloomdb_insert_u64_batch(db, vals, 3));
+    assert(bloomdb_set_concurrent(db, true));
+    pthread_t tid[THREADS];
+    Worker w[THREADS];
+    for (int t = 0; t < THREADS; t++) {
+        w[t] = (Worker){ db, 5000000 + (uint64_t)t * 10000 };
+        assert(pthread_create(&tid[t], NULL, insert_worker, &w[t]) == 0);
+    }
+    for (int t = 0; t < THREADS; t++) pthread_join(tid[t], NULL);
+    assert(bloomdb_set_concurrent(db, false));
+    check_marks(db, before);
+    assert(bloomdb_save_incremental(db, BASE, NULL));
+    loaded = bloomdb_load(BASE);
+    assert(loaded && memcmp(loaded->bitarray, db->bitarray, db->byte_count) == 0);
+    bloomdb_free(loaded);
+    bloomdb_free(before);
+
+    // Test 5: base de otro filtro o inexistente -> se escribe entera
+    BloomDB* small = bloomdb_create(1000, 3, 1);
+    assert(bloomdb_save(small, BASE));
+    assert(bloomdb_insert_u64(db, 31337));
+    assert(bloomdb_save_incremental(db, BASE, NULL));
+    loaded = bloomdb_load(BASE);
+    assert(loaded && loaded->bit_count == BITS);
+    assert(memcmp(loaded->bitarray, db->bitarray, db->byte_count) == 0);
+    bloomdb_free(loaded);
+    unlink(BASE);
+    assert(bloomdb_insert_u64(db, 31338));
+    assert(bloomdb_save_incremental(db, BASE, NULL));
+    loaded = bloomdb_load(BASE);
+    assert(loaded && memcmp(loaded->bitarray, db->bitarray, db->byte_count) == 0);
+    bloomdb_free(loaded);
+
+    // Test 6: deltas dañados, cortados o de otro filtro no se aplican
+    assert(bloomdb_insert(db, "delta-err", 9));
+    assert(bloomdb_save_incremental(db, NULL, DELTA));
+    copy = bloomdb_load(COPY);
+    BloomDB* pristine = clone(copy);
+    FILE* f = fopen(DELTA, "r+b");
+    fseek(f, 64 + 8 + 100, SEEK_SET);
+    int c = fgetc(f);
+    fseek(f, 64 + 8 + 100, SEEK_SET);
+    fputc(c ^ 0x01, f);
+    fclose(f);
+    assert(bloomdb_apply_delta_ex(copy, DELTA) == BLOOMDB_ERR_CHECKSUM);
+    assert(memcmp(copy->bitarray, pristine->bitarray, copy->byte_count) == 0);
+    assert(truncate(DELTA, 64 + 8 + 10) == 0);
+    assert(bloomdb_apply_delta_ex(copy, DELTA) == BLOOMDB_ERR_FORMAT);
+    assert(bloomdb_apply_delta_ex(small, DELTA) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_apply_delta_ex(copy, BASE) == BLOOMDB_ERR_FORMAT);
+    assert(bloomdb_apply_delta_ex(copy, "no-such.delta") == BLOOMDB_ERR_FILE_IO);
+    bloomdb_free(pristine);
+    bloomdb_free(copy);
+    bloomdb_free(small);
+
+    // Test 7: tamaño no múltiplo de página; la última es más corta
+    BloomDB* odd = bloomdb_create(3 * 8 * 4096 + 100, 5, 9);
+    assert(bloomdb_page_count(odd) == 4);
+    assert(bloomdb_save(odd, BASE) && bloomdb_track_dirty(odd, true));
+    for (uint64_t i = 0; i < 5000; i++) assert(bloomdb_insert_u64(odd, i));
+    assert(bloomdb_dirty_pages(odd) == 4);
+    assert(bloomdb_save_incremental(odd, BASE, DELTA));
+    loaded = bloomdb_load(BASE);
+    assert(loaded && memcmp(loaded->bitarray, odd->bitarray, odd->byte_count) == 0);
+    BloomDB* empty = bloomdb_create(odd->bit_count, 5, 9);
+    assert(bloomdb_apply_delta(empty, DELTA));
+    assert(memcmp(empty->bitarray, odd->bitarray, odd->byte_count) == 0);
+    bloomdb_free(empty);
+    bloomdb_free(loaded);
+
+    // Sin cambios: delta vacío, válido
+    assert(bloomdb_save_incremental(odd, BASE, DELTA));
+    assert(bloomdb_apply_delta(odd, DELTA) && bloomdb_dirty_pages(odd) == 0);
+
+    // Desactivar libera el bitmap y vuelve a los kernels sin marcas
+    assert(bloomdb_track_dirty(odd, false) && odd->dirty == NULL);
+    assert(bloomdb_insert_u64(odd, 123456));
+    bloomdb_free(odd);
+
+    // Test 8: llamadas solo con delta o solo con base. Cada destino recibe
+    // lo que se saltó en las anteriores
+    BloomDB* mixed = bloomdb_create(BITS, 7, 42);
+    assert(bloomdb_track_dirty(mixed, true));
+    assert(bloomdb_save(mixed, BASE) && bloomdb_save(mixed, COPY));
+    for (uint64_t i = 0; i < 1000; i++) assert(bloomdb_insert_u64(mixed, 7000000 + i));
+    assert(bloomdb_save_incremental_ex(mixed, NULL, DELTA) == BLOOMDB_OK);
+    assert(mixed->base_lag && bloomdb_dirty_pages(mixed) == 0);
+    for (uint64_t i = 0; i < 10; i++) assert(bloomdb_insert_u64(mixed, 8000000 + i));
+    assert(bloomdb_save_incremental_ex(mixed, BASE, NULL) == BLOOMDB_OK);
+    assert(mixed->base_lag == NULL && mixed->delta_lag);
+    loaded = NULL;
+    assert(bloomdb_load_ex(BASE, &loaded) == BLOOMDB_OK);
+    assert(memcmp(loaded->bitarray, mixed->bitarray, mixed->byte_count) == 0);
+    bloomdb_free(loaded);
+
+    // El siguiente delta lleva también las 10 claves que solo fueron a la base
+    copy = bloomdb_load(COPY);
+    assert(copy && bloomdb_apply_delta(copy, DELTA));
+    assert(!bloomdb_might_contain_u64(copy, 8000000) || !bloomdb_might_contain_u64(copy, 8000001));
+    assert(bloomdb_insert_u64(mixed, 9000000));
+    assert(bloomdb_save_incremental_ex(mixed, NULL, DELTA) == BLOOMDB_OK);
+    assert(bloomdb_apply_delta(copy, DELTA));
+    assert(memcmp(copy->bitarray, mixed->bitarray, mixed->byte_count) == 0);
+    bloomdb_free(copy);
+
+    // Y la base, a su vez, la clave que solo fue al delta
+    assert(bloomdb_save_incremental(mixed, BASE, DELTA));
+    assert(mixed->base_lag == NULL && mixed->delta_lag == NULL);
+    assert(bloomdb_load_ex(BASE, &loaded) == BLOOMDB_OK);
+    assert(memcmp(loaded->bitarray, mixed->bitarray, mixed->byte_count) == 0);
+    bloomdb_free(loaded);
+    bloomdb_free(mixed);
+
+    // Test 9: argumentos inválidos y mapeos de solo lectura
+    assert(bloomdb_track_dirty_ex(NULL, true) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_save_incremental_ex(NULL, BASE, NULL) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_save_incremental_ex(db, NULL, NULL) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_save_incremental_ex(db, "no-such-dir/x.bloom", NULL) == BLOOMDB_ERR_FILE_IO);
+    assert(bloomdb_apply_delta_ex(db, NULL) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_save(db, BASE));
+    BloomDB* ro = bloomdb_open_mmap(BASE, BLOOMDB_MMAP_READ_ONLY);
+    assert(bloomdb_track_dirty_ex(ro, true) == BLOOMDB_ERR_READ_ONLY);
+    assert(bloomdb_apply_delta_ex(ro, DELTA) == BLOOMDB_ERR_READ_ONLY);
+    bloomdb_free(ro);
+
+    bloomdb_free(db);
+    unlink(BASE);
+    unlink(COPY);
+    unlink(DELTA);
+
+    printf("✓ test_incremental: OK\n");
+    return 0;
+}
@@ -0,0 +1,204 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+#include "bloomdb.h"
+#include "storage.h"
+#include "insert_log.h"
+
+#define N 5000
+
+static const char* SNAP = "test_log.bloom";
+static const char* LOG = "test_log.bloomlog";
+
+static long file_size(const char* path) {
+    struct stat st;
+    return stat(path, &st) == 0 ? (long)st.st_size : -1;
+}
+
+static void key_of(char* buf, size_t size, int i) {
+    snprintf(buf, size, "log-key-%d", i);
+}
+
+// Último snapshot + log, como al arrancar tras un crash
+static BloomDB* recover(BloomDBLog** out_log) {
+    BloomDB* db = bloomdb_load(SNAP);
+    assert(db);
+    BloomDBLogOptions opts = { 4096, 0 };
+    assert(bloomdb_log_open_ex(db, LOG, &opts, out_log) == BLOOMDB_OK);
+    return db;
+}
+
+int main(void) {
+    printf("== test_log ==\n");
+    unlink(SNAP);
+    unlink(LOG);
+    char buf[32];
+
+    // Test 1: el proceso muere sin cerrar el log. Lo sincronizado se
+    // recupera; el grupo pendiente (sin fdatasync) puede perderse
+    BloomDB* base = bloomdb_create(N * 10, 7, 42);
+    assert(bloomdb_save(base, SNAP));
+    pid_t pid = fork();
+    assert(pid >= 0);
+    if (pid == 0) {
+        BloomDB* db = bloomdb_load(SNAP);
+        BloomDBLogOptions opts = { 1024, 0 };   // 64 registros por grupo
+        BloomDBLog* log = bloomdb_log_open(db, LOG, &opts);
+        if (!db || !log) _exit(1);
+        for (int i = 0; i < N; i++) {
+            key_of(buf, sizeof(buf), i);
+            if (!bloomdb_log_insert(log, buf, strlen(buf))) _exit(1);
+        }
+        if (!bloomdb_log_sync(log)) _exit(1);
+        if (!bloomdb_log_insert_u64(log, 777)) _exit(1);   // pendiente
+        _exit(0);
+    }
+    int status;
+    assert(waitpid(pid, &status, 0) == pid && WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    assert(file_size(LOG) == 32 + (N / 64) * (8 + 64 * 16) + 8 + (N % 64) * 16);
+
+    BloomDBLog* log = NULL;
+    BloomDB* db = recover(&log);
+    assert(log->replayed == N);
+    for (int i = 0; i < N; i++) {
+        key_of(buf, sizeof(buf), i);
+        assert(bloomdb_insert(base, buf, strlen(buf)));
+        assert(bloomdb_might_contain(db, buf, strlen(buf)));
+    }
+    assert(memcmp(db->bitarray, base->bitarray, base->byte_count) == 0);
+
+    // Test 2: inserciones por el log, close y reapertura acumulan
+    assert(bloomdb_log_insert_u64_ex(log, 123) == BLOOMDB_OK);
+    assert(bloomdb_insert_u64(base, 123));
+    assert(log->appended == 1 && log->pending == 1);
+    assert(bloomdb_log_close_ex(log) == BLOOMDB_OK);
+    bloomdb_free(db);
+    db = recover(&log);
+    assert(log->replayed == N + 1);
+    assert(bloomdb_might_contain_u64(db, 123));
+    assert(memcmp(db->bitarray, base->bitarray, base->byte_count) == 0);
+    bloomdb_log_close(log);
+    bloomdb_free(db);
+
+    // Test 3: cola cortada (frame a medias) y basura al final: se
+    // descartan y el archivo se trunca al último frame completo
+    const long good = file_size(LOG);
+    FILE* f = fopen(LOG, "ab");
+    const uint8_t torn[] = { 5, 0, 0, 0, 0xaa, 0xbb, 0xcc, 0xdd, 1, 2, 3 };
+    fwrite(torn, 1, sizeof(torn), f);
+    fclose(f);
+    db = recover(&log);
+    assert(log->replayed == N + 1 && file_size(LOG) == good);
+    bloomdb_log_close(log);
+    bloomdb_free(db);
+
+    // Un frame completo con CRC mal: también es el final del log
+    f = fopen(LOG, "r+b");
+    fseek(f, good - 1, SEEK_SET);
+    fputc(0x5a, f);
+    fclose(f);
+    db = recover(&log);
+    assert(log->replayed == N && file_size(LOG) == good - 8 - 16);
+    assert(bloomdb_log_insert_u64_ex(log, 123) == BLOOMDB_OK);
+    assert(bloomdb_log_sync_ex(log) == BLOOMDB_OK && file_size(LOG) == good);
+
+    // Test 4: checkpoint -> snapshot con todo y log vacío
+    assert(bloomdb_log_checkpoint_ex(log, SNAP) == BLOOMDB_OK);
+    assert(file_size(LOG) == 32 && access("test_log.bloom.tmp", F_OK) != 0);
+    assert(bloomdb_log_insert_u64_ex(log, 456) == BLOOMDB_OK);
+    assert(bloomdb_insert_u64(base, 456));
+    assert(bloomdb_log_close_ex(log) == BLOOMDB_OK);
+    bloomdb_free(db);
+    db = recover(&log);
+    assert(log->replayed == 1);
+    assert(memcmp(db->bitarray, base->bitarray, base->byte_count) == 0);
+    bloomdb_log_close(log);
+    bloomdb_free(db);
+
+    // Test 5: group commit por tiempo sin más inserciones
+    unlink(LOG);
+    db = bloomdb_load(SNAP);
+    BloomDBLogOptions timed = { 1 << 20, 5 };
+    log = bloomdb_log_open(db, LOG, &timed);
+    assert(log && log->flusher_running);
+    for (int i = 0; i < 10; i++) assert(bloomdb_log_insert_u64(log, (uint64_t)i));
+    for (int t = 0; t < 200 && file_size(LOG) == 32; t++) usleep(5000);
+    assert(file_size(LOG) == 32 + 8 + 10 * 16);
+    assert(bloomdb_log_sync(log) && log->syncs == 1);   // nada más pendiente
+    bloomdb_log_close(log);
+
+    // group_bytes 0: un fdatasync por inserción
+    BloomDBLogOptions each = { 0, 0 };
+    log = bloomdb_log_open(db, LOG, &each);
+    assert(log && log->replayed == 10);
+    assert(bloomdb_log_insert_u64(log, 99) && bloomdb_log_insert_u64(log, 98));
+    assert(log->syncs == 2 && log->pending == 0);
+    assert(file_size(LOG) == 32 + 3 * 8 + 12 * 16);
+    bloomdb_log_close(log);
+
+    // Test 6: log y snapshot deben ser de la misma seed y otros ficheros
+    // (snapshot, scalable) no se abren como log; filtros legacy y mapeos de
+    // solo lectura no admiten log
+    BloomDB* other = bloomdb_create(N * 10, 7, 43);
+    assert(bloomdb_log_open_ex(other, LOG, NULL, &log) == BLOOMDB_ERR_FORMAT);
+    bloomdb_free(other);
+    f = fopen(LOG, "r+b");
+    fseek(f, 9, SEEK_SET);
+    fputc(0x55, f);
+    fclose(f);
+    assert(bloomdb_log_open_ex(db, LOG, NULL, &log) == BLOOMDB_ERR_CHECKSUM);
+    assert(bloomdb_log_open_ex(db, SNAP, NULL, &log) == BLOOMDB_ERR_FORMAT);
+    BloomDBScalable* sf = bloomdb_scalable_create(1000, 0.01, 1);
+    assert(bloomdb_scalable_save(sf, LOG));
+    assert(bloomdb_log_open_ex(db, LOG, NULL, &log) == BLOOMDB_ERR_FORMAT);
+    bloomdb_scalable_free(sf);
+    unlink(LOG);
+    BloomDB* legacy = bloomdb_create(1024, 3, 1);
+    legacy->hash_algo = BLOOMDB_HASH_LEGACY;
+    assert(bloomdb_log_open_ex(legacy, LOG, NULL, &log) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    bloomdb_free(legacy);
+    BloomDB* ro = bloomdb_open_mmap(SNAP, BLOOMDB_MMAP_READ_ONLY);
+    assert(bloomdb_log_open_ex(ro, LOG, NULL, &log) == BLOOMDB_ERR_READ_ONLY);
+    bloomdb_free(ro);
+
+    // Test 7: mapeo escribible, checkpoint sin ruta = msync del propio archivo
+    BloomDB* rw = bloomdb_open_mmap(SNAP, BLOOMDB_MMAP_WRITABLE);
+    log = bloomdb_log_open(rw, LOG, NULL);
+    assert(log);
+    assert(bloomdb_log_insert(log, "mapped", 6));
+    assert(bloomdb_log_checkpoint(log, NULL));
+    assert(file_size(LOG) == 32);
+    bloomdb_log_close(log);
+    bloomdb_free(rw);
+    BloomDB* check = bloomdb_load(SNAP);
+    assert(check && bloomdb_might_contain(check, "mapped", 6));
+    bloomdb_free(check);
+    assert(bloomdb_log_checkpoint_ex(NULL, SNAP) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    log = bloomdb_log_open(db, LOG, NULL);
+    assert(bloomdb_log_checkpoint_ex(log, NULL) == BLOOMDB_ERR_INVALID_ARGUMENT);   // filtro del heap
+    assert(bloomdb_log_insert_ex(log, NULL, 3) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    bloomdb_log_close(log);
+
+    // Test 8: argumentos inválidos
+    BloomDBLogOptions huge = { (size_t)BLOOMDB_LOG_MAX_GROUP_BYTES + 1, 0 };
+    assert(bloomdb_log_open_ex(db, LOG, &huge, &log) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_log_open_ex(NULL, LOG, NULL, &log) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_log_open_ex(db, NULL, NULL, &log) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_log_open_ex(db, LOG, NULL, NULL) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_log_open_ex(db, "no-such-dir/x.log", NULL, &log) == BLOOMDB_ERR_FILE_IO);
+    assert(bloomdb_log_sync_ex(NULL) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_log_close_ex(NULL) == BLOOMDB_ERR_INVALID_ARGUMENT);
+
+    bloomdb_free(db);
+    bloomdb_free(base);
+    unlink(SNAP);
+    unlink(LOG);
+
+    printf("✓ test_log: OK\n");
+    return 0;
+}
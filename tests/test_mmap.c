@@ -0,0 +1,272 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+#include "bloomdb.h"
+#include "storage.h"
+
+#define N 20000
+
+static void key_of(char* buf, size_t size, const char* prefix, int i) {
+    snprintf(buf, size, "%s-%d", prefix, i);
+}
+
+// flags de la cabecera v2 (byte 44)
+static uint32_t header_flags(const char* path) {
+    uint8_t head[48];
+    FILE* f = fopen(path, "rb");
+    assert(f && fread(head, 1, sizeof(head), f) == sizeof(head));
+    fclose(f);
+    return (uint32_t)head[44] | (uint32_t)head[45] << 8 | (uint32_t)head[46] << 16 | (uint32_t)head[47] << 24;
+}
+
+static long file_size(const char* path) {
+    struct stat st;
+    return stat(path, &st) == 0 ? (long)st.st_size : -1;
+}
+
+int main(void) {
+    printf("== test_mmap ==\n");
+
+    const char* path = "test_mmap.bloom";
+    char buf[48];
+    BloomDB* db = bloomdb_create(N * 10, 7, 99);
+    for (int i = 0; i < N; i++) {
+        key_of(buf, sizeof(buf), "key", i);
+        assert(bloomdb_insert(db, buf, strlen(buf)));
+    }
+    assert(bloomdb_save(db, path));
+    const long size = file_size(path);
+
+    // Test 1: solo lectura -> mismas respuestas que el original, sin copia
+    BloomDB* ro = NULL;
+    assert(bloomdb_open_mmap_ex(path, BLOOMDB_MMAP_READ_ONLY, &ro) == BLOOMDB_OK);
+    assert(ro->mapping != NULL && ro->read_only);
+    assert(ro->bit_count == db->bit_count && ro->num_hashes == db->num_hashes && ro->seed == db->seed);
+    assert(ro->hash_algo == db->hash_algo && ro->index_mode == db->index_mode);
+    assert(memcmp(ro->bitarray, db->bitarray, db->byte_count) == 0);
+    for (int i = 0; i < 2 * N; i++) {
+        key_of(buf, sizeof(buf), "key", i);
+        assert(bloomdb_might_contain(ro, buf, strlen(buf)) == bloomdb_might_contain(db, buf, strlen(buf)));
+    }
+    assert(bloomdb_count_set_bits(ro) == bloomdb_count_set_bits(db));
+
+    // Toda escritura devuelve READ_ONLY y el filtro queda igual
+    BloomDBDigest d = bloomdb_hash(99, "new", 3);
+    const void* keys[1] = { "new" };
+    size_t lens[1] = { 3 };
+    uint64_t values[1] = { 7 };
+    assert(bloomdb_insert_ex(ro, "new", 3) == BLOOMDB_ERR_READ_ONLY);
+    assert(bloomdb_insert_digest_ex(ro, &d) == BLOOMDB_ERR_READ_ONLY);
+    assert(bloomdb_insert_batch_ex(ro, keys, lens, 1) == BLOOMDB_ERR_READ_ONLY);
+    assert(bloomdb_insert_u64_ex(ro, 7) == BLOOMDB_ERR_READ_ONLY);
+    assert(bloomdb_insert_u128_ex(ro, 7, 8) == BLOOMDB_ERR_READ_ONLY);
+    assert(bloomdb_insert_u64_batch_ex(ro, values, 1) == BLOOMDB_ERR_READ_ONLY);
+    assert(bloomdb_build_parallel_ex(ro, keys, lens, 1, 2) == BLOOMDB_ERR_READ_ONLY);
+    assert(bloomdb_merge_ex(ro, db) == BLOOMDB_ERR_READ_ONLY);
+    assert(!bloomdb_insert(ro, "new", 3));
+    assert(strcmp(bloomdb_strerror(BLOOMDB_ERR_READ_ONLY), "Filter is read-only") == 0);
+    assert(bloomdb_sync_ex(ro) == BLOOMDB_OK);
+    // v2: el bitarray empieza en página propia, hay modo concurrente
+    assert(((uintptr_t)ro->bitarray & 4095) == 0);
+    assert(bloomdb_set_concurrent_ex(ro, true) == BLOOMDB_OK);
+    assert(bloomdb_insert_ex(ro, "new", 3) == BLOOMDB_ERR_READ_ONLY);
+    assert(bloomdb_set_concurrent_ex(ro, false) == BLOOMDB_OK);
+    // Un filtro mapeado se puede guardar en otro archivo
+    assert(bloomdb_save(ro, "test_mmap_copy.bloom"));
+    BloomDB* copy = bloomdb_load("test_mmap_copy.bloom");
+    assert(copy && memcmp(copy->bitarray, db->bitarray, db->byte_count) == 0);
+    bloomdb_free(copy);
+    unlink("test_mmap_copy.bloom");
+    bloomdb_free(ro);
+
+    // Test 2: escribible -> las inserciones van al archivo (MAP_SHARED)
+    BloomDB* rw = bloomdb_open_mmap(path, BLOOMDB_MMAP_WRITABLE | BLOOMDB_MMAP_RANDOM);
+    assert(rw && !rw->read_only);
+    BloomDB* other = bloomdb_open_mmap(path, BLOOMDB_MMAP_READ_ONLY | BLOOMDB_MMAP_POPULATE);
+    assert(other);
+    for (int i = 0; i < N; i++) {
+        key_of(buf, sizeof(buf), "more", i);
+        assert(bloomdb_insert(rw, buf, strlen(buf)));
+        assert(bloomdb_insert(db, buf, strlen(buf)));
+    }
+    assert(bloomdb_insert_u64(rw, 123456789));
+    assert(bloomdb_insert_u64(db, 123456789));
+    // Con hilos sobre el mapeo y el mismo resultado
+    const void* pk[64];
+    size_t pl[64];
+    char pbuf[64][16];
+    for (int i = 0; i < 64; i++) {
+        pl[i] = (size_t)snprintf(pbuf[i], sizeof(pbuf[i]), "par-%d", i);
+        pk[i] = pbuf[i];
+    }
+    assert(bloomdb_build_parallel(rw, pk, pl, 64, 4));
+    assert(bloomdb_insert_batch(db, pk, pl, 64));
+    assert(bloomdb_sync(rw));
+    // Otro mapeo del mismo archivo ve los cambios al momento (page cache)
+    assert(memcmp(other->bitarray, db->bitarray, db->byte_count) == 0);
+    bloomdb_free(other);
+    bloomdb_free(rw);
+    assert(file_size(path) == size);
+
+    BloomDB* reloaded = NULL;
+    assert(bloomdb_load_ex(path, &reloaded) == BLOOMDB_OK);
+    assert(memcmp(reloaded->bitarray, db->bitarray, db->byte_count) == 0);
+    for (int i = 0; i < N; i++) {
+        key_of(buf, sizeof(buf), "more", i);
+        assert(bloomdb_might_contain(reloaded, buf, strlen(buf)));
+    }
+    bloomdb_free(reloaded);
+
+    // Test 3: CRC por chunk. Recién sincronizado todo cuadra; un bit
+    // cambiado por fuera se detecta en su chunk, al cargar y con VERIFY
+    BloomDB* v = bloomdb_open_mmap(path, BLOOMDB_MMAP_VERIFY);
+    assert(v && bloomdb_chunk_count(v) >= 1);
+    assert(bloomdb_verify(v, 0) && bloomdb_verify(v, 3));
+    bloomdb_free(v);
+
+    BloomDB* big = bloomdb_create((size_t)40 << 23, 3, 5);   // 40 MiB, 40 chunks
+    for (int i = 0; i < N; i++) assert(bloomdb_insert_u64(big, (uint64_t)i));
+    assert(bloomdb_save(big, "test_mmap_big.bloom"));
+    v = bloomdb_open_mmap("test_mmap_big.bloom", BLOOMDB_MMAP_WRITABLE);
+    const size_t chunks = bloomdb_chunk_count(v);
+    assert(chunks == 40);
+    assert(bloomdb_verify_ex(v, 4) == BLOOMDB_OK);
+    assert(header_flags("test_mmap_big.bloom") == 2);   // CRC atrasados mientras esté abierto
+    v->bitarray[(size_t)17 << 20] ^= 0x10;   // cambio sin pasar por sync
+    assert(bloomdb_verify_chunks_ex(v, 0, 17) == BLOOMDB_OK);
+    assert(bloomdb_verify_chunks_ex(v, 17, 1) == BLOOMDB_ERR_CHECKSUM);
+    assert(bloomdb_verify_chunks_ex(v, 18, chunks - 18) == BLOOMDB_OK);
+    assert(bloomdb_verify_ex(v, 0) == BLOOMDB_ERR_CHECKSUM);
+    assert(bloomdb_verify_ex(v, 1) == BLOOMDB_ERR_CHECKSUM);
+    assert(bloomdb_verify_chunks_ex(v, chunks, 1) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    // Con la marca, load no compara con la tabla y un mapeo de solo lectura
+    // no tiene CRC que verificar
+    BloomDB* bad = NULL;
+    assert(bloomdb_load_ex("test_mmap_big.bloom", &bad) == BLOOMDB_OK);
+    assert(memcmp(bad->bitarray, v->bitarray, v->byte_count) == 0);
+    bloomdb_free(bad);
+    assert(bloomdb_open_mmap_ex("test_mmap_big.bloom", BLOOMDB_MMAP_VERIFY, &bad) == BLOOMDB_OK);
+    assert(bloomdb_chunk_count(bad) == 0);
+    bloomdb_free(bad);
+    // sync rehace la tabla: el cambio pasa a ser legítimo
+    assert(bloomdb_sync(v) && bloomdb_verify(v, 0));
+    assert(header_flags("test_mmap_big.bloom") == 2);
+    bloomdb_free(v);
+    assert(header_flags("test_mmap_big.bloom") == 0);
+    assert(bloomdb_load_ex("test_mmap_big.bloom", &bad) == BLOOMDB_OK);
+    bloomdb_free(bad);
+
+    // Cerrado limpio: un bit cambiado por fuera se detecta al cargar y con
+    // VERIFY, también abriendo escribible (y el archivo no se toca)
+    FILE* f = fopen("test_mmap_big.bloom", "r+b");
+    assert(f && fseek(f, 4096 + (17 << 20), SEEK_SET) == 0);
+    int c = fgetc(f);
+    assert(fseek(f, 4096 + (17 << 20), SEEK_SET) == 0 && fputc(c ^ 0x10, f) != EOF);
+    fclose(f);
+    assert(bloomdb_load_ex("test_mmap_big.bloom", &bad) == BLOOMDB_ERR_CHECKSUM);
+    assert(bloomdb_open_mmap_ex("test_mmap_big.bloom", BLOOMDB_MMAP_VERIFY, &bad) == BLOOMDB_ERR_CHECKSUM);
+    assert(bloomdb_open_mmap_ex("test_mmap_big.bloom", BLOOMDB_MMAP_WRITABLE | BLOOMDB_MMAP_VERIFY, &bad) ==
+           BLOOMDB_ERR_CHECKSUM);
+    assert(header_flags("test_mmap_big.bloom") == 0);
+    assert(bloomdb_load_ex("test_mmap_big.bloom", &bad) == BLOOMDB_ERR_CHECKSUM);
+    assert(bloomdb_save(big, "test_mmap_big.bloom"));
+
+    // free sin sync deja la tabla al día
+    v = bloomdb_open_mmap("test_mmap_big.bloom", BLOOMDB_MMAP_WRITABLE);
+    assert(v && bloomdb_insert_u64(v, 424242));
+    bloomdb_free(v);
+    assert(header_flags("test_mmap_big.bloom") == 0);
+    assert(bloomdb_load_ex("test_mmap_big.bloom", &bad) == BLOOMDB_OK);
+    assert(bloomdb_might_contain_u64(bad, 424242));
+    bloomdb_free(bad);
+
+    // El proceso muere con el mapeo abierto: la marca se queda y load
+    // acepta el archivo; el siguiente mapeo escribible rehace la tabla
+    pid_t pid = fork();
+    assert(pid >= 0);
+    if (pid == 0) {
+        BloomDB* child = bloomdb_open_mmap("test_mmap_big.bloom", BLOOMDB_MMAP_WRITABLE);
+        if (!child || !bloomdb_insert_u64(child, 777777)) _exit(1);
+        _exit(0);
+    }
+    int status;
+    assert(waitpid(pid, &status, 0) == pid && WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    assert(header_flags("test_mmap_big.bloom") == 2);
+    assert(bloomdb_load_ex("test_mmap_big.bloom", &bad) == BLOOMDB_OK);
+    assert(bloomdb_might_contain_u64(bad, 777777) && bloomdb_might_contain_u64(bad, 424242));
+    bloomdb_free(bad);
+    v = bloomdb_open_mmap("test_mmap_big.bloom", BLOOMDB_MMAP_WRITABLE | BLOOMDB_MMAP_VERIFY);
+    assert(v && bloomdb_verify(v, 0));
+    bloomdb_free(v);
+    assert(header_flags("test_mmap_big.bloom") == 0);
+    v = bloomdb_open_mmap("test_mmap_big.bloom", BLOOMDB_MMAP_VERIFY);
+    assert(v && bloomdb_might_contain_u64(v, 777777));
+    bloomdb_free(v);
+
+    // Cabecera dañada: CHECKSUM tanto al cargar como al mapear
+    f = fopen("test_mmap_big.bloom", "r+b");
+    assert(f && fseek(f, 20, SEEK_SET) == 0 && fputc(0x7f, f) != EOF);
+    fclose(f);
+    assert(bloomdb_load_ex("test_mmap_big.bloom", &bad) == BLOOMDB_ERR_CHECKSUM);
+    assert(bloomdb_open_mmap_ex("test_mmap_big.bloom", 0, &bad) == BLOOMDB_ERR_CHECKSUM);
+    bloomdb_free(big);
+    unlink("test_mmap_big.bloom");
+
+    // Sin tabla de CRC (filtro del heap) no hay nada que verificar
+    assert(bloomdb_chunk_count(db) == 0);
+    assert(bloomdb_verify_ex(db, 0) == BLOOMDB_ERR_INVALID_ARGUMENT);
+
+    // Test 4: archivo v1 (cabecera nativa de 28 bytes): se mapea igual, pero
+    // sin alinear no hay modo concurrente ni CRC
+    f = fopen("test_mmap_v1.bloom", "wb");
+    assert(f);
+    fwrite(&db->bit_count,  sizeof(size_t),   1, f);
+    fwrite(&db->byte_count, sizeof(size_t),   1, f);
+    fwrite(&db->num_hashes, sizeof(int),      1, f);
+    fwrite(&db->seed,       sizeof(uint64_t), 1, f);
+    fwrite(db->bitarray, 1, db->byte_count, f);
+    uint32_t ext[4] = { 0x58424442u, 2, (uint32_t)db->hash_algo, (uint32_t)db->index_mode };
+    fwrite(ext, sizeof(uint32_t), 4, f);
+    fclose(f);
+    BloomDB* v1 = bloomdb_open_mmap("test_mmap_v1.bloom", 0);
+    assert(v1 && memcmp(v1->bitarray, db->bitarray, db->byte_count) == 0);
+    assert(v1->hash_algo == db->hash_algo && v1->index_mode == db->index_mode);
+    assert(bloomdb_set_concurrent_ex(v1, true) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_chunk_count(v1) == 0);
+    assert(bloomdb_verify_ex(v1, 0) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    bloomdb_free(v1);
+    assert(bloomdb_open_mmap_ex("test_mmap_v1.bloom", BLOOMDB_MMAP_VERIFY, &bad) == BLOOMDB_ERR_FORMAT);
+    unlink("test_mmap_v1.bloom");
+
+    // Test 5: archivos inválidos
+    assert(bloomdb_open_mmap_ex("nonexistent.bloom", 0, &ro) == BLOOMDB_ERR_FILE_IO);
+    assert(bloomdb_open_mmap("nonexistent.bloom", 0) == NULL);
+    assert(truncate(path, size - 100) == 0);   // bitarray cortado
+    assert(bloomdb_open_mmap_ex(path, 0, &ro) == BLOOMDB_ERR_FORMAT);
+    assert(truncate(path, 10) == 0);           // cabecera cortada
+    assert(bloomdb_open_mmap_ex(path, 0, &ro) == BLOOMDB_ERR_FORMAT);
+    BloomDBSplit* sf = bloomdb_split_create(1 << 12, 1);
+    assert(bloomdb_split_save(sf, path));
+    assert(bloomdb_open_mmap_ex(path, 0, &ro) == BLOOMDB_ERR_FORMAT);
+    bloomdb_split_free(sf);
+
+    // Test 6: argumentos inválidos
+    assert(bloomdb_open_mmap_ex(NULL, 0, &ro) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_open_mmap_ex(path, 0, NULL) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_open_mmap_ex(path, 1 << 10, &ro) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_sync_ex(db) == BLOOMDB_ERR_INVALID_ARGUMENT);   // filtro del heap
+    assert(bloomdb_sync_ex(NULL) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(!bloomdb_sync(db));
+
+    bloomdb_free(db);
+    unlink(path);
+
+    printf("✓ test_mmap: OK\n");
+    return 0;
+}
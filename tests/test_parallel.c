@@ -0,0 +1,87 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include "bloomdb.h"
+
+#define NKEYS 200000
+
+static char (*key_buf)[32];
+static const void* keys[NKEYS];
+static size_t lens[NKEYS];
+
+// Construye en serie y en paralelo con los mismos parámetros y compara bits
+static void check_identical(size_t bits, int k, int hash_algo, size_t n, int threads) {
+    BloomDB* serial = bloomdb_create(bits, k, 11);
+    BloomDB* par = bloomdb_create(bits, k, 11);
+    assert(serial && par);
+    serial->hash_algo = hash_algo;
+    par->hash_algo = hash_algo;
+
+    for (size_t i = 0; i < n; i++) assert(bloomdb_insert(serial, keys[i], lens[i]));
+    assert(bloomdb_build_parallel_ex(par, keys, lens, n, threads) == BLOOMDB_OK);
+
+    assert(memcmp(serial->bitarray, par->bitarray, serial->byte_count) == 0);
+    assert(par->concurrent == 0);   // el modo del llamador no cambia
+    for (size_t i = 0; i < n; i += 101) assert(bloomdb_might_contain(par, keys[i], lens[i]));
+
+    bloomdb_free(serial);
+    bloomdb_free(par);
+}
+
+int main(void) {
+    printf("== test_parallel ==\n");
+
+    key_buf = malloc(sizeof(*key_buf) * NKEYS);
+    assert(key_buf != NULL);
+    for (int i = 0; i < NKEYS; i++) {
+        snprintf(key_buf[i], sizeof(key_buf[i]), "parallel-%d", i * 7919);
+        keys[i] = key_buf[i];
+        lens[i] = strlen(key_buf[i]);
+    }
+
+    // Test 1: argumentos inválidos; el lote se valida antes de insertar nada
+    BloomDB* db = bloomdb_create(100000, 5, 1);
+    assert(bloomdb_build_parallel_ex(NULL, keys, lens, 10, 2) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_build_parallel_ex(db, NULL, lens, 10, 2) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_build_parallel_ex(db, keys, NULL, 10, 2) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_build_parallel_ex(db, NULL, NULL, 0, 2) == BLOOMDB_OK);
+
+    size_t saved_len = lens[NKEYS - 1];
+    lens[NKEYS - 1] = 0;
+    assert(!bloomdb_build_parallel(db, keys, lens, NKEYS, 4));
+    lens[NKEYS - 1] = saved_len;
+    assert(bloomdb_count_set_bits(db) == 0);
+    bloomdb_free(db);
+
+    // Test 2: idéntico bit a bit al build en serie para varios hilos
+    // (incluido el automático), k especializado y genérico, y tamaños que
+    // no son múltiplo de 64 bits
+    const int threads[] = { 1, 2, 3, 8, 0 };
+    for (int t = 0; t < 5; t++) {
+        check_identical(2000003, 7, BLOOMDB_HASH_MURMUR3, NKEYS, threads[t]);
+    }
+    check_identical(1 << 20, 3, BLOOMDB_HASH_MURMUR3, NKEYS, 4);
+    check_identical(100001, 20, BLOOMDB_HASH_MURMUR3, NKEYS, 5);
+
+    // Test 3: pocas claves (un solo hilo efectivo) y filtros legacy
+    check_identical(5000, 4, BLOOMDB_HASH_MURMUR3, 37, 8);
+    check_identical(500009, 5, BLOOMDB_HASH_LEGACY, 50000, 4);
+
+    // Test 4: sobre un filtro con contenido previo y en modo concurrente
+    BloomDB* a = bloomdb_create(300007, 6, 2);
+    BloomDB* b = bloomdb_create(300007, 6, 2);
+    assert(bloomdb_insert(a, "previa", 6) && bloomdb_insert(b, "previa", 6));
+    assert(bloomdb_set_concurrent(b, true));
+    for (int i = 0; i < NKEYS; i++) assert(bloomdb_insert(a, keys[i], lens[i]));
+    assert(bloomdb_build_parallel(b, keys, lens, NKEYS, 6));
+    assert(b->concurrent == 1);
+    assert(memcmp(a->bitarray, b->bitarray, a->byte_count) == 0);
+    bloomdb_free(a);
+    bloomdb_free(b);
+
+    free(key_buf);
+    printf("✓ test_parallel: OK\n");
+    return 0;
+}
@@ -0,0 +1,114 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <unistd.h>
+
+#include "bloom_partitioned.h"
+#include "hash64.h"
+#include "storage.h"
+
+static size_t slice_popcount(const BloomDBPartitioned* pf, int slice) {
+    size_t words = pf->slice_bits / 64;
+    size_t count = 0;
+    for (size_t i = 0; i < words; i++) {
+        count += (size_t)__builtin_popcountll(pf->words[(size_t)slice * words + i]);
+    }
+    return count;
+}
+
+int main(void) {
+    printf("== test_partitioned ==\n");
+
+    // Test 1: argumentos inválidos
+    BloomDBPartitioned* pf = NULL;
+    assert(bloomdb_partitioned_create_ex(0, 4, 1, &pf) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_partitioned_create_ex(1000, 0, 1, &pf) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_partitioned_create_ex(1000, BLOOMDB_PARTITIONED_MAX_HASHES + 1, 1, &pf) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_partitioned_create_ex(1000, 4, 1, NULL) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(pf == NULL);
+
+    // Test 2: las particiones se redondean a potencia de 2 (>= 64)
+    pf = bloomdb_partitioned_create(1000, 7, 1);
+    assert(pf != NULL);
+    assert(pf->slice_bits == 256 && pf->bit_count == 7 * 256);
+    bloomdb_partitioned_free(pf);
+    pf = bloomdb_partitioned_create(10, 3, 1);
+    assert(pf->slice_bits == 64);
+    bloomdb_partitioned_free(pf);
+    pf = bloomdb_partitioned_create(8 * 4096, 8, 1);
+    assert(pf->slice_bits == 4096 && pf->bit_count == 8 * 4096);
+    bloomdb_partitioned_free(pf);
+
+    // Test 3: cada clave pone exactamente un bit en cada partición, en la
+    // posición (h1 + i*h2) & (slice_bits - 1) de la partición i
+    pf = bloomdb_partitioned_create(8 * (1 << 16), 8, 42);
+    assert(pf->slice_bits == (1 << 16));
+    const char* key = "partitioned-key";
+    assert(bloomdb_partitioned_insert(pf, key, strlen(key)));
+    hash128_t h = hash128(key, strlen(key), 42);
+    for (int i = 0; i < 8; i++) {
+        assert(slice_popcount(pf, i) == 1);
+        size_t bit = (size_t)i * pf->slice_bits + ((h.h1 + (uint64_t)i * h.h2) & (pf->slice_bits - 1));
+        assert(pf->words[bit >> 6] & (1ULL << (bit & 63)));
+    }
+    assert(bloomdb_partitioned_might_contain(pf, key, strlen(key)));
+
+    // Test 4: sin falsos negativos; FPR cerca de (1 - e^(-n/s))^k
+    const int n = 50000;
+    char buf[48];
+    for (int i = 0; i < n; i++) {
+        snprintf(buf, sizeof(buf), "user-%d", i);
+        assert(bloomdb_partitioned_insert(pf, buf, strlen(buf)));
+    }
+    for (int i = 0; i < n; i++) {
+        snprintf(buf, sizeof(buf), "user-%d", i);
+        assert(bloomdb_partitioned_might_contain(pf, buf, strlen(buf)));
+    }
+    int fp = 0;
+    const int trials = 200000;
+    for (int i = 0; i < trials; i++) {
+        snprintf(buf, sizeof(buf), "other-%d", i);
+        fp += bloomdb_partitioned_might_contain(pf, buf, strlen(buf));
+    }
+    // n/s = 50001/65536 -> (1 - e^-0.763)^8 ≈ 0.0062
+    double rate = (double)fp / trials;
+    printf("   FPR medido = %.4f%% (teórico ~0.62%%)\n", 100.0 * rate);
+    assert(rate > 0.004 && rate < 0.009);
+
+    // Test 5: guardar y cargar
+    const char* path = "test_partitioned.bloom";
+    assert(bloomdb_partitioned_save(pf, path));
+    BloomDBPartitioned* loaded = NULL;
+    assert(bloomdb_partitioned_load_ex(path, &loaded) == BLOOMDB_OK);
+    assert(loaded->slice_bits == pf->slice_bits && loaded->bit_count == pf->bit_count);
+    assert(loaded->num_hashes == pf->num_hashes && loaded->seed == pf->seed);
+    assert(memcmp(loaded->words, pf->words, pf->bit_count / 8) == 0);
+    for (int i = 0; i < n; i += 17) {
+        snprintf(buf, sizeof(buf), "user-%d", i);
+        assert(bloomdb_partitioned_might_contain(loaded, buf, strlen(buf)));
+    }
+
+    // Test 6: formato incorrecto y argumentos inválidos
+    BloomDBPartitioned* wrong = NULL;
+    BloomDB* plain = bloomdb_create(1000, 3, 1);
+    assert(bloomdb_save(plain, path));
+    assert(bloomdb_partitioned_load_ex(path, &wrong) == BLOOMDB_ERR_FORMAT);
+    assert(wrong == NULL);
+    assert(bloomdb_partitioned_load_ex("nonexistent.bloom", &wrong) == BLOOMDB_ERR_FILE_IO);
+    assert(bloomdb_partitioned_load("nonexistent.bloom") == NULL);
+    assert(bloomdb_partitioned_insert_ex(pf, NULL, 1) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_partitioned_insert_ex(pf, "k", 0) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    bool result;
+    assert(bloomdb_partitioned_might_contain_ex(pf, "k", 1, NULL) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_partitioned_might_contain_ex(NULL, "k", 1, &result) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_partitioned_save_ex(NULL, path) == BLOOMDB_ERR_INVALID_ARGUMENT);
+
+    bloomdb_free(plain);
+    bloomdb_partitioned_free(pf);
+    bloomdb_partitioned_free(loaded);
+    unlink(path);
+
+    printf("✓ test_partitioned: OK\n");
+    return 0;
+}
@@ -0,0 +1,174 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <unistd.h>
+
+#include "bloom_range.h"
+#include "storage.h"
+
+#define N 20000
+#define LEVELS 20
+
+static uint64_t rng_state = 0x9e3779b97f4a7c15ULL;
+
+static uint64_t next_rand(void) {
+    uint64_t x = rng_state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return rng_state = x;
+}
+
+static int cmp_u64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+// ¿Hay alguna clave de sorted[0..n) en [lo, hi]?
+static bool truth(const uint64_t* sorted, size_t n, uint64_t lo, uint64_t hi) {
+    size_t a = 0, b = n;
+    while (a < b) {
+        size_t mid = a + (b - a) / 2;
+        if (sorted[mid] < lo) a = mid + 1;
+        else b = mid;
+    }
+    return a < n && sorted[a] <= hi;
+}
+
+// Rangos vacíos de ancho width que dan positivo, sobre trials intentos
+static double empty_range_rate(const BloomDBRange* rf, const uint64_t* sorted, size_t n,
+                               uint64_t base, uint64_t span, uint64_t width, int trials) {
+    int fp = 0, empty = 0;
+    for (int i = 0; i < trials; i++) {
+        uint64_t lo = base + next_rand() % span;
+        uint64_t hi = lo + width - 1;
+        if (truth(sorted, n, lo, hi)) continue;
+        empty++;
+        fp += bloomdb_range_might_contain_range(rf, lo, hi);
+    }
+    assert(empty > trials / 2);
+    return (double)fp / empty;
+}
+
+int main(void) {
+    printf("== test_range ==\n");
+
+    // Test 1: argumentos inválidos
+    BloomDBRange* rf = NULL;
+    assert(bloomdb_range_create_ex(1 << 20, 7, 0, 1, &rf) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_range_create_ex(1 << 20, 7, BLOOMDB_RANGE_MAX_LEVELS + 1, 1, &rf) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_range_create_ex(0, 7, 8, 1, &rf) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_range_create_ex(1 << 20, 7, 8, 1, NULL) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(rf == NULL);
+
+    // Claves: la mitad al azar en todo el dominio, la otra mitad en 100
+    // grupos de 100 claves con huecos de 1 a 64
+    uint64_t* keys = malloc(N * sizeof(uint64_t));
+    for (int i = 0; i < N / 2; i++) keys[i] = next_rand();
+    for (int c = 0, i = N / 2; c < 100; c++) {
+        uint64_t x = next_rand() >> 8;
+        for (int j = 0; j < N / 200; j++, i++) keys[i] = x += 1 + next_rand() % 64;
+    }
+
+    rf = bloomdb_range_create((size_t)N * LEVELS * 10, 7, LEVELS, 42);
+    assert(rf->levels == LEVELS);
+    for (int i = 0; i < N; i++) assert(bloomdb_range_insert(rf, keys[i]));
+    assert(rf->count == N);
+    qsort(keys, N, sizeof(uint64_t), cmp_u64);
+
+    // Test 2: sin falsos negativos (puntos y rangos alrededor de cada clave)
+    for (int i = 0; i < N; i++) {
+        uint64_t k = keys[i];
+        assert(bloomdb_range_might_contain(rf, k));
+        assert(bloomdb_range_might_contain_range(rf, k, k));
+        uint64_t below = next_rand() % 5000, above = next_rand() % 5000;
+        uint64_t lo = k > below ? k - below : 0;
+        uint64_t hi = k < UINT64_MAX - above ? k + above : UINT64_MAX;
+        assert(bloomdb_range_might_contain_range(rf, lo, hi));
+    }
+    assert(bloomdb_range_might_contain_range(rf, 0, UINT64_MAX));
+    assert(bloomdb_range_might_contain_range(rf, keys[N - 1], UINT64_MAX));
+    assert(bloomdb_range_might_contain_range(rf, 0, keys[0]));
+
+    // Test 3: rangos vacíos al azar; el descenso mantiene el FPR de un rango
+    // cerca del de una consulta puntual
+    double point = empty_range_rate(rf, keys, N, 0, UINT64_MAX, 1, 200000);
+    double r100 = empty_range_rate(rf, keys, N, 0, UINT64_MAX, 100, 200000);
+    double r64k = empty_range_rate(rf, keys, N, 0, UINT64_MAX, 65536, 200000);
+    printf("   FPR aleatorio: punto %.3f%%, ancho 100 %.3f%%, ancho 2^16 %.3f%%\n",
+           100 * point, 100 * r100, 100 * r64k);
+    assert(point < 0.02 && r100 < 0.02 && r64k < 0.02);
+
+    // Test 4: rangos vacíos entre claves agrupadas (los prefijos altos sí
+    // están: solo el descenso los descarta)
+    int fp = 0, empty = 0;
+    for (int i = 0; i < N - 1; i++) {
+        if (keys[i + 1] - keys[i] < 3 || keys[i + 1] - keys[i] > 64) continue;
+        empty++;
+        fp += bloomdb_range_might_contain_range(rf, keys[i] + 1, keys[i + 1] - 1);
+    }
+    printf("   FPR en huecos de grupos: %.3f%% (%d huecos)\n", 100.0 * fp / empty, empty);
+    assert(empty > N / 4 && (double)fp / empty < 0.05);
+
+    // Test 5: rango más ancho que los niveles guardados -> true conservador
+    BloomDBRange* small = bloomdb_range_create(1 << 16, 5, 4, 1);
+    assert(bloomdb_range_insert(small, 1ULL << 40));
+    assert(!bloomdb_range_might_contain_range(small, 0, 15));
+    assert(bloomdb_range_might_contain_range(small, 0, 1ULL << 50));
+    assert(bloomdb_range_might_contain_range(small, (1ULL << 40) - 1000, (1ULL << 40) + 1000));
+    bloomdb_range_free(small);
+
+    // Test 6: rangos que acaban en UINT64_MAX (el último par de hijos no da
+    // la vuelta hasta la clave 0)
+    BloomDBRange* edge = bloomdb_range_create(1 << 16, 5, 4, 1);
+    assert(bloomdb_range_insert(edge, 0));
+    assert(bloomdb_insert_u128(edge->db, UINT64_MAX >> 1, 1)); // falso positivo forzado en el nivel 1
+    assert(!bloomdb_range_might_contain_range(edge, UINT64_MAX - 1, UINT64_MAX));
+    assert(!bloomdb_range_might_contain_range(edge, UINT64_MAX, UINT64_MAX));
+    assert(!bloomdb_range_might_contain_range(edge, UINT64_MAX - 15, UINT64_MAX));
+    assert(bloomdb_range_insert(edge, UINT64_MAX));
+    assert(bloomdb_range_might_contain_range(edge, UINT64_MAX, UINT64_MAX));
+    assert(bloomdb_range_might_contain_range(edge, UINT64_MAX - 1, UINT64_MAX));
+    assert(bloomdb_range_might_contain_range(edge, UINT64_MAX - 15, UINT64_MAX));
+    bloomdb_range_free(edge);
+
+    // Test 7: guardar y cargar
+    const char* path = "test_range.bloom";
+    assert(bloomdb_range_save(rf, path));
+    BloomDBRange* loaded = NULL;
+    assert(bloomdb_range_load_ex(path, &loaded) == BLOOMDB_OK);
+    assert(loaded->levels == rf->levels && loaded->count == rf->count);
+    assert(loaded->db->bit_count == rf->db->bit_count && loaded->db->num_hashes == rf->db->num_hashes);
+    assert(loaded->db->seed == rf->db->seed && loaded->db->index_mode == rf->db->index_mode);
+    assert(memcmp(loaded->db->bitarray, rf->db->bitarray, rf->db->byte_count) == 0);
+    for (int i = 0; i < 10000; i++) {
+        uint64_t lo = next_rand(), hi = lo + next_rand() % 100000;
+        if (hi < lo) hi = UINT64_MAX;
+        assert(bloomdb_range_might_contain_range(loaded, lo, hi) == bloomdb_range_might_contain_range(rf, lo, hi));
+    }
+
+    // Test 8: formato incorrecto y argumentos inválidos
+    BloomDBRange* wrong = NULL;
+    BloomDB* plain = bloomdb_create(1000, 3, 1);
+    assert(bloomdb_save(plain, path));
+    assert(bloomdb_range_load_ex(path, &wrong) == BLOOMDB_ERR_FORMAT);
+    assert(wrong == NULL);
+    assert(bloomdb_range_load_ex("nonexistent.bloom", &wrong) == BLOOMDB_ERR_FILE_IO);
+    assert(bloomdb_range_load("nonexistent.bloom") == NULL);
+    bool result;
+    assert(bloomdb_range_might_contain_range_ex(rf, 10, 9, &result) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_range_might_contain_range_ex(rf, 1, 9, NULL) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_range_might_contain_ex(NULL, 1, &result) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_range_insert_ex(NULL, 1) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_range_save_ex(NULL, path) == BLOOMDB_ERR_INVALID_ARGUMENT);
+
+    bloomdb_free(plain);
+    bloomdb_range_free(rf);
+    bloomdb_range_free(loaded);
+    free(keys);
+    unlink(path);
+
+    printf("✓ test_range: OK\n");
+    return 0;
+}
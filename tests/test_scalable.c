@@ -0,0 +1,120 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <unistd.h>
+
+#include "bloom_scalable.h"
+#include "storage.h"
+
+int main(void) {
+    printf("== test_scalable ==\n");
+
+    // Test 1: argumentos inválidos
+    BloomDBScalable* sf = NULL;
+    assert(bloomdb_scalable_create_ex(0, 0.01, 1, &sf) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_scalable_create_ex(1000, 0.0, 1, &sf) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_scalable_create_ex(1000, 1.0, 1, &sf) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_scalable_create_ex(1000, 0.01, 1, NULL) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(sf == NULL);
+
+    // Test 2: empieza con una slice dimensionada para su capacidad
+    sf = bloomdb_scalable_create(1000, 0.01, 7);
+    assert(sf != NULL);
+    assert(sf->slice_count == 1);
+    // p0 = 0.01 * 0.15 = 0.0015 -> k = 10, ~13.5 bits por clave
+    assert(sf->slices[0]->num_hashes == 10);
+    assert(sf->slices[0]->bit_count > 13000 && sf->slices[0]->bit_count < 14000);
+    assert(bloomdb_scalable_fpr_bound(sf) < 0.01);
+
+    // Test 3: 200x la capacidad inicial; crece sin falsos negativos y cada
+    // slice es más grande y más estricta que la anterior
+    const int n = 200000;
+    char buf[48];
+    for (int i = 0; i < n; i++) {
+        snprintf(buf, sizeof(buf), "user-%d", i);
+        assert(bloomdb_scalable_insert(sf, buf, strlen(buf)));
+    }
+    printf("   slices tras %d claves: %zu\n", n, sf->slice_count);
+    assert(sf->slice_count >= 7 && sf->slice_count <= 9);
+    for (size_t i = 1; i < sf->slice_count; i++) {
+        assert(sf->slices[i]->bit_count > sf->slices[i - 1]->bit_count);
+        assert(sf->slices[i]->num_hashes >= sf->slices[i - 1]->num_hashes);
+        assert(sf->slices[i]->seed == sf->seed);
+    }
+    // Las slices llenas se cerraron cerca del 50% de ocupación
+    for (size_t i = 0; i + 1 < sf->slice_count; i++) {
+        double fill = (double)bloomdb_count_set_bits(sf->slices[i]) / sf->slices[i]->bit_count;
+        assert(fill >= 0.5 && fill < 0.505);
+    }
+    for (int i = 0; i < n; i++) {
+        snprintf(buf, sizeof(buf), "user-%d", i);
+        assert(bloomdb_scalable_might_contain(sf, buf, strlen(buf)));
+    }
+
+    // Test 4: el FPR compuesto queda por debajo de la cota
+    int fp = 0;
+    for (int i = 0; i < n; i++) {
+        snprintf(buf, sizeof(buf), "other-%d", i);
+        fp += bloomdb_scalable_might_contain(sf, buf, strlen(buf));
+    }
+    double bound = bloomdb_scalable_fpr_bound(sf);
+    printf("   FPR medido = %.4f%%, cota = %.4f%%\n", 100.0 * fp / n, 100.0 * bound);
+    assert(bound < 0.01);
+    assert((double)fp / n < 0.01);
+
+    // Test 5: claves repetidas no ponen bits ni hacen crecer la cadena
+    size_t slices_before = sf->slice_count;
+    for (int r = 0; r < 50; r++) {
+        for (int i = 0; i < 1000; i++) {
+            snprintf(buf, sizeof(buf), "user-%d", n - 1 - i);
+            assert(bloomdb_scalable_insert(sf, buf, strlen(buf)));
+        }
+    }
+    assert(sf->slice_count == slices_before);
+
+    // Test 6: la cadena entera en un archivo
+    const char* path = "test_scalable.bloom";
+    assert(bloomdb_scalable_save(sf, path));
+    BloomDBScalable* loaded = NULL;
+    assert(bloomdb_scalable_load_ex(path, &loaded) == BLOOMDB_OK);
+    assert(loaded->slice_count == sf->slice_count);
+    assert(loaded->fpr == sf->fpr && loaded->seed == sf->seed);
+    assert(loaded->inserted == sf->inserted && loaded->next_check == sf->next_check);
+    for (size_t i = 0; i < sf->slice_count; i++) {
+        assert(loaded->slices[i]->bit_count == sf->slices[i]->bit_count);
+        assert(loaded->slices[i]->index_mode == sf->slices[i]->index_mode);
+        assert(memcmp(loaded->slices[i]->bitarray, sf->slices[i]->bitarray, sf->slices[i]->byte_count) == 0);
+    }
+    for (int i = 0; i < n; i += 37) {
+        snprintf(buf, sizeof(buf), "user-%d", i);
+        assert(bloomdb_scalable_might_contain(loaded, buf, strlen(buf)));
+    }
+    // La copia cargada sigue creciendo igual que la original
+    for (int i = n; i < 2 * n; i++) {
+        snprintf(buf, sizeof(buf), "user-%d", i);
+        assert(bloomdb_scalable_insert(sf, buf, strlen(buf)));
+        assert(bloomdb_scalable_insert(loaded, buf, strlen(buf)));
+    }
+    assert(loaded->slice_count == sf->slice_count);
+
+    // Test 7: formato incorrecto y argumentos inválidos
+    BloomDBScalable* wrong = NULL;
+    BloomDB* plain = bloomdb_create(1000, 3, 1);
+    assert(bloomdb_save(plain, path));
+    assert(bloomdb_scalable_load_ex(path, &wrong) == BLOOMDB_ERR_FORMAT);
+    assert(wrong == NULL);
+    assert(bloomdb_scalable_load_ex("nonexistent.bloom", &wrong) == BLOOMDB_ERR_FILE_IO);
+    assert(bloomdb_scalable_insert_ex(sf, NULL, 1) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    bool result;
+    assert(bloomdb_scalable_might_contain_ex(sf, "k", 1, NULL) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_scalable_might_contain_ex(NULL, "k", 1, &result) == BLOOMDB_ERR_INVALID_ARGUMENT);
+
+    bloomdb_free(plain);
+    bloomdb_scalable_free(sf);
+    bloomdb_scalable_free(loaded);
+    unlink(path);
+
+    printf("✓ test_scalable: OK\n");
+    return 0;
+}
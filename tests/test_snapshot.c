@@ -0,0 +1,128 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "bloomdb.h"
+#include "storage.h"
+
+#define N 20000
+
+static const char* PATH = "test_snapshot.bloom";
+
+typedef struct {
+    pthread_mutex_t lock;
+    int calls;
+    BloomDBError status;
+    char path[64];
+} CallbackLog;
+
+static void on_snapshot(BloomDBError status, const char* path, void* user) {
+    CallbackLog* cl = (CallbackLog*)user;
+    pthread_mutex_lock(&cl->lock);
+    cl->calls++;
+    cl->status = status;
+    snprintf(cl->path, sizeof(cl->path), "%s", path);
+    pthread_mutex_unlock(&cl->lock);
+}
+
+static int callback_calls(CallbackLog* cl) {
+    pthread_mutex_lock(&cl->lock);
+    int calls = cl->calls;
+    pthread_mutex_unlock(&cl->lock);
+    return calls;
+}
+
+int main(void) {
+    printf("== test_snapshot ==\n");
+    CallbackLog cl = { PTHREAD_MUTEX_INITIALIZER, 0, BLOOMDB_OK, "" };
+
+    // Test 1: el hilo principal sigue insertando mientras se escribe. El
+    // snapshot tiene todo lo anterior a la llamada y sus CRC cuadran. Sin
+    // modo concurrente no se admite (carrera con las inserciones)
+    BloomDB* db = bloomdb_create((size_t)64 << 23, 7, 11);   // 64 MiB, 64 chunks
+    for (uint64_t i = 0; i < N; i++) assert(bloomdb_insert_u64(db, i));
+    BloomDBSnapshot* snap = NULL;
+    assert(bloomdb_snapshot_async_ex(db, PATH, NULL, NULL, &snap) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_snapshot_scheduler_start(db, PATH, 5, NULL, NULL) == NULL);
+    assert(bloomdb_set_concurrent(db, true));
+    snap = bloomdb_snapshot_async(db, PATH, on_snapshot, &cl);
+    assert(snap);
+    for (uint64_t i = N; i < 50 * N; i++) assert(bloomdb_insert_u64(db, i));
+    assert(bloomdb_snapshot_wait_ex(snap) == BLOOMDB_OK);
+    assert(cl.calls == 1 && cl.status == BLOOMDB_OK && strcmp(cl.path, PATH) == 0);
+    assert(access("test_snapshot.bloom.tmp", F_OK) != 0);
+
+    BloomDB* loaded = NULL;
+    assert(bloomdb_load_ex(PATH, &loaded) == BLOOMDB_OK);
+    for (uint64_t i = 0; i < N; i++) assert(bloomdb_might_contain_u64(loaded, i));
+    // Nada que no esté también en el filtro vivo
+    for (size_t i = 0; i < db->byte_count; i++) assert((loaded->bitarray[i] & ~db->bitarray[i]) == 0);
+    bloomdb_free(loaded);
+
+    // Sin inserciones simultáneas es idéntico a bloomdb_save
+    assert(bloomdb_snapshot_wait(bloomdb_snapshot_async(db, PATH, NULL, NULL)));
+    loaded = bloomdb_load(PATH);
+    assert(loaded && memcmp(loaded->bitarray, db->bitarray, db->byte_count) == 0);
+    bloomdb_free(loaded);
+    bloomdb_free(db);
+
+    // Test 2: modo concurrente con varios hilos insertando (el filtro
+    // pequeño: sin alinear el final a palabras de 8 bytes)
+    db = bloomdb_create(N * 10 + 3, 5, 12);
+    assert(bloomdb_set_concurrent(db, true));
+    for (uint64_t i = 0; i < N; i++) assert(bloomdb_insert_u64(db, i));
+    snap = bloomdb_snapshot_async(db, PATH, NULL, NULL);
+    for (uint64_t i = N; i < 2 * N; i++) assert(bloomdb_insert_u64(db, i));
+    assert(bloomdb_snapshot_wait(snap));
+    loaded = bloomdb_load(PATH);
+    assert(loaded && loaded->bit_count == db->bit_count);
+    for (uint64_t i = 0; i < N; i++) assert(bloomdb_might_contain_u64(loaded, i));
+    bloomdb_free(loaded);
+
+    // Test 3: error de escritura -> callback y wait con FILE_IO, path intacto
+    cl.calls = 0;
+    snap = bloomdb_snapshot_async(db, "no-such-dir/snap.bloom", on_snapshot, &cl);
+    assert(snap);
+    assert(bloomdb_snapshot_wait_ex(snap) == BLOOMDB_ERR_FILE_IO);
+    assert(cl.calls == 1 && cl.status == BLOOMDB_ERR_FILE_IO);
+
+    // Test 4: snapshots periódicos
+    cl.calls = 0;
+    BloomDBSnapshotScheduler* sched = bloomdb_snapshot_scheduler_start(db, PATH, 5, on_snapshot, &cl);
+    assert(sched);
+    for (uint64_t i = 2 * N; i < 3 * N; i++) assert(bloomdb_insert_u64(db, i));
+    for (int t = 0; t < 400 && callback_calls(&cl) < 3; t++) usleep(5000);
+    assert(callback_calls(&cl) >= 3);
+    assert(bloomdb_snapshot_scheduler_stop_ex(sched) == BLOOMDB_OK);
+    const int calls = callback_calls(&cl);
+    usleep(20000);
+    assert(callback_calls(&cl) == calls);   // parado de verdad
+    loaded = bloomdb_load(PATH);
+    assert(loaded);
+    for (uint64_t i = 0; i < N; i++) assert(bloomdb_might_contain_u64(loaded, i));
+    bloomdb_free(loaded);
+
+    // stop antes del primer intervalo: ningún snapshot
+    cl.calls = 0;
+    sched = bloomdb_snapshot_scheduler_start(db, PATH, 60000, on_snapshot, &cl);
+    assert(sched);
+    bloomdb_snapshot_scheduler_stop(sched);
+    assert(cl.calls == 0);
+
+    // Test 5: argumentos inválidos
+    assert(bloomdb_snapshot_async_ex(NULL, PATH, NULL, NULL, &snap) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_snapshot_async_ex(db, NULL, NULL, NULL, &snap) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_snapshot_async_ex(db, PATH, NULL, NULL, NULL) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_snapshot_wait_ex(NULL) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_snapshot_scheduler_start_ex(db, PATH, 0, NULL, NULL, &sched) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_snapshot_scheduler_stop_ex(NULL) == BLOOMDB_ERR_INVALID_ARGUMENT);
+
+    bloomdb_free(db);
+    unlink(PATH);
+
+    printf("✓ test_snapshot: OK\n");
+    return 0;
+}
@@ -0,0 +1,129 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <unistd.h>
+
+#include "bloom_split.h"
+#include "hash64.h"
+#include "storage.h"
+
+// Referencia independiente del layout: bloque por fastrange(h1) y un bit por
+// palabra a partir de (uint32_t)h2 * sal >> 27
+static const uint32_t SALT[8] = {
+    0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+    0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U
+};
+
+static void reference_insert(uint32_t* blocks, size_t block_count, const void* key, size_t len, uint64_t seed) {
+    hash128_t h = hash128(key, len, seed);
+    size_t block = (size_t)(((unsigned __int128)h.h1 * block_count) >> 64);
+    uint32_t key32 = (uint32_t)h.h2;
+    for (int w = 0; w < 8; w++) {
+        blocks[block * 8 + w] |= 1U << ((key32 * SALT[w]) >> 27);
+    }
+}
+
+int main(void) {
+    printf("== test_split ==\n");
+
+    // Test 1: argumentos inválidos
+    BloomDBSplit* sf = NULL;
+    assert(bloomdb_split_create_ex(0, 1, &sf) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_split_create_ex(4096, 1, NULL) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(sf == NULL);
+
+    // Test 2: tamaño redondeado a bloques de 256 bits y alineado a 32 bytes
+    sf = bloomdb_split_create(1000, 42);
+    assert(sf != NULL);
+    assert(sf->block_count == 4);
+    assert(sf->bit_count == 1024);
+    assert(((uintptr_t)sf->blocks & 31) == 0);
+    bloomdb_split_free(sf);
+
+    // Test 3: una clave pone exactamente un bit en cada palabra de un bloque
+    sf = bloomdb_split_create(256 * 64, 42);
+    assert(sf != NULL);
+    assert(bloomdb_split_insert(sf, "single-key", strlen("single-key")));
+    int blocks_touched = 0;
+    for (size_t b = 0; b < sf->block_count; b++) {
+        const uint32_t* words = sf->blocks + b * BLOOMDB_SPLIT_BLOCK_WORDS;
+        int c = 0;
+        for (int w = 0; w < BLOOMDB_SPLIT_BLOCK_WORDS; w++) c += __builtin_popcount(words[w]);
+        if (c) {
+            blocks_touched++;
+            for (int w = 0; w < BLOOMDB_SPLIT_BLOCK_WORDS; w++) {
+                assert(__builtin_popcount(words[w]) == 1);
+            }
+        }
+    }
+    assert(blocks_touched == 1);
+    bloomdb_split_free(sf);
+
+    // Test 4: los bits coinciden con la fórmula de referencia (el camino
+    // SIMD, si se usa, debe dar exactamente lo mismo que el escalar)
+    const int n = 20000;
+    const uint64_t seed = 1234;
+    sf = bloomdb_split_create((size_t)n * 10, seed);
+    assert(sf != NULL);
+    uint32_t* ref = calloc(sf->block_count * BLOOMDB_SPLIT_BLOCK_WORDS, sizeof(uint32_t));
+    assert(ref != NULL);
+    char buf[48];
+    for (int i = 0; i < n; i++) {
+        snprintf(buf, sizeof(buf), "user-%d@example.com", i);
+        assert(bloomdb_split_insert(sf, buf, strlen(buf)));
+        reference_insert(ref, sf->block_count, buf, strlen(buf), seed);
+    }
+    assert(memcmp(ref, sf->blocks, sf->block_count * 32) == 0);
+    free(ref);
+
+    // Test 5: sin falsos negativos y FPR razonable (10 bits/clave: ~1.3%)
+    for (int i = 0; i < n; i++) {
+        snprintf(buf, sizeof(buf), "user-%d@example.com", i);
+        assert(bloomdb_split_might_contain(sf, buf, strlen(buf)));
+    }
+    int fp = 0;
+    for (int i = 0; i < n; i++) {
+        snprintf(buf, sizeof(buf), "other-%d@example.org", i);
+        fp += bloomdb_split_might_contain(sf, buf, strlen(buf));
+    }
+    printf("   FPR (10 bits/clave, k=8) = %.3f%%\n", 100.0 * fp / n);
+    assert(fp < n / 40);   // < 2.5%
+
+    // Test 6: argumentos inválidos en insert/might_contain
+    bool result;
+    assert(bloomdb_split_insert_ex(NULL, "k", 1) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_split_insert_ex(sf, NULL, 1) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_split_insert_ex(sf, "k", 0) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_split_might_contain_ex(sf, "k", 1, NULL) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_split_might_contain_ex(NULL, "k", 1, &result) == BLOOMDB_ERR_INVALID_ARGUMENT);
+
+    // Test 7: save/load
+    const char* path = "test_split.bloom";
+    assert(bloomdb_split_save(sf, path));
+    BloomDBSplit* loaded = NULL;
+    assert(bloomdb_split_load_ex(path, &loaded) == BLOOMDB_OK);
+    assert(loaded->block_count == sf->block_count);
+    assert(loaded->seed == sf->seed);
+    assert(memcmp(loaded->blocks, sf->blocks, sf->block_count * 32) == 0);
+    for (int i = 0; i < n; i += 97) {
+        snprintf(buf, sizeof(buf), "user-%d@example.com", i);
+        assert(bloomdb_split_might_contain(loaded, buf, strlen(buf)));
+    }
+
+    // Test 8: un filtro bloqueado no es un split-block
+    BloomDBBlocked* blocked = bloomdb_blocked_create(4096, 7, 1);
+    assert(bloomdb_blocked_save(blocked, path));
+    BloomDBSplit* wrong = NULL;
+    assert(bloomdb_split_load_ex(path, &wrong) == BLOOMDB_ERR_FORMAT);
+    assert(wrong == NULL);
+    assert(bloomdb_split_load_ex("nonexistent.bloom", &wrong) == BLOOMDB_ERR_FILE_IO);
+
+    bloomdb_blocked_free(blocked);
+    bloomdb_split_free(sf);
+    bloomdb_split_free(loaded);
+    unlink(path);
+
+    printf("✓ test_split: OK\n");
+    return 0;
+}
@@ -1,6 +1,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <assert.h>
+#include <stdint.h>
 #include <unistd.h>
 
 #include "bloomdb.h"
@@ -87,6 +88,94 @@ int main(void) {
     assert(err == BLOOMDB_ERR_FORMAT);  // Archivo truncado se considera formato inválido
     assert(truncated_db == NULL);
 
+    // Test 8: El algoritmo de hash y el modo de índice se conservan
+    assert(loaded->hash_algo == BLOOMDB_HASH_MURMUR3);
+    assert(loaded->index_mode == db->index_mode);
+
+    // Test 9: Archivo del formato original (sin extensión) => hash legacy
+    const char* legacy_path = "test_legacy.bloom";
+    BloomDB* legacy = NULL;
+    err = bloomdb_create_ex(4096, 4, 99, &legacy);
+    assert(err == BLOOMDB_OK);
+    legacy->hash_algo = BLOOMDB_HASH_LEGACY;
+    assert(bloomdb_insert_cstr(legacy, "old-key-1"));
+    assert(bloomdb_insert_cstr(legacy, "old-key-2"));
+
+    f = fopen(legacy_path, "wb");
+    assert(f != NULL);
+    fwrite(&legacy->bit_count,  sizeof(size_t),   1, f);
+    fwrite(&legacy->byte_count, sizeof(size_t),   1, f);
+    fwrite(&legacy->num_hashes, sizeof(int),      1, f);
+    fwrite(&legacy->seed,       sizeof(uint64_t), 1, f);
+    fwrite(legacy->bitarray, 1, legacy->byte_count, f);
+    fclose(f);
+
+    BloomDB* legacy_loaded = NULL;
+    err = bloomdb_load_ex(legacy_path, &legacy_loaded);
+    assert(err == BLOOMDB_OK);
+    assert(legacy_loaded->hash_algo == BLOOMDB_HASH_LEGACY);
+    assert(legacy_loaded->index_mode == BLOOMDB_INDEX_MODULO);
+    assert(bloomdb_might_contain_cstr(legacy_loaded, "old-key-1"));
+    assert(bloomdb_might_contain_cstr(legacy_loaded, "old-key-2"));
+    assert(memcmp(legacy->bitarray, legacy_loaded->bitarray, legacy->byte_count) == 0);
+
+    // Test 10: Extensión con algoritmo desconocido => formato inválido
+    f = fopen(legacy_path, "ab");
+    assert(f != NULL);
+    uint32_t bad_ext[3] = { 0x58424442u, 1, 42 };
+    fwrite(bad_ext, sizeof(uint32_t), 3, f);
+    fclose(f);
+
+    BloomDB* bad_algo = NULL;
+    err = bloomdb_load_ex(legacy_path, &bad_algo);
+    assert(err == BLOOMDB_ERR_FORMAT);
+    assert(bad_algo == NULL);
+
+    bloomdb_free(legacy);
+    bloomdb_free(legacy_loaded);
+
+    // Test 11: Extensión de un solo campo (solo hash_algo) => índice por módulo
+    BloomDB* modulo = bloomdb_create(5000, 3, 8);
+    assert(modulo != NULL);
+    modulo->index_mode = BLOOMDB_INDEX_MODULO;
+    assert(bloomdb_insert_cstr(modulo, "modulo-key"));
+
+    f = fopen(legacy_path, "wb");
+    assert(f != NULL);
+    fwrite(&modulo->bit_count,  sizeof(size_t),   1, f);
+    fwrite(&modulo->byte_count, sizeof(size_t),   1, f);
+    fwrite(&modulo->num_hashes, sizeof(int),      1, f);
+    fwrite(&modulo->seed,       sizeof(uint64_t), 1, f);
+    fwrite(modulo->bitarray, 1, modulo->byte_count, f);
+    uint32_t one_field[3] = { 0x58424442u, 1, BLOOMDB_HASH_MURMUR3 };
+    fwrite(one_field, sizeof(uint32_t), 3, f);
+    fclose(f);
+
+    BloomDB* modulo_loaded = NULL;
+    err = bloomdb_load_ex(legacy_path, &modulo_loaded);
+    assert(err == BLOOMDB_OK);
+    assert(modulo_loaded->hash_algo == BLOOMDB_HASH_MURMUR3);
+    assert(modulo_loaded->index_mode == BLOOMDB_INDEX_MODULO);
+    assert(bloomdb_might_contain_cstr(modulo_loaded, "modulo-key"));
+
+    // Test 12: Modo máscara con un tamaño que no es potencia de 2 => inválido
+    f = fopen(legacy_path, "r+b");
+    assert(f != NULL);
+    uint32_t mask_mode = BLOOMDB_INDEX_MASK;
+    fseek(f, -12, SEEK_END);
+    uint32_t two_fields[4] = { 0x58424442u, 2, BLOOMDB_HASH_MURMUR3, mask_mode };
+    fwrite(two_fields, sizeof(uint32_t), 4, f);
+    fclose(f);
+
+    BloomDB* bad_mask = NULL;
+    err = bloomdb_load_ex(legacy_path, &bad_mask);
+    assert(err == BLOOMDB_ERR_FORMAT);
+    assert(bad_mask == NULL);
+
+    bloomdb_free(modulo);
+    bloomdb_free(modulo_loaded);
+    unlink(legacy_path);
+
     // Cleanup
     bloomdb_free(db);
     bloomdb_free(loaded);
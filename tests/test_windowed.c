@@ -0,0 +1,166 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <unistd.h>
+
+#include "bloom_windowed.h"
+#include "storage.h"
+
+#define GENS 4
+#define PER_GEN 20000
+
+static void key_of(char* buf, size_t size, int gen, int i) {
+    snprintf(buf, size, "event-%d-%d", gen, i);
+}
+
+// Claves de la generación gen presentes en el filtro
+static int present(const BloomDBWindowed* wf, int gen) {
+    char buf[48];
+    int count = 0;
+    for (int i = 0; i < PER_GEN; i++) {
+        key_of(buf, sizeof(buf), gen, i);
+        count += bloomdb_windowed_might_contain(wf, buf, strlen(buf));
+    }
+    return count;
+}
+
+int main(void) {
+    printf("== test_windowed ==\n");
+
+    // Test 1: argumentos inválidos
+    BloomDBWindowed* wf = NULL;
+    assert(bloomdb_windowed_create_ex(0, 7, 4, 1, &wf) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_windowed_create_ex(1000, 0, 4, 1, &wf) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_windowed_create_ex(1000, 7, 0, 1, &wf) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_windowed_create_ex(1000, 7, BLOOMDB_WINDOWED_MAX_GENERATIONS + 1, 1, &wf) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_windowed_create_ex(1000, 7, 4, 1, NULL) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(wf == NULL);
+
+    // Test 2: carriles de 1, 2, 4 u 8 bits según G
+    const int gens[] = { 1, 2, 3, 4, 5, 8 };
+    const int widths[] = { 1, 2, 4, 4, 8, 8 };
+    for (int i = 0; i < 6; i++) {
+        wf = bloomdb_windowed_create(1001, 7, gens[i], 1);
+        assert(wf->lane_bits == widths[i]);
+        assert(wf->byte_count == (1001 * (size_t)widths[i] + 7) / 8);
+        bloomdb_windowed_free(wf);
+    }
+
+    // Test 3: misma respuesta que G BloomDB separados con los mismos
+    // parámetros (la consulta es el OR de las generaciones)
+    const size_t bits = 10 * PER_GEN;
+    wf = bloomdb_windowed_create(bits, 7, GENS, 42);
+    BloomDB* ref[GENS];
+    char buf[48];
+    for (int g = 0; g < GENS; g++) {
+        ref[g] = bloomdb_create(bits, 7, 42);
+        if (g > 0) assert(bloomdb_windowed_rotate(wf));
+        assert(wf->current == g);
+        for (int i = 0; i < PER_GEN; i++) {
+            key_of(buf, sizeof(buf), g, i);
+            assert(bloomdb_windowed_insert(wf, buf, strlen(buf)));
+            assert(bloomdb_insert(ref[g], buf, strlen(buf)));
+        }
+    }
+    for (int i = 0; i < 200000; i++) {
+        snprintf(buf, sizeof(buf), "probe-%d", i % 2 ? i : i / 2);
+        if (i % 4 == 0) key_of(buf, sizeof(buf), i % GENS, i % PER_GEN);
+        bool expected = false;
+        for (int g = 0; g < GENS; g++) expected |= bloomdb_might_contain(ref[g], buf, strlen(buf));
+        assert(bloomdb_windowed_might_contain(wf, buf, strlen(buf)) == expected);
+    }
+    for (int g = 0; g < GENS; g++) assert(present(wf, g) == PER_GEN);
+
+    // Test 4: cada rotación olvida la generación más antigua y nada más
+    for (int r = 0; r < GENS; r++) {
+        assert(bloomdb_windowed_rotate(wf));
+        for (int g = 0; g < GENS; g++) {
+            int p = present(wf, g);
+            if (g <= r) assert(p < PER_GEN / 20);   // olvidada: solo falsos positivos
+            else assert(p == PER_GEN);
+        }
+    }
+    assert(wf->rotations == 2 * GENS - 1);
+    bloomdb_windowed_free(wf);
+    for (int g = 0; g < GENS; g++) bloomdb_free(ref[g]);
+
+    // Test 5: deduplicación con un solo hash
+    wf = bloomdb_windowed_create(1 << 16, 6, 3, 7);
+    assert(!bloomdb_windowed_test_and_insert(wf, "evt", 3));
+    assert(bloomdb_windowed_test_and_insert(wf, "evt", 3));
+    assert(bloomdb_windowed_rotate(wf));
+    assert(bloomdb_windowed_test_and_insert(wf, "evt", 3));   // visto hace una generación
+    assert(bloomdb_windowed_rotate(wf));
+    assert(bloomdb_windowed_rotate(wf));
+    assert(bloomdb_windowed_might_contain(wf, "evt", 3));     // re-insertado en la generación 1
+    assert(bloomdb_windowed_rotate(wf));
+    assert(!bloomdb_windowed_test_and_insert(wf, "evt", 3));  // fuera de la ventana
+    bloomdb_windowed_free(wf);
+
+    // Test 6: FPR constante sobre un flujo sin fin (rotación cada PER_GEN claves)
+    wf = bloomdb_windowed_create(bits, 7, GENS, 9);
+    double rates[3];
+    int stream = 0;
+    for (int phase = 0; phase < 3; phase++) {
+        for (int r = 0; r < 5; r++) {
+            for (int i = 0; i < PER_GEN; i++, stream++) {
+                snprintf(buf, sizeof(buf), "stream-%d", stream);
+                bloomdb_windowed_insert(wf, buf, strlen(buf));
+            }
+            bloomdb_windowed_rotate(wf);
+        }
+        int fp = 0;
+        for (int i = 0; i < 100000; i++) {
+            snprintf(buf, sizeof(buf), "never-%d-%d", phase, i);
+            fp += bloomdb_windowed_might_contain(wf, buf, strlen(buf));
+        }
+        rates[phase] = fp / 100000.0;
+    }
+    printf("   FPR tras 5/10/15 rotaciones = %.3f%% / %.3f%% / %.3f%%\n",
+           100 * rates[0], 100 * rates[1], 100 * rates[2]);
+    for (int i = 0; i < 3; i++) assert(rates[i] < 0.04);   // 3 generaciones llenas al ~0.8%
+    assert(rates[2] < 2 * rates[0] + 0.001);
+
+    // Test 7: guardar y cargar
+    const char* path = "test_windowed.bloom";
+    assert(bloomdb_windowed_save(wf, path));
+    BloomDBWindowed* loaded = NULL;
+    assert(bloomdb_windowed_load_ex(path, &loaded) == BLOOMDB_OK);
+    assert(loaded->positions == wf->positions && loaded->lane_bits == wf->lane_bits);
+    assert(loaded->generations == wf->generations && loaded->current == wf->current);
+    assert(loaded->num_hashes == wf->num_hashes && loaded->seed == wf->seed);
+    assert(loaded->rotations == wf->rotations && loaded->index_mode == wf->index_mode);
+    assert(memcmp(loaded->lanes, wf->lanes, wf->byte_count) == 0);
+    for (int i = stream - 3 * PER_GEN; i < stream; i += 7) {
+        snprintf(buf, sizeof(buf), "stream-%d", i);
+        assert(bloomdb_windowed_might_contain(loaded, buf, strlen(buf)));
+    }
+    // La copia rota igual que la original
+    assert(bloomdb_windowed_rotate(loaded) && bloomdb_windowed_rotate(wf));
+    assert(memcmp(loaded->lanes, wf->lanes, wf->byte_count) == 0);
+
+    // Test 8: formato incorrecto y argumentos inválidos
+    BloomDBWindowed* wrong = NULL;
+    BloomDB* plain = bloomdb_create(1000, 3, 1);
+    assert(bloomdb_save(plain, path));
+    assert(bloomdb_windowed_load_ex(path, &wrong) == BLOOMDB_ERR_FORMAT);
+    assert(wrong == NULL);
+    assert(bloomdb_windowed_load_ex("nonexistent.bloom", &wrong) == BLOOMDB_ERR_FILE_IO);
+    assert(bloomdb_windowed_load("nonexistent.bloom") == NULL);
+    bool result;
+    assert(bloomdb_windowed_insert_ex(wf, NULL, 1) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_windowed_might_contain_ex(wf, "k", 0, &result) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_windowed_might_contain_ex(wf, "k", 1, NULL) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_windowed_test_and_insert_ex(wf, "k", 1, NULL) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_windowed_rotate_ex(NULL) == BLOOMDB_ERR_INVALID_ARGUMENT);
+    assert(bloomdb_windowed_save_ex(NULL, path) == BLOOMDB_ERR_INVALID_ARGUMENT);
+
+    bloomdb_free(plain);
+    bloomdb_windowed_free(wf);
+    bloomdb_windowed_free(loaded);
+    unlink(path);
+
+    printf("✓ test_windowed: OK\n");
+    return 0;
+}